@@ -0,0 +1,180 @@
+// Necessario per getrusage con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/core/game.h"
+#include "../src/card/card.h"
+#include "../src/rng/rng.h"
+#include "../src/utils/utils.h"
+#include "../src/model/constants.h"
+#include "../src/model/colors.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef _WIN32
+    #include <sys/resource.h>
+#endif
+
+static double* turn_latencies = NULL; // Durate dei turni giocati, in secondi
+static size_t num_turns = 0;          // Numero di turni misurati
+static size_t turns_capacity = 0;     // Capacità del vettore delle durate
+static double turn_start_time = -1;   // Istante di inizio del turno corrente (negativo SE nessun turno è in corso)
+
+/**
+ * @brief Registra la durata del turno appena concluso.
+ *
+ * @param end_time Istante di fine del turno.
+ */
+static void record_turn(double end_time) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE nessun turno è in corso => non c'è nulla da registrare
+    if (turn_start_time < 0) {
+        return;
+    }
+
+    // SE il vettore è pieno => raddoppia la capacità
+    // (viene usata realloc e non safe_realloc per non contare le allocazioni del benchmark stesso)
+    if (num_turns == turns_capacity) {
+        turns_capacity = turns_capacity == 0 ? 1024 : turns_capacity * 2;
+        turn_latencies = realloc(turn_latencies, turns_capacity * sizeof(double));
+        if (turn_latencies == NULL) {
+            printf(RED "[!] Errore di riallocazione di memoria dinamica!" RESET);
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    turn_latencies[num_turns++] = end_time - turn_start_time;
+    return;
+}
+
+/**
+ * @brief Osservatore dei turni: chiude la misurazione del turno precedente e apre quella del nuovo turno.
+ *
+ * @param game Puntatore alla partita (non utilizzato).
+ */
+static void on_turn_start(const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    (void) game;
+
+    double now = get_wall_time();
+    record_turn(now);
+    turn_start_time = now;
+    return;
+}
+
+/**
+ * @brief Confronta due durate (per qsort).
+ *
+ * @param a Puntatore alla prima durata.
+ * @param b Puntatore alla seconda durata.
+ * @return Valore negativo, nullo o positivo a seconda dell'ordine delle durate.
+ */
+static int compare_latencies(const void* a, const void* b) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    double x = *(const double*) a, y = *(const double*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Restituisce il percentile richiesto di un vettore di durate ordinato.
+ *
+ * @param sorted Vettore ordinato delle durate.
+ * @param size Dimensione del vettore.
+ * @param percent Percentile richiesto (0-100).
+ * @return Durata al percentile richiesto, in secondi.
+ */
+static double percentile(const double* sorted, size_t size, int percent) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return size == 0 ? 0.0 : sorted[(size - 1) * (size_t) percent / 100];
+}
+
+/**
+ * @brief Restituisce il picco di memoria residente del processo, in KiB.
+ *
+ * @return Picco della memoria residente in KiB, oppure -1 SE non disponibile.
+ */
+static long peak_rss_kib() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        return -1;
+    #else
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) != 0) {
+            return -1;
+        }
+        #ifdef __APPLE__
+            return usage.ru_maxrss / 1024; // Su macOS il valore è espresso in byte
+        #else
+            return usage.ru_maxrss;
+        #endif
+    #endif
+}
+
+/**
+ * @brief Esegue N partite complete con giocatori casuali e stampa le metriche del motore di gioco.
+ *
+ * Utilizzo: bench [numero partite] [numero giocatori] [seme]
+ */
+int main(int argc, char* argv[]) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int num_games = argc >= 2 ? atoi(argv[1]) : DEFAULT_BENCH_GAMES; // Numero di partite da giocare
+    int num_players = argc >= 3 ? atoi(argv[2]) : DEFAULT_SIMULATION_PLAYERS; // Numero di giocatori per partita
+    uint64_t seed = DEFAULT_BENCH_SEED; // Seme del benchmark
+
+    // Controllo SE i parametri del benchmark sono validi
+    if (num_games < 1 || num_players < MIN_PLAYERS || num_players > MAX_PLAYERS || (argc >= 4 && !parse_seed(argv[3], &seed))) {
+        printf("[" RED "!" RESET "] Utilizzo: %s [numero partite] [numero giocatori (min. 2, max. 4)] [seme]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    // Durante il benchmark l'output di gioco viene soppresso
+    set_silent_output(true);
+
+    int num_completed_games = 0; // Numero di partite terminate con un vincitore
+    unsigned long long start_allocations = count_allocations();
+    double start_time = get_wall_time();
+
+    for (int i = 0; i < num_games; i++) {
+        Game game;
+        init_simulated_game(&game, i, num_players, seed, NULL);
+        game.turn_observer = on_turn_start;
+
+        play_game(&game);
+        record_turn(get_wall_time()); // Chiude la misurazione dell'ultimo turno della partita
+        turn_start_time = -1;
+
+        num_completed_games += game.winner != NULL;
+        free_game(&game);
+    }
+
+    double elapsed_time = get_wall_time() - start_time;
+    unsigned long long num_allocations = count_allocations() - start_allocations;
+
+    set_silent_output(false);
+
+    qsort(turn_latencies, num_turns, sizeof(double), compare_latencies);
+
+    printf("[" HBLU "i" RESET "] Benchmark: %d partite, %d giocatori, seme %" PRIu64 " (%d con un vincitore)\n", num_games, num_players, seed, num_completed_games);
+    printf("    tempo totale:        %.3f s\n", elapsed_time);
+    printf("    partite/s:           %.1f\n", elapsed_time > 0 ? num_games / elapsed_time : 0.0);
+    printf("    turni/s:             %.1f (%zu turni)\n", elapsed_time > 0 ? (double) num_turns / elapsed_time : 0.0, num_turns);
+    printf("    latenza turno p50:   %.2f us\n", percentile(turn_latencies, num_turns, 50) * 1e6);
+    printf("    latenza turno p99:   %.2f us\n", percentile(turn_latencies, num_turns, 99) * 1e6);
+
+    long peak_rss = peak_rss_kib();
+    if (peak_rss >= 0) {
+        printf("    picco RSS:           %ld KiB\n", peak_rss);
+    } else {
+        printf("    picco RSS:           n/d\n");
+    }
+    printf("    allocazioni totali:  %llu (%.1f per partita)\n", num_allocations, (double) num_allocations / num_games);
+
+    free(turn_latencies);
+    free_card_definitions(); // Libera la tabella delle definizioni delle carte
+
+    return 0;
+}
@@ -2,63 +2,139 @@
 #include "../utils/utils.h"
 #include "../effect/effect.h"
 #include "../logging/logging.h"
+#include "../decision/decision.h"
+#include "../rng/rng.h"
+#include "../journal/journal.h"
 #include <assert.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Tabella globale (condivisa da tutte le partite) delle definizioni immutabili delle carte.
+// Ogni definizione è allocata singolarmente, così i puntatori restano validi anche quando la tabella cresce.
+static Card_definition** card_definitions = NULL;
+// Istanza condivisa di ogni definizione (stessa posizione nella tabella): i mazzi contengono puntatori a queste istanze,
+// quindi creare, copiare o caricare un mazzo non alloca nulla per le singole carte.
+static Card** card_instances = NULL;
+static int num_card_definitions = 0;
+static bool deck_definitions_loaded = false; // Flag per sapere se il file del mazzo è già stato letto
+
+// Cache delle carte formattate e frame riutilizzato per stampare carte e mazzi, locali al thread
+// (solo il thread della partita reale stampa, i thread delle partite simulate sono silenziosi)
+static THREAD_LOCAL Rendered_card_cache rendered_cards = {NULL, 0, 0};
+static THREAD_LOCAL Frame print_buffer = {NULL, 0, 0};
+
 /**
- * @brief Carica un mazzo di carte da un file.
+ * @brief Libera la cache delle carte formattate e il frame di stampa del thread corrente.
  * 
- * @param filename Nome del file da cui caricare le carte.
- * @param num_cards Puntatore al numero di carte totali.
- * @param num_unique_cards Puntatore al numero di carte univoche.
- * @return Card* Puntatore alla testa della lista di carte.
+ * Va chiamata da ogni thread che ha stampato carte prima di terminare (il thread principale lo fa in free_card_definitions).
  */
-Card* load_cards(const char* filename, int* num_cards, int* num_unique_cards) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void free_rendered_cards() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    puts("\n[" HBLU "i" RESET "] Caricamento delle carte dal mazzo in corso...");
+    for (int i = 0; i < rendered_cards.capacity; i++) {
+        free(rendered_cards.entries[i].rows);
+        free(rendered_cards.entries[i].row_offsets);
+    }
+
+    free(rendered_cards.entries);
+    rendered_cards.entries = NULL;
+    rendered_cards.capacity = 0;
+    rendered_cards.size = 0;
+
+    free_frame(&print_buffer);
+
+    return;
+}
+
+/**
+ * @brief Carica le definizioni delle carte dal file del mazzo, SE non sono già state caricate.
+ * 
+ * Va chiamata prima di avviare più partite in parallelo, così che la tabella globale delle definizioni
+ * venga solo letta (e mai modificata) dai thread.
+ * 
+ * @param filename Nome del file da cui caricare le definizioni.
+ */
+void load_card_definitions(const char* filename) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE le definizioni del mazzo sono già state lette => non c'è nulla da fare
+    if (deck_definitions_loaded) {
+        return;
+    }
 
     FILE* file = safe_fopen(filename, "r"); // Apertura del file in lettura
-    *num_cards = 0; // Inizializzazione del numero di carte totali
-    *num_unique_cards = 0; // Inizializzazione del numero di carte univoche
-    Card* deck = NULL; // Inizializzazione del mazzo
 
     int quantity, check; // Variabili di controllo + quantità di carte
     do {
         // Legge la quantità di carte e verifica se la lettura è andata a buon fine
         check = fscanf(file, " %d", &quantity);
         if (check == 1) {
-            Card* card = read_card(file); // Legge la carta dal file
-            *num_cards += quantity; // Incrementa il numero di carte totali
-            (*num_unique_cards)++; // Incrementa il numero di carte univoche
+            Card_definition* definition = read_card(file); // Legge la definizione della carta dal file
+            definition->quantity = quantity; // Imposta la quantità di copie nel mazzo
 
-            // Aggiunge la carta al mazzo per la quantità specificata
-            for (int i = 0; i < quantity; i++) {
-                Card* copy_of_card = (Card*) safe_calloc(1, sizeof(Card)); // Alloca la memoria per la copia della carta
-                copy_card(card, copy_of_card); // Copia la carta
-                deck = add_card(deck, copy_of_card); // Aggiunge la carta al mazzo
+            // Registra la definizione (SE è già presente ne aggiorna solo la quantità)
+            Card_definition* registered = register_card_definition(definition);
+            if (registered != definition) {
+                registered->quantity += quantity;
             }
-
-            free_card(card); // Libera la memoria allocata per la carta iniziale
         }
     } while (check == 1); // Continua finché ci sono carte da leggere
 
     fclose(file); // Chiusura del file
+    deck_definitions_loaded = true;
+
+    return;
+}
+
+/**
+ * @brief Carica un mazzo di carte da un file.
+ * 
+ * Il file viene letto solo la prima volta: le definizioni delle carte vengono registrate nella tabella globale
+ * e ogni carta del mazzo è un'istanza che punta alla propria definizione.
+ * 
+ * @param filename Nome del file da cui caricare le carte.
+ * @param num_cards Puntatore al numero di carte totali.
+ * @param num_unique_cards Puntatore al numero di carte univoche.
+ * @return Deck Mazzo di carte caricato.
+ */
+Deck load_cards(const char* filename, int* num_cards, int* num_unique_cards) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    print_msg("\n[" HBLU "i" RESET "] Caricamento delle carte dal mazzo in corso...\n");
+
+    load_card_definitions(filename); // Legge le definizioni del mazzo (solo la prima volta)
+
+    *num_cards = 0; // Inizializzazione del numero di carte totali
+    *num_unique_cards = 0; // Inizializzazione del numero di carte univoche
+    Deck deck; // Inizializzazione del mazzo
+    init_deck(&deck);
+
+    // Crea un'istanza per ogni copia di ogni definizione presente nel mazzo
+    for (int i = 0; i < num_card_definitions; i++) {
+        if (card_definitions[i]->quantity > 0) {
+            *num_cards += card_definitions[i]->quantity; // Incrementa il numero di carte totali
+            (*num_unique_cards)++; // Incrementa il numero di carte univoche
+
+            for (int j = 0; j < card_definitions[i]->quantity; j++) {
+                add_card(&deck, card_instances[i]); // Aggiunge la carta in coda al mazzo
+            }
+        }
+    }
+
     return deck;
 }
 
 /**
- * @brief Legge una carta da un file.
+ * @brief Legge la definizione di una carta da un file.
  * 
  * @param file Puntatore al file da cui leggere la carta.
- * @return Card* Puntatore alla carta letta.
+ * @return Card_definition* Puntatore alla definizione letta (non ancora registrata).
  */
-Card* read_card(FILE* file) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+Card_definition* read_card(FILE* file) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    // Alloca la memoria per la carta
-    Card* card = (Card*) safe_calloc(1, sizeof(Card));
+    // Alloca la memoria per la definizione della carta
+    Card_definition* card = (Card_definition*) safe_calloc(1, sizeof(Card_definition));
 
     // Legge il nome della carta e verifica se la lettura è andata a buon fine
     if (fscanf(file, " %" STR_MAX_NAME_LENGTH "[^\n]s", card->name) != INPUT_UNIT) {
@@ -119,119 +195,428 @@ Card* read_card(FILE* file) {
         exit(EXIT_FAILURE);
     }
 
-    card->next_card = NULL;
     return card;
 }
 
 /**
- * @brief Libera la memoria allocata per una carta.
+ * @brief Registra una definizione nella tabella globale delle carte.
+ * 
+ * SE è già presente una definizione con lo stesso nome, la nuova definizione viene liberata
+ * e viene restituita quella già registrata.
  * 
- * @param card Puntatore alla carta da liberare.
+ * @param definition Puntatore alla definizione da registrare (la tabella ne acquisisce la proprietà).
+ * @return Card_definition* Puntatore alla definizione registrata.
  */
-void free_card(Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+Card_definition* register_card_definition(Card_definition* definition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    if (card == NULL) {
-        return;
+    Card_definition* registered = (Card_definition*) find_card_definition(definition->name);
+
+    // SE la definizione è già presente nella tabella
+    if (registered != NULL) {
+        free(definition->effects);
+        free(definition);
+        return registered;
     }
 
-    if (card->effects != NULL) {
-        free(card->effects);
-        card->effects = NULL;
+    card_definitions = (Card_definition**) safe_realloc(card_definitions, ((size_t) num_card_definitions + 1) * sizeof(Card_definition*));
+    card_instances = (Card**) safe_realloc(card_instances, ((size_t) num_card_definitions + 1) * sizeof(Card*));
+    definition->id = num_card_definitions; // L'id della definizione è la sua posizione nella tabella
+    definition->hash_key = mix_hash(HASH_KEYS_SEED + (unsigned int) definition->id); // Chiave dell'hash ricavata dall'id (uguale ad ogni esecuzione)
+    compile_card_effects(definition); // Compila gli effetti (le combinazioni non valide vengono rifiutate qui)
+    definition->description_rows = wrap_text_lines(definition->description, REAL_CARD_WIDTH, definition->description_lines, MAX_DESCRIPTION_ROWS); // Suddivide la descrizione in righe una sola volta
+    card_instances[num_card_definitions] = (Card*) safe_malloc(sizeof(Card)); // Istanza condivisa da tutte le copie della carta
+    card_instances[num_card_definitions]->def = definition;
+    card_definitions[num_card_definitions++] = definition;
+
+    return definition;
+}
+
+/**
+ * @brief Cerca una definizione nella tabella globale delle carte tramite il nome.
+ * 
+ * @param name Nome della carta.
+ * @return const Card_definition* Puntatore alla definizione trovata, NULL altrimenti.
+ */
+const Card_definition* find_card_definition(const char* name) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    for (int i = 0; i < num_card_definitions; i++) {
+        if (strcmp(card_definitions[i]->name, name) == 0) {
+            return card_definitions[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Restituisce il numero di definizioni presenti nella tabella globale delle carte.
+ * 
+ * @return int Numero di definizioni registrate.
+ */
+int count_card_definitions() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return num_card_definitions;
+}
+
+/**
+ * @brief Restituisce la definizione con l'id indicato.
+ * 
+ * @param id Id della definizione (posizione nella tabella).
+ * @return const Card_definition* Puntatore alla definizione.
+ */
+const Card_definition* get_card_definition(int id) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return card_definitions[id];
+}
+
+/**
+ * @brief Libera la memoria allocata per la tabella globale delle definizioni delle carte.
+ */
+void free_card_definitions() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    for (int i = 0; i < num_card_definitions; i++) {
+        free(card_definitions[i]->effects);
+        free(card_definitions[i]->programs);
+        free(card_definitions[i]);
+        free(card_instances[i]);
     }
 
-    free(card);
+    free_rendered_cards(); // Le carte formattate puntano alle definizioni
+
+    free(card_definitions);
+    free(card_instances);
+    card_definitions = NULL;
+    card_instances = NULL;
+    num_card_definitions = 0;
+    deck_definitions_loaded = false;
+
     return;
 }
 
 /**
- * @brief Libera la memoria allocata per un mazzo di carte.
+ * @brief Restituisce l'istanza condivisa di una carta a partire dalla sua definizione (nessuna allocazione).
+ * Tutte le copie della carta nei mazzi puntano alla stessa istanza, che viene liberata insieme alle definizioni.
+ * 
+ * @param definition Puntatore alla definizione (registrata) della carta.
+ * @return Card* Puntatore all'istanza della carta.
+ */
+Card* get_definition_card(const Card_definition* definition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return card_instances[definition->id];
+}
+
+/**
+ * @brief Inizializza un mazzo di carte vuoto.
+ * 
+ * @param deck Puntatore al mazzo di carte da inizializzare.
+ */
+void init_deck(Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    deck->cards = NULL;
+    deck->capacity = 0;
+    deck->head = 0;
+    deck->size = 0;
+    deck->effect_index = NULL;
+    deck->journal = NULL;
+    deck->zone = 0;
+    deck->hash = 0;
+    deck->hash_power = 1;
+
+    return;
+}
+
+/**
+ * @brief Libera la memoria allocata per un mazzo di carte e lo lascia vuoto (le carte sono istanze condivise e non vengono liberate).
  * 
  * @param deck Puntatore al mazzo di carte da liberare.
  */
-void free_deck(Card* deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void free_deck(Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    Card* current_card = deck;
-    Card* next_card = NULL;
+    free(deck->cards);
+    free(deck->effect_index);
+    init_deck(deck);
 
-    while (current_card != NULL) {
-        next_card = current_card->next_card;
-        free_card(current_card);
-        current_card = next_card;
+    return;
+}
+
+/**
+ * @brief Aggiunge in coda ad un mazzo ogni carta di un altro mazzo, nello stesso ordine.
+ * Le carte sono istanze condivise: vengono copiati solo i puntatori, senza allocazioni per carta.
+ * 
+ * @param destination Puntatore al mazzo (già inizializzato) in cui copiare le carte.
+ * @param source Puntatore al mazzo da copiare.
+ */
+void copy_deck(Deck* destination, const Deck* source) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    reserve_deck(destination, destination->size + source->size); // Una sola allocazione per l'intero mazzo
+    for (int i = 0; i < source->size; i++) {
+        add_card(destination, get_card(source, i));
+    }
+
+    return;
+}
+
+/**
+ * @brief Aggiorna l'indice degli effetti di un mazzo quando una carta entra o esce dal mazzo.
+ * 
+ * @param deck Puntatore al mazzo di carte.
+ * @param card Puntatore alla carta aggiunta o rimossa.
+ * @param delta +1 se la carta è stata aggiunta al mazzo, -1 se è stata rimossa.
+ */
+static void update_effect_index(Deck* deck, const Card* card, int delta) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il mazzo non ha un indice degli effetti => non fa nulla
+    if (deck->effect_index == NULL) {
+        return;
+    }
+
+    // Ogni effetto della carta incrementa (o decrementa) il contatore della propria terna (azione, giocatore bersaglio, carta bersaglio)
+    for (int i = 0; i < card->def->num_effects; i++) {
+        const Effect* effect = &card->def->effects[i];
+        deck->effect_index->counts[effect->action_effect][effect->target_player][effect->target_card] += delta;
+        assert (deck->effect_index->counts[effect->action_effect][effect->target_player][effect->target_card] >= 0 && "Indice degli effetti non valido!");
+    }
+
+    return;
+}
+
+/**
+ * @brief Abilita l'indice degli effetti di un mazzo, così che deck_contains_effect risponda in tempo costante.
+ * L'indice viene poi aggiornato ogni volta che una carta entra o esce dal mazzo.
+ * 
+ * @param deck Puntatore al mazzo di carte (può già contenere delle carte).
+ */
+void enable_effect_index(Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il mazzo ha già un indice degli effetti => non fa nulla
+    if (deck->effect_index != NULL) {
+        return;
+    }
+
+    deck->effect_index = (Effect_index*) safe_calloc(1, sizeof(Effect_index));
+
+    // Indicizza le carte già presenti nel mazzo
+    for (int i = 0; i < deck->size; i++) {
+        update_effect_index(deck, get_card(deck, i), 1);
     }
 
     return;
 }
 
 /**
- * @brief Copia i dati di una carta in un'altra.
+ * @brief Calcola da zero l'hash dell'ordine delle carte di un mazzo: somma delle chiavi delle carte,
+ * con la carta in posizione i moltiplicata per HASH_MULTIPLIER^i (aritmetica modulo 2^64).
  * 
- * @param src Puntatore alla carta sorgente.
- * @param dst Puntatore alla carta destinazione.
+ * @param deck Puntatore al mazzo di carte.
+ * @return uint64_t Hash del mazzo.
  */
-void copy_card(Card* src, Card* dst) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+uint64_t compute_deck_hash(const Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    assert (src != NULL && "Source card is NULL!");
+    uint64_t hash = 0, power = 1;
+    for (int i = 0; i < deck->size; i++) {
+        hash += get_card(deck, i)->def->hash_key * power;
+        power *= HASH_MULTIPLIER;
+    }
 
-    strncpy(dst->name, src->name, MAX_NAME_LENGTH); // Copia il nome della carta
-    strncpy(dst->description, src->description, MAX_DESCRIPTION_LENGTH); // Copia la descrizione della carta
-    dst->type = src->type; // Copia il tipo della carta
-    dst->num_effects = src->num_effects; // Copia il numero di effetti della carta
+    return hash;
+}
 
-    // Se la carta ha effetti, li copia
-    if (src->num_effects > 0) {
-        dst->effects = (Effect*) safe_calloc(dst->num_effects, sizeof(Effect)); // Alloca la memoria per gli effetti
+/**
+ * @brief Aggiorna l'hash di un mazzo quando una carta viene rimossa (da chiamare prima di rimuoverla).
+ * Le carte che seguono scalano di una posizione: il loro contributo viene diviso per HASH_MULTIPLIER.
+ * Viene scorsa solo la parte più corta del mazzo, quindi togliere la prima o l'ultima carta costa O(1).
+ * 
+ * @param deck Puntatore al mazzo di carte.
+ * @param card_index Indice della carta da rimuovere.
+ * @param card Puntatore alla carta da rimuovere.
+ */
+static void remove_card_hash(Deck* deck, int card_index, const Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t before = 0, after = 0; // Contributi delle carte che precedono e che seguono la carta rimossa
+    uint64_t power = 1; // HASH_MULTIPLIER^card_index
 
-        // Copia tutta la lista degli effetti
-        for (int i = 0; i < dst->num_effects; i++) {
-            dst->effects[i].action_effect = src->effects[i].action_effect;
-            dst->effects[i].target_player = src->effects[i].target_player;
-            dst->effects[i].target_card = src->effects[i].target_card;
+    if (card_index < deck->size / 2) {
+        for (int i = 0; i < card_index; i++) {
+            before += get_card(deck, i)->def->hash_key * power;
+            power *= HASH_MULTIPLIER;
         }
+        after = deck->hash - before - card->def->hash_key * power;
     } else {
-        dst->effects = NULL; // Per evitare problemi imposto a NULL se non ci sono effetti
+        power = deck->hash_power;
+        for (int i = deck->size - 1; i > card_index; i--) {
+            power *= HASH_MULTIPLIER_INVERSE;
+            after += get_card(deck, i)->def->hash_key * power;
+        }
+        power *= HASH_MULTIPLIER_INVERSE;
+        before = deck->hash - after - card->def->hash_key * power;
     }
 
-    dst->when_activate = src->when_activate; // Copia il momento di attivazione della carta
-    dst->optional = src->optional;           // Copia la flag opzionale della carta
-    dst->next_card = NULL;                   // Imposta il puntatore alla prossima carta a NULL
+    deck->hash = before + after * HASH_MULTIPLIER_INVERSE;
+    deck->hash_power *= HASH_MULTIPLIER_INVERSE;
 
     return;
 }
 
+/**
+ * @brief Porta la capacità di un mazzo di carte ad almeno un certo numero di carte, riportando le carte all'inizio del buffer.
+ * Usata prima di aggiungere molte carte insieme, così il buffer viene allocato una sola volta.
+ * 
+ * @param deck Puntatore al mazzo di carte.
+ * @param capacity Numero minimo di carte che il mazzo deve poter contenere.
+ */
+void reserve_deck(Deck* deck, int capacity) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il mazzo ha già la capacità richiesta => non fa nulla
+    if (capacity <= deck->capacity) {
+        return;
+    }
+
+    Card** new_cards = (Card**) safe_malloc((size_t) capacity * sizeof(Card*));
+
+    // Copia le carte nell'ordine del mazzo (il buffer circolare viene "srotolato")
+    for (int i = 0; i < deck->size; i++) {
+        new_cards[i] = get_card(deck, i);
+    }
+
+    free(deck->cards);
+    deck->cards = new_cards;
+    deck->capacity = capacity;
+    deck->head = 0;
+
+    return;
+}
+
+/**
+ * @brief Raddoppia la capacità di un mazzo di carte.
+ * 
+ * @param deck Puntatore al mazzo di carte.
+ */
+static void grow_deck(Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    reserve_deck(deck, deck->capacity == 0 ? DECK_INITIAL_CAPACITY : deck->capacity * 2);
+    return;
+}
+
+/**
+ * @brief Restituisce la carta in una determinata posizione del mazzo.
+ * 
+ * @param deck Puntatore al mazzo di carte.
+ * @param index Indice della carta (partendo da 0).
+ * @return Card* Puntatore alla carta.
+ */
+Card* get_card(const Deck* deck, int index) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    assert ((index >= 0 && index < deck->size) && "Indice della carta non valido!");
+    return deck->cards[(deck->head + index) % deck->capacity];
+}
+
 /**
  * @brief Aggiunge una carta in coda ad un mazzo.
  * 
- * @param head Puntatore alla testa del mazzo.
+ * @param deck Puntatore al mazzo.
  * @param card Puntatore alla carta da aggiungere.
- * @return Card* Puntatore alla testa del mazzo.
  */
-Card* add_card(Card* head, Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void add_card(Deck* deck, Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     assert (card != NULL && "Card is NULL!");
 
-    // Se la carta è già collegata ad un'altra carta, la scollega
-    if (card->next_card != NULL) {
-        card->next_card = NULL;
+    // SE il mazzo è pieno, ne aumenta la capacità
+    if (deck->size == deck->capacity) {
+        grow_deck(deck);
     }
 
-    // Se il mazzo è vuoto, la carta diventa la testa
-    if (head == NULL) {
-        head = card;
-    } else {
-        // Altrimenti scorre il mazzo fino all'ultima carta
-        Card* current = head;
-        while (current->next_card != NULL) {
-            current = current->next_card;
-        }
+    deck->cards[(deck->head + deck->size) % deck->capacity] = card;
+    deck->size++;
+    deck->hash += card->def->hash_key * deck->hash_power; // La carta entra in ultima posizione
+    deck->hash_power *= HASH_MULTIPLIER;
+    update_effect_index(deck, card, 1);
+    journal_add_card(deck, card, false);
+
+    return;
+}
+
+/**
+ * @brief Aggiunge una carta in cima ad un mazzo.
+ * 
+ * @param deck Puntatore al mazzo.
+ * @param card Puntatore alla carta da aggiungere.
+ */
+void add_card_front(Deck* deck, Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    assert (card != NULL && "Card is NULL!");
 
-        current->next_card = card; // Collega la carta alla fine del mazzo
+    // SE il mazzo è pieno, ne aumenta la capacità
+    if (deck->size == deck->capacity) {
+        grow_deck(deck);
     }
 
-    return head;
+    deck->head = (deck->head + deck->capacity - 1) % deck->capacity;
+    deck->cards[deck->head] = card;
+    deck->size++;
+    deck->hash = deck->hash * HASH_MULTIPLIER + card->def->hash_key; // Le altre carte scalano di una posizione
+    deck->hash_power *= HASH_MULTIPLIER;
+    update_effect_index(deck, card, 1);
+    journal_add_card(deck, card, true);
+
+    return;
+}
+
+/**
+ * @brief Rimuove e restituisce la carta in cima ad un mazzo.
+ * 
+ * @param deck Puntatore al mazzo.
+ * @return Card* Puntatore alla carta rimossa.
+ */
+Card* pop_card_front(Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    assert (deck->size > 0 && "Mazzo vuoto!");
+
+    journal_remove_card(deck, 0);
+
+    Card* card = deck->cards[deck->head];
+    remove_card_hash(deck, 0, card);
+    deck->head = (deck->head + 1) % deck->capacity;
+    deck->size--;
+    update_effect_index(deck, card, -1);
+
+    return card;
+}
+
+/**
+ * @brief Rimuove e restituisce la carta in coda ad un mazzo.
+ * 
+ * @param deck Puntatore al mazzo.
+ * @return Card* Puntatore alla carta rimossa.
+ */
+Card* pop_card_back(Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    assert (deck->size > 0 && "Mazzo vuoto!");
+
+    journal_remove_card(deck, deck->size - 1);
+
+    Card* card = deck->cards[(deck->head + deck->size - 1) % deck->capacity];
+    remove_card_hash(deck, deck->size - 1, card);
+    deck->size--;
+    update_effect_index(deck, card, -1);
+
+    return card;
 }
 
 /**
@@ -241,7 +626,7 @@ Card* add_card(Card* head, Card* card) {
  * @return char* Stringa del tipo di carta.
  */
 char* get_type_card(Type_card type) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     char* type_card; // Inizializa la stringa del tipo di carta
 
@@ -282,34 +667,6 @@ char* get_type_card(Type_card type) {
     return type_card;
 }
 
-/**
- * @brief Restituisce il tipo di carta in formato stringa formattato.
- * 
- * @param type Valore dell'enumerazione del tipo di carta.
- * @return char* Stringa del tipo di carta formattata.
- */
-char* get_parsed_type_card(Type_card type) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    // Stringhe di inizio e fine per il tipo di carta
-    const static char start_str[] = "[";
-    const static char end_str[] = "]";
-
-    char* type_card = get_type_card(type); // Ottiene il tipo di carta in formato stringa
-    int parsed_type_len = strlen(type_card) + strlen(start_str) + strlen(end_str); // Calcola la lunghezza della stringa formattata
-
-    // Alloca la memoria per la stringa formattata
-    char* parsed_type_card = (char*) safe_malloc((parsed_type_len + 1) * sizeof(char));
-    parsed_type_card[0] = '\0'; // Inizializa la stringa
-
-    // Costruisce la stringa formattata
-    strcat(parsed_type_card, start_str);
-    strcat(parsed_type_card, type_card);
-    strcat(parsed_type_card, end_str);
-
-    return parsed_type_card;
-}
-
 /**
  * @brief Restituisce il colore per la formattazione in base al tipo di carta.
  * 
@@ -317,7 +674,7 @@ char* get_parsed_type_card(Type_card type) {
  * @return char* Stringa del colore per la formattazione.
  */
 char* get_color_by_type(Type_card type) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     char* color; // Inizializza il colore per la formattazione
 
@@ -350,205 +707,264 @@ char* get_color_by_type(Type_card type) {
 }
 
 /**
- * @brief Calcola il numero massimo di righe per la descrizione di un mazzo di carte.
+ * @brief Scrive nel frame una riga di una carta (senza indice).
  * 
- * @param deck Puntatore al mazzo di carte.
- * @return int Il numero massimo di righe per la descrizione delle carte.
+ * Il layout della carta è: bordo superiore, nome, tipo, riga vuota, descrizione (allineata a max_rows_description righe),
+ * riga vuota e bordo inferiore. La riga dell'indice, quando serve, viene inserita prima del bordo inferiore da render_card_index_row.
+ * 
+ * @param frame Puntatore al frame in cui scrivere.
+ * @param definition Puntatore alla definizione della carta.
+ * @param max_rows_description Numero di righe riservate alla descrizione.
+ * @param row Riga della carta da scrivere (partendo da 0).
  */
-int calculate_max_row_length_for_description(const Card* deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static void render_card_row(Frame* frame, const Card_definition* definition, int max_rows_description, int row) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    const char* card_color = get_color_by_type(definition->type); // Colore della carta in base al tipo
+    int last_row = CARD_BASE_HEIGHT + max_rows_description - 2;
+
+    // SE è il bordo superiore o inferiore della carta
+    if (row == 0 || row == last_row) {
+        frame_append(frame, card_color);
+        frame_append(frame, row == 0 ? UNICODE_BORDER_UP_LEFT : UNICODE_BORDER_DOWN_LEFT);
+        frame_append_repeat(frame, UNICODE_BORDER_HORIZONTAL, CARD_WIDTH);
+        frame_append(frame, row == 0 ? UNICODE_BORDER_UP_RIGHT : UNICODE_BORDER_DOWN_RIGHT);
+        frame_append(frame, RESET);
+        return;
+    }
 
-    int max_row_length = 0; // Inizializza il numero massimo di righe per la descrizione a 0
+    // SE è la riga del tipo della carta (il bordo ha lo stesso colore del tipo)
+    if (row == 2) {
+        char parsed_type[MAX_NAME_LENGTH + 1];
+        snprintf(parsed_type, sizeof(parsed_type), "[%s]", get_type_card(definition->type));
 
-    // Scorre tutte le carte del mazzo
-    Card* current_card = deck;
-    while (current_card != NULL) {
-        // Calcola il numero di righe per la descrizione della carta
-        int card_description_rows = 0;
-        char** wrapped_description = wrap_text(current_card->description, REAL_CARD_WIDTH, &card_description_rows);
-
-        // Aggiorna il numero massimo di righe per la descrizione
-        max_row_length = max(max_row_length, card_description_rows);
-
-        // Libera la memoria allocata per le righe della descrizione
-        for (int j = 0; j < card_description_rows; j++) {
-            free(wrapped_description[j]);
-        }
+        frame_append(frame, card_color);
+        frame_append(frame, UNICODE_BORDER_VERTICAL " ");
+        frame_append_centered(frame, parsed_type, REAL_CARD_WIDTH);
+        frame_append(frame, " " UNICODE_BORDER_VERTICAL RESET);
+        return;
+    }
 
-        free(wrapped_description); // Libera la memoria allocata per l'array di righe
-        current_card = current_card->next_card; // Passa alla carta successiva
+    frame_append(frame, card_color);
+    frame_append(frame, UNICODE_BORDER_VERTICAL RESET " ");
+
+    if (row == 1) {
+        // Nome della carta
+        frame_append(frame, BOLD);
+        frame_append_centered(frame, definition->name, REAL_CARD_WIDTH);
+        frame_append(frame, RESET);
+    } else if (row >= 4 && row < 4 + definition->description_rows) {
+        // Riga della descrizione della carta (calcolata alla registrazione della definizione), completata con spazi
+        const Text_line* line = &definition->description_lines[row - 4];
+        frame_append(frame, ITALIC);
+        frame_append_length(frame, definition->description + line->start, line->length);
+        frame_append_repeat(frame, " ", REAL_CARD_WIDTH - line->length);
+        frame_append(frame, RESET);
+    } else {
+        // Riga vuota
+        frame_append_repeat(frame, " ", REAL_CARD_WIDTH);
     }
 
-    return max_row_length;
+    frame_append(frame, " ");
+    frame_append(frame, card_color);
+    frame_append(frame, UNICODE_BORDER_VERTICAL RESET);
+
+    return;
 }
 
 /**
- * @brief Formatta graficamente una carta in un buffer di righe.
+ * @brief Scrive nel frame la riga dell'indice di una carta visibile.
  * 
- * @param buffer_rows Puntatore per restituire il numero di righe del buffer.
- * @param card Puntatore alla carta da formattare.
- * @param max_rows_description Numero massimo di righe per la descrizione.
+ * @param frame Puntatore al frame in cui scrivere.
+ * @param definition Puntatore alla definizione della carta.
  * @param card_index Indice della carta.
  * @param total_cards Numero totale di carte.
- * @return char** Buffer di righe contenente la carta formattata.
  */
-char** format_card(int* buffer_rows, const Card* card, int max_rows_description, int card_index, int total_cards) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static void render_card_index_row(Frame* frame, const Card_definition* definition, int card_index, int total_cards) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    // Costruzione dei separatori e calcolo del padding
-    char* card_border = repeat_string(UNICODE_BORDER_HORIZONTAL, CARD_WIDTH);
-    char* card_line_separator = repeat_char(' ', REAL_CARD_WIDTH);
+    const char* card_color = get_color_by_type(definition->type); // Colore della carta in base al tipo
 
-    char* card_name = padding_string(card->name, REAL_CARD_WIDTH);
-    char* parsed_type = get_parsed_type_card(card->type);
-    char* card_type = padding_string(parsed_type, REAL_CARD_WIDTH);
+    char parsed_index[MAX_CARD_INDEX_LENGTH + 1];
+    snprintf(parsed_index, sizeof(parsed_index), "%d/%d", card_index, total_cards);
 
-    // Calcola il numero di righe per la descrizione della carta
-    int card_description_lines = 0;
-    char** wrapped_description = wrap_text(card->description, REAL_CARD_WIDTH, &card_description_lines);
+    frame_append(frame, card_color);
+    frame_append(frame, UNICODE_BORDER_VERTICAL RESET " ");
+    frame_append_centered(frame, parsed_index, REAL_CARD_WIDTH);
+    frame_append(frame, " ");
+    frame_append(frame, card_color);
+    frame_append(frame, UNICODE_BORDER_VERTICAL RESET);
 
-    // Calcola il colore della carta in base al tipo e calcola la dimensione del colore in caratteri
-    char* card_color = get_color_by_type(card->type);
-    int card_color_size = strlen(card_color) + strlen(RESET);
+    return;
+}
 
-    bool need_index = card_index != -1; // Flag per la necessità dell'indice
+/**
+ * @brief Calcola l'indice di una voce nella cache delle carte formattate.
+ * 
+ * @param cache Puntatore alla cache.
+ * @param definition Puntatore alla definizione della carta.
+ * @param max_rows_description Numero di righe riservate alla descrizione.
+ * @return int Indice della voce con la chiave indicata, oppure della voce libera in cui inserirla.
+ */
+static int find_rendered_card_slot(const Rendered_card_cache* cache, const Card_definition* definition, int max_rows_description) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t mask = (uint64_t) cache->capacity - 1;
+    uint64_t index = (definition->hash_key ^ ((unsigned int) (max_rows_description + 1) * HASH_MULTIPLIER)) & mask;
 
-    if (!max_rows_description) {
-        // SE non è stato specificato il numero massimo di righe per la descrizione della carta
-        // utilizza il numero di righe effettivo della descrizione della carta
-        max_rows_description = card_description_lines;
+    // Scansione lineare fino alla voce cercata o alla prima voce libera
+    while (cache->entries[index].def != NULL && (cache->entries[index].def != definition || cache->entries[index].max_rows_description != max_rows_description)) {
+        index = (index + 1) & mask;
     }
 
-    // Calcola il numero totale di righe del buffer
-    int total_rows = CARD_BASE_HEIGHT + max_rows_description - !need_index;
-    *buffer_rows = total_rows;
+    return (int) index;
+}
 
-    // Calcola la lunghezza totale di ogni riga del buffer
-    int total_row_length = strlen(UNICODE_BORDER_UP_LEFT) + strlen(card_border) + strlen(UNICODE_BORDER_UP_RIGHT) + card_color_size;
+/**
+ * @brief Raddoppia la capacità della cache delle carte formattate, reinserendo le voci presenti.
+ * 
+ * @param cache Puntatore alla cache.
+ */
+static void grow_rendered_cards(Rendered_card_cache* cache) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    char** buffer = (char**) safe_malloc(total_rows * sizeof(char*)); // Alloca la memoria per il buffer
+    Rendered_card* old_entries = cache->entries;
+    int old_capacity = cache->capacity;
 
-    for (int i = 0; i < total_rows; i++) {
-        // Alloca la memoria per ogni riga del buffer
-        buffer[i] = (char*) safe_malloc((total_row_length + 1) * sizeof(char));
-        buffer[i][0] = '\0'; // Inizializza la stringa
+    cache->capacity = old_capacity == 0 ? RENDERED_CARDS_INITIAL_CAPACITY : old_capacity * 2;
+    cache->entries = (Rendered_card*) safe_calloc((size_t) cache->capacity, sizeof(Rendered_card));
+
+    // Le righe formattate non vengono copiate: si spostano solo le voci che le puntano
+    for (int i = 0; i < old_capacity; i++) {
+        if (old_entries[i].def != NULL) {
+            cache->entries[find_rendered_card_slot(cache, old_entries[i].def, old_entries[i].max_rows_description)] = old_entries[i];
+        }
     }
 
-    // Costruzione del buffer
-    int buffer_index = 0;
+    free(old_entries);
 
-    sprintf(buffer[buffer_index++], "%s%s%s%s%s", card_color, UNICODE_BORDER_UP_LEFT, card_border, UNICODE_BORDER_UP_RIGHT, RESET);
-    sprintf(buffer[buffer_index++], "%s%s%s %s%s%s %s%s%s", card_color, UNICODE_BORDER_VERTICAL, RESET, BOLD, card_name, RESET, card_color, UNICODE_BORDER_VERTICAL, RESET);
-    sprintf(buffer[buffer_index++], "%s%s %s %s%s", card_color, UNICODE_BORDER_VERTICAL, card_type, UNICODE_BORDER_VERTICAL, RESET);
-    sprintf(buffer[buffer_index++], "%s%s%s %s %s%s%s", card_color, UNICODE_BORDER_VERTICAL, RESET, card_line_separator, card_color, UNICODE_BORDER_VERTICAL, RESET);
+    return;
+}
+
+/**
+ * @brief Restituisce le righe formattate di una carta, formattandola solo la prima volta.
+ * 
+ * Le carte sono immutabili, quindi le righe dipendono solo dalla definizione e dalle righe riservate alla descrizione
+ * (uguali per tutte le carte di un mazzo). L'indice, che cambia da mazzo a mazzo, non fa parte delle righe salvate.
+ * 
+ * @param definition Puntatore alla definizione della carta.
+ * @param max_rows_description Numero di righe riservate alla descrizione (almeno quelle della descrizione della carta).
+ * @return const Rendered_card* Puntatore alla carta formattata (valido fino a free_card_definitions).
+ */
+static const Rendered_card* get_rendered_card(const Card_definition* definition, int max_rows_description) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    for (int i = 0; i < card_description_lines; i++) {
-        sprintf(buffer[buffer_index++], "%s%s%s %s%s%s %s%s%s", card_color, UNICODE_BORDER_VERTICAL, RESET, ITALIC, wrapped_description[i], RESET, card_color, UNICODE_BORDER_VERTICAL, RESET);
-        free(wrapped_description[i]);
+    // SE la cache è vuota => la inizializza
+    if (rendered_cards.capacity == 0) {
+        grow_rendered_cards(&rendered_cards);
     }
 
-    for (int i = card_description_lines; i < max_rows_description; i++) {
-        sprintf(buffer[buffer_index++], "%s%s%s %s %s%s%s", card_color, UNICODE_BORDER_VERTICAL, RESET, card_line_separator, card_color, UNICODE_BORDER_VERTICAL, RESET);
+    int slot = find_rendered_card_slot(&rendered_cards, definition, max_rows_description);
+
+    // SE la carta è già stata formattata con questo layout => restituisce le righe salvate
+    if (rendered_cards.entries[slot].def != NULL) {
+        return &rendered_cards.entries[slot];
     }
 
-    sprintf(buffer[buffer_index++], "%s%s%s %s %s%s%s", card_color, UNICODE_BORDER_VERTICAL, RESET, card_line_separator, card_color, UNICODE_BORDER_VERTICAL, RESET);
+    // SE la cache supera i 3/4 della capacità => la ingrandisce e ricalcola la posizione della nuova voce
+    if ((rendered_cards.size + 1) * 4 > rendered_cards.capacity * 3) {
+        grow_rendered_cards(&rendered_cards);
+        slot = find_rendered_card_slot(&rendered_cards, definition, max_rows_description);
+    }
 
-    if (need_index) {
-        char* parsed_index = (char*) safe_malloc((MAX_CARD_INDEX_LENGTH + 1) * sizeof(char));
-        sprintf(parsed_index, "%d/%d", card_index, total_cards);
-        char* padded_card_index = padding_string(parsed_index, REAL_CARD_WIDTH);
+    // Formattazione della carta, una riga dopo l'altra
+    Rendered_card* entry = &rendered_cards.entries[slot];
+    entry->def = definition;
+    entry->max_rows_description = max_rows_description;
+    entry->num_rows = CARD_BASE_HEIGHT + max_rows_description - 1;
+    entry->row_offsets = (size_t*) safe_malloc((size_t) (entry->num_rows + 1) * sizeof(size_t));
 
-        sprintf(buffer[buffer_index++], "%s%s%s %s %s%s%s", card_color, UNICODE_BORDER_VERTICAL, RESET, padded_card_index, card_color, UNICODE_BORDER_VERTICAL, RESET);
+    Frame frame;
+    init_frame(&frame, (size_t) entry->num_rows * (MAX_CARD_WIDTH * strlen(UNICODE_BORDER_HORIZONTAL) + FRAME_ESCAPE_BYTES));
 
-        free(parsed_index);
-        free(padded_card_index);
+    for (int i = 0; i < entry->num_rows; i++) {
+        entry->row_offsets[i] = frame.length;
+        render_card_row(&frame, definition, max_rows_description, i);
     }
+    entry->row_offsets[entry->num_rows] = frame.length;
+    entry->rows = frame.data; // Il buffer del frame passa alla voce della cache
 
-    sprintf(buffer[buffer_index++], "%s%s%s%s%s", card_color, UNICODE_BORDER_DOWN_LEFT, card_border, UNICODE_BORDER_DOWN_RIGHT, RESET);
+    rendered_cards.size++;
 
-    // Liberazione della memoria allocata dinamicamente
-    free(card_border);
-    free(card_line_separator);
-    free(card_name);
-    free(parsed_type);
-    free(card_type);
-    free(wrapped_description);
-
-    return buffer;
+    return entry;
 }
 
 /**
- * @brief Formatta graficamente una carta nascosta in un buffer di righe.
+ * @brief Accoda al frame una riga di una carta già formattata.
  * 
- * @param buffer_rows Puntatore per restituire il numero di righe del buffer.
- * @param card_index Indice della carta.
- * @param total_cards Numero totale di carte.
- * @return char** Buffer di righe contenente la carta nascosta formattata.
+ * @param frame Puntatore al frame in cui scrivere.
+ * @param rendered Puntatore alla carta formattata.
+ * @param row Riga della carta (partendo da 0).
  */
-char** format_hidden_card(int* buffer_rows, int card_index, int total_cards) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static void append_rendered_card_row(Frame* frame, const Rendered_card* rendered, int row) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    // Costruzione dei separatori e calcolo del padding
-    char* card_border = repeat_string(UNICODE_BORDER_HORIZONTAL, CARD_WIDTH);
-    char* card_line_separator = repeat_char(' ', REAL_CARD_WIDTH);
+    size_t start = rendered->row_offsets[row];
+    frame_append_length(frame, rendered->rows + start, rendered->row_offsets[row + 1] - start);
 
-    char* card_name = padding_string("Unstable Students", REAL_CARD_WIDTH);
+    return;
+}
 
-    // Calcola il colore della carta in base al tipo e calcola la dimensione del colore in caratteri
-    char* card_color = WHT;
-    int card_color_size = strlen(card_color) + strlen(RESET);
+/**
+ * @brief Scrive nel frame una riga di una carta nascosta.
+ * 
+ * @param frame Puntatore al frame in cui scrivere.
+ * @param card_index Indice della carta (-1 per non mostrarlo).
+ * @param total_cards Numero totale di carte.
+ * @param row Riga della carta da scrivere (partendo da 0).
+ */
+static void render_hidden_card_row(Frame* frame, int card_index, int total_cards, int row) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     bool need_index = card_index != -1; // Flag per la necessità dell'indice
+    int last_row = CARD_BASE_HEIGHT + CARD_HIDDEN_HEIGHT - !need_index - 1;
 
-    // Calcola il numero totale di righe del buffer
-    int total_rows = CARD_BASE_HEIGHT + CARD_HIDDEN_HEIGHT - !need_index;
-    *buffer_rows = total_rows;
-
-    // Calcola la lunghezza totale di ogni riga del buffer
-    int total_row_length = strlen(UNICODE_BORDER_UP_LEFT) + strlen(card_border) + strlen(UNICODE_BORDER_UP_RIGHT) + card_color_size;
-
-    // Alloca la memoria per il buffer
-    char** buffer = (char**) safe_malloc(total_rows * sizeof(char*));
-
-    for (int i = 0; i < total_rows; i++) {
-        // Alloca la memoria per ogni riga del buffer
-        buffer[i] = (char*) safe_malloc((total_row_length + 1) * sizeof(char));
-        buffer[i][0] = '\0'; // Inizializza la stringa
+    // SE è il bordo superiore o inferiore della carta
+    if (row == 0 || row == last_row) {
+        frame_append(frame, row == 0 ? UNICODE_BORDER_UP_LEFT : UNICODE_BORDER_DOWN_LEFT);
+        frame_append_repeat(frame, UNICODE_BORDER_HORIZONTAL, CARD_WIDTH);
+        frame_append(frame, row == 0 ? UNICODE_BORDER_UP_RIGHT : UNICODE_BORDER_DOWN_RIGHT);
+        return;
     }
 
-    // Costruzione del buffer
-    int buffer_index = 0;
-
-    sprintf(buffer[buffer_index++], "%s%s%s", UNICODE_BORDER_UP_LEFT, card_border, UNICODE_BORDER_UP_RIGHT);
-    sprintf(buffer[buffer_index++], "%s %s%s%s %s", UNICODE_BORDER_VERTICAL, BOLD, card_name, RESET, UNICODE_BORDER_VERTICAL);
-    sprintf(buffer[buffer_index++], "%s %s %s", UNICODE_BORDER_VERTICAL, card_line_separator, UNICODE_BORDER_VERTICAL);
-
-    sprintf(buffer[buffer_index++], "%s   %s   %s", UNICODE_BORDER_VERTICAL, HIDDEN_CARD_FIRST_PATTERN, UNICODE_BORDER_VERTICAL);
-    sprintf(buffer[buffer_index++], "%s   %s   %s", UNICODE_BORDER_VERTICAL, HIDDEN_CARD_SECOND_PATTERN, UNICODE_BORDER_VERTICAL);
-    sprintf(buffer[buffer_index++], "%s   %s   %s", UNICODE_BORDER_VERTICAL, HIDDEN_CARD_FIRST_PATTERN, UNICODE_BORDER_VERTICAL);
-    sprintf(buffer[buffer_index++], "%s   %s   %s", UNICODE_BORDER_VERTICAL, HIDDEN_CARD_SECOND_PATTERN, UNICODE_BORDER_VERTICAL);
-
-    sprintf(buffer[buffer_index++], "%s %s %s", UNICODE_BORDER_VERTICAL, card_line_separator, UNICODE_BORDER_VERTICAL);
-
-    if (need_index) {
-        char* parsed_index = (char*) safe_malloc((MAX_CARD_INDEX_LENGTH + 1) * sizeof(char));
-        sprintf(parsed_index, "%d/%d", card_index, total_cards);
-        char* card_index = padding_string(parsed_index, REAL_CARD_WIDTH);
-
-        sprintf(buffer[buffer_index++], "%s %s %s", UNICODE_BORDER_VERTICAL, card_index, UNICODE_BORDER_VERTICAL);
-
-        free(parsed_index);
-        free(card_index);
+    // SE è una riga del retro della carta (i pattern si alternano)
+    if (row >= 3 && row < 3 + CARD_HIDDEN_HEIGHT + 1) {
+        frame_append(frame, UNICODE_BORDER_VERTICAL "   ");
+        frame_append(frame, row % 2 == 1 ? HIDDEN_CARD_FIRST_PATTERN : HIDDEN_CARD_SECOND_PATTERN);
+        frame_append(frame, "   " UNICODE_BORDER_VERTICAL);
+        return;
     }
 
-    sprintf(buffer[buffer_index++], "%s%s%s", UNICODE_BORDER_DOWN_LEFT, card_border, UNICODE_BORDER_DOWN_RIGHT);
+    frame_append(frame, UNICODE_BORDER_VERTICAL " ");
+
+    if (row == 1) {
+        // Nome del gioco
+        frame_append(frame, BOLD);
+        frame_append_centered(frame, "Unstable Students", REAL_CARD_WIDTH);
+        frame_append(frame, RESET);
+    } else if (need_index && row == last_row - 1) {
+        // Indice della carta
+        char parsed_index[MAX_CARD_INDEX_LENGTH + 1];
+        snprintf(parsed_index, sizeof(parsed_index), "%d/%d", card_index, total_cards);
+        frame_append_centered(frame, parsed_index, REAL_CARD_WIDTH);
+    } else {
+        // Riga vuota
+        frame_append_repeat(frame, " ", REAL_CARD_WIDTH);
+    }
 
-    // Liberazione della memoria allocata dinamicamente
-    free(card_border);
-    free(card_line_separator);
-    free(card_name);
+    frame_append(frame, " " UNICODE_BORDER_VERTICAL);
 
-    return buffer;
+    return;
 }
 
 /**
@@ -557,255 +973,206 @@ char** format_hidden_card(int* buffer_rows, int card_index, int total_cards) {
  * @param card Puntatore alla carta da stampare.
  */
 void print_card(const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la modalità silenziosa è attiva => non formatta la carta
+    if (is_silent_output()) {
+        return;
+    }
 
-    // Formatta la carta in un buffer di righe
-    int buffer_rows = 0;
-    char** buffer = format_card(&buffer_rows, card, 0, -1, -1);
+    const Rendered_card* rendered = get_rendered_card(card->def, card->def->description_rows);
 
-    // Stampa la carta
-    for (int i = 0; i < buffer_rows; i++) {
-        printf("%s\n", buffer[i]);
-        free(buffer[i]); // Liberazione della memoria allocata dinamicamente per la riga
-        buffer[i] = NULL; // Imposta il puntatore a NULL per evitare problemi dopo la deallocazione
+    // Le righe della carta vengono copiate dalla cache nel frame del thread e stampate con un'unica scrittura
+    reset_frame(&print_buffer);
+    for (int i = 0; i < rendered->num_rows; i++) {
+        append_rendered_card_row(&print_buffer, rendered, i);
+        frame_append(&print_buffer, "\n");
     }
 
-    free(buffer); // Liberazione della memoria allocata dinamicamente per il buffer
+    print_frame(&print_buffer);
+
     return;
 }
 
 /**
- * @brief Formatta graficamente un mazzo di carte in un buffer di righe.
+ * @brief Calcola il layout grafico di un mazzo di carte (numero di righe e larghezza), prima di scriverlo.
+ * 
+ * Il numero di righe della descrizione di ogni carta è calcolato alla registrazione della definizione.
  * 
- * @param buffer_rows Puntatore per restituire il numero di righe del buffer.
- * @param deck Puntatore al mazzo di carte da formattare.
+ * @param layout Puntatore al layout da calcolare.
+ * @param deck Puntatore al mazzo di carte.
  * @param deck_name Nome del mazzo di carte.
  * @param offset_card_index Indice di offset per la numerazione delle carte.
  * @param hidden Flag per nascondere le informazioni delle carte.
- * @param color Colore del mazzo di carte.
- * @return char** Buffer di righe contenente il mazzo di carte formattato.
+ * @param color Colore del mazzo di carte (NULL per il colore bianco).
  */
-char** format_deck(int* buffer_rows, const Card* deck, const char* deck_name, int offset_card_index, bool hidden, char* color) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    // SE non è stato specificato un colore, utilizza il colore bianco
-    if (color == NULL) {
-        color = WHT;
-    }
-
-    char** buffer = NULL; // Inizializzazione del buffer
-    int extra_space_for_color = (strlen(color) + strlen(RESET)) * (DECK_PADDING + COLOR_PADDING); // Calcolo dello spazio extra per il colore
-
-    // SE il deck è vuoto, formatta un deck vuoto
-    if (deck == NULL) {
-        // Alloca la memoria per il buffer
-        buffer = (char**) safe_malloc(EMPTY_DECK_HEIGHT * sizeof(char*));
-        *buffer_rows = EMPTY_DECK_HEIGHT; // Imposta il numero di righe del buffer
-
-        // Alloca la memoria per ogni riga del buffer
-        for (int i = 0; i < EMPTY_DECK_HEIGHT; i++) {
-            buffer[i] = (char*) safe_malloc(((strlen(UNICODE_BORDER_HORIZONTAL) * EMPTY_DECK_WIDTH) + extra_space_for_color + 1) * sizeof(char));
-            buffer[i][0] = '\0'; // Inizializza la stringa
+void init_deck_layout(Deck_layout* layout, const Deck* deck, const char* deck_name, int offset_card_index, bool hidden, const char* color) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    layout->deck = deck;
+    layout->name = deck_name;
+    layout->color = color == NULL ? WHT : color; // SE non è stato specificato un colore, utilizza il colore bianco
+    layout->hidden = hidden;
+    layout->offset_card_index = offset_card_index;
+    layout->num_cards = count_cards(deck);
+    layout->max_rows_description = CARD_HIDDEN_HEIGHT;
+
+    // SE le carte sono visibili => calcola il numero massimo di righe delle descrizioni
+    if (!hidden && layout->num_cards > 0) {
+        layout->max_rows_description = 0;
+
+        for (int i = 0; i < layout->num_cards; i++) {
+            layout->max_rows_description = max(layout->max_rows_description, get_card(deck, i)->def->description_rows);
         }
+    }
 
-        // Costruzione dei separatori e calcolo del padding
-        char* empty_deck_border = repeat_string(UNICODE_BORDER_HORIZONTAL, EMPTY_DECK_WIDTH-DECK_PADDING);
-        char* empy_line = repeat_char(' ', EMPTY_DECK_WIDTH-DECK_PADDING);
-
-        char* parsed_deck_name = padding_string(deck_name, DECK_NAME_WIDTH);
+    layout->card_rows = CARD_BASE_HEIGHT + layout->max_rows_description; // Righe di ogni carta (indice compreso)
 
-        int available_space = (EMPTY_DECK_WIDTH-DECK_PADDING-DECK_PADDING);
-        int deck_name_padding = calculate_padding(available_space, DECK_NAME_WIDTH);
+    int cards_per_row = min(MAX_CARD_PER_ROW, layout->num_cards); // Carte nella riga più larga del mazzo
+    int card_lines = (layout->num_cards / MAX_CARD_PER_ROW) + (layout->num_cards % MAX_CARD_PER_ROW != 0); // Righe di carte
 
-        char* deck_name_left_border = repeat_string(UNICODE_BORDER_HORIZONTAL, deck_name_padding);
-        char* deck_name_right_border = repeat_string(UNICODE_BORDER_HORIZONTAL, available_space-DECK_NAME_WIDTH-deck_name_padding);
+    // SE il mazzo è vuoto => ha un'altezza fissa, altrimenti dipende dal numero di righe di carte
+    layout->rows = layout->num_cards == 0 ? EMPTY_DECK_HEIGHT : DECK_BASE_HEIGHT + (layout->card_rows * card_lines);
+    layout->width = max(DECK_PADDING + cards_per_row * MAX_CARD_WIDTH + DECK_PADDING, EMPTY_DECK_WIDTH);
 
-        char* empy_text = padding_string("///", EMPTY_DECK_WIDTH-DECK_PADDING);
+    // Stima per eccesso dei byte di una riga: ogni carattere visibile occupa al massimo quanto un bordo unicode
+    layout->max_row_bytes = (size_t) layout->width * strlen(UNICODE_BORDER_HORIZONTAL) + (size_t) (cards_per_row + 2) * FRAME_ESCAPE_BYTES;
 
-        // Costruzione del buffer
-        int buffer_index = 0;
+    return;
+}
 
-        sprintf(buffer[buffer_index++], "%s%s%s[%s%s%s%s]%s%s%s", color, UNICODE_BORDER_UP_LEFT, deck_name_left_border, BOLD, parsed_deck_name, RESET, color, deck_name_right_border, UNICODE_BORDER_UP_RIGHT, RESET);
-        sprintf(buffer[buffer_index++], "%s%s%s%s%s%s%s", color, UNICODE_BORDER_VERTICAL, RESET, empy_line, color, UNICODE_BORDER_VERTICAL, RESET);
-        sprintf(buffer[buffer_index++], "%s%s%s%s%s%s%s%s%s", color, UNICODE_BORDER_VERTICAL, RESET, BOLD, empy_text, RESET, color, UNICODE_BORDER_VERTICAL, RESET);
-        sprintf(buffer[buffer_index++], "%s%s%s%s%s%s%s", color, UNICODE_BORDER_VERTICAL, RESET, empy_line, color, UNICODE_BORDER_VERTICAL, RESET);
-        sprintf(buffer[buffer_index++], "%s%s%s%s%s", color, UNICODE_BORDER_DOWN_LEFT, empty_deck_border, UNICODE_BORDER_DOWN_RIGHT, RESET);
+/**
+ * @brief Scrive nel frame una riga di un mazzo di carte (senza andare a capo).
+ * 
+ * @param frame Puntatore al frame in cui scrivere.
+ * @param layout Puntatore al layout del mazzo.
+ * @param row Riga del mazzo da scrivere (partendo da 0).
+ */
+void render_deck_row(Frame* frame, const Deck_layout* layout, int row) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-        // Liberazione della memoria allocata dinamicamente
-        free(empty_deck_border);
-        free(empy_line);
-        free(parsed_deck_name);
-        free(deck_name_left_border);
-        free(deck_name_right_border);
-        free(empy_text);
-    } else {
-        // SE il deck non è vuoto, formatta il deck con le carte al suo interno
-        int num_cards = count_cards(deck); // Calcola il numero di carte nel mazzo
-        // Calcola il numero massimo di righe da utilizzare per la descrizione di ogni carta
-        int max_rows_description = hidden == true ? CARD_HIDDEN_HEIGHT : calculate_max_row_length_for_description(deck);
-        int card_rows = CARD_BASE_HEIGHT + max_rows_description; // Calcola il numero di righe totali per ogni carta
-        int line_cards = (num_cards / MAX_CARD_PER_ROW) + (num_cards % MAX_CARD_PER_ROW != 0); // Calcola il numero di righe di carte
-        int deck_rows = DECK_BASE_HEIGHT + (card_rows * line_cards); // Calcola il numero di righe complessive da utilizzare per la formattazione del mazzo
-
-        // Alloca la memoria per il buffer
-        buffer = (char**) safe_calloc(deck_rows, sizeof(char*));
-        *buffer_rows = deck_rows; // Imposta il numero di righe del buffer
-
-        Card* current_card = deck; // Inizializza la carta corrente al primo elemento del mazzo
-        int card_index = 1; // Inizializza l'indice delle carte da 1
-
-        // Scorre tutte le carte del mazzo
-        while (current_card != NULL) {
-            // Per ogni carta, formatta la carta in un buffer di righe
-            char** card_buffer = NULL;
-            int card_buffer_rows = 0;
-
-            if (hidden == true) {
-                // SE la carta è nascosta, formatta la carta nascosta con il template apposito
-                card_buffer = format_hidden_card(&card_buffer_rows, offset_card_index+card_index, offset_card_index+num_cards);
-            } else {
-                // Altrimenti, formatta la carta con il suoi dati effettivi
-                card_buffer = format_card(&card_buffer_rows, current_card, max_rows_description, offset_card_index+card_index, offset_card_index+num_cards);
-            }
+    const char* color = layout->color;
 
-            // Calcola l'offset per la posizione della carta nel buffer (in base alla riga)
-            int offset = (card_index-1) / MAX_CARD_PER_ROW;
-            offset *= card_rows;
+    // SE è il bordo superiore => contiene il nome del mazzo, centrato rispetto all'area delle carte
+    if (row == 0) {
+        int card_area_width = layout->width - DECK_PADDING - DECK_PADDING;
+        int deck_name_padding = calculate_padding(card_area_width, DECK_NAME_WIDTH);
 
-            // Aggiunge la carta formattata al buffer del mazzo
-            for (int i = 0, j = offset+i+1; i < card_buffer_rows; i++, j++) {
-                // Inizializa la riga del buffer se non è stata inizializzata
-                if (buffer[j] == NULL) {
-                    buffer[j] = (char*) safe_malloc(sizeof(char));
-                    buffer[j][0] = '\0';
-                }
+        frame_append(frame, color);
+        frame_append(frame, UNICODE_BORDER_UP_LEFT);
+        frame_append_repeat(frame, UNICODE_BORDER_HORIZONTAL, deck_name_padding);
+        frame_append(frame, "[" BOLD);
+        frame_append_centered(frame, layout->name, DECK_NAME_WIDTH);
+        frame_append(frame, RESET);
+        frame_append(frame, color);
+        frame_append(frame, "]");
+        frame_append_repeat(frame, UNICODE_BORDER_HORIZONTAL, card_area_width - DECK_NAME_WIDTH - deck_name_padding);
+        frame_append(frame, UNICODE_BORDER_UP_RIGHT RESET);
+        return;
+    }
 
-                // Rialloca la memoria per farci stare la riga del buffer della carta formattata
-                buffer[j] = (char*) safe_realloc(buffer[j], (strlen(buffer[j]) + strlen(card_buffer[i]) + 1) * sizeof(char));
+    // SE è il bordo inferiore
+    if (row == layout->rows - 1) {
+        frame_append(frame, color);
+        frame_append(frame, UNICODE_BORDER_DOWN_LEFT);
+        frame_append_repeat(frame, UNICODE_BORDER_HORIZONTAL, layout->width - 2);
+        frame_append(frame, UNICODE_BORDER_DOWN_RIGHT RESET);
+        return;
+    }
 
-                strcat(buffer[j], card_buffer[i]); // Concatena la riga del buffer della carta formattata al buffer del mazzo
-                free(card_buffer[i]); // Libera la memoria allocata per la riga del buffer della carta formattata
-                card_buffer[i] = NULL; // Imposta il puntatore a NULL per evitare problemi dopo la deallocazione
-            }
+    frame_append(frame, color);
+    frame_append(frame, UNICODE_BORDER_VERTICAL RESET);
 
-            free(card_buffer); // Libera la memoria allocata per il buffer di righe della carta
-            current_card = current_card->next_card; // Passa alla carta successiva
-            card_index++; // Incrementa l'indice delle carte
+    if (layout->num_cards == 0) {
+        // SE il mazzo è vuoto => la riga centrale contiene il simbolo del mazzo vuoto
+        if (row == EMPTY_DECK_HEIGHT / 2) {
+            frame_append(frame, BOLD);
+            frame_append_centered(frame, "///", layout->width - 2);
+            frame_append(frame, RESET);
+        } else {
+            frame_append_repeat(frame, " ", layout->width - 2);
         }
+    } else {
+        // Riga di carte a cui appartiene la riga del mazzo e riga all'interno delle carte
+        int card_line = (row - 1) / layout->card_rows;
+        int card_row = (row - 1) % layout->card_rows;
 
-        // Costruzione dei separatori e calcolo del padding
-        int real_cards_width = min(MAX_CARD_PER_ROW, num_cards) * MAX_CARD_WIDTH;
-        int edges_width = strlen(UNICODE_BORDER_UP_LEFT) + strlen(UNICODE_BORDER_UP_RIGHT);
-        int deck_width = (real_cards_width * strlen(UNICODE_BORDER_HORIZONTAL)) + (edges_width * DECK_PADDING);
-        int colored_deck_width = strlen(buffer[1]) + (edges_width * DECK_PADDING);
-
-        int last_row_cards = num_cards % MAX_CARD_PER_ROW;
-        last_row_cards = last_row_cards == 0 ? MAX_CARD_PER_ROW : last_row_cards; // Se l'ultima riga è piena (resto == 0), allora last_row_cards = MAX_CARD_PER_ROW
-        int real_last_row_cards_width = last_row_cards * MAX_CARD_WIDTH;
-
-        int max_space_available = max(DECK_PADDING+real_cards_width+DECK_PADDING, EMPTY_DECK_WIDTH);
-        // SE l'ultima riga è più corta della larghezza massima disponibile, allora allinea le carte al centro
-        if (real_last_row_cards_width < max_space_available) {
-            deck_width = max_space_available * strlen(UNICODE_BORDER_HORIZONTAL);
-
-            int offset = (line_cards-1) * card_rows + 1; // Calcola l'offset per la posizione delle carte nell'ultima riga
-
-            // Per ogni carta dell'ultima riga
-            for (int i = offset; i < offset+card_rows; i++) {
-                // Calcola lo spazio disponibile per allineare le carte al centro
-                int space_available = max_space_available-DECK_PADDING-DECK_PADDING;
-                int line_padding = calculate_padding(space_available, real_last_row_cards_width);
-
-                char* left_padding = repeat_char(' ', line_padding);
-                char* right_padding = repeat_char(' ', space_available-real_last_row_cards_width-line_padding);
+        int first_card = card_line * MAX_CARD_PER_ROW;
+        int last_card = min(layout->num_cards, first_card + MAX_CARD_PER_ROW);
 
-                // Allocare la memoria per il buffer temporaneo
-                char* tmp = (char*) safe_malloc((strlen(buffer[i]) + strlen(left_padding) + strlen(right_padding) + 1) * sizeof(char));
-                tmp[0] = '\0';
-                sprintf(tmp, "%s%s%s", left_padding, buffer[i], right_padding); // Formatta il buffer temporaneo con il padding per allineare le carte al centro
+        // Le carte della riga vengono centrate nello spazio disponibile (solo l'ultima riga può non essere piena)
+        int space_available = layout->width - DECK_PADDING - DECK_PADDING;
+        int cards_width = (last_card - first_card) * MAX_CARD_WIDTH;
+        int line_padding = calculate_padding(space_available, cards_width);
 
-                free(buffer[i]); // Libera la memoria allocata per la riga del buffer
-                buffer[i] = tmp;
+        frame_append(frame, " ");
+        frame_append_repeat(frame, " ", line_padding);
 
-                free(left_padding); // Libera la memoria allocata per il padding sinistro
-                free(right_padding); // Libera la memoria allocata per il padding destro
-            }
-        }
+        for (int i = first_card; i < last_card; i++) {
+            int card_index = layout->offset_card_index + i + 1; // L'indice delle carte parte da 1
+            int total_cards = layout->offset_card_index + layout->num_cards;
 
-        // Per ogni riga del buffer del mazzo
-        for (int i = 0; i < deck_rows; i++) {
-            // SE la riga del buffer non è stata inizializzata
-            if (buffer[i] == NULL) {
-                // Alloca la memoria per la riga del buffer
-                buffer[i] = (char*) safe_calloc(colored_deck_width + extra_space_for_color + 1, sizeof(char));
-                buffer[i][0] = '\0'; // Inizializza la stringa
+            if (layout->hidden) {
+                render_hidden_card_row(frame, card_index, total_cards, card_row);
             } else {
-                // Rialloca la memoria per la riga del buffer
-                buffer[i] = (char*) safe_realloc(buffer[i], (colored_deck_width + extra_space_for_color + 1) * sizeof(char));
+                // Le righe della carta vengono dalla cache, tranne quella dell'indice (penultima riga) che cambia da mazzo a mazzo
+                const Card_definition* definition = get_card(layout->deck, i)->def;
+                const Rendered_card* rendered = get_rendered_card(definition, layout->max_rows_description);
+
+                if (card_row < rendered->num_rows - 1) {
+                    append_rendered_card_row(frame, rendered, card_row);
+                } else if (card_row == rendered->num_rows - 1) {
+                    render_card_index_row(frame, definition, card_index, total_cards);
+                } else {
+                    append_rendered_card_row(frame, rendered, rendered->num_rows - 1);
+                }
             }
         }
 
-        // Costruzione dei separatori e calcolo del padding
-        int card_area_width = max(real_cards_width, EMPTY_DECK_WIDTH-DECK_PADDING-DECK_PADDING);
-        int deck_name_padding = calculate_padding(card_area_width, DECK_NAME_WIDTH);
-
-        char* deck_border = repeat_string(UNICODE_BORDER_HORIZONTAL, (deck_width-edges_width)/strlen(UNICODE_BORDER_HORIZONTAL));
-        char* parsed_deck_name = padding_string(deck_name, DECK_NAME_WIDTH);
-
-        char* deck_name_left_border = repeat_string(UNICODE_BORDER_HORIZONTAL, deck_name_padding);
-        char* deck_name_right_border = repeat_string(UNICODE_BORDER_HORIZONTAL, card_area_width-DECK_NAME_WIDTH-deck_name_padding);
-
-        // Costruzione del buffer
-        int buffer_index = 0;
-
-        sprintf(buffer[buffer_index++], "%s%s%s[%s%s%s%s]%s%s%s", color, UNICODE_BORDER_UP_LEFT, deck_name_left_border, BOLD, parsed_deck_name, RESET, color, deck_name_right_border, UNICODE_BORDER_UP_RIGHT, RESET);
-
-        for (int i = 1; i < deck_rows-1; i++) {
-            // Alloco un buffer temporaneo
-            char* tmp = (char*) safe_calloc((colored_deck_width + extra_space_for_color + 1), sizeof(char));
-            tmp[0] = '\0'; // Inizializzo il buffer temporaneo con un terminatore di stringa
-
-            sprintf(tmp, "%s%s%s %s %s%s%s", color, UNICODE_BORDER_VERTICAL, RESET, buffer[buffer_index], color, UNICODE_BORDER_VERTICAL, RESET);
-
-            free(buffer[buffer_index]); // Libero la memoria precedentemente allocata
-            buffer[buffer_index++] = tmp; // Assegno il nuovo buffer temporaneo al buffer principale e incremento l'indice del buffer principale
-        }
-
-        sprintf(buffer[buffer_index++], "%s%s%s%s%s", color, UNICODE_BORDER_DOWN_LEFT, deck_border, UNICODE_BORDER_DOWN_RIGHT, RESET);
-
-        // Liberazione della memoria allocata dinamicamente
-        free(deck_border);
-        free(parsed_deck_name);
-        free(deck_name_left_border);
-        free(deck_name_right_border);
+        frame_append_repeat(frame, " ", space_available - cards_width - line_padding);
+        frame_append(frame, " ");
     }
 
-    return buffer;
+    frame_append(frame, color);
+    frame_append(frame, UNICODE_BORDER_VERTICAL RESET);
+
+    return;
 }
 
 /**
  * @brief Stampa un mazzo di carte.
  * 
+ * Il layout viene calcolato in anticipo, ogni riga viene scritta una sola volta nel frame del thread (riutilizzato
+ * da una stampa all'altra) e il mazzo viene stampato con un'unica scrittura. Con la cache delle carte formattate
+ * già popolata la stampa non esegue allocazioni.
+ * 
  * @param deck Puntatore al mazzo di carte da stampare.
  * @param deck_name Nome del mazzo di carte.
  * @param offset_card_index Indice di offset per la numerazione delle carte.
  * @param hidden Flag per nascondere le informazioni delle carte.
  * @param color Colore del mazzo di carte.
  */
-void print_deck(const Card* deck, const char* deck_name, int offset_card_index, bool hidden, char* color) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void print_deck(const Deck* deck, const char* deck_name, int offset_card_index, bool hidden, char* color) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    // Formatta il mazzo di carte in un buffer di righe
-    int buffer_rows = 0;
-    char** buffer = format_deck(&buffer_rows, deck, deck_name, offset_card_index, hidden, color);
+    // SE la modalità silenziosa è attiva => non formatta il mazzo
+    if (is_silent_output()) {
+        return;
+    }
 
-    for (int i = 0; i < buffer_rows; i++) {
-        printf("%s\n", buffer[i]); // Stampa ogni riga del buffer
-        free(buffer[i]); // Libera la memoria allocata per la riga del buffer
-        buffer[i] = NULL; // Imposta il puntatore a NULL per evitare problemi dopo la deallocazione
+    Deck_layout layout;
+    init_deck_layout(&layout, deck, deck_name, offset_card_index, hidden, color);
+
+    reset_frame(&print_buffer);
+    reserve_frame(&print_buffer, (size_t) layout.rows * (layout.max_row_bytes + 1));
+
+    for (int i = 0; i < layout.rows; i++) {
+        render_deck_row(&print_buffer, &layout, i);
+        frame_append(&print_buffer, "\n");
     }
 
-    free(buffer); // Libera la memoria allocata per il buffer
+    print_frame(&print_buffer);
+
     return;
 }
 
@@ -815,75 +1182,63 @@ void print_deck(const Card* deck, const char* deck_name, int offset_card_index,
  * @param deck Puntatore al mazzo di carte.
  * @return int Numero di carte presenti nel mazzo.
  */
-int count_cards(Card* deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    int count = 0; // Inizializza il conteggio delle carte a 0
-    Card* current_card = deck; // Inizializza la carta corrente al primo elemento del maazzo
-
-    // Scorre tutte le carte del mazzo
-    while (current_card != NULL) {
-        count++; // Incrementa il conteggio delle carte
-        current_card = current_card->next_card; // Passa alla carta successiva
-    }
-
-    return count;
+int count_cards(const Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return deck->size;
 }
 
 /**
- * @brief Mescola un mazzo di carte.
+ * @brief Mescola un mazzo di carte (algoritmo di Fisher-Yates).
  * 
  * @param deck Puntatore al mazzo di carte da mescolare.
- * @param num_cards Numero di carte presenti nel mazzo.
- * @return Card* Puntatore alla testa del nuovo mazzo di carte mescolato.
+ * @param rng Puntatore al generatore di numeri casuali della partita.
  */
-Card* shuffle_deck(Card* deck, int num_cards) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void shuffle_deck(Deck* deck, Rng* rng) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    assert (deck != NULL && "Deck is NULL!");
-    assert (num_cards > 0 && "Number of cards is invalid!");
+    assert (deck->size > 0 && "Number of cards is invalid!");
 
-    // SE il mazzo contiene una sola carta, restituisce il mazzo invariato
-    if (num_cards == 1) {
-        return deck;
-    }
-
-    // Alloca la memoria per un array di puntatori alle carte
-    Card** arr_card = (Card**) safe_malloc(num_cards * sizeof(Card*));
+    // Scorre il mazzo dall'ultima carta alla seconda, scambiando ogni carta con una carta casuale tra quelle che la precedono (lei compresa)
+    for (int i = deck->size - 1; i > 0; i--) {
+        int j = random_int(rng, 0, i); // Genera un indice casuale per la carta con cui scambiare
 
-    // Riempie l'array di puntatori alle carte con le carte del mazzo
-    int i = 0; // Inizializza l'indice dell'array di puntatori
-    Card* current_card = deck; // Inizializza la carta corrente al primo elemento del mazzo
-    while (current_card != NULL) {
-        arr_card[i++] = current_card; // Aggiunge la carta corrente all'array di puntatori
-        current_card = current_card->next_card; // Passa alla carta successiva
+        // Scambia le carte
+        Card** card_i = &deck->cards[(deck->head + i) % deck->capacity];
+        Card** card_j = &deck->cards[(deck->head + j) % deck->capacity];
+        Card* temp = *card_i;
+        *card_i = *card_j;
+        *card_j = temp;
     }
 
-    // Mescola l'array di puntatori alle carte
-    int idx, idj; // Inizializza gli indici per lo scambio delle carte
-    for (int i = 0; i < SHUFFLE_ROUNDS; i++) {
-        idx = rand() % num_cards; // Genera un indice casuale per la carta da scambiare
-        idj = rand() % num_cards; // Genera un indice casuale per la carta con cui scambiare
+    deck->hash = compute_deck_hash(deck); // Il nuovo ordine del mazzo richiede di ricalcolare l'hash
+    journal_reset_deck(deck); // Il nuovo ordine del mazzo viene registrato per intero nel journal
 
-        // Scambia le carte
-        Card* temp = arr_card[idx];
-        arr_card[idx] = arr_card[idj];
-        arr_card[idj] = temp;
-    }
+    return;
+}
 
-    // Collega le carte dell'array di puntatori
-    for (int i = 0; i < num_cards - 1; i++) {
-        arr_card[i]->next_card = arr_card[i + 1];
-    }
-    arr_card[num_cards - 1]->next_card = NULL; // Imposta il puntatore alla prossima carta dell'ultima carta a NULL
+/**
+ * @brief Scambia il contenuto di due mazzi di carte (scambio dei buffer in tempo costante).
+ * Ogni mazzo mantiene la propria zona del journal, così che lo scambio venga registrato come tale.
+ * 
+ * @param deck_a Puntatore al primo mazzo.
+ * @param deck_b Puntatore al secondo mazzo.
+ */
+void swap_decks(Deck* deck_a, Deck* deck_b) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    journal_swap_decks(deck_a, deck_b);
 
-    // La nuova testa del mazzo è la prima carta dell'array di puntatori
-    Card* new_deck = arr_card[0];
+    Deck temp = *deck_a;
+    *deck_a = *deck_b;
+    *deck_b = temp;
 
-    // Libera la memoria allocata per l'array di puntatori
-    free(arr_card);
+    // Ripristina la zona del journal di ogni mazzo
+    deck_b->journal = deck_a->journal;
+    deck_b->zone = deck_a->zone;
+    deck_a->journal = temp.journal;
+    deck_a->zone = temp.zone;
 
-    return new_deck;
+    return;
 }
 
 /**
@@ -892,34 +1247,22 @@ Card* shuffle_deck(Card* deck, int num_cards) {
  * @param deck Puntatore al mazzo di carte da cui separare le carte MATRICOLA.
  * @param study_room Puntatore al mazzo di carte in cui aggiungere le carte MATRICOLA.
  */
-void separate_matricola_cards(Card** deck, Card** study_room) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void separate_matricola_cards(Deck* deck, Deck* study_room) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    Card* current_card = *deck; // Inizializza la carta corrente al primo elemento del mazzo
-    Card* prev_card = NULL; // Inizializza la carta precedente a NULL
-    Card* next_card = NULL; // Inizializza la prossima carta a NULL
+    int num_cards = deck->size; // Numero di carte presenti nel mazzo
 
-    // Scorre tutte le carte del mazzo
-    while (current_card != NULL) {
-        next_card = current_card->next_card; // Salva la prossima carta
+    // Scorre tutte le carte del mazzo una sola volta: le carte MATRICOLA vengono spostate nell'aula studio
+    // mentre le altre vengono rimesse in coda al mazzo, mantenendo il loro ordine
+    for (int i = 0; i < num_cards; i++) {
+        Card* current_card = pop_card_front(deck);
 
         // SE la carta corrente è una carta MATRICOLA
-        if (current_card->type == MATRICOLA) {
-            // SE la carta precedente è NULL, allora la carta corrente è la testa del mazzo
-            if (prev_card == NULL) {
-                *deck = next_card; // Imposta la testa del mazzo alla prossima carta
-            } else {
-                prev_card->next_card = next_card; // Collega la carta precedente alla prossima carta
-            }
-
-            current_card->next_card = NULL; // Imposta il puntatore alla prossima carta della carta corrente a NULL
-            *study_room = add_card(*study_room, current_card); // Aggiunge la carta Matricola al mazzo dell'aula studio
-
+        if (current_card->def->type == MATRICOLA) {
+            add_card(study_room, current_card); // Aggiunge la carta Matricola al mazzo dell'aula studio
         } else {
-            prev_card = current_card; // Imposta la carta precedente alla carta corrente
+            add_card(deck, current_card); // Rimette la carta in coda al mazzo
         }
-
-        current_card = next_card; // Passa alla prossima carta
     }
 
     return;
@@ -933,80 +1276,88 @@ void separate_matricola_cards(Card** deck, Card** study_room) {
  * @param discard_deck Puntatore al mazzo degli scarti.
  * @param show_card Flag per mostrare la carta pescata.
  */
-void draw_card(Player** player, Card** draw_deck, Card** discard_deck, bool show_card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    int num_cards = count_cards(*draw_deck); // Conteggio delle carte nel mazzo di pesca
+void draw_card(Player** player, Deck* draw_deck, Deck* discard_deck, bool show_card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // SE il mazzo di pesca è vuoto
-    if (num_cards == 0) {
-        assert (*discard_deck != NULL && "Il mazzo di pesca e il mazzo degli scarti sono vuoti!");
+    if (draw_deck->size == 0) {
+        assert (discard_deck->size > 0 && "Il mazzo di pesca e il mazzo degli scarti sono vuoti!");
 
-        num_cards = count_cards(*discard_deck); // Conteggio delle carte nel mazzo degli scarti
-        *draw_deck = shuffle_deck(*discard_deck, num_cards); // Mescola il mazzo degli scarti e lo trasforma nel mazzo di pesca
-        *discard_deck = NULL; // Imposta il mazzo degli scarti a NULL
+        // Il mazzo degli scarti diventa il mazzo di pesca (scambio dei buffer) e viene mescolato
+        swap_decks(draw_deck, discard_deck);
+        shuffle_deck(draw_deck, &(*player)->game->rng);
     }
 
-    Card* current_card = *draw_deck; // Inizializza la carta corrente al primo elemento del mazzo
-    *draw_deck = current_card->next_card; // Sposta la testa del mazzo alla prossima carta
-    current_card->next_card = NULL; // Scollega la carta corrente dal mazzo di pesca
-    (*player)->hand = add_card((*player)->hand, current_card); // Aggiunge la carta pescata alla mano del giocatore
+    Card* current_card = pop_card_front(draw_deck); // Pesca la prima carta del mazzo
+    add_card(&(*player)->hand, current_card); // Aggiunge la carta pescata alla mano del giocatore
 
     log_draw_card(*player, current_card); // Registra l'azione di pesca della carta nel file di log
 
     // SE è richiesto di mostrare la carta pescata
     if (show_card == true) {
-        printf("\n[" GRN "+" RESET "] Hai pescato una carta!\n");
+        print_msg("\n[" GRN "+" RESET "] Hai pescato una carta!\n");
+        set_output_recipient(*player); // La carta pescata è visibile solo al giocatore che l'ha pescata
         print_card(current_card); // Stampa la carta pescata
+        set_output_recipient(NULL);
     }
 
     return;
 }
 
 /**
- * @brief Pesca una carta MATRICOLA dal mazzo dell'aula studio e la aggiunge alla mano del giocatore.
+ * @brief Pesca una carta MATRICOLA dal mazzo dell'aula studio e la aggiunge all'aula del giocatore.
  * 
  * @param player_classroom Puntatore all'aula del giocatore.
  * @param study_room Puntatore al mazzo dell'aula studio.
- * @return Card* Puntatore all'aula del giocatore aggiornata.
  */
-Card* draw_matricola_card(Card* player_classroom, Card** study_room) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void draw_matricola_card(Deck* player_classroom, Deck* study_room) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int num_study_room = count_cards(*study_room); // Conteggio delle carte nell'aula studio
-    assert (num_study_room > 0 && "Carte Matricola terminate!");
+    assert (study_room->size > 0 && "Carte Matricola terminate!");
 
-    Card* current_card = *study_room; // Inizializza la carta corrente al primo elemento dell'aula studio
-    *study_room = current_card->next_card; // Sposta la testa dell'aula studio alla prossima carta
-    current_card->next_card = NULL; // Scollega la carta corrente dall'aula studio
-    player_classroom = add_card(player_classroom, current_card); // Aggiunge la carta MATRICOLA all'aula del giocatore
+    // Aggiunge la prima carta MATRICOLA dell'aula studio all'aula del giocatore
+    add_card(player_classroom, pop_card_front(study_room));
 
-    return player_classroom;
+    return;
 }
 
 /**
  * @brief Fa scegliere al giocatore una carta da un mazzo di carte.
  * 
+ * @param player Puntatore al giocatore che deve scegliere la carta.
  * @param deck Puntatore al mazzo di carte.
  * @param msg Messaggio per la scelta della carta.
  * @param error_msg Messaggio di errore per la scelta non valida della carta.
  * @return int Indice della carta selezionata.
  */
-int choice_card(Card* deck, char* msg, char* error_msg) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+int choice_card(Player* player, Deck* deck, char* msg, char* error_msg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return choice_filtered_card(player, deck, CARD_FILTER_ANY, ALL, NULL, msg, error_msg);
+}
 
-    int num_cards = count_cards(deck); // Conteggio delle carte nel mazzo
-    int card_index; // Inizializzazione dell'indice della carta selezionata
+/**
+ * @brief Fa scegliere al giocatore una carta da un mazzo di carte, indicando quali carte sono ammesse.
+ * 
+ * Il filtro non viene imposto al giocatore umano (la validità della carta scelta resta controllata dal chiamante),
+ * ma permette ai bot di scegliere direttamente tra le sole carte ammesse (vedi list_legal_choices).
+ * 
+ * @param player Puntatore al giocatore che deve scegliere la carta.
+ * @param deck Puntatore al mazzo di carte.
+ * @param filter Filtro delle carte ammesse.
+ * @param force_card_type Tipo di carta richiesto (CARD_FILTER_PLAYABLE e CARD_FILTER_TYPE).
+ * @param card Puntatore alla carta da bloccare (CARD_FILTER_BLOCKER).
+ * @param msg Messaggio per la scelta della carta.
+ * @param error_msg Messaggio di errore per la scelta non valida della carta.
+ * @return int Indice della carta selezionata.
+ */
+int choice_filtered_card(Player* player, Deck* deck, Card_filter filter, Type_card force_card_type, const Card* card, char* msg, char* error_msg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    do {
-        printf(msg); // Stampa il messaggio per la scelta della carta
-        read_int(&card_index); // Legge l'indice della carta selezionata
+    int num_cards = count_cards(deck); // Conteggio delle carte nel mazzo
 
-        // SE l'indice della carta selezionata non è valido
-        if (card_index < 1 || card_index > num_cards) {
-            printf(error_msg); // Stampa il messaggio di errore
-        }
-    } while (card_index < 1 || card_index > num_cards);
+    // Chiede la scelta al fornitore di decisioni del giocatore
+    Decision decision = {DECISION_CARD, player, 1, num_cards, msg, error_msg, deck, filter, force_card_type, card, false};
+    int card_index = decide(&decision);
 
     // Ritorna l'indice della carta selezionata (partendo da 0)
     return card_index-1;
@@ -1020,29 +1371,33 @@ int choice_card(Card* deck, char* msg, char* error_msg) {
  * @param unlink_card Flag per scollegare la carta dal mazzo.
  * @return Card* Puntatore alla carta selezionata.
  */
-Card* select_card(int card_index, Card** deck, bool unlink_card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+Card* select_card(int card_index, Deck* deck, bool unlink_card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    assert (*deck != NULL && "Mazzo vuoto!");
-    assert ((card_index >= 0 && card_index < count_cards(*deck)) && "Indice della carta non valido!");
+    assert (deck->size > 0 && "Mazzo vuoto!");
+    assert ((card_index >= 0 && card_index < deck->size) && "Indice della carta non valido!");
 
-    Card* current_card = *deck; // Inizializza la carta corrente al primo elemento del mazzo
-    Card* prev_card = NULL; // Inizializza la carta precedente a NULL
+    Card* current_card = get_card(deck, card_index); // Accesso diretto alla carta tramite indice
 
-    // Scorre la lista fino all'indice della carta da scartare
-    for (int i = 0; i < card_index; i++) {
-        prev_card = current_card; // Imposta la carta precedente alla carta corrente
-        current_card = current_card->next_card; // Passa alla prossima carta
-    }
-
-    // SE la carta deve essere scollata dal mazzo
+    // SE la carta deve essere scollegata dal mazzo
     if (unlink_card == true) {
-        // SE la carta precedente è NULL, allora la carta corrente è la testa del mazzo
-        if (prev_card == NULL) {
-            *deck = current_card->next_card; // Sposta la testa del mazzo alla prossima carta
+        journal_remove_card(deck, card_index);
+        remove_card_hash(deck, card_index, current_card);
+
+        // Sposta la parte più corta del mazzo per chiudere il buco lasciato dalla carta
+        if (card_index < deck->size / 2) {
+            for (int i = card_index; i > 0; i--) {
+                deck->cards[(deck->head + i) % deck->capacity] = deck->cards[(deck->head + i - 1) % deck->capacity];
+            }
+            deck->head = (deck->head + 1) % deck->capacity;
         } else {
-            prev_card->next_card = current_card->next_card; // Collega la carta precedente alla prossima carta
+            for (int i = card_index; i < deck->size - 1; i++) {
+                deck->cards[(deck->head + i) % deck->capacity] = deck->cards[(deck->head + i + 1) % deck->capacity];
+            }
         }
+
+        deck->size--;
+        update_effect_index(deck, current_card, -1); // Rimuove gli effetti della carta dall'indice del mazzo
     }
 
     return current_card;
@@ -1054,14 +1409,13 @@ Card* select_card(int card_index, Card** deck, bool unlink_card) {
  * @param card Puntatore alla carta da scartare.
  * @param discard_deck Puntatore al mazzo degli scarti.
  */
-void discard_card(Card* card, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void discard_card(Card* card, Deck* discard_deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     assert (card != NULL && "Carta da scartare non valida!");
 
     // Aggiunge la carta scartata in cima al mazzo degli scarti
-    card->next_card = *discard_deck; // Imposta la prossima carta della carta scartata alla testa del mazzo degli scarti
-    *discard_deck = card; // Imposta la carta scartata come testa del mazzo degli scarti
+    add_card_front(discard_deck, card);
 
     return;
 }
@@ -1073,8 +1427,8 @@ void discard_card(Card* card, Card** discard_deck) {
  * @param player_hand Puntatore alla mano del giocatore.
  * @param discard_deck Puntatore al mazzo degli scarti.
  */
-void select_and_discard_card(int card_index, Card** player_hand, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void select_and_discard_card(int card_index, Deck* player_hand, Deck* discard_deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Selezione della carta da scartare dalla mano del giocatore
     Card* selected_card = select_card(card_index, player_hand, true);
@@ -1090,14 +1444,15 @@ void select_and_discard_card(int card_index, Card** player_hand, Card** discard_
  * @param card Puntatore alla carta da cercare.
  * @return true se la carta è presente nel mazzo, false altrimenti.
  */
-bool deck_contains_card(const Card* deck, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+bool deck_contains_card(const Deck* deck, const Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     bool found = false; // Inizializza il flag di ricerca a false
 
     // Scorre tutte le carte del mazzo
-    for (Card* current_card = deck; current_card != NULL && !found; current_card = current_card->next_card) {
-        found = strcmp(current_card->name, card->name) == 0; // Confronta il nome della carta corrente con il nome della carta da cercare
+    for (int i = 0; i < deck->size && !found; i++) {
+        Card* current_card = get_card(deck, i);
+        found = current_card->def == card->def; // Le carte con lo stesso nome condividono la stessa definizione
     }
 
     return found;
@@ -1110,20 +1465,21 @@ bool deck_contains_card(const Card* deck, const Card* card) {
  * @param required_type Tipo di carta richiesto.
  * @return true se il tipo di carta è presente nel mazzo, false altrimenti.
  */
-bool deck_contains_type(const Card* deck, Type_card required_type) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+bool deck_contains_type(const Deck* deck, Type_card required_type) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     bool found = false; // Inizializza il flag di ricerca a false
 
     // Scorre tutte le carte del mazzo
-    for (Card* current_card = deck; current_card != NULL && !found; current_card = current_card->next_card) {
+    for (int i = 0; i < deck->size && !found; i++) {
+        Card* current_card = get_card(deck, i);
         found = (
             required_type == ALL // Se il tipo richiesto è ALL, allora la carta è valida
-            || current_card->type == required_type // Se il tipo della carta corrente è uguale al tipo richiesto, allora la carta è valida
+            || current_card->def->type == required_type // Se il tipo della carta corrente è uguale al tipo richiesto, allora la carta è valida
             || (required_type == STUDENTE && (
-                current_card->type == MATRICOLA
-                || current_card->type == STUDENTE_SEMPLICE
-                || current_card->type == LAUREANDO
+                current_card->def->type == MATRICOLA
+                || current_card->def->type == STUDENTE_SEMPLICE
+                || current_card->def->type == LAUREANDO
             )) // Se il tipo richiesto è STUDENTE, allora la carta è valida se è una carta MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
         ); // Confronta il tipo della carta corrente con il tipo richiesto
     }
@@ -1140,15 +1496,21 @@ bool deck_contains_type(const Card* deck, Type_card required_type) {
  * @param target_card Carta bersaglio dell'effetto richiesto.
  * @return true se l'effetto è presente in una delle carte del mazzo, false altrimenti.
  */
-bool deck_contains_effect(const Card* deck, Action action, Type_Player target_player, Type_card target_card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+bool deck_contains_effect(const Deck* deck, Action action, Type_Player target_player, Type_card target_card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il mazzo ha un indice degli effetti => basta controllare il contatore della terna richiesta
+    if (deck->effect_index != NULL && action >= 0 && target_player >= 0 && target_card >= 0) {
+        return deck->effect_index->counts[action][target_player][target_card] > 0;
+    }
 
     bool found = false; // Inizializza il flag di ricerca a false
 
     // Scorre tutte le carte del mazzo
-    for (Card* current_card = deck; current_card != NULL && !found; current_card = current_card->next_card) {
+    for (int i = 0; i < deck->size && !found; i++) {
+        Card* current_card = get_card(deck, i);
         // Controlla se l'effetto è presente nella carta corrente
-        found = has_effect(current_card->effects, current_card->num_effects, action, target_player, target_card);
+        found = has_effect(current_card->def->effects, current_card->def->num_effects, action, target_player, target_card);
     }
 
     return found;
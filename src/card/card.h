@@ -6,32 +6,46 @@
 #include <stdbool.h>
 #include <stdio.h>
 
-Card* load_cards(const char* filename, int* num_cards, int* num_unique_cards);
-Card* read_card(FILE* file);
-void free_card(Card* card);
-void free_deck(Card* deck);
-void copy_card(Card* src, Card* dst);
-Card* add_card(Card* head, Card* card);
+void load_card_definitions(const char* filename);
+Deck load_cards(const char* filename, int* num_cards, int* num_unique_cards);
+Card_definition* read_card(FILE* file);
+Card_definition* register_card_definition(Card_definition* definition);
+const Card_definition* find_card_definition(const char* name);
+int count_card_definitions();
+const Card_definition* get_card_definition(int id);
+void free_card_definitions();
+void free_rendered_cards();
+Card* get_definition_card(const Card_definition* definition);
+void init_deck(Deck* deck);
+void free_deck(Deck* deck);
+void copy_deck(Deck* destination, const Deck* source);
+void reserve_deck(Deck* deck, int capacity);
+void enable_effect_index(Deck* deck);
+uint64_t compute_deck_hash(const Deck* deck);
+Card* get_card(const Deck* deck, int index);
+void add_card(Deck* deck, Card* card);
+void add_card_front(Deck* deck, Card* card);
+Card* pop_card_front(Deck* deck);
+Card* pop_card_back(Deck* deck);
 char* get_type_card(Type_card type);
-char* get_parsed_type_card(Type_card type);
 char* get_color_by_type(Type_card type);
-int calculate_max_row_length_for_description(const Card* deck);
-char** format_card(int* buffer_rows, const Card* card, int max_rows_description, int card_index, int total_cards);
-char** format_hidden_card(int* buffer_rows, int card_index, int total_cards);
 void print_card(const Card* card);
-char** format_deck(int* buffer_rows, const Card* deck, const char* deck_name, int offset_card_index, bool hidden, char* color);
-void print_deck(const Card* deck, const char* deck_name, int offset_card_index, bool hidden, char* color);
-int count_cards(Card* deck);
-Card* shuffle_deck(Card* deck, int num_cards);
-void separate_matricola_cards(Card** deck, Card** study_room);
-void draw_card(Player** player, Card** draw_deck, Card** discard_deck, bool show_card);
-Card* draw_matricola_card(Card* player_classroom, Card** study_room);
-int choice_card(Card* deck, char* msg, char* error_msg);
-Card* select_card(int card_index, Card** deck, bool unlink_card);
-void discard_card(Card* card, Card** discard_deck);
-void select_and_discard_card(int card_index, Card** player_hand, Card** discard_deck);
-bool deck_contains_card(const Card* deck, const Card* card);
-bool deck_contains_type(const Card* deck, Type_card required_type);
-bool deck_contains_effect(const Card* deck, Action action, Type_Player target_player, Type_card target_card);
+void init_deck_layout(Deck_layout* layout, const Deck* deck, const char* deck_name, int offset_card_index, bool hidden, const char* color);
+void render_deck_row(Frame* frame, const Deck_layout* layout, int row);
+void print_deck(const Deck* deck, const char* deck_name, int offset_card_index, bool hidden, char* color);
+int count_cards(const Deck* deck);
+void shuffle_deck(Deck* deck, Rng* rng);
+void swap_decks(Deck* deck_a, Deck* deck_b);
+void separate_matricola_cards(Deck* deck, Deck* study_room);
+void draw_card(Player** player, Deck* draw_deck, Deck* discard_deck, bool show_card);
+void draw_matricola_card(Deck* player_classroom, Deck* study_room);
+int choice_card(Player* player, Deck* deck, char* msg, char* error_msg);
+int choice_filtered_card(Player* player, Deck* deck, Card_filter filter, Type_card force_card_type, const Card* card, char* msg, char* error_msg);
+Card* select_card(int card_index, Deck* deck, bool unlink_card);
+void discard_card(Card* card, Deck* discard_deck);
+void select_and_discard_card(int card_index, Deck* player_hand, Deck* discard_deck);
+bool deck_contains_card(const Deck* deck, const Card* card);
+bool deck_contains_type(const Deck* deck, Type_card required_type);
+bool deck_contains_effect(const Deck* deck, Action action, Type_Player target_player, Type_card target_card);
 
 #endif
\ No newline at end of file
@@ -3,41 +3,50 @@
 #include "../card/card.h"
 #include "../save_load/save_load.h"
 #include "../logging/logging.h"
+#include "../decision/decision.h"
+#include "../rng/rng.h"
+#include "../journal/journal.h"
+#include "../screen/screen.h"
+#include "../replay/replay.h"
 
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
+#include <inttypes.h>
+#include <assert.h>
 
 /**
  * @brief Inizializza una nuova partita.
  * 
  * @param registered_saves Puntatore al puntatore all'array dei salvataggi registrati.
  * @param num_registered_saves Puntatore al numero di salvataggi registrati.
+ * @param seed Seme del generatore di numeri casuali della partita.
  */
-void init_new_game(char*** registered_saves, int* num_registered_saves) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void init_new_game(char*** registered_saves, int* num_registered_saves, uint64_t seed) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Costruzione del separatore del round
     char* round_separator = repeat_string(UNICODE_BORDER_HORIZONTAL, ROUND_SEPARATOR_SIZE);
-    printf(BOLD "%s%s%s\n" RESET, UNICODE_BORDER_VERTICAL, round_separator, UNICODE_BORDER_VERTICAL);
+    print_msg(BOLD "%s%s%s\n" RESET, UNICODE_BORDER_VERTICAL, round_separator, UNICODE_BORDER_VERTICAL);
 
-    printf("\n[" HGRN "+" RESET "] Inizializzazione di una nuova partita...\n");
+    print_msg("\n[" HGRN "+" RESET "] Inizializzazione di una nuova partita...\n");
 
     char game_name[MAX_FILENAME_LENGTH + 1]; // Buffer per il nome della partita
     bool is_valid_name = false; // Flag per il nome valido della partita
 
     do {
-        printf("\n[" HBLU "i" RESET "] Inserisci il nome della partita (caratteri ammessi a-z, A-Z, 0-9, \"_\" e \"-\"):\n");
-        printf("> ");
+        print_msg("\n[" HBLU "i" RESET "] Inserisci il nome della partita (caratteri ammessi a-z, A-Z, 0-9, \"_\" e \"-\"):\n");
+        print_msg("> ");
         scanf(" %" STR_MAX_FILENAME_LENGTH "[^\n]s", game_name);
         clear_buffer();
 
         // SE il nome della partita non è valido
         if (!is_valid_filename(game_name)) {
-            printf("[" RED "!" RESET "] Nome della partita non valido. Riprova!\n");
+            print_msg("[" RED "!" RESET "] Nome della partita non valido. Riprova!\n");
         } else if (is_already_registered(game_name, *registered_saves, *num_registered_saves)) {
             // SE il nome della partita è già stato utilizzato
-            printf("[" RED "!" RESET "] Il nome della partita è già stato utilizzato. Riprova!\n");
+            print_msg("[" RED "!" RESET "] Il nome della partita è già stato utilizzato. Riprova!\n");
         } else {
             is_valid_name = true; // Imposta il nome della partita come valido
         }
@@ -47,12 +56,12 @@ void init_new_game(char*** registered_saves, int* num_registered_saves) {
     // Inizializzazione del numero di giocatori
     int num_players = 0;
     do {
-        printf("\n[" HBLU "i" RESET "] Quanti giocatori parteciperanno alla partita? (min. 2, max. 4)\n");
-        printf("> ");
+        print_msg("\n[" HBLU "i" RESET "] Quanti giocatori parteciperanno alla partita? (min. 2, max. 4)\n");
+        print_msg("> ");
 
         read_int(&num_players); // Legge il numero di giocatori
         if (num_players < MIN_PLAYERS || num_players > MAX_PLAYERS) {
-            printf("[" RED "!" RESET "] Numero di giocatori non valido. Riprova!\n");
+            print_msg("[" RED "!" RESET "] Numero di giocatori non valido. Riprova!\n");
         }
 
     } while (num_players < MIN_PLAYERS || num_players > MAX_PLAYERS);
@@ -62,13 +71,13 @@ void init_new_game(char*** registered_saves, int* num_registered_saves) {
         char temp_name[MAX_NAME_LENGTH + 1]; // Buffer per il nome del giocatore
 
         do {
-            printf("\n[" HBLU "i" RESET "] Inserisci il nome del %d° giocatore:\n", i + 1);
-            printf("> ");
+            print_msg("\n[" HBLU "i" RESET "] Inserisci il nome del %d° giocatore:\n", i + 1);
+            print_msg("> ");
             scanf(" %" STR_MAX_NAME_LENGTH "[^\n]s", temp_name);
 
             // SE il nome del giocatore non è valido
             if (strlen(temp_name) == 0) {
-                printf("[" RED "!" RESET "] Nome non valido. Riprova!\n");
+                print_msg("[" RED "!" RESET "] Nome non valido. Riprova!\n");
             }
 
         } while (strlen(temp_name) == 0); // Continua finché il nome del giocatore non è valido
@@ -77,20 +86,39 @@ void init_new_game(char*** registered_saves, int* num_registered_saves) {
         sanitize_string(temp_name);
         strip_string(temp_name);
         players = add_player(players, temp_name); // Aggiunge il giocatore alla lista
-    }
 
-    // Inizializzazione del mazzo di carte
-    int num_draw_deck_cards = 0, num_unique_cards = 0;
-    Card* draw_deck = load_cards(DEFAULT_DECK_PATH, &num_draw_deck_cards, &num_unique_cards);
+        // Scelta di chi prende le decisioni del giocatore (umano o bot)
+        print_msg("\n[" HBLU "i" RESET "] Chi gioca come \"%s\"?\n", temp_name);
+        for (int j = 0; j < NUM_DECISION_PROVIDERS; j++) {
+            print_msg("  %d. %s%s\n", j + 1, j == 0 ? "" : "bot ", DECISION_PROVIDERS[j]->name);
+        }
 
-    draw_deck = shuffle_deck(draw_deck, num_draw_deck_cards); // Mescola il mazzo di carte
+        int provider_index = 0;
+        do {
+            print_msg("> ");
+            read_int(&provider_index);
+            if (provider_index < 1 || provider_index > NUM_DECISION_PROVIDERS) {
+                print_msg("[" RED "!" RESET "] Scelta non valida. Riprova!\n");
+            }
+        } while (provider_index < 1 || provider_index > NUM_DECISION_PROVIDERS);
 
-    // Inizializzazione del mazzo dell'aula studio
-    Card* study_room = NULL;
-    separate_matricola_cards(&draw_deck, &study_room); // Separa le carte MATRICOLA dal mazzo di carte
+        // Il giocatore appena aggiunto è l'ultimo della lista circolare
+        Player* last_player = players;
+        while (last_player->next_player != players) {
+            last_player = last_player->next_player;
+        }
+        last_player->provider = DECISION_PROVIDERS[provider_index - 1];
+    }
 
-    Card* discard_deck = NULL; // Placeholder per il mazzo degli scarti
-    init_hand(players, &draw_deck, &study_room, &discard_deck); // Inizializza le carte in mano e dell'aula studio per ogni giocatore
+    // Inizializzazione della partita
+    Game game = {0};
+    strncpy(game.name, game_name, MAX_FILENAME_LENGTH);
+    game.players = players;
+    init_game_rng(&game, seed); // Inizializza i generatori di numeri casuali della partita
+    link_players_to_game(&game);
+    init_game_cards(&game); // Inizializza i mazzi e distribuisce le carte iniziali
+
+    print_msg("\n[" HBLU "i" RESET "] Seme della partita: " HYEL "%" PRIu64 RESET " (usa " SEED_OPTION " %" PRIu64 " per rigiocarla)\n", seed, seed);
 
     // Libera la memoria dinamica del separatore del round
     free(round_separator);
@@ -98,39 +126,155 @@ void init_new_game(char*** registered_saves, int* num_registered_saves) {
     // Registra il salvataggio della partita
     *registered_saves = register_new_save(DEFAULT_SAVES_LIST_PATH, game_name, *registered_saves, num_registered_saves);
 
-    // Registra l'azione di inizio di una nuova partita nel file di log
-    log_init_game(game_name);
+    // Apre il file di log della partita e registra l'azione di inizio di una nuova partita
+    open_logger(&game.logger, DEFAULT_LOG_FILE_PATH);
+    log_init_game(&game.logger, &game);
+
+    // Registra le decisioni della partita nel replay, accanto al salvataggio
+    char replay_path[MAX_FILENAME_LENGTH + SAVES_FOLDER_LEN + REPLAY_EXTENSION_LEN + 1];
+    sprintf(replay_path, "%s%s%s", SAVES_FOLDER, game_name, REPLAY_EXTENSION);
+    open_replay(&game.replay, replay_path, &game);
+    print_msg("[" HBLU "i" RESET "] Le decisioni della partita vengono registrate nel replay \"" GRN "%s" RESET "\" (usa " REPLAY_OPTION " per rigiocarla).\n", replay_path);
 
     // Avvia la partita
-    play_game(game_name, players, draw_deck, discard_deck, study_room);
+    play_game(&game);
+
+    // Libera la memoria allocata per la partita
+    free_game(&game);
+    return;
+}
+
+/**
+ * @brief Collega ogni giocatore alla partita a cui partecipa (e quindi al suo generatore di numeri casuali).
+ * 
+ * @param game Puntatore alla partita.
+ */
+void link_players_to_game(Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Player* current_player = game->players;
+    do {
+        current_player->game = game;
+        current_player = current_player->next_player;
+    } while (current_player != game->players);
+
+    return;
+}
+
+/**
+ * @brief Inizializza i mazzi di una nuova partita e distribuisce le carte iniziali ai giocatori.
+ * 
+ * @param game Puntatore alla partita (con i giocatori e il generatore di numeri casuali già inizializzati).
+ */
+void init_game_cards(Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Inizializzazione del mazzo di carte
+    int num_draw_deck_cards = 0, num_unique_cards = 0;
+    game->draw_deck = load_cards(DEFAULT_DECK_PATH, &num_draw_deck_cards, &num_unique_cards);
+
+    shuffle_deck(&game->draw_deck, &game->rng); // Mescola il mazzo di carte
+
+    // Inizializzazione del mazzo dell'aula studio
+    init_deck(&game->study_room);
+    separate_matricola_cards(&game->draw_deck, &game->study_room); // Separa le carte MATRICOLA dal mazzo di carte
+
+    init_deck(&game->discard_deck); // Placeholder per il mazzo degli scarti
+    init_hand(game->players, &game->draw_deck, &game->study_room, &game->discard_deck); // Inizializza le carte in mano e dell'aula studio per ogni giocatore
+
+    return;
+}
+
+/**
+ * @brief Mostra il giocatore corrente o gli altri giocatori componendo un unico frame dello schermo.
+ * 
+ * Il frame (intestazione del turno e riquadri dei giocatori) viene presentato con present_screen: richiedendo
+ * più volte la stessa visualizzazione vengono riscritte solo le righe cambiate, senza sfarfallio.
+ * 
+ * @param game Puntatore alla partita.
+ * @param current_player Puntatore al giocatore di turno.
+ * @param show_others Flag per mostrare gli altri giocatori invece del giocatore di turno.
+ * @param players_colors Colori dei giocatori.
+ * @param num_players Numero di giocatori.
+ */
+static void show_players(const Game* game, Player* current_player, bool show_others, const char** players_colors, int num_players) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la modalità silenziosa è attiva => non compone il frame
+    if (is_silent_output()) {
+        return;
+    }
+
+    Frame frame;
+    init_frame(&frame, 0); // La capacità viene riservata da render_player
+
+    // Intestazione del turno
+    char header[MAX_NAME_LENGTH + sizeof("\n[" HCYN "#" RESET "] 0000000000° Round -> Turno di " RED RESET "\n\n")];
+    sprintf(header, "\n[" HCYN "#" RESET "] %d° Round -> Turno di %s%s%s\n\n", game->round+1, players_colors[game->round % num_players], current_player->name, RESET);
+    frame_append(&frame, header);
+
+    if (!show_others) {
+        render_player(&frame, current_player, true, (char*) players_colors[game->round % num_players]);
+    } else {
+        Player* p = current_player->next_player; // Primo giocatore dopo il giocatore corrente
+        int round_offset = game->round+1; // Offset per il calcolo del colore del giocatore
+
+        // Continua finché non torna al giocatore corrente
+        while (p != current_player) {
+            // NB: per [TASTO 4] tenere a mente l'effetto MOSTRA
+            bool show_hand = deck_contains_effect(&p->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(&p->classroom, MOSTRA, IO, ALL); // Controlla se il giocatore deve mostrare la mano a tutti i giocatori
+            render_player(&frame, p, show_hand, (char*) players_colors[round_offset++ % num_players]);
+            frame_append(&frame, "\n");
+            p = p->next_player; // Passa al prossimo giocatore
+        }
+    }
+
+    // Il frame è la schermata del giocatore di turno (con le carte della sua mano): al server viene inviato solo a lui
+    set_output_recipient(current_player);
+    present_screen(&frame);
+    set_output_recipient(NULL);
+    free_frame(&frame);
+
+    return;
+}
+
+/**
+ * @brief Inizializza i generatori di numeri casuali di una partita a partire dal suo seme.
+ *
+ * Il generatore della partita (mescolamento dei mazzi) e quello dei bot sono separati: così lo stato della partita
+ * dipende solo dal seme e dalle decisioni prese, che sono tutto ciò che viene registrato in un replay.
+ *
+ * @param game Puntatore alla partita.
+ * @param seed Seme della partita.
+ */
+void init_game_rng(Game* game, uint64_t seed) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    init_rng(&game->rng, seed);
+    init_rng(&game->decision_rng, mix_hash(seed)); // Seme dei bot ricavato da quello della partita
+
     return;
 }
 
 /**
  * @brief Gioca una partita.
  * 
- * @param game_name Nome della partita.
- * @param players Puntatore alla testa della lista circolare dei giocatori.
- * @param draw_deck Punatore al mazzo di carte da cui pescare.
- * @param discard_deck Puntatore al mazzo degli scarti.
- * @param study_room Puntatore al mazzo dell'aula studio.
+ * @param game Puntatore alla partita da giocare.
  */
-void play_game(const char* game_name, Player* players, Card* draw_deck, Card* discard_deck, Card* study_room) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void play_game(Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Costruzione del percorso del file di salvataggio
     char full_path_game_name[MAX_FILENAME_LENGTH + SAVES_FOLDER_LEN + SAVES_EXTENSION_LEN + 1];
-    sprintf(full_path_game_name, "%s%s%s", SAVES_FOLDER, game_name, SAVES_EXTENSION);
+    sprintf(full_path_game_name, "%s%s%s", SAVES_FOLDER, game->name, SAVES_EXTENSION);
 
-    bool is_new_game = !file_exists(full_path_game_name); // Flag per sapere se è una nuova partita
+    // Flag per sapere se è una nuova partita (le partite headless non vengono mai salvate)
+    bool is_new_game = !game->headless && !file_exists(full_path_game_name);
 
     const char* players_colors[] = {RED, GRN, YEL, BLU}; // Colori dei giocatori
-    int num_players = count_players(players); // Numero di giocatori
-
-    int round = 0; // Contatore dei round
+    int num_players = count_players(game->players); // Numero di giocatori
 
-    Player* current_player = players; // Puntatore al giocatore corrente
-    Player* p = NULL; // Puntatore temporaneo per la gestione dei giocatori
+    Player* current_player = game->current_player != NULL ? game->current_player : game->players; // Puntatore al giocatore corrente (le partite caricate riprendono dal giocatore di turno salvato)
     int player_action = 0; // Scelta dell'azione del giocatore
     int round_offset = 0; // Offset per il calcolo del colore del giocatore
     bool valid_action = false; // Flag per l'azione valida del giocatore
@@ -141,35 +285,42 @@ void play_game(const char* game_name, Player* players, Card* draw_deck, Card* di
 
     do {
         // Fase 0: Inizio del turno
-        log_prefix_round(true, false); // Incrementa il contatore dei round nel prefisso del log
+        game->current_player = current_player;
+        log_next_round(&game->logger); // Incrementa il contatore dei round nel prefisso del log (e scrive su disco il turno precedente)
+        flush_replay(&game->replay); // Scrive su disco le decisioni del turno precedente
+
+        // SE è presente un osservatore dei turni => lo notifica dell'inizio del turno
+        if (game->turn_observer != NULL) {
+            game->turn_observer(game);
+        }
 
         // Fase 1: Salvataggio della partita
         // Prima dell'inizio di ogni turno va salvata la partita nell'apposito file binario di salvataggio (vedi slide 63 e 64: File di salvataggio).
         // SE è una nuova partita o il round è maggiore di 0 => salva la partita
-        if (is_new_game || round > 0) {
-            save_game(full_path_game_name, current_player, draw_deck, discard_deck, study_room); // Salva la partita
+        if (!game->headless && (is_new_game || game->round > 0)) {
+            save_game(full_path_game_name, game, current_player); // Salva la partita
         }
 
-        printf(BOLD "\n%s%s%s\n" RESET, UNICODE_BORDER_VERTICAL, round_separator, UNICODE_BORDER_VERTICAL);
-        printf("\n[" HCYN "#" RESET "] %d° Round -> Turno di %s%s%s\n", round+1, players_colors[round % num_players], current_player->name, RESET);
+        print_msg(BOLD "\n%s%s%s\n" RESET, UNICODE_BORDER_VERTICAL, round_separator, UNICODE_BORDER_VERTICAL);
+        print_msg("\n[" HCYN "#" RESET "] %d° Round -> Turno di %s%s%s\n", game->round+1, players_colors[game->round % num_players], current_player->name, RESET);
 
         // Fase 1.5: Attivazione degli effetti delle carte presenti nel campo di gioco del giocatore
         // Si dovrà controllare se nel campo di gioco del giocatore sono presenti carte bonus/malus che hanno come QUANDO dell’Effetto "INIZIO" e, in caso affermativo, svolgere gli effetti di queste carte.
-        for (Card* current_card = current_player->magic_cards; current_card != NULL; current_card = current_card->next_card) {
-            check_effect(current_player, current_card, INIZIO, &draw_deck, &discard_deck); // Controlla l'effetto della carta bonus/malus
+        for (int i = 0; i < count_cards(&current_player->magic_cards); i++) {
+            check_effect(current_player, get_card(&current_player->magic_cards, i), INIZIO, &game->draw_deck, &game->discard_deck); // Controlla l'effetto della carta bonus/malus
         }
         // Successivamente fare la stessa cosa con le carte presenti nell'aula studio.
-        for (Card* current_card = current_player->classroom; current_card != NULL; current_card = current_card->next_card) {
-            check_effect(current_player, current_card, INIZIO, &draw_deck, &discard_deck); // Controlla l'effetto della carta studente
+        for (int i = 0; i < count_cards(&current_player->classroom); i++) {
+            check_effect(current_player, get_card(&current_player->classroom, i), INIZIO, &game->draw_deck, &game->discard_deck); // Controlla l'effetto della carta studente
         }
 
         // Fase 2: Pescare una carta dal mazzo
-        draw_card(&current_player, &draw_deck, &discard_deck, true); // Pesca una carta dal mazzo
+        draw_card(&current_player, &game->draw_deck, &game->discard_deck, true); // Pesca una carta dal mazzo
 
         // Fase 3: Azione del giocatore
         do {
-            printf(ACTION_MENU); // Stampa il menu delle azioni
-            read_int(&player_action); // Legge l'azione del giocatore
+            // Chiede l'azione al fornitore di decisioni del giocatore corrente
+            player_action = decide_int(current_player, DECISION_ACTION, PLAY_ACTION, EXIT_ACTION, ACTION_MENU, "\n[" RED "!" RESET "] Scelta non valida! Riprova!\n");
             valid_action = true; // Imposta l'azione del giocatore come valida
 
             switch (player_action) {
@@ -178,43 +329,32 @@ void play_game(const char* game_name, Player* players, Card* draw_deck, Card* di
                     // SE non dispone di carte giocabili => verrà considerata come azione non valida
                     // e l'unica azione possibile sarà quella di pescare una carta
                     if (count_playable_cards(current_player, ALL) == 0) {
-                        printf("\n[" RED "!" RESET "] %s non hai carte giocabili! Devi pescare una carta!\n", current_player->name);
+                        print_msg("\n[" RED "!" RESET "] %s non hai carte giocabili! Devi pescare una carta!\n", current_player->name);
                         valid_action = false; // Imposta l'azione del giocatore come non valida
                     } else {
                         // Non è possibile inserire due carte identiche nella propria aula (o bonusmalus) o quella di un altro giocatore.
                         // SE si prova a giocare una carta già presente nell'aula o bonus/malus
                         // => non sarà possibile giocare la carta => la carta verrà scartata
-                        play_hand(current_player, ALL, &draw_deck, &discard_deck, true); // Gioca una carta
+                        play_hand(current_player, ALL, &game->draw_deck, &game->discard_deck, true); // Gioca una carta
                     }
                     break;
                 case DRAW_ACTION:
                     // Pesca un'ulteriore carta dal mazzo
-                    draw_card(&current_player, &draw_deck, &discard_deck, true);
+                    draw_card(&current_player, &game->draw_deck, &game->discard_deck, true);
                     break;
                 case SHOW_ACTION:
                     // Mostra la tua mano, l'aula studio e le carte bonus/malus
-                    print_player(current_player, true, players_colors[round % num_players]);
+                    show_players(game, current_player, false, players_colors, num_players);
                     break;
                 case SHOW_OTHERS_ACTION:
                     // Visualizza lo stato degli altri giocatori (numero carte in mano, l'aula studio e le carte bonus/malus)
-                    p = current_player->next_player; // Passa al prossimo giocatore (il primo giocatore dopo il giocatore corrente)
-                    round_offset = round+1; // Inizializza l'offset per il calcolo del colore del giocatore
-
-                    // Continua finché non torna al giocatore corrente
-                    while (p != current_player) {
-                        // NB: per [TASTO 4] tenere a mente l'effetto MOSTRA
-                        bool show_hand = deck_contains_effect(p->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(p->classroom, MOSTRA, IO, ALL); // Controlla se il giocatore deve mostrare la mano a tutti i giocatori
-                        print_player(p, show_hand, players_colors[round_offset++ % num_players]); // Stampa il giocatore
-                        printf("\n");
-                        p = p->next_player; // Passa al prossimo giocatore
-                    }
-
+                    show_players(game, current_player, true, players_colors, num_players);
                     break;
                 case EXIT_ACTION:
-                    printf("\n[" RED "-" RESET "] Uscita dalla partita in corso...\n");
+                    print_msg("\n[" RED "-" RESET "] Uscita dalla partita in corso...\n");
                     break;
                 default:
-                    printf("\n[" RED "!" RESET "] Scelta non valida! Riprova!\n");
+                    print_msg("\n[" RED "!" RESET "] Scelta non valida! Riprova!\n");
                     valid_action = false; // Imposta l'azione del giocatore come non valida
                     break;
             }
@@ -225,55 +365,189 @@ void play_game(const char* game_name, Player* players, Card* draw_deck, Card* di
         // Scartare il quantitativo di carte necessario affinché il numero di carte in mano sia
         // minore o uguale a 5. Il giocatore sceglie che carte scartare nel mazzo degli scarti.
         if (player_action != EXIT_ACTION) {
-            check_hand(current_player, players_colors[round % num_players], &discard_deck); // Controlla la mano del giocatore
+            check_hand(current_player, players_colors[game->round % num_players], &game->discard_deck); // Controlla la mano del giocatore
 
             // Fase 5: Fine del gioco
             // Alla fine di ogni turno si controlla la condizione di vittoria del giocatore corrente.
             // Se la condizione è soddisfatta il gioco finisce e si da un messaggio di congratulazioni
             // al giocatore, altrimenti si passa il turno al giocatore successivo.
             if (check_win_condition(current_player)) {
-                printf("\n[" HCYN "#" RESET "] Partita Terminata! - Recap Partita:\n\n");
+                print_msg("\n[" HCYN "#" RESET "] Partita Terminata! - Recap Partita:\n\n");
 
                 // Visualizza lo stato finale della partita
                 Player *p = current_player;
-                round_offset = round; // Inizializza l'offset per il calcolo del colore del giocatore
+                round_offset = game->round; // Inizializza l'offset per il calcolo del colore del giocatore
 
                 do {
                     print_player(p, true, players_colors[round_offset++ % num_players]); // Stampa il giocatore
-                    printf("\n");
+                    print_msg("\n");
                     p = p->next_player; // Passa al prossimo giocatore
                 } while (p != current_player); // Continua finché non torna al giocatore corrente
 
                 // Visualizza lo stato del mazzo degli scarti
-                print_deck(discard_deck, "Mazzo degli Scarti", 0, false, DISCARD_DECK_COLOR);
+                print_deck(&game->discard_deck, "Mazzo degli Scarti", 0, false, DISCARD_DECK_COLOR);
 
-                printf("\n[" RED "!!!" RESET "] Il giocatore \"%s%s%s\" ha vinto! Congratulazioni!\n", players_colors[round % num_players], current_player->name, RESET);
+                print_msg("\n[" RED "!!!" RESET "] Il giocatore \"%s%s%s\" ha vinto! Congratulazioni!\n", players_colors[game->round % num_players], current_player->name, RESET);
 
                 // Registra l'azione di vittoria nel file di log
                 log_winner_game(current_player);
 
+                game->winner = current_player; // Salva il vincitore della partita
                 game_over = true; // Imposta il termine del gioco
             } else {
                 current_player = current_player->next_player; // Passa al prossimo giocatore
-                round++; // Incrementa il contatore dei round
+                game->current_player = current_player;
+                game->round++; // Incrementa il contatore dei round
+
+                // SE è stato raggiunto il limite massimo di round => la partita termina senza vincitori
+                if (game->max_rounds > 0 && game->round >= game->max_rounds) {
+                    print_msg("\n[" RED "!" RESET "] Raggiunto il limite di %d round! Partita terminata senza vincitori.\n", game->max_rounds);
+                    game_over = true; // Imposta il termine del gioco
+                }
             }
         }
 
     } while (player_action != EXIT_ACTION && !game_over);
 
+    // Registra nel replay la fine della partita con l'hash dello stato finale
+    end_replay(&game->replay, game);
+
     // Fase 4: Fine del gioco
-    printf(BOLD "\n%s%s%s\n" RESET, UNICODE_BORDER_VERTICAL, round_separator, UNICODE_BORDER_VERTICAL);
+    print_msg(BOLD "\n%s%s%s\n" RESET, UNICODE_BORDER_VERTICAL, round_separator, UNICODE_BORDER_VERTICAL);
 
     // Libera la memoria allocata dinamicamente
     free(round_separator);
-    free_deck(draw_deck);
-    free_deck(study_room);
-    free_deck(discard_deck);
-    free_players(players);
 
     return;
 }
 
+/**
+ * @brief Libera la memoria allocata per una partita (mazzi e giocatori).
+ * 
+ * @param game Puntatore alla partita.
+ */
+void free_game(Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    free_deck(&game->draw_deck);
+    free_deck(&game->study_room);
+    free_deck(&game->discard_deck);
+    free_players(game->players);
+    close_logger(&game->logger); // Scrive su disco gli eventi ancora in memoria e chiude il file di log
+    close_journal(&game->journal); // Chiude il file di salvataggio su cui viene registrato il journal
+    close_replay(&game->replay); // Chiude il replay SE la partita non è terminata
+
+    game->players = NULL;
+    game->winner = NULL;
+
+    return;
+}
+
+/**
+ * @brief Crea una copia indipendente di una partita (mazzi, giocatori e generatore di numeri casuali).
+ * 
+ * La copia è headless: non ha logger, journal né osservatore dei turni, quindi può essere giocata
+ * (ad esempio dalla ricerca dei bot) senza toccare la partita originale né i file su disco.
+ * 
+ * @param clone Puntatore alla partita da inizializzare come copia.
+ * @param game Puntatore alla partita da copiare.
+ */
+void clone_game(Game* clone, const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    *clone = (Game) {0};
+    strcpy(clone->name, game->name);
+    clone->round = game->round;
+    clone->max_rounds = game->max_rounds;
+    clone->headless = true;
+    clone->rng = game->rng;
+    clone->decision_rng = game->decision_rng;
+
+    init_deck(&clone->draw_deck);
+    init_deck(&clone->discard_deck);
+    init_deck(&clone->study_room);
+    copy_deck(&clone->draw_deck, &game->draw_deck);
+    copy_deck(&clone->discard_deck, &game->discard_deck);
+    copy_deck(&clone->study_room, &game->study_room);
+
+    // Copia dei giocatori, nello stesso ordine della partita originale
+    Player* current_player = game->players;
+    Player* last_player = NULL;
+    do {
+        clone->players = add_player(clone->players, current_player->name);
+        last_player = last_player == NULL ? clone->players : last_player->next_player;
+
+        last_player->provider = current_player->provider;
+        copy_deck(&last_player->hand, &current_player->hand);
+        copy_deck(&last_player->classroom, &current_player->classroom);
+        copy_deck(&last_player->magic_cards, &current_player->magic_cards);
+
+        // Il giocatore di turno della copia è quello nella stessa posizione al tavolo
+        if (current_player == game->current_player) {
+            clone->current_player = last_player;
+        }
+
+        current_player = current_player->next_player;
+    } while (current_player != game->players);
+
+    link_players_to_game(clone);
+
+    return;
+}
+
+/**
+ * @brief Calcola l'hash a 64 bit dello stato della partita: ordine delle carte di ogni mazzo (mazzo di pesca,
+ * scarti, aula studio e mazzi di ogni giocatore), giocatore di turno e round.
+ * 
+ * Ogni mazzo mantiene il proprio hash aggiornato ad ogni spostamento di carta (vedi add_card e select_card),
+ * quindi il costo dipende solo dal numero di mazzi e non dal numero di carte. Due partite nello stesso stato
+ * hanno lo stesso hash (le chiavi delle carte non dipendono dall'esecuzione), il che permette di confrontare
+ * due esecuzioni con lo stesso seme o di riconoscere posizioni già viste.
+ * 
+ * @param game Puntatore alla partita.
+ * @return uint64_t Hash dello stato della partita.
+ */
+uint64_t hash_game(const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int current_seat = -1; // Posto al tavolo del giocatore di turno (-1 SE la partita non è iniziata)
+    int seat = 0;
+    Player* player = game->players;
+    do {
+        if (player == game->current_player) {
+            current_seat = seat;
+        }
+        seat++;
+        player = player->next_player;
+    } while (player != game->players);
+
+    uint64_t hash = mix_hash(((uint64_t) (uint32_t) game->round << 32) | (uint32_t) current_seat);
+
+    // Ogni mazzo contribuisce con il proprio hash, mescolato con la sua posizione nella partita
+    const Deck* common_decks[] = {&game->draw_deck, &game->discard_deck, &game->study_room};
+    uint64_t slot = 0;
+    for (int i = 0; i < 3; i++) {
+        #ifdef DEBUG
+            assert (common_decks[i]->hash == compute_deck_hash(common_decks[i]) && "Hash del mazzo non aggiornato!");
+        #endif
+        hash += mix_hash(common_decks[i]->hash ^ (++slot * HASH_MULTIPLIER));
+    }
+
+    player = game->players;
+    do {
+        const Deck* player_decks[] = {&player->hand, &player->classroom, &player->magic_cards};
+        for (int i = 0; i < 3; i++) {
+            #ifdef DEBUG
+                assert (player_decks[i]->hash == compute_deck_hash(player_decks[i]) && "Hash del mazzo non aggiornato!");
+            #endif
+            hash += mix_hash(player_decks[i]->hash ^ (++slot * HASH_MULTIPLIER));
+        }
+        player = player->next_player;
+    } while (player != game->players);
+
+    return hash;
+}
+
 /**
  * @brief Controlla la condizione di vittoria di un giocatore.
  * 
@@ -281,14 +555,100 @@ void play_game(const char* game_name, Player* players, Card* draw_deck, Card* di
  * @return true se il giocatore ha vinto, false altrimenti.
  */
 bool check_win_condition(Player* player) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int num_students = count_cards(player->classroom); // Conteggio degli studenti presenti nell'aula studio
+    int num_students = count_cards(&player->classroom); // Conteggio degli studenti presenti nell'aula studio
 
     // NB: la condizione di vittoria può essere influenzata da dei malus (vedi INGEGNERIZZAZIONE)
-    if (deck_contains_effect(player->magic_cards, INGEGNERE, IO, STUDENTE) || deck_contains_effect(player->magic_cards, INGEGNERE, IO, ALL)) {
+    if (deck_contains_effect(&player->magic_cards, INGEGNERE, IO, STUDENTE) || deck_contains_effect(&player->magic_cards, INGEGNERE, IO, ALL)) {
         return false;
     }
 
     return num_students >= NUM_STUDENTS_TO_WIN;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Inizializza una partita simulata, in cui tutte le decisioni vengono prese dai bot e nulla viene salvato su file.
+ * 
+ * @param game Puntatore alla partita da inizializzare.
+ * @param index Indice della partita all'interno della simulazione.
+ * @param num_players Numero di giocatori.
+ * @param seed Seme della simulazione (la partita usa il seme seed + index).
+ * @param seat_providers Bot assegnati ai posti al tavolo (NULL o posti NULL => bot casuali).
+ */
+void init_simulated_game(Game* game, int index, int num_players, uint64_t seed, const Decision_provider* const* seat_providers) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Inizializzazione della partita simulata
+    *game = (Game) {0};
+    sprintf(game->name, "simulazione_%d", index + 1);
+    game->headless = true;
+    game->max_rounds = MAX_SIMULATION_ROUNDS;
+
+    // Inizializzazione dei giocatori, le cui decisioni vengono prese dai bot (casuali SE il posto non ha un bot assegnato)
+    for (int j = 0; j < num_players; j++) {
+        char temp_name[MAX_NAME_LENGTH + 1];
+        sprintf(temp_name, "Bot %d", j + 1);
+        game->players = add_player(game->players, temp_name);
+    }
+
+    Player* current_player = game->players;
+    for (int j = 0; j < num_players; j++) {
+        bool has_provider = seat_providers != NULL && seat_providers[j] != NULL;
+        current_player->provider = has_provider ? seat_providers[j] : &RANDOM_PROVIDER;
+        current_player = current_player->next_player;
+    }
+
+    // Ogni partita ha il proprio seme, ricavato dal seme della simulazione
+    init_game_rng(game, seed + (uint64_t) index);
+    link_players_to_game(game);
+    init_game_cards(game);
+
+    return;
+}
+
+/**
+ * @brief Simula in modalità headless un certo numero di partite giocate dai bot.
+ * 
+ * @param num_games Numero di partite da simulare.
+ * @param num_players Numero di giocatori per partita.
+ * @param seed Seme della simulazione (la partita i-esima usa il seme seed + i).
+ * @param seat_providers Bot assegnati ai posti al tavolo (NULL o posti NULL => bot casuali).
+ */
+void simulate_games(int num_games, int num_players, uint64_t seed, const Decision_provider* const* seat_providers) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Durante la simulazione non viene stampato nulla e non viene scritto il file di log (il logger delle partite non viene aperto)
+    set_silent_output(true);
+
+    int num_completed_games = 0; // Numero di partite terminate con un vincitore
+    long total_rounds = 0; // Numero totale di round giocati
+    clock_t start_time = clock(); // Tempo di inizio della simulazione
+
+    for (int i = 0; i < num_games; i++) {
+        Game game;
+        init_simulated_game(&game, i, num_players, seed, seat_providers);
+
+        play_game(&game);
+
+        // Aggiornamento delle statistiche
+        num_completed_games += game.winner != NULL;
+        total_rounds += game.round + 1;
+
+        free_game(&game);
+    }
+
+    double elapsed_time = (double) (clock() - start_time) / CLOCKS_PER_SEC; // Tempo impiegato in secondi
+
+    set_silent_output(false);
+
+    print_msg("[" HBLU "i" RESET "] Simulate %d partite con %d giocatori in %.3f secondi", num_games, num_players, elapsed_time);
+    if (elapsed_time > 0) {
+        print_msg(" (%.1f partite/s)", num_games / elapsed_time);
+    }
+    print_msg(".\n");
+    print_msg("[" HBLU "i" RESET "] Seme della simulazione: %" PRIu64 "\n", seed);
+    print_msg("[" HBLU "i" RESET "] Partite con un vincitore: %d/%d, round medi per partita: %.1f\n", num_completed_games, num_games, num_games > 0 ? (double) total_rounds / num_games : 0.0);
+
+    return;
+}
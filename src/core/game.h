@@ -2,9 +2,18 @@
 #define UNSTABLE_STUDENTS_GAME_H
 
 #include "../model/structs.h"
+#include <stdint.h>
 
-void init_new_game(char*** registered_saves, int* num_registered_saves);
-void play_game(const char* game_name, Player* players, Card* draw_deck, Card* discard_deck, Card* study_room);
+void init_new_game(char*** registered_saves, int* num_registered_saves, uint64_t seed);
+void link_players_to_game(Game* game);
+void init_game_rng(Game* game, uint64_t seed);
+void init_game_cards(Game* game);
+void play_game(Game* game);
+void free_game(Game* game);
+void clone_game(Game* clone, const Game* game);
+uint64_t hash_game(const Game* game);
 bool check_win_condition(Player* player);
+void init_simulated_game(Game* game, int index, int num_players, uint64_t seed, const Decision_provider* const* seat_providers);
+void simulate_games(int num_games, int num_players, uint64_t seed, const Decision_provider* const* seat_providers);
 
 #endif
\ No newline at end of file
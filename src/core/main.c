@@ -1,18 +1,174 @@
 #include "../save_load/save_load.h"
 #include "../utils/utils.h"
+#include "../card/card.h"
+#include "../rng/rng.h"
+#include "../logging/logging.h"
+#include "../tournament/tournament.h"
+#include "../thread/thread.h"
+#include "../mcts/mcts.h"
+#include "../screen/screen.h"
+#include "../server/server.h"
+#include "../replay/replay.h"
+#include "../decision/decision.h"
 #include "game.h"
-#include <time.h>
 #include <string.h>
 
 int main(int argc, char* argv[]) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    bool fixed_seed = false; // Flag per sapere se il seme è stato passato da riga di comando
+    uint64_t seed = 0; // Seme passato da riga di comando
+    Log_flush_policy flush_policy; // Politica di scrittura su disco del file di log passata da riga di comando
+    Log_rotation_policy rotation_policy; // Politica di rotazione del file di log passata da riga di comando
+    int mcts_budget_ms; // Tempo di ricerca per mossa del bot MCTS passato da riga di comando
+    const Decision_provider* seat_providers[MAX_PLAYERS] = {NULL}; // Bot assegnati ai posti delle partite simulate (NULL => bot casuale)
+    const char* replay_folder = NULL; // Cartella dei replay delle partite del server passata da riga di comando (NULL => nessun replay)
+
+    // Legge le opzioni da riga di comando (--seed S, --log-flush P, --log-rotate R, --bots B, --mcts-budget MS, --replay-dir D) e le rimuove dagli argomenti
+    int arg_index = 1;
+    while (arg_index < argc) {
+        if (strcmp(argv[arg_index], SEED_OPTION) == 0) {
+            // Controllo SE il seme è valido
+            if (arg_index + 1 >= argc || !parse_seed(argv[arg_index + 1], &seed)) {
+                printf("[" RED "!" RESET "] Utilizzo: %s " SEED_OPTION " <seme (intero senza segno)>\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            fixed_seed = true;
+        } else if (strcmp(argv[arg_index], LOG_FLUSH_OPTION) == 0) {
+            // Controllo SE la politica di scrittura è valida
+            if (arg_index + 1 >= argc || !parse_log_flush_policy(argv[arg_index + 1], &flush_policy)) {
+                printf("[" RED "!" RESET "] Utilizzo: %s " LOG_FLUSH_OPTION " <always|turn|exit>\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            set_log_flush_policy(flush_policy);
+        } else if (strcmp(argv[arg_index], LOG_ROTATE_OPTION) == 0) {
+            // Controllo SE la politica di rotazione è valida
+            if (arg_index + 1 >= argc || !parse_log_rotation_policy(argv[arg_index + 1], &rotation_policy)) {
+                printf("[" RED "!" RESET "] Utilizzo: %s " LOG_ROTATE_OPTION " <size|game>\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            set_log_rotation_policy(rotation_policy);
+        } else if (strcmp(argv[arg_index], BOTS_OPTION) == 0) {
+            // Controllo SE la lista dei bot è valida
+            if (arg_index + 1 >= argc || !parse_seat_providers(argv[arg_index + 1], seat_providers)) {
+                printf("[" RED "!" RESET "] Utilizzo: %s " BOTS_OPTION " <bot del 1° posto>[,<bot del 2° posto>,...] (bot: casuale, avido, bloccatore, mcts)\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+        } else if (strcmp(argv[arg_index], MCTS_BUDGET_OPTION) == 0) {
+            // Controllo SE il tempo di ricerca è valido
+            if (arg_index + 1 >= argc || !parse_mcts_time_budget(argv[arg_index + 1], &mcts_budget_ms)) {
+                printf("[" RED "!" RESET "] Utilizzo: %s " MCTS_BUDGET_OPTION " <millisecondi di ricerca per mossa (1-60000)>\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            set_mcts_time_budget(mcts_budget_ms);
+        } else if (strcmp(argv[arg_index], REPLAY_DIR_OPTION) == 0) {
+            // Controllo SE la cartella è stata indicata
+            if (arg_index + 1 >= argc) {
+                printf("[" RED "!" RESET "] Utilizzo: %s " REPLAY_DIR_OPTION " <cartella dei replay delle partite del server>\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            replay_folder = argv[arg_index + 1];
+        } else {
+            arg_index++; // Argomento non riconosciuto come opzione: viene lasciato agli altri controlli
+            continue;
+        }
+
+        // Rimuove l'opzione e il suo valore dagli argomenti
+        for (int j = arg_index; j + 2 <= argc; j++) {
+            argv[j] = argv[j + 2];
+        }
+        argc -= 2;
+    }
+
+    // SE è stata richiesta la simulazione di partite in modalità headless (--simulate N [giocatori])
+    if (argc >= 3 && strcmp(argv[1], SIMULATE_OPTION) == 0) {
+        int num_games = atoi(argv[2]); // Numero di partite da simulare
+        int num_players = argc >= 4 ? atoi(argv[3]) : DEFAULT_SIMULATION_PLAYERS; // Numero di giocatori per partita
+
+        // Controllo SE i parametri della simulazione sono validi
+        if (num_games < 1 || num_players < MIN_PLAYERS || num_players > MAX_PLAYERS) {
+            printf("[" RED "!" RESET "] Utilizzo: %s " SIMULATE_OPTION " <numero partite> [numero giocatori (min. 2, max. 4)]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        simulate_games(num_games, num_players, fixed_seed ? seed : generate_seed(), seat_providers);
+
+        free_card_definitions(); // Libera la tabella delle definizioni delle carte
+        return 0;
+    }
+
+    // SE è stato richiesto un torneo di partite simulate in parallelo (--tournament N [giocatori] [thread])
+    if (argc >= 3 && strcmp(argv[1], TOURNAMENT_OPTION) == 0) {
+        int num_games = atoi(argv[2]); // Numero di partite del torneo
+        int num_players = argc >= 4 ? atoi(argv[3]) : DEFAULT_SIMULATION_PLAYERS; // Numero di giocatori per partita
+        int num_threads = argc >= 5 ? atoi(argv[4]) : count_available_cores(); // Numero di thread (di default uno per core)
+
+        // Controllo SE i parametri del torneo sono validi
+        if (num_games < 1 || num_players < MIN_PLAYERS || num_players > MAX_PLAYERS || num_threads < 1 || num_threads > MAX_TOURNAMENT_THREADS) {
+            printf("[" RED "!" RESET "] Utilizzo: %s " TOURNAMENT_OPTION " <numero partite> [numero giocatori (min. 2, max. 4)] [numero thread]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        run_tournament(num_games, num_players, num_threads, fixed_seed ? seed : generate_seed(), seat_providers);
+
+        free_card_definitions(); // Libera la tabella delle definizioni delle carte
+        return 0;
+    }
+
+    // SE è stato richiesto il server di gioco in rete (--server PORTA [giocatori], con --replay-dir i tavoli vengono registrati)
+    if (argc >= 3 && strcmp(argv[1], SERVER_OPTION) == 0) {
+        int port = atoi(argv[2]); // Porta TCP del server
+        int num_players = argc >= 4 ? atoi(argv[3]) : MIN_PLAYERS; // Numero di giocatori per tavolo
+
+        // Controllo SE i parametri del server sono validi
+        if (port < 0 || port > 65535 || num_players < MIN_PLAYERS || num_players > MAX_PLAYERS) {
+            printf("[" RED "!" RESET "] Utilizzo: %s " SERVER_OPTION " <porta (0 => scelta dal sistema)> [giocatori per tavolo (min. 2, max. 4)]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        run_server(port, num_players, replay_folder); // Termina solo SE il server non può essere avviato
+
+        free_card_definitions(); // Libera la tabella delle definizioni delle carte
+        return EXIT_FAILURE;
+    }
+
+    // SE è stato richiesto di convertire il file di log binario in testo (--render-log [FILE])
+    if (argc >= 2 && strcmp(argv[1], RENDER_LOG_OPTION) == 0) {
+        return render_log(argc >= 3 ? argv[2] : DEFAULT_LOG_FILE_PATH, stdout) ? 0 : EXIT_FAILURE;
+    }
+
+    // SE sono stati richiesti gli eventi di una partita o di un suo turno (--query-log PARTITA [TURNO])
+    if (argc >= 3 && strcmp(argv[1], QUERY_LOG_OPTION) == 0) {
+        int round = argc >= 4 ? atoi(argv[3]) : 0; // Turno richiesto (0 => tutta la partita)
+
+        // Controllo SE il turno è valido
+        if (round < 0) {
+            printf("[" RED "!" RESET "] Utilizzo: %s " QUERY_LOG_OPTION " <nome partita> [turno]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        return query_log(DEFAULT_LOG_FILE_PATH, argv[2], round, stdout) ? 0 : EXIT_FAILURE;
+    }
+
+    // SE è stato richiesto di rigiocare un replay (--replay FILE [volte])
+    if (argc >= 3 && strcmp(argv[1], REPLAY_OPTION) == 0) {
+        int num_runs = argc >= 4 ? atoi(argv[3]) : 1; // Numero di volte in cui rigiocare la partita
+
+        // Controllo SE i parametri del replay sono validi
+        if (num_runs < 1) {
+            printf("[" RED "!" RESET "] Utilizzo: %s " REPLAY_OPTION " <file di replay> [numero di volte]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        bool matches = run_replay(argv[2], num_runs);
+
+        free_card_definitions(); // Libera la tabella delle definizioni delle carte
+        return matches ? 0 : EXIT_FAILURE;
+    }
 
     // Pulizia dello schermo all'avvio del gioco
     clear_screen();
 
-    // Inizializzazione del generatore di numeri casuali
-    srand(time(NULL));
-
     // Stampa del banner del gioco
     printf(GAME_BANNER);
 
@@ -68,7 +224,7 @@ int main(int argc, char* argv[]) {
 
         switch (user_choice) {
             case NEW_GAME_ACTION:
-                init_new_game(&registered_saves, &num_registered_saves); // Inizializzazione di una nuova partita
+                init_new_game(&registered_saves, &num_registered_saves, fixed_seed ? seed : generate_seed()); // Inizializzazione di una nuova partita
                 break;
 
             case LOAD_GAME_ACTION:
@@ -148,9 +304,8 @@ int main(int argc, char* argv[]) {
 
     } while (user_choice != EXIT_GAME_ACTION);
 
-    log_prefix_round(false, true); // Reset del contatore dei round
-
     // Deallocazione della memoria dinamica per i salvataggi registrati
     free_registered_saves(registered_saves, num_registered_saves);
+    free_card_definitions(); // Libera la tabella delle definizioni delle carte
     return 0;
 }
\ No newline at end of file
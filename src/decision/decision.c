@@ -0,0 +1,458 @@
+#include "decision.h"
+
+#include "../card/card.h"
+#include "../effect/effect.h"
+#include "../player/player.h"
+#include "../utils/utils.h"
+#include "../model/constants.h"
+#include "../rng/rng.h"
+#include "../replay/replay.h"
+#include "../mcts/mcts.h"
+#include <string.h>
+
+// Fornitore di decisioni che legge le scelte del giocatore da terminale
+const Decision_provider HUMAN_PROVIDER = {"umano", human_decide};
+
+// Fornitore di decisioni che sceglie casualmente tra le opzioni ammesse
+const Decision_provider RANDOM_PROVIDER = {"casuale", random_decide};
+
+// Fornitore di decisioni che cerca di aumentare il più possibile gli studenti nella propria aula
+const Decision_provider GREEDY_PROVIDER = {"avido", greedy_decide};
+
+// Fornitore di decisioni che conserva le carte ISTANTANEE per bloccare e attacca il giocatore in testa con i MALUS
+const Decision_provider BLOCKER_PROVIDER = {"bloccatore", blocker_decide};
+
+// Fornitore di decisioni che sceglie la mossa con una ricerca Monte Carlo sulle possibili configurazioni delle carte nascoste
+const Decision_provider MCTS_PROVIDER = {"mcts", mcts_decide};
+
+// Fornitori di decisioni assegnabili ai posti al tavolo (nell'ordine in cui vengono proposti)
+const Decision_provider* const DECISION_PROVIDERS[NUM_DECISION_PROVIDERS] = {&HUMAN_PROVIDER, &RANDOM_PROVIDER, &GREEDY_PROVIDER, &BLOCKER_PROVIDER, &MCTS_PROVIDER};
+
+/**
+ * @brief Chiede una decisione al giocatore tramite terminale.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Valore scelto dal giocatore (non necessariamente valido).
+ */
+int human_decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int choice = 0; // Inizializza la scelta del giocatore
+
+    switch (decision->type) {
+        case DECISION_OPTIONAL_EFFECT:
+        case DECISION_BLOCK_EFFECT:
+            // Le decisioni sì/no vengono lette come carattere
+            choice = read_char("sSnN", decision->msg, decision->error_msg);
+            return choice == 's' || choice == 'S';
+
+        default:
+            print_msg("%s", decision->msg); // Stampa il messaggio per la scelta
+            read_int(&choice); // Legge la scelta del giocatore
+            return choice;
+    }
+}
+
+/**
+ * @brief Controlla se una carta del mazzo della decisione è ammessa dal filtro della decisione.
+ *
+ * @param decision Puntatore alla decisione.
+ * @param card Puntatore alla carta.
+ * @return true Se la carta può essere scelta, false altrimenti.
+ */
+static bool is_legal_card(const Decision* decision, Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    switch (decision->filter) {
+        case CARD_FILTER_PLAYABLE:
+            // Stessi controlli di play_hand: nessun MALUS lo impedisce e la carta è del tipo richiesto
+            return can_play_card(decision->player, card) && matches_card_type(card, decision->force_card_type);
+        case CARD_FILTER_BLOCKER:
+            // Stessi controlli di block_effect: la carta è ISTANTANEA e può bloccare la carta della decisione
+            return can_block_card(card, decision->card);
+        case CARD_FILTER_TYPE:
+            // Stessi controlli degli effetti ELIMINA e RUBA: la carta è del tipo richiesto dall'effetto
+            return matches_card_type(card, decision->force_card_type);
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief Elenca le scelte valide di una decisione, senza stampare nulla e senza chiedere nulla al giocatore.
+ *
+ * Le azioni di gioco valide sono giocare una carta (SE il giocatore ha carte giocabili) e pescare una carta
+ * (le azioni che mostrano le carte o escono dalla partita non fanno avanzare il gioco e non vengono elencate).
+ * Le scelte di una carta di un mazzo rispettano il filtro della decisione; per tutte le altre decisioni
+ * sono valide tutte le scelte dell'intervallo.
+ *
+ * @param decision Puntatore alla decisione.
+ * @param choices Vettore in cui scrivere le scelte valide.
+ * @param max_choices Dimensione del vettore delle scelte.
+ * @return int Numero di scelte valide scritte nel vettore (almeno 1 SE l'intervallo non è vuoto).
+ */
+int list_legal_choices(const Decision* decision, int* choices, int max_choices) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int num_choices = 0; // Numero di scelte valide trovate
+
+    switch (decision->type) {
+        case DECISION_ACTION:
+            if (count_playable_cards(decision->player, ALL) > 0) {
+                choices[num_choices++] = PLAY_ACTION;
+            }
+            choices[num_choices++] = DRAW_ACTION;
+            return num_choices;
+
+        case DECISION_CARD:
+            // SE la scelta riguarda un solo mazzo => sono valide solo le carte ammesse dal filtro
+            if (decision->deck != NULL) {
+                for (int i = decision->min_range; i <= decision->max_range && num_choices < max_choices; i++) {
+                    if (is_legal_card(decision, get_card(decision->deck, i - 1))) {
+                        choices[num_choices++] = i;
+                    }
+                }
+
+                // SE nessuna carta è ammessa dal filtro => vengono elencate tutte (sarà il chiamante a rifiutare la scelta)
+                if (num_choices > 0) {
+                    return num_choices;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    // Tutte le scelte dell'intervallo sono valide
+    for (int i = decision->min_range; i <= decision->max_range && num_choices < max_choices; i++) {
+        choices[num_choices++] = i;
+    }
+
+    return num_choices;
+}
+
+/**
+ * @brief Prende una decisione casuale tra le scelte valide.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Valore scelto casualmente.
+ */
+int random_decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Rng* rng = &decision->player->game->decision_rng; // Generatore di numeri casuali dei bot
+
+    int choices[MAX_LEGAL_CHOICES];
+    int num_choices = list_legal_choices(decision, choices, MAX_LEGAL_CHOICES);
+
+    return choices[random_int(rng, 0, num_choices - 1)];
+}
+
+/**
+ * @brief Restituisce il valore di una carta in gioco per il giocatore che la possiede.
+ *
+ * @param card Puntatore alla carta.
+ * @return int Valore della carta (negativo SE la carta danneggia chi la possiede).
+ */
+static int card_value(const Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    switch (card->def->type) {
+        case LAUREANDO:
+            return 4;
+        case STUDENTE:
+        case STUDENTE_SEMPLICE:
+            return 3;
+        case MATRICOLA:
+        case BONUS:
+        case ISTANTANEA:
+            return 2;
+        case MALUS:
+            return -2;
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief Restituisce quanto conviene a un bot giocare una carta dalla propria mano.
+ *
+ * @param player Puntatore al giocatore che gioca la carta.
+ * @param card Puntatore alla carta.
+ * @param blocker Flag per la strategia del bot bloccatore.
+ * @return int Punteggio della carta (le carte con punteggio non positivo non vale la pena giocarle).
+ */
+static int play_score(Player* player, const Card* card, bool blocker) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    switch (card->def->type) {
+        case MATRICOLA:
+        case STUDENTE_SEMPLICE:
+        case STUDENTE:
+        case LAUREANDO:
+            // SE la carta è già presente nell'aula verrebbe scartata
+            return deck_contains_card(&player->classroom, card) ? -1 : card_value(card);
+        case BONUS:
+            return deck_contains_card(&player->magic_cards, card) ? -1 : card_value(card);
+        case MALUS:
+            return blocker ? 5 : 1; // Il bloccatore attacca il giocatore in testa appena può
+        case ISTANTANEA:
+            return blocker ? -1 : 0; // Il bloccatore conserva le ISTANTANEE per bloccare
+        default:
+            return 1;
+    }
+}
+
+/**
+ * @brief Restituisce la scelta con il punteggio migliore (massimo o minimo).
+ *
+ * @param choices Vettore delle scelte valide.
+ * @param scores Vettore dei punteggi delle scelte.
+ * @param num_choices Numero di scelte valide.
+ * @param maximize Flag per scegliere il punteggio massimo (true) o minimo (false).
+ * @return int Scelta con il punteggio migliore (a parità di punteggio la prima).
+ */
+static int best_choice(const int* choices, const int* scores, int num_choices, bool maximize) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int best = 0;
+    for (int i = 1; i < num_choices; i++) {
+        if (maximize ? scores[i] > scores[best] : scores[i] < scores[best]) {
+            best = i;
+        }
+    }
+
+    return choices[best];
+}
+
+/**
+ * @brief Sceglie il giocatore a cui applicare una carta o un effetto.
+ *
+ * Le carte BONUS vengono assegnate a se stessi, tutto il resto va al giocatore con più studenti nell'aula.
+ *
+ * @param decision Puntatore alla decisione (di tipo DECISION_PLAYER).
+ * @return int Indice del giocatore scelto (come in choose_player).
+ */
+static int choose_target_player(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la carta da assegnare è un BONUS e ci si può scegliere => sceglie se stesso (primo della lista)
+    if (decision->with_me && decision->card != NULL && decision->card->def->type == BONUS) {
+        return decision->min_range;
+    }
+
+    // Scorre i giocatori nello stesso ordine di choose_player
+    Player* current_player = decision->player->next_player;
+    int index = decision->with_me ? 2 : 1;
+    int best_index = index, max_students = -1;
+
+    while (current_player != decision->player && index <= decision->max_range) {
+        int num_students = count_cards(&current_player->classroom);
+        if (num_students > max_students) {
+            max_students = num_students;
+            best_index = index;
+        }
+        current_player = current_player->next_player;
+        index++;
+    }
+
+    return best_index;
+}
+
+/**
+ * @brief Prende una decisione secondo la strategia dei bot avido e bloccatore.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @param blocker Flag per la strategia del bot bloccatore.
+ * @return int Valore scelto.
+ */
+static int strategy_decide(const Decision* decision, bool blocker) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Player* player = decision->player;
+    int choices[MAX_LEGAL_CHOICES], scores[MAX_LEGAL_CHOICES];
+    int num_choices = list_legal_choices(decision, choices, MAX_LEGAL_CHOICES);
+
+    switch (decision->type) {
+        case DECISION_ACTION:
+            // Gioca una carta SOLO SE ne vale la pena, altrimenti pesca
+            for (int i = 0; i < count_cards(&player->hand); i++) {
+                Card* card = get_card(&player->hand, i);
+                if (can_play_card(player, card) && play_score(player, card, blocker) > 0) {
+                    return PLAY_ACTION;
+                }
+            }
+            return DRAW_ACTION;
+
+        case DECISION_CARD:
+            // SE la scelta non riguarda un solo mazzo => non ci sono informazioni per scegliere
+            if (decision->deck == NULL) {
+                break;
+            }
+
+            for (int i = 0; i < num_choices; i++) {
+                const Card* card = get_card(decision->deck, choices[i] - 1);
+
+                if (decision->filter == CARD_FILTER_PLAYABLE) {
+                    scores[i] = play_score(player, card, blocker); // Carta da giocare
+                } else if (decision->deck == &player->hand) {
+                    scores[i] = -play_score(player, card, blocker) - (blocker && card->def->type == ISTANTANEA ? 10 : 0); // Carta da scartare dalla propria mano
+                } else {
+                    scores[i] = card_value(card);
+                }
+            }
+
+            // Le carte dei propri mazzi (da scartare o eliminare) vengono scelte tra quelle di valore minore,
+            // le carte degli altri giocatori (da rubare o eliminare) tra quelle di valore maggiore
+            if (decision->filter == CARD_FILTER_PLAYABLE || decision->deck == &player->hand) {
+                return best_choice(choices, scores, num_choices, true);
+            }
+            return best_choice(choices, scores, num_choices, !(decision->deck == &player->classroom || decision->deck == &player->magic_cards));
+
+        case DECISION_PLAYER:
+            return choose_target_player(decision);
+
+        case DECISION_OPTIONAL_EFFECT:
+            return 1;
+
+        case DECISION_BLOCK_EFFECT:
+            // Il bloccatore blocca sempre, l'avido solo i MALUS
+            return blocker || decision->card == NULL || decision->card->def->type == MALUS;
+    }
+
+    return choices[random_int(&player->game->decision_rng, 0, num_choices - 1)];
+}
+
+/**
+ * @brief Prende una decisione cercando di aumentare il più possibile gli studenti nella propria aula.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Valore scelto.
+ */
+int greedy_decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return strategy_decide(decision, false);
+}
+
+/**
+ * @brief Prende una decisione conservando le carte ISTANTANEE per bloccare e attaccando con i MALUS il giocatore in testa.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Valore scelto.
+ */
+int blocker_decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return strategy_decide(decision, true);
+}
+
+/**
+ * @brief Cerca un fornitore di decisioni tramite il nome.
+ *
+ * @param name Nome del fornitore (es. "avido").
+ * @return const Decision_provider* Puntatore al fornitore, NULL SE non esiste.
+ */
+const Decision_provider* find_decision_provider(const char* name) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    for (int i = 0; i < NUM_DECISION_PROVIDERS; i++) {
+        if (strcmp_insensitive(DECISION_PROVIDERS[i]->name, name)) {
+            return DECISION_PROVIDERS[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Legge i bot da assegnare ai posti al tavolo da una lista separata da virgole (es. "avido,bloccatore").
+ *
+ * I posti non indicati nella lista restano NULL (vengono occupati da bot casuali). I giocatori umani non sono ammessi,
+ * perché la lista viene usata per le partite giocate senza terminale.
+ *
+ * @param list Lista dei nomi dei bot.
+ * @param providers Vettore (di MAX_PLAYERS elementi) in cui scrivere i fornitori dei posti.
+ * @return true Se la lista è valida, false altrimenti.
+ */
+bool parse_seat_providers(const char* list, const Decision_provider** providers) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char buffer[MAX_BOTS_LIST_LENGTH + 1];
+    if (strlen(list) > MAX_BOTS_LIST_LENGTH) {
+        return false;
+    }
+    strcpy(buffer, list);
+
+    int seat = 0;
+    for (char* name = strtok(buffer, ","); name != NULL; name = strtok(NULL, ",")) {
+        const Decision_provider* provider = find_decision_provider(name);
+
+        // SE il bot non esiste, è un giocatore umano o ci sono più bot che posti => la lista non è valida
+        if (provider == NULL || provider == &HUMAN_PROVIDER || seat >= MAX_PLAYERS) {
+            return false;
+        }
+        providers[seat++] = provider;
+    }
+
+    return seat > 0;
+}
+
+/**
+ * @brief Chiede una decisione al fornitore di decisioni del giocatore, finché il valore non è compreso nell'intervallo.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Valore scelto.
+ */
+int decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int choice;
+
+    do {
+        choice = decision->player->provider->decide(decision); // Chiede la decisione al fornitore del giocatore
+
+        // Controlla SE la scelta è valida
+        if (choice < decision->min_range || choice > decision->max_range) {
+            print_msg("%s", decision->error_msg); // Stampa il messaggio di errore
+        }
+    } while (choice < decision->min_range || choice > decision->max_range);
+
+    record_decision(&decision->player->game->replay, choice); // Registra la decisione nel replay della partita (SE registrata)
+
+    return choice;
+}
+
+/**
+ * @brief Chiede un valore intero al fornitore di decisioni del giocatore, finché non è compreso nell'intervallo.
+ *
+ * @param player Puntatore al giocatore che deve prendere la decisione.
+ * @param type Tipo di decisione.
+ * @param min_range Valore minimo accettato.
+ * @param max_range Valore massimo accettato.
+ * @param msg Messaggio da visualizzare per la scelta.
+ * @param error_msg Messaggio di errore in caso di scelta non valida.
+ * @return int Valore scelto.
+ */
+int decide_int(Player* player, Decision_type type, int min_range, int max_range, const char* msg, const char* error_msg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Decision decision = {type, player, min_range, max_range, msg, error_msg, NULL, CARD_FILTER_ANY, ALL, NULL, false};
+    return decide(&decision);
+}
+
+/**
+ * @brief Chiede una decisione sì/no al fornitore di decisioni del giocatore.
+ *
+ * @param player Puntatore al giocatore che deve prendere la decisione.
+ * @param type Tipo di decisione.
+ * @param card Puntatore alla carta a cui si riferisce la decisione (da bloccare o con effetto opzionale).
+ * @param msg Messaggio da visualizzare per la scelta.
+ * @param error_msg Messaggio di errore in caso di scelta non valida.
+ * @return true se il giocatore ha risposto sì, false altrimenti.
+ */
+bool decide_yes_no(Player* player, Decision_type type, const Card* card, const char* msg, const char* error_msg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Decision decision = {type, player, 0, 1, msg, error_msg, NULL, CARD_FILTER_ANY, ALL, card, false};
+    return decide(&decision) == 1;
+}
@@ -0,0 +1,25 @@
+#ifndef UNSTABLE_STUDENTS_DECISION_H
+#define UNSTABLE_STUDENTS_DECISION_H
+
+#include "../model/structs.h"
+#include <stdbool.h>
+
+extern const Decision_provider HUMAN_PROVIDER;
+extern const Decision_provider RANDOM_PROVIDER;
+extern const Decision_provider GREEDY_PROVIDER;
+extern const Decision_provider BLOCKER_PROVIDER;
+extern const Decision_provider MCTS_PROVIDER;
+extern const Decision_provider* const DECISION_PROVIDERS[NUM_DECISION_PROVIDERS];
+
+int human_decide(const Decision* decision);
+int list_legal_choices(const Decision* decision, int* choices, int max_choices);
+int random_decide(const Decision* decision);
+int greedy_decide(const Decision* decision);
+int blocker_decide(const Decision* decision);
+const Decision_provider* find_decision_provider(const char* name);
+bool parse_seat_providers(const char* list, const Decision_provider** providers);
+int decide(const Decision* decision);
+int decide_int(Player* player, Decision_type type, int min_range, int max_range, const char* msg, const char* error_msg);
+bool decide_yes_no(Player* player, Decision_type type, const Card* card, const char* msg, const char* error_msg);
+
+#endif
@@ -4,6 +4,9 @@
 #include "../player/player.h"
 #include "../card/card.h"
 #include "../logging/logging.h"
+#include "../decision/decision.h"
+#include <assert.h>
+#include <stdlib.h>
 
 /**
  * @brief Controlla se un determinato effetto è presente in una carta.
@@ -16,7 +19,7 @@
  * @return true se l'effetto è presente nella carta, false altrimenti.
  */
 bool has_effect(Effect* effects, int num_effects, Action action, Type_Player target_player, Type_card target_card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // -1 è un valore valido per action, target_player e target_card
     // in quanto si tratta di un valore speciale per indicare che non si vuole
@@ -45,1880 +48,786 @@ bool has_effect(Effect* effects, int num_effects, Action action, Type_Player tar
  * @param draw_deck Puntatore al mazzo di pesca.
  * @param discard_deck Puntaore al mazzo degli scarti.
  */
-void check_effect(Player* owner_card, Card* card, When when_activate, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void check_effect(Player* owner_card, Card* card, When when_activate, Deck* draw_deck, Deck* discard_deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Controllo se la carta ha effetti
-    if (card->num_effects == 0) {
+    if (card->def->num_effects == 0) {
         return;
     }
 
     // Controllo se la carta ha effetti attivabili in questo momento
-    if (card->when_activate != when_activate) {
+    if (card->def->when_activate != when_activate) {
         return;
     }
 
-    printf("\n[" HMAG "@" RESET "] Attivazione degli effetti in corso...\n");
+    print_msg("\n[" HMAG "@" RESET "] Attivazione degli effetti in corso...\n");
     print_card(card); // Stampa la carta giocata
 
     // Controllo se l'effetto è opzionale
-    if (card->optional == true) {
+    if (card->def->optional == true) {
         // Chiedere all'utente se attivare l'effetto
-        printf("\n[" HBLU "i" RESET "] %s vuoi attivare l'effetto della carta \"%s%s%s\"? (" GRN "s" RESET "/" RED "n" RESET "):\n", owner_card->name, get_color_by_type(card->type), card->name, RESET);
-        char choice = read_char("sSnN", "> ", "[" RED "!" RESET "] Scelta non valida! Riprova!\n");
+        print_msg("\n[" HBLU "i" RESET "] %s vuoi attivare l'effetto della carta \"%s%s%s\"? (" GRN "s" RESET "/" RED "n" RESET "):\n", owner_card->name, get_color_by_type(card->def->type), card->def->name, RESET);
+        bool choice = decide_yes_no(owner_card, DECISION_OPTIONAL_EFFECT, card, "> ", "[" RED "!" RESET "] Scelta non valida! Riprova!\n");
 
-        if (choice == 'n' || choice == 'N') {
-            printf("\n[" HBLU "i" RESET "] %s hai scelto di " RED "non attivare" RESET " l'effetto della carta \"%s%s%s\"!\n", owner_card->name, get_color_by_type(card->type), card->name, RESET);
+        if (!choice) {
+            print_msg("\n[" HBLU "i" RESET "] %s hai scelto di " RED "non attivare" RESET " l'effetto della carta \"%s%s%s\"!\n", owner_card->name, get_color_by_type(card->def->type), card->def->name, RESET);
             return;
         }
 
-        printf("\n[" HBLU "i" RESET "] %s hai scelto di " GRN "attivare" RESET " l'effetto della carta \"%s%s%s\"!\n", owner_card->name, get_color_by_type(card->type), card->name, RESET);
+        print_msg("\n[" HBLU "i" RESET "] %s hai scelto di " GRN "attivare" RESET " l'effetto della carta \"%s%s%s\"!\n", owner_card->name, get_color_by_type(card->def->type), card->def->name, RESET);
     }
 
-    // Inizializzazione delle variabili
-    bool blocked_effect = false;
-    Player* current_player = NULL;
-    Player* target_player = NULL;
-    Card* card_used_for_block = NULL;
+    // Stato condiviso dagli effetti della carta (il giocatore target degli effetti TU viene scelto una sola volta)
+    Effect_state state = {0};
+    state.card = card;
+    state.player = owner_card;
+    state.draw_deck = draw_deck;
+    state.discard_deck = discard_deck;
+
+    // Scorre tutti gli effetti della carta: ogni programma offre ai giocatori target di bloccare l'effetto e, SE nessuno lo blocca, lo applica.
+    // Se un giocatore blocca un effetto, gli effetti successivi della carta non vengono attivati.
+    for (int i = 0; i < card->def->num_effects && !state.blocked; i++) {
+        activate_effect(&state, i);
+    }
 
-    // Scorre tutti gli effetti della carta
-    for (int i = 0; i < card->num_effects && !blocked_effect; i++) {
-        // In base al giocatore target dell'effetto, controlla se l'effetto può essere bloccato e in caso affermativo chiede se bloccarlo
-        // altrimenti applica l'effetto
-        switch (card->effects[i].target_player) {
-            case IO:
-                target_player = NULL; // Ripristina il giocatore target (viene usato solo per gli effetti con target giocatore == TU)
-                //  Gli effetti con TargetGiocatore IO e quelli che si giocano su se stessi non dovrebbero triggerare la possibilità di giocare MAI.
-                activate_effect(card, &card->effects[i], owner_card, target_player, draw_deck, discard_deck); // Applica l'effetto
-                break;
-            case TU:
-                if (target_player == NULL) {
-                    // Chiede all'utente a quale giocatore applicare l'effetto
-                    target_player = choose_player(owner_card, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                }
+    return;
+}
 
-                // SE il giocatore target può bloccare l'effetto, chiedo SE vuole bloccarlo
-                if (can_block_effect(target_player, card) && ask_block_effect(target_player, card)) {
-                    // Blocca l'effetto utilizzando una carta ISTANTANEA
-                    card_used_for_block = block_effect(target_player, card, discard_deck);
-                    blocked_effect = true; // Imposta il flag di blocco a true
-                } else {
-                    activate_effect(card, &card->effects[i], owner_card, target_player, draw_deck, discard_deck); // Applica l'effetto
-                }
+/**
+ * @brief Interrompe il caricamento delle carte a causa di un effetto non valido.
+ * 
+ * @param definition Puntatore alla definizione della carta.
+ * @param effect_index Indice dell'effetto non valido.
+ * @param reason Motivo per cui l'effetto non è valido.
+ */
+static void reject_effect(const Card_definition* definition, int effect_index, const char* reason) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-                break;
-            case VOI:
-            case TUTTI: // IO non posso MAI difendermi da un effetto
-                target_player = NULL; // Ripristina il giocatore target (viene usato solo per gli effetti con target giocatore == TU)
-
-                current_player = owner_card->next_player; // Salto il giocatore corrente (me stesso => IO => owner_card)
-                do {
-                    // SE il giocatore target può bloccare l'effetto, chiedo SE vuole bloccarlo
-                    if (can_block_effect(current_player, card) && ask_block_effect(current_player, card)) {
-                        // Blocca l'effetto utilizzando una carta ISTANTANEA
-                        card_used_for_block = block_effect(current_player, card, discard_deck);
-                        blocked_effect = true; // Imposta il flag di blocco a true
-                    }
-                    current_player = current_player->next_player; // Passa al prossimo giocatore
-                } while (current_player != owner_card && !blocked_effect);
+    printf("\n[" RED "!" RESET "] Il %d° effetto della carta \"%s\" non è valido: %s!\n", effect_index+1, definition->name, reason);
+    exit(EXIT_FAILURE);
+}
 
-                // Se un giocatore decide di bloccare l'effetto della carta lo blocca per tutti i giocatori coinvolti
-                if (!blocked_effect) {
-                    activate_effect(card, &card->effects[i], owner_card, target_player, draw_deck, discard_deck); // Applica l'effetto
-                }
-                break;
-        }
-    }
+/**
+ * @brief Aggiunge un'operazione primitiva in coda al programma di un effetto.
+ * 
+ * @param program Puntatore al programma dell'effetto.
+ * @param op Operazione primitiva da aggiungere.
+ * @param arg Argomento dell'operazione.
+ * @return int Indice dell'istruzione aggiunta.
+ */
+static int emit_op(Effect_program* program, Effect_op op, int arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    return;
+    assert (program->length < MAX_EFFECT_PROGRAM_LENGTH && "Programma dell'effetto troppo lungo!");
+
+    Effect_instruction* instruction = &program->code[program->length];
+    instruction->op = (uint8_t) op;
+    instruction->arg = (uint8_t) arg;
+    instruction->jump = 0;
+
+    return program->length++;
 }
 
 /**
- * @brief Attiva un effetto di una carta.
+ * @brief Compila un effetto in un programma di operazioni primitive.
  * 
- * @param card Puntatore alla carta.
- * @param effect Puntatore all'effetto.
- * @param player Puntatore al giocatore che possiede la carta.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param draw_deck Puntatore al mazzo di pesca.
- * @param discard_deck Puntatore al mazzo degli scarti.
+ * Ogni programma sceglie il giocatore target (effetti TU), offre ai giocatori target di bloccare l'effetto (tranne che per IO)
+ * e poi esegue, in un ciclo sui giocatori target, le operazioni dell'azione: scelta della carta (con il filtro sul tipo),
+ * spostamento della carta e controllo degli effetti della carta spostata. Le combinazioni non valide interrompono il caricamento.
+ * 
+ * @param definition Puntatore alla definizione della carta.
+ * @param effect_index Indice dell'effetto da compilare.
+ * @param program Puntatore al programma da riempire.
  */
-void activate_effect(Card* card, Effect* effect, Player* player, Player* target_player, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static void compile_effect(const Card_definition* definition, int effect_index, Effect_program* program) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    const Effect* effect = &definition->effects[effect_index];
+    program->length = 0;
+
+    // SE uno dei campi dell'effetto è fuori dall'intervallo dei valori ammessi
+    if ((int) effect->action_effect < GIOCA || (int) effect->action_effect > INGEGNERE) {
+        reject_effect(definition, effect_index, "azione sconosciuta");
+    }
+    if ((int) effect->target_player < IO || (int) effect->target_player > TUTTI) {
+        reject_effect(definition, effect_index, "giocatore target sconosciuto");
+    }
+    if ((int) effect->target_card < ALL || (int) effect->target_card > ISTANTANEA) {
+        reject_effect(definition, effect_index, "tipo di carta target sconosciuto");
+    }
+
+    // Scelta del giocatore target e offerta del blocco (IO non può MAI difendersi dai propri effetti)
+    emit_op(program, OP_SELECT_TARGET, effect->target_player);
+    if (effect->target_player != IO) {
+        emit_op(program, OP_OFFER_BLOCK, effect->target_player);
+    }
+
+    // Gli effetti passivi vengono controllati altrove (es. can_play_istantanea): non hanno un ciclo sui giocatori target
+    if (effect->action_effect == BLOCCA || effect->action_effect == MOSTRA || effect->action_effect == IMPEDIRE || effect->action_effect == INGEGNERE) {
+        emit_op(program, OP_PASSIVE, effect->action_effect);
+        return;
+    }
 
-    // In base all'azione dell'effetto, attiva l'effetto
+    int loop_index = emit_op(program, OP_FOR_TARGETS, effect->target_player) + 1; // Prima istruzione del corpo del ciclo
+    int choose_index = -1; // Istruzione di scelta della carta (-1 SE l'azione non sceglie una carta)
+
+    // In base all'azione dell'effetto
     switch (effect->action_effect) {
-        case GIOCA:
-            // Attiva l'effetto di giocare una carta
-            gioca_effect(player, target_player, card, effect, draw_deck, discard_deck);
+        case ELIMINA:
+        case RUBA:
+            // Valori ammessi da effect->target_card per gli effetti ELIMINA e RUBA:
+            // STUDENTE, MATRICOLA, STUDENTE_SEMPLICE, LAUREANDO (aula studio)
+            // BONUS, MALUS (carte bonus/malus)
+            // ALL (qualsiasi carta presente nell'aula studio o bonus/malus)
+            if (effect->target_card == MAGIA || effect->target_card == ISTANTANEA) {
+                reject_effect(definition, effect_index, effect->action_effect == ELIMINA ? "tipo di carta non valido per l'effetto ELIMINA" : "tipo di carta non valido per l'effetto RUBA");
+            }
+
+            choose_index = emit_op(program, OP_CHOOSE_CARD, effect->target_card);
+            emit_op(program, OP_ANNOUNCE, 0);
+
+            if (effect->action_effect == ELIMINA) {
+                emit_op(program, OP_DISCARD, 0);
+                emit_op(program, OP_TRIGGER_TARGET, FINE);
+            } else {
+                emit_op(program, OP_STEAL, 0);
+                emit_op(program, OP_TRIGGER_TARGET, FINE);
+                emit_op(program, OP_GIVE, 0);
+                emit_op(program, OP_TRIGGER_PLAYER, SUBITO);
+            }
             break;
+
+        // Si assume che effect->target_card sia sempre ALL per gli effetti SCARTA e PRENDI
+        // in quanto, solitamente, non dovresti poter vedere la mano degli altri giocatori
+        // (a meno che non ci siano effetti malus che lo permettano) e quindi non poter vedere
+        // e scegliere il tipo richiesto di carta
         case SCARTA:
-            // Attiva l'effetto di scartare una carta
-            scarta_effect(player, target_player, card, effect, draw_deck, discard_deck);
+            choose_index = emit_op(program, OP_CHOOSE_HAND_CARD, 0);
+            emit_op(program, OP_ANNOUNCE, 0);
+            emit_op(program, OP_DISCARD, 0);
             break;
-        case ELIMINA:
-            // Attiva l'effetto di eliminare una carta
-            elimina_effect(player, target_player, card, effect, draw_deck, discard_deck);
+
+        case PRENDI:
+            choose_index = emit_op(program, OP_CHOOSE_HAND_CARD, 0);
+            emit_op(program, OP_STEAL, 0);
+            emit_op(program, OP_GIVE, 0);
+            emit_op(program, OP_ANNOUNCE, 0);
             break;
-        case RUBA:
-            // Attiva l'effetto di rubare una carta
-            ruba_effect(player, target_player, card, effect, draw_deck, discard_deck);
+
+        case GIOCA:
+            emit_op(program, OP_PLAY_CARD, effect->target_card);
             break;
+
         case PESCA:
-            // Attiva l'effetto di pescare una carta
-            pesca_effect(player, target_player, card, effect, draw_deck, discard_deck);
-            break;
-        case PRENDI:
-            // Attiva l'effetto di prendere una carta
-            prendi_effect(player, target_player, card, effect, draw_deck, discard_deck);
+            emit_op(program, OP_DRAW, 0);
             break;
+
         case SCAMBIA:
-            // Attiva l'effetto di scambiare una carta
-            scambia_effect(player, target_player, card, effect, draw_deck, discard_deck);
+            // Le carte in mano possono essere scambiate con un solo giocatore
+            if (effect->target_player == VOI || effect->target_player == TUTTI) {
+                reject_effect(definition, effect_index, "giocatore target non valido per l'effetto SCAMBIA");
+            }
+            emit_op(program, OP_SWAP_HANDS, 0);
             break;
-        // Gli effetti di default non fanno nulla
-        case BLOCCA:
-        case MOSTRA:
-        case IMPEDIRE:
-        case INGEGNERE:
+
         default:
-            printf("\n[" RED "!" RESET "] Attivazione dell'effetto di default!\n");
             break;
     }
 
-    return;
-}
-
-/**
- * @brief Controlla se un giocatore può bloccare l'effetto di una carta.
- * 
- * @param player Puntatore al giocatore.
- * @param card Puntatore alla carta da bloccare.
- * @return true Se il giocatore può bloccare l'effetto della carta, false altrimenti.
- */
-bool can_block_effect(Player* player, Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    bool can_block = false;     // Inizializza il flag di blocco a false
-    bool can_play_card = true; // Inizializza il flag di giocabilità della carta a true
-
-    // Scorre tutte le carte in mano del giocatore
-    for (Card* current_card = player->hand; current_card != NULL && !can_block; current_card = current_card->next_card) {
-        // SE la carta corrente è una carta ISTANTANEA
-        if (current_card->type == ISTANTANEA) {
-            // Controlla se la carta ISTANTANEA ha come effetto il blocco dell'effetto della carta
-            can_block = has_effect(current_card->effects, current_card->num_effects, BLOCCA, IO, card->type) || has_effect(current_card->effects, current_card->num_effects, BLOCCA, IO, ALL);
-        }
-    }
-
-    // SE il giocatore ha una carta ISTANTANEA che può bloccare l'effetto della carta
-    if (can_block) {
-        // Controlla se il giocatore ha delle carte MALUS che impediscono di giocare carte ISTANTANEE
-        printf("\n[" HBLU "i" RESET "] %s possiedi una carta " BHGRN "ISTANTANEA" RESET " che può bloccare l'effetto di \"%s%s%s\"!\n", player->name, get_color_by_type(card->type), card->name, RESET);
-
-        // Scorre tutte le carte del mazzo bonus/malus del giocatore
-        for (Card* current_card = player->magic_cards; current_card != NULL && can_play_card; current_card = current_card->next_card) {
-            // SE la carta corrente ha effetti e si attiva SEMPRE
-            if (current_card->num_effects > 0 && current_card->when_activate == SEMPRE) {
-                // Controlla se la carta corrente ha come effetto l'impedimento di giocare carte ISTANTANEE
-                can_play_card = !has_effect(current_card->effects, current_card->num_effects, IMPEDIRE, IO, ISTANTANEA);
-            }
-        }
+    int next_index = emit_op(program, OP_NEXT_TARGET, 0);
 
-        // SE il giocatore non può giocare carte ISTANTANEE
-        if (!can_play_card) {
-            printf("\n[" RED "!" RESET "] Tuttavia non puoi giocare una carta " BHGRN "ISTANTANEA" RESET ", a causa di un " BHRED "MALUS" RESET ", per bloccare l'effetto di \"%s%s%s\"!\n", player->name, get_color_by_type(card->type), card->name, RESET);
-        }
+    // Risolve i salti: senza carte da scegliere si passa al prossimo giocatore, altrimenti si ricomincia dal corpo del ciclo
+    if (choose_index >= 0) {
+        program->code[choose_index].jump = (uint8_t) next_index;
     }
+    program->code[next_index].jump = (uint8_t) loop_index;
 
-    // Restituisce true se il giocatore può bloccare l'effetto della carta e può giocare carte ISTANTANEE, altrimenti false
-    return can_block & can_play_card;
+    return;
 }
 
 /**
- * @brief Chiede al giocatore se vuole bloccare l'effetto di una carta.
+ * @brief Compila tutti gli effetti di una definizione di carta.
  * 
- * @param player Puntatore al giocatore.
- * @param card Puntatore alla carta da bloccare.
- * @return true Se il giocatore vuole bloccare l'effetto della carta, false altrimenti.
+ * Viene chiamata una sola volta per definizione, alla sua registrazione nella tabella globale.
+ * 
+ * @param definition Puntatore alla definizione della carta.
  */
-bool ask_block_effect(Player* player, Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void compile_card_effects(Card_definition* definition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    // Chiede all'utente se vuole bloccare l'effetto della carta
-    printf("\n[" HBLU "i" RESET "] %s vuoi bloccare l'effetto di \"%s%s%s\" utilizzando una carta " BHGRN "ISTANTANEA" RESET "? (" GRN "s" RESET "/" RED "n" RESET "):\n", player->name, get_color_by_type(card->type), card->name, RESET);
-    char choice = read_char("sSnN", "> ", "[" RED "!" RESET "] Scelta non valida! Riprova!\n");
+    // SE la carta non ha effetti => non c'è nulla da compilare
+    if (definition->num_effects <= 0) {
+        definition->programs = NULL;
+        return;
+    }
 
-    if (choice == 'n' || choice == 'N') {
-        printf("\n[" RED "-" RESET "] Hai scelto di " RED "non bloccare" RESET " l'effetto di \"%s%s%s\"!\n", get_color_by_type(card->type), card->name, RESET);
-        return false;
+    definition->programs = (Effect_program*) safe_calloc((size_t) definition->num_effects, sizeof(Effect_program));
+    for (int i = 0; i < definition->num_effects; i++) {
+        compile_effect(definition, i, &definition->programs[i]);
     }
 
-    printf("\n[" GRN "+" RESET "] Hai scelto di " GRN "bloccare" RESET " l'effetto di \"%s%s%s\"!\n", get_color_by_type(card->type), card->name, RESET);
-    return true;
+    return;
 }
 
 /**
- * @brief Blocca l'effetto di una carta utilizzando una carta ISTANTANEA.
+ * @brief Chiede al giocatore di scegliere una carta del giocatore target per gli effetti ELIMINA e RUBA.
  * 
- * @param player Puntatore al giocatore.
- * @param card Puntatore alla carta da bloccare.
- * @param discard_deck Puntatore al mazzo degli scarti.
- * @return Card* Puntatore alla carta ISTANTANEA giocata.
+ * @param player Puntatore al giocatore che sceglie.
+ * @param target_player Puntatore al giocatore target.
+ * @param effect Puntatore all'effetto.
+ * @param zone Puntatore al mazzo da cui è stata scelta la carta (aula studio o bonus/malus del giocatore target).
+ * @param card_index Puntatore all'indice della carta scelta nel mazzo.
+ * @return Card* Puntatore alla carta scelta (non scollegata), oppure NULL SE il giocatore target non ha carte del tipo richiesto.
  */
-Card* block_effect(Player* player, Card* card, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static Card* choose_target_card(Player* player, Player* target_player, const Effect* effect, Deck** zone, int* card_index) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    bool is_me = effect->target_player == IO; // I messaggi degli effetti su se stessi sono in seconda persona
+    const char* verb = effect->action_effect == ELIMINA ? "eliminare" : "rubare";
+    char* index_msg = effect->action_effect == ELIMINA ? "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> " : "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ";
+    Card* chosen_card = NULL;
+
+    // SE può essere scelta qualsiasi carta (aula studio + bonus/malus)
+    if (effect->target_card == ALL) {
+        int num_cards_classroom = count_cards(&target_player->classroom); // Numero di carte presenti nell'aula studio del giocatore target
+        int num_cards_magic = count_cards(&target_player->magic_cards);   // Numero di carte presenti nel mazzo bonus/malus del giocatore target
+
+        // SE il giocatore target non ha carte (aula studio + bonus/malus)
+        if ((num_cards_classroom + num_cards_magic) == 0) {
+            if (is_me) {
+                print_msg("\n[" RED "!" RESET "] Non hai carte da %s!\n", verb);
+            } else {
+                print_msg("\n[" RED "!" RESET "] %s non ha carte da %s!\n", target_player->name, verb);
+            }
+            return NULL;
+        }
 
-    // Chiede al giocatore di scegliere una carta ISTANTANEA da utilizzare per bloccare l'effetto della carta
-    printf("\n[" HBLU "i" RESET "] %s scegli una carta " BHGRN "ISTANTANEA" RESET " da utilizzare per bloccare l'effetto di \"%s%s%s\":\n\n", player->name, get_color_by_type(card->type), card->name, RESET);
-    print_deck(player->hand, "Carte in Mano", 0, false, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore
+        if (is_me) {
+            print_msg("\n[" HBLU "i" RESET "] %s scegli una carta da %s:\n\n", player->name, verb);
+        } else {
+            print_msg("\n[" HBLU "i" RESET "] %s scegli una carta da %s a %s:\n\n", player->name, verb, target_player->name);
+        }
+        print_deck(&target_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore target
+        print_msg("\n");
+        print_deck(&target_player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore target
 
-    // Inizializzazione delle variabili per la scelta della carta ISTANTANEA da utilizzare
-    int card_index;
-    Card* played_card;
-    bool is_valid = false;
-    do {
-        // Chiede all'utente di scegliere una carta ISTANTANEA da utilizzare
-        card_index = choice_card(player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da utilizzare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-        played_card = select_card(card_index, &player->hand, false); // Seleziona la carta scelta
+        // Chiede all'utente di scegliere una carta (aula studio + bonus/malus) del giocatore target
+        *card_index = decide_int(player, DECISION_CARD, 1, (num_cards_classroom+num_cards_magic), index_msg, "[" RED "!" RESET "] Indice non valido! Riprova!\n");
 
-        // SE la carta selezionata non è una carta ISTANTANEA
-        if (played_card->type != ISTANTANEA) {
-            printf("\n[" RED "!" RESET "] La carta selezionata non è una carta " BHGRN "ISTANTANEA" RESET "! Riprova!\n");
-        } else if (!has_effect(played_card->effects, played_card->num_effects, BLOCCA, IO, card->type) && !has_effect(played_card->effects, played_card->num_effects, BLOCCA, IO, ALL)) {
-            // SE la carta ISTANTANEA non può bloccare l'effetto della carta
-            printf("\n[" RED "!" RESET "] La carta selezionata non può bloccare l'effetto di \"%s%s%s\"! Riprova!\n", get_color_by_type(card->type), card->name, RESET);
+        // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio => la carta è nel mazzo bonus/malus
+        if (*card_index > num_cards_classroom) {
+            *zone = &target_player->magic_cards;
+            *card_index -= num_cards_classroom + 1;
         } else {
-            is_valid = true; // La carta selezionata è valida
+            *zone = &target_player->classroom;
+            *card_index -= 1;
         }
 
-    } while (!is_valid);
+        return select_card(*card_index, *zone, false);
+    }
 
-    printf("\n[" GRN "+" RESET "] Hai utilizzato una carta " BHGRN "ISTANTANEA" RESET " per bloccare l'effetto di \"%s%s%s\"!\n", get_color_by_type(card->type), card->name, RESET);
-    print_card(played_card); // Stampa la carta utilizzata per bloccare l'effetto
+    // Le carte STUDENTE, MATRICOLA, STUDENTE_SEMPLICE e LAUREANDO sono nell'aula studio, le carte BONUS e MALUS nel mazzo bonus/malus
+    bool is_classroom = effect->target_card != BONUS && effect->target_card != MALUS;
+    *zone = is_classroom ? &target_player->classroom : &target_player->magic_cards;
 
-    // Scollega effettivamente la carta dalla mano del giocatore
-    played_card = select_card(card_index, &player->hand, true);
+    // SE il giocatore target non ha carte del tipo richiesto
+    if (!deck_contains_type(*zone, effect->target_card)) {
+        if (is_me) {
+            print_msg("\n[" RED "!" RESET "] %s non hai carte di tipo %s%s%s da %s!\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, verb);
+        } else {
+            print_msg("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da %s!\n", target_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, verb);
+        }
+        return NULL;
+    }
 
-    // Registra l'azione di blocco dell'effetto della carta nel file di log
-    log_block_effect(player, played_card, card);
+    if (is_me) {
+        print_msg("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, verb);
+    } else {
+        print_msg("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da %s a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, verb, target_player->name);
+    }
+    if (is_classroom) {
+        print_deck(*zone, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore target
+    } else {
+        print_deck(*zone, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore target
+    }
 
-    // Applica l'effetto della carta istantanea, la carta viene scartata
-    discard_card(played_card, discard_deck);
+    bool is_valid_choice = false; // Flag per la validità della scelta dell'utente
+    do {
+        // Chiede all'utente di scegliere una carta del tipo richiesto
+        *card_index = choice_filtered_card(player, *zone, CARD_FILTER_TYPE, effect->target_card, NULL, index_msg, "[" RED "!" RESET "] Indice non valido! Riprova!\n");
+        chosen_card = select_card(*card_index, *zone, false); // Seleziona la carta scelta
 
-    return played_card;
+        // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
+        if (effect->target_card != STUDENTE && chosen_card->def->type != effect->target_card) {
+            print_msg("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
+        } else {
+            is_valid_choice = true; // La scelta dell'utente è valida
+        }
+    } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
+
+    return chosen_card;
 }
 
 /**
- * @brief Applica l'effetto di giocare una carta dalla propria mano.
+ * @brief Chiede al giocatore di scegliere una carta dalla mano del giocatore target per gli effetti SCARTA e PRENDI.
  * 
- * @param player Puntatore al giocatore.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta.
+ * @param player Puntatore al giocatore che sceglie.
+ * @param target_player Puntatore al giocatore target.
  * @param effect Puntatore all'effetto.
- * @param draw_deck Puntatore al mazzo di pesca.
- * @param discard_deck Puntatore al mazzo degli scarti.
+ * @param zone Puntatore in cui salvare il mazzo da cui è stata scelta la carta (la mano del giocatore target).
+ * @param card_index Puntatore all'indice della carta scelta nel mazzo.
+ * @return Card* Puntatore alla carta scelta (non scollegata), oppure NULL SE il giocatore target non ha carte in mano.
  */
-void gioca_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    Player* current_player = player; // Inizializza il giocatore corrente al giocatore proprietario della carta
+static Card* choose_hand_card(Player* player, Player* target_player, const Effect* effect, Deck** zone, int* card_index) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    bool is_me = effect->target_player == IO; // I messaggi degli effetti su se stessi sono in seconda persona
+    bool is_discard = effect->action_effect == SCARTA;
+    const char* verb = is_discard ? "scartare" : "prendere";
+    char* index_msg = is_discard ? "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da scartare:\n> " : "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da prendere:\n> ";
+
+    // SE il giocatore target non ha carte in mano
+    if (count_cards(&target_player->hand) == 0) {
+        if (is_me) {
+            print_msg("\n[" RED "!" RESET "] %s non hai carte in mano da %s!\n", player->name, verb);
+        } else {
+            print_msg("\n[" RED "!" RESET "] Il giocatore %s non ha carte in mano da %s!\n", target_player->name, verb);
+        }
+        return NULL;
+    }
 
-    // In base al giocatore target dell'effetto
-    switch (effect->target_player) {
-        case IO:
-            // SE il giocatore non ha carte giocabili
-            if (count_playable_cards(player, effect->target_card) == 0) {
-                printf("\n[" RED "!" RESET "] %s non hai carte giocabili!\n", player->name);
-            } else {
-                // Fa giocare una carta dalla mano del giocatore
-                play_hand(player, effect->target_card, draw_deck, discard_deck, true);
-            }
-            break;
+    if (is_me) {
+        print_msg(is_discard ? "\n[" HBLU "i" RESET "] %s scegli una carta da scartare:\n\n" : "\n[" HBLU "i" RESET "] %s scegli una carta da prendere dalla tua mano:\n\n", player->name);
+    } else {
+        print_msg("\n[" HBLU "i" RESET "] %s scegli una carta da %s dalla mano di %s:\n\n", player->name, verb, target_player->name);
+    }
 
-        case TU:
-            if (target_player == NULL) {
-                // Chiedere all'utente a quale giocatore applicare l'effetto
-                // Non dovrebbe mai essere NULL, ma per sicurezza lo controllo
-                target_player = choose_player(player, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-            }
+    // Controlla se il giocatore può vedere la mano del giocatore target (la propria o con effetti MOSTRA)
+    bool public_hand = deck_contains_effect(&target_player->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(&target_player->classroom, MOSTRA, IO, ALL);
+    bool show_hand = target_player == player || public_hand;
 
-            // SE il giocatore target non ha carte giocabili
-            if (count_playable_cards(target_player, effect->target_card) == 0) {
-                printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte giocabili!\n", target_player->name);
-            } else {
-                // Fa giocare una carta dalla mano del giocatore target
-                play_hand(target_player, effect->target_card, draw_deck, discard_deck, true);
-            }
-            break;
+    // SE la mano non è visibile a tutti (effetto MOSTRA) => viene stampata solo al giocatore che sceglie
+    set_output_recipient(public_hand ? NULL : player);
+    print_deck(&target_player->hand, "Carte in Mano", 0, !show_hand, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore target
+    set_output_recipient(NULL);
 
-        case VOI:
-            current_player = current_player->next_player; // Salta il giocatore corrente (me stesso => IO => player)
-            do {
-                // SE il giocatore corrente non ha carte giocabili
-                if (count_playable_cards(current_player, effect->target_card) == 0) {
-                    printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte giocabili!\n", current_player->name);
-                } else {
-                    // Fa giocare una carta dalla mano del giocatore corrente
-                    play_hand(current_player, effect->target_card, draw_deck, discard_deck, true);
-                }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non torna al giocatore iniziale
-            break;
+    // Chiede all'utente di scegliere una carta dalla mano del giocatore target
+    *zone = &target_player->hand;
+    *card_index = choice_card(player, *zone, index_msg, "[" RED "!" RESET "] Indice non valido! Riprova!\n");
 
-        case TUTTI:
-            do {
-                // SE il giocatore corrente non ha carte giocabili
-                if (count_playable_cards(current_player, effect->target_card) == 0) {
-                    printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte giocabili!\n", current_player->name);
-                } else {
-                    // Fa giocare una carta dalla mano del giocatore corrente
-                    play_hand(current_player, effect->target_card, draw_deck, discard_deck, true);
-                }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non torna al giocatore iniziale
-            break;
-    }
-    return;
+    return select_card(*card_index, *zone, false);
 }
 
 /**
- * @brief Applica l'effetto di scartare una carta dalla propria mano.
+ * @brief Stampa e registra nel file di log lo spostamento della carta scelta, in base all'azione dell'effetto.
  * 
- * @param player Puntatore al giocatore.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta.
+ * @param state Puntatore allo stato degli effetti della carta.
  * @param effect Puntatore all'effetto.
- * @param draw_deck Puntatore al mazzo di pesca.
- * @param discard_deck Puntatore al mazzo degli scarti.
  */
-void scarta_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    Player* current_player = player; // Inizializza il giocatore corrente al giocatore proprietario della carta
-    int card_index = 0;              // Inizializza l'indice della carta da scartare a 0
-    bool show_hand = false;          // Inizializza il flag per mostrare la mano del giocatore a false
-    Card* selected_card = NULL;      // Inizializza la carta selezionata a NULL
-
-    // Si assume che effect->target_card sia sempre ALL
-    // in quanto, solitamente, non dovresti poter vedere la mano degli altri giocatori
-    // (a meno che non ci siano effetti malus che lo permettano) e quindi non poter vedere
-    // e scegliere il tipo richiesto di carta da scartare
-
-    // In base al giocatore target dell'effetto
-    switch (effect->target_player) {
-        case IO:
-            // SE il giocatore non ha carte in mano
-            if (count_cards(player->hand) == 0) {
-                printf("\n[" RED "!" RESET "] %s non hai carte in mano da scartare!\n", player->name);
-            } else {
-                printf("\n[" HBLU "i" RESET "] %s scegli una carta da scartare:\n\n", player->name);
-                print_deck(player->hand, "Carte in Mano", 0, false, HAND_DECK_COLOR); // Stampa le carte in mano
-
-                // Chiede all'utente di scegliere una carta da scartare dalla mano
-                card_index = choice_card(player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da scartare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
+static void announce_move(const Effect_state* state, const Effect* effect) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-                printf("\n[" RED "-" RESET "] %s hai scartato una carta dalla tua mano!\n", player->name);
-                selected_card = select_card(card_index, &player->hand, false); // Seleziona la carta scelta dalla mano del giocatore
-                print_card(selected_card); // Stampa la carta scartata
+    Player* player = state->player;
+    Player* target_player = state->current_player;
 
-                // Registra l'azione di scartare la carta nel file di log
-                log_scarta_effect(player, player, selected_card);
-
-                // Seleziona, scollega e scarta la carta scelta dalla mano del giocatore
-                select_and_discard_card(card_index, &player->hand, discard_deck);
-            }
+    // In base all'azione dell'effetto
+    switch (effect->action_effect) {
+        case ELIMINA:
+            print_msg("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, target_player->name);
+            print_card(state->chosen_card); // Stampa la carta eliminata
+            log_elimina_effect(player, target_player, state->chosen_card); // Registra l'azione di eliminare la carta nel file di log
             break;
 
-        case TU:
-            if (target_player == NULL) {
-                // Chiedere all'utente a quale giocatore applicare l'effetto
-                // Non dovrebbe mai essere NULL, ma per sicurezza lo controllo
-                target_player = choose_player(player, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-            }
+        case RUBA:
+            print_msg("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, target_player->name);
+            print_card(state->chosen_card); // Stampa la carta rubata
+            log_ruba_effect(player, target_player, state->chosen_card); // Registra l'azione di rubare la carta nel file di log
+            break;
 
-            // SE il giocatore target non ha carte in mano
-            if (count_cards(target_player->hand) == 0) {
-                printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte in mano da scartare!\n", target_player->name);
+        case SCARTA:
+            if (effect->target_player == IO) {
+                print_msg("\n[" RED "-" RESET "] %s hai scartato una carta dalla tua mano!\n", player->name);
             } else {
-                printf("\n[" HBLU "i" RESET "] %s scegli una carta da scartare dalla mano di %s:\n\n", player->name, target_player->name);
-
-                // Controlla se il giocatore può vedere la mano del giocatore target (effetti MOSTRA)
-                show_hand = deck_contains_effect(target_player->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(target_player->classroom, MOSTRA, IO, ALL);
-                print_deck(target_player->hand, "Carte in Mano", 0, show_hand, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore target
-
-                // Chiede all'utente di scegliere una carta da scartare dalla mano del giocatore target
-                card_index = choice_card(target_player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da scartare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                printf("\n[" RED "-" RESET "] %s hai scartato una carta dalla mano di %s!\n", player->name, target_player->name);
-                selected_card = select_card(card_index, &target_player->hand, false); // Seleziona la carta scelta dalla mano del giocatore target
-                print_card(selected_card); // Stampa la carta scartata
-
-                // Registra l'azione di scartare la carta nel file di log
-                log_scarta_effect(player, target_player, selected_card);
-
-                // Seleziona, scollega e scarta la carta scelta dalla mano del giocatore target
-                select_and_discard_card(card_index, &target_player->hand, discard_deck);
+                print_msg("\n[" RED "-" RESET "] %s hai scartato una carta dalla mano di %s!\n", player->name, target_player->name);
             }
+            print_card(state->chosen_card); // Stampa la carta scartata
+            log_scarta_effect(player, target_player, state->chosen_card); // Registra l'azione di scartare la carta nel file di log
             break;
 
-        case VOI:
-            current_player = current_player->next_player; // Salta il giocatore corrente (me stesso => IO => player)
-            do {
-                // SE il giocatore corrente non ha carte in mano
-                if (count_cards(current_player->hand) == 0) {
-                    printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte in mano da scartare!\n", current_player->name);
-                } else {
-                    printf("\n[" HBLU "i" RESET "] %s scegli una carta da scartare dalla mano di %s:\n\n", player->name, current_player->name);
-
-                    // Controlla se il giocatore può vedere la mano del giocatore corrente (effetti MOSTRA)
-                    show_hand = deck_contains_effect(current_player->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(current_player->classroom, MOSTRA, IO, ALL);
-                    print_deck(current_player->hand, "Carte in Mano", 0, show_hand, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore corrente
-
-                    // Chiede all'utente di scegliere una carta da scartare dalla mano del giocatore corrente
-                    card_index = choice_card(current_player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da scartare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                    printf("\n[" RED "-" RESET "] %s hai scartato una carta dalla mano di %s!\n", player->name, current_player->name);
-                    selected_card = select_card(card_index, &current_player->hand, false); // Seleziona la carta scelta dalla mano del giocatore corrente
-                    print_card(selected_card); // Stampa la carta scartata
-
-                    // Registra l'azione di scartare la carta nel file di log
-                    log_scarta_effect(player, current_player, selected_card);
-
-                    // Seleziona, scollega e scarta la carta scelta dalla mano del giocatore corrente
-                    select_and_discard_card(card_index, &current_player->hand, discard_deck);
-                }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non torna al giocatore iniziale
+        case PRENDI:
+            print_msg("\n[" GRN "+" RESET "] %s hai preso una carta da %s!\n", player->name, target_player->name);
+            set_output_recipient(player); // La carta presa finisce nella mano del giocatore: è visibile solo a lui
+            print_card(state->chosen_card); // Stampa la carta presa
+            set_output_recipient(NULL);
+            log_prendi_effect(player, target_player, state->chosen_card); // Registra l'effetto di prendere una carta dalla mano di un giocatore
             break;
 
-        case TUTTI:
-            do {
-                // SE il giocatore corrente non ha carte in mano
-                if (count_cards(current_player->hand) == 0) {
-                    printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte in mano da scartare!\n", current_player->name);
-                } else {
-                    printf("\n[" HBLU "i" RESET "] %s scegli una carta da scartare dalla mano di %s:\n\n", player->name, current_player->name);
-
-                    // Controlla se il giocatore può vedere la mano del giocatore corrente (effetti MOSTRA) o se è il giocatore corrente
-                    show_hand = (player == current_player) || deck_contains_effect(current_player->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(current_player->classroom, MOSTRA, IO, ALL);
-                    print_deck(current_player->hand, "Carte in Mano", 0, show_hand, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore corrente
-
-                    // Chiede all'utente di scegliere una carta da scartare dalla mano del giocatore corrente
-                    card_index = choice_card(current_player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da scartare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                    printf("\n[" RED "-" RESET "] %s hai scartato una carta dalla mano di %s!\n", player->name, current_player->name);
-                    selected_card = select_card(card_index, &current_player->hand, false); // Seleziona la carta scelta dalla mano del giocatore corrente
-                    print_card(selected_card); // Stampa la carta scartata
-
-                    // Registra l'azione di scartare la carta nel file di log
-                    log_scarta_effect(player, current_player, selected_card);
-
-                    // Seleziona, scollega e scarta la carta scelta dalla mano del giocatore corrente
-                    select_and_discard_card(card_index, &current_player->hand, discard_deck);
-                }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non torna al giocatore iniziale
+        default:
             break;
     }
+
     return;
 }
 
 /**
- * @brief Applica l'effetto di eliminare una carta dall'aula studio o bonus/malus.
+ * @brief Offre ai giocatori target di un effetto di bloccarlo con una carta ISTANTANEA.
  * 
- * @param player Puntatore al giocatore.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta.
- * @param effect Puntatore all'effetto.
- * @param draw_deck Puntatore al mazzo di pesca.
- * @param discard_deck Puntatore al mazzo degli scarti.
+ * @param state Puntatore allo stato degli effetti della carta.
+ * @param target Giocatore target dell'effetto (TU, VOI o TUTTI).
+ * @return true Se un giocatore ha bloccato l'effetto, false altrimenti.
  */
-void elimina_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    Player* current_player = player; // Inizializza il giocatore corrente al giocatore proprietario della carta
-    int num_cards_classroom = 0, num_cards_magic = 0, card_index = 0; // Inizializza il numero di carte presenti nell'aula studio, nel mazzo bonus/malus e l'indice della carta scelta dall'utente a 0
-    Card* deleted_card = NULL; // Inizializza la carta eliminata a NULL
-    bool is_valid_choice = false; // Inizializza il flag per la validità della scelta dell'utente a false
-
-    // Valori ammessi da effect->target_card per l'effetto ELIMINA:
-    // STUDENTE, MATRICOLA, STUDENTE_SEMPLICE, LAUREANDO
-    // BONUS, MALUS
-    // ALL (qualsiasi carta presente nell'aula studio o bonus/malus)
-
-    // In base al giocatore target dell'effetto
-    switch (effect->target_player) {
-        case IO:
-            // In base al tipo di carta da eliminare 
-            switch (effect->target_card) {
-                case STUDENTE:
-                case MATRICOLA:
-                case STUDENTE_SEMPLICE:
-                case LAUREANDO:
-                    // SE il giocatore non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                    if (!deck_contains_type(player->classroom, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non hai carte di tipo %s%s%s da eliminare!\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        print_deck(player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore
-
-                        do {
-                            // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da eliminare
-                            card_index = choice_card(player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            deleted_card = select_card(card_index, &player->classroom, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                            if (effect->target_card != STUDENTE && deleted_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, player->name);
-                        print_card(deleted_card); // Stampa la carta eliminata
-
-                        // Registra l'azione di eliminare la carta nel file di log
-                        log_elimina_effect(player, player, deleted_card);
-
-                        // Seleziona e scarta la carta
-                        select_and_discard_card(card_index, &player->classroom, discard_deck);
-                        // Controlla e attiva eventuali effetti della carta eliminata
-                        check_effect(player, deleted_card, FINE, draw_deck, discard_deck);
-                    }
-                    break;
-
-                case BONUS:
-                case MALUS:
-                    // SE il giocatore non ha carte bonus/malus
-                    if (!deck_contains_type(player->magic_cards, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non hai carte di tipo %s%s%s da eliminare!\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        print_deck(player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte bonus/malus del giocatore
-
-                        do {
-                            // Chiede all'utente di scegliere una carta di tipo BONUS o MALUS da eliminare
-                            card_index = choice_card(player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            deleted_card = select_card(card_index, &player->magic_cards, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è del tipo richiesto
-                            if (deleted_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, player->name);
-                        print_card(deleted_card); // Stampa la carta eliminata
-
-                        // Registra l'azione di eliminare la carta nel file di log
-                        log_elimina_effect(player, player, deleted_card);
-
-                        // Seleziona e scarta la carta
-                        select_and_discard_card(card_index, &player->magic_cards, discard_deck);
-                        // Controlla e attiva eventuali effetti della carta eliminata
-                        check_effect(player, deleted_card, FINE, draw_deck, discard_deck);
-                    }
-                    break;
-
-                case ALL:
-                    num_cards_classroom = count_cards(player->classroom); // Conta il numero di carte presenti nell'aula studio
-                    num_cards_magic = count_cards(player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus
-
-                    // SE il giocatore non ha carte da eliminare (aula studio + bonus/malus)
-                    if ((num_cards_classroom + num_cards_magic) == 0) {
-                        printf("\n[" RED "!" RESET "] Non hai carte da eliminare!\n");
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta da eliminare:\n\n", player->name);
-                        print_deck(player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore
-                        printf("\n");
-                        print_deck(player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore
-
-                        // Chiede all'utente di scegliere una carta da eliminare (aula studio + bonus/malus)
-                        card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                        // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                        if (card_index > num_cards_classroom) {
-                            card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus
-                            deleted_card = select_card(card_index-1, &player->magic_cards, true); // Seleziona la carta scelta
-                        } else {
-                            // Altrimenti seleziona la carta nell'aula studio
-                            deleted_card = select_card(card_index-1, &player->classroom, true); // Seleziona la carta scelta
-                        }
-
-                        printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, player->name);
-                        print_card(deleted_card); // Stampa la carta eliminata
-
-                        // Registra l'azione di eliminare la carta nel file di log
-                        log_elimina_effect(player, player, deleted_card);
-
-                        // Scarta la carta selezionata
-                        discard_card(deleted_card, discard_deck);
-                        // Controlla e attiva eventuali effetti della carta eliminata
-                        check_effect(player, deleted_card, FINE, draw_deck, discard_deck);
-                    }
-                    break;
-
-                default:
-                    printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto ELIMINA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    break;
-            }
-            break;
-
-        case TU:
-            if (target_player == NULL) {
-                // Chiedere all'utente a quale giocatore applicare l'effetto
-                // Non dovrebbe mai essere NULL, ma per sicurezza lo controllo
-                target_player = choose_player(player, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-            }
-
-            // In base al tipo di carta da eliminare
-            switch (effect->target_card) {
-                case STUDENTE:
-                case MATRICOLA:
-                case STUDENTE_SEMPLICE:
-                case LAUREANDO:
-                    // SE il giocatore target non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                    if (!deck_contains_type(target_player->classroom, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da eliminare!\n", target_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, target_player->name);
-                        print_deck(target_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore target
-
-                        do {
-                            // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da eliminare al giocatore target
-                            card_index = choice_card(target_player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            deleted_card = select_card(card_index, &target_player->classroom, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                            if (effect->target_card != STUDENTE && deleted_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, target_player->name);
-                        print_card(deleted_card); // Stampa la carta eliminata
-
-                        // Registra l'azione di eliminare la carta nel file di log
-                        log_elimina_effect(player, target_player, deleted_card);
-
-                        // Seleziona e scarta la carta
-                        select_and_discard_card(card_index, &target_player->classroom, discard_deck);
-                        // Controlla e attiva eventuali effetti della carta eliminata
-                        check_effect(target_player, deleted_card, FINE, draw_deck, discard_deck);
-                    }
-                    break;
-
-                case BONUS:
-                case MALUS:
-                    // SE il giocatore target non ha carte bonus/malus
-                    if (!deck_contains_type(target_player->magic_cards, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da eliminare!\n", target_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, target_player->name);
-                        print_deck(target_player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore target
-
-                        do {
-                            // Chiede all'utente di scegliere una carta di tipo BONUS o MALUS da eliminare al giocatore target
-                            card_index = choice_card(target_player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            deleted_card = select_card(card_index, &target_player->magic_cards, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è del tipo richiesto
-                            if (deleted_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, target_player->name);
-                        print_card(deleted_card); // Stampa la carta eliminata
-
-                        // Registra l'azione di eliminare la carta nel file di log
-                        log_elimina_effect(player, target_player, deleted_card);
+static bool offer_block(Effect_state* state, Type_Player target) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE l'effetto è rivolto a un solo giocatore => solo lui può bloccarlo
+    if (target == TU) {
+        // SE il giocatore target può bloccare l'effetto, chiedo SE vuole bloccarlo
+        if (can_block_effect(state->target_player, state->card) && ask_block_effect(state->target_player, state->card)) {
+            block_effect(state->target_player, state->card, state->discard_deck); // Blocca l'effetto utilizzando una carta ISTANTANEA
+            return true;
+        }
+        return false;
+    }
 
-                        // Seleziona e scarta la carta
-                        select_and_discard_card(card_index, &target_player->magic_cards, discard_deck);
-                        // Controlla e attiva eventuali effetti della carta eliminata
-                        check_effect(target_player, deleted_card, FINE, draw_deck, discard_deck);
-                    }
-                    break;
+    // Con VOI e TUTTI lo chiede agli altri giocatori (IO non posso MAI difendermi da un effetto)
+    Player* current_player = state->player->next_player;
+    do {
+        // SE il giocatore corrente può bloccare l'effetto, chiedo SE vuole bloccarlo
+        // (SE un giocatore decide di bloccare l'effetto della carta lo blocca per tutti i giocatori coinvolti)
+        if (can_block_effect(current_player, state->card) && ask_block_effect(current_player, state->card)) {
+            block_effect(current_player, state->card, state->discard_deck); // Blocca l'effetto utilizzando una carta ISTANTANEA
+            return true;
+        }
+        current_player = current_player->next_player; // Passa al prossimo giocatore
+    } while (current_player != state->player);
 
-                case ALL:
-                    num_cards_classroom = count_cards(target_player->classroom); // Conta il numero di carte presenti nell'aula studio del giocatore target
-                    num_cards_magic = count_cards(target_player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus del giocatore target
+    return false;
+}
 
-                    // SE il giocatore target non ha carte da eliminare (aula studio + bonus/malus)
-                    if ((num_cards_classroom + num_cards_magic) == 0) {
-                        printf("\n[" RED "!" RESET "] %s non ha carte da eliminare!\n", target_player->name);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta da eliminare a %s:\n\n", player->name, target_player->name);
-                        print_deck(target_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore target
-                        printf("\n");
-                        print_deck(target_player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore target
-
-                        // Chiede all'utente di scegliere una carta da eliminare (aula studio + bonus/malus) al giocatore target
-                        card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                        // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                        if (card_index > num_cards_classroom) {
-                            card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus del giocatore target
-                            deleted_card = select_card(card_index-1, &target_player->magic_cards, true); // Seleziona la carta scelta
-                        } else {
-                            // Altrimenti seleziona la carta nell'aula studio del giocatore target
-                            deleted_card = select_card(card_index-1, &target_player->classroom, true); // Seleziona la carta scelta
-                        }
-
-                        printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, target_player->name);
-                        print_card(deleted_card); // Stampa la carta eliminata
-
-                        // Registra l'azione di eliminare la carta nel file di log
-                        log_elimina_effect(player, target_player, deleted_card);
-
-                        // Scarta la carta selezionata
-                        discard_card(deleted_card, discard_deck);
-                        // Controlla e attiva eventuali effetti della carta eliminata
-                        check_effect(target_player, deleted_card, FINE, draw_deck, discard_deck);
-                    }
-                    break;
+/**
+ * @brief Attiva un effetto di una carta eseguendo il programma compilato al caricamento.
+ * 
+ * @param state Puntatore allo stato degli effetti della carta (condiviso dagli effetti della stessa carta).
+ * @param effect_index Indice dell'effetto nella definizione della carta.
+ */
+void activate_effect(Effect_state* state, int effect_index) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    const Effect* effect = &state->card->def->effects[effect_index];
+    const Effect_program* program = &state->card->def->programs[effect_index]; // Programma compilato dell'effetto
+    Player* player = state->player; // Giocatore che possiede la carta
+
+    int pc = 0; // Indice dell'istruzione corrente
+    while (pc < program->length) {
+        const Effect_instruction* instruction = &program->code[pc++];
+
+        switch ((Effect_op) instruction->op) {
+            case OP_SELECT_TARGET:
+                // SE l'effetto non è rivolto a un solo giocatore => azzera il giocatore target (viene usato solo per gli effetti TU)
+                if ((Type_Player) instruction->arg != TU) {
+                    state->target_player = NULL;
+                } else if (state->target_player == NULL) {
+                    // Chiede all'utente a quale giocatore applicare l'effetto
+                    state->target_player = choose_player(player, false, NULL, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
+                }
+                break;
 
-                default:
-                    printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto ELIMINA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    break;
-            }
-            break;
+            case OP_OFFER_BLOCK:
+                // SE un giocatore blocca l'effetto => il programma termina
+                if (offer_block(state, (Type_Player) instruction->arg)) {
+                    state->blocked = true;
+                    pc = program->length;
+                }
+                break;
 
-        case VOI:
-            current_player = current_player->next_player; // Salta il giocatore corrente (me stesso => IO => player)
-            do {
-                // In base al tipo di carta da eliminare
-                switch (effect->target_card) {
-                    case STUDENTE:
-                    case MATRICOLA:
-                    case STUDENTE_SEMPLICE:
-                    case LAUREANDO:
-                        // SE il giocatore corrente non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                        if (!deck_contains_type(current_player->classroom, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da eliminare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-
-                            do {
-                                // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da eliminare al giocatore corrente
-                                card_index = choice_card(current_player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                deleted_card = select_card(card_index, &current_player->classroom, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                                if (effect->target_card != STUDENTE && deleted_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, current_player->name);
-                            print_card(deleted_card); // Stampa la carta eliminata
-
-                            // Registra l'azione di eliminare la carta nel file di log
-                            log_elimina_effect(player, current_player, deleted_card);
-
-                            // Seleziona e scarta la carta
-                            select_and_discard_card(card_index, &current_player->classroom, discard_deck);
-                            // Controlla e attiva eventuali effetti della carta eliminata
-                            check_effect(current_player, deleted_card, FINE, draw_deck, discard_deck);
-                        }
+            case OP_FOR_TARGETS:
+                // In base al giocatore target dell'effetto
+                switch ((Type_Player) instruction->arg) {
+                    case IO:
+                        state->current_player = player;
+                        state->end_player = player->next_player;
                         break;
-
-                    case BONUS:
-                    case MALUS:
-                        // SE il giocatore corrente non ha carte bonus/malus
-                        if (!deck_contains_type(current_player->magic_cards, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da eliminare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            do {
-                                // Chiede all'utente di scegliere una carta di tipo BONUS o MALUS da eliminare al giocatore corrente
-                                card_index = choice_card(current_player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                deleted_card = select_card(card_index, &current_player->magic_cards, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è del tipo richiesto
-                                if (deleted_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, current_player->name);
-                            print_card(deleted_card); // Stampa la carta eliminata
-
-                            // Registra l'azione di eliminare la carta nel file di log
-                            log_elimina_effect(player, current_player, deleted_card);
-
-                            // Seleziona e scarta la carta
-                            select_and_discard_card(card_index, &current_player->magic_cards, discard_deck);
-                            // Controlla e attiva eventuali effetti della carta eliminata
-                            check_effect(current_player, deleted_card, FINE, draw_deck, discard_deck);
-                        }
+                    case TU:
+                        state->current_player = state->target_player;
+                        state->end_player = state->target_player->next_player;
                         break;
-
-                    case ALL:
-                        num_cards_classroom = count_cards(current_player->classroom); // Conta il numero di carte presenti nell'aula studio del giocatore corrente
-                        num_cards_magic = count_cards(current_player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                        // SE il giocatore corrente non ha carte da eliminare (aula studio + bonus/malus)
-                        if ((num_cards_classroom + num_cards_magic) == 0) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte da eliminare!\n", current_player->name);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-                            printf("\n");
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            // Chiede all'utente di scegliere una carta da eliminare (aula studio + bonus/malus) al giocatore corrente
-                            card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                            // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                            if (card_index > num_cards_classroom) {
-                                card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus del giocatore corrente
-                                deleted_card = select_card(card_index-1, &current_player->magic_cards, true); // Seleziona la carta scelta
-                            } else {
-                                // Altrimenti seleziona la carta nell'aula studio del giocatore corrente
-                                deleted_card = select_card(card_index-1, &current_player->classroom, true); // Seleziona la carta scelta
-                            }
-
-                            printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, current_player->name);
-                            print_card(deleted_card); // Stampa la carta eliminata
-
-                            // Registra l'azione di eliminare la carta nel file di log
-                            log_elimina_effect(player, current_player, deleted_card);
-
-                            // Scarta la carta selezionata
-                            discard_card(deleted_card, discard_deck);
-                            // Controlla e attiva eventuali effetti della carta eliminata
-                            check_effect(current_player, deleted_card, FINE, draw_deck, discard_deck);
-                        }
+                    case VOI:
+                        state->current_player = player->next_player; // Salta il giocatore proprietario della carta
+                        state->end_player = player;
                         break;
-
-                    default:
-                        printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto ELIMINA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
+                    case TUTTI:
+                        state->current_player = player;
+                        state->end_player = player;
                         break;
                 }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non torna al giocatore iniziale
-            break;
-
-        case TUTTI:
-            do {
-                // In base al tipo di carta da eliminare
-                switch (effect->target_card) {
-                    case STUDENTE:
-                    case MATRICOLA:
-                    case STUDENTE_SEMPLICE:
-                    case LAUREANDO:
-                        // SE il giocatore corrente non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                        if (!deck_contains_type(current_player->classroom, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da eliminare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-
-                            do {
-                                // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da eliminare al giocatore corrente
-                                card_index = choice_card(current_player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                deleted_card = select_card(card_index, &current_player->classroom, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                                if (effect->target_card != STUDENTE && deleted_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, current_player->name);
-                            print_card(deleted_card); // Stampa la carta eliminata
-
-                            // Registra l'azione di eliminare la carta nel file di log
-                            log_elimina_effect(player, current_player, deleted_card);
-
-                            // Seleziona e scarta la carta
-                            select_and_discard_card(card_index, &current_player->classroom, discard_deck);
-                            // Controlla e attiva eventuali effetti della carta eliminata
-                            check_effect(current_player, deleted_card, FINE, draw_deck, discard_deck);
-                        }
-                        break;
-
-                    case BONUS:
-                    case MALUS:
-                        // SE il giocatore corrente non ha carte bonus/malus
-                        if (!deck_contains_type(current_player->magic_cards, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da eliminare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            do {
-                                // Chiede all'utente di scegliere una carta di tipo BONUS o MALUS da eliminare al giocatore corrente
-                                card_index = choice_card(current_player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                deleted_card = select_card(card_index, &current_player->magic_cards, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è del tipo richiesto
-                                if (deleted_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, current_player->name);
-                            print_card(deleted_card); // Stampa la carta eliminata
-
-                            // Registra l'azione di eliminare la carta nel file di log
-                            log_elimina_effect(player, current_player, deleted_card);
-
-                            // Seleziona e scarta la carta
-                            select_and_discard_card(card_index, &current_player->magic_cards, discard_deck);
-                            // Controlla e attiva eventuali effetti della carta eliminata
-                            check_effect(current_player, deleted_card, FINE, draw_deck, discard_deck);
-                        }
-                        break;
+                break;
 
-                    case ALL:
-                        num_cards_classroom = count_cards(current_player->classroom); // Conta il numero di carte presenti nell'aula studio del giocatore corrente
-                        num_cards_magic = count_cards(current_player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                        // SE il giocatore corrente non ha carte da eliminare (aula studio + bonus/malus)
-                        if ((num_cards_classroom + num_cards_magic) == 0) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte da eliminare!\n", current_player->name);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da eliminare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-                            printf("\n");
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            // Chiede all'utente di scegliere una carta da eliminare (aula studio + bonus/malus) al giocatore corrente
-                            card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da eliminare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                            // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                            if (card_index > num_cards_classroom) {
-                                card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus del giocatore corrente
-                                deleted_card = select_card(card_index-1, &current_player->magic_cards, true); // Seleziona la carta scelta
-                            } else {
-                                // Altrimenti seleziona la carta nell'aula studio del giocatore corrente
-                                deleted_card = select_card(card_index-1, &current_player->classroom, true); // Seleziona la carta scelta
-                            }
-
-                            printf("\n[" RED "-" RESET "] %s hai eliminato una carta a %s!\n", player->name, current_player->name);
-                            print_card(deleted_card); // Stampa la carta eliminata
-
-                            // Registra l'azione di eliminare la carta nel file di log
-                            log_elimina_effect(player, current_player, deleted_card);
-
-                            // Scarta la carta selezionata
-                            discard_card(deleted_card, discard_deck);
-                            // Controlla e attiva eventuali effetti della carta eliminata
-                            check_effect(current_player, deleted_card, FINE, draw_deck, discard_deck);
-                        }
-                        break;
+            case OP_CHOOSE_CARD:
+                state->chosen_card = choose_target_card(player, state->current_player, effect, &state->zone, &state->card_index);
 
-                    default:
-                        printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto ELIMINA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        break;
+                // SE il giocatore target non ha carte del tipo richiesto => passa al prossimo giocatore
+                if (state->chosen_card == NULL) {
+                    pc = instruction->jump;
                 }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non torna al giocatore iniziale
-            break;
-    }
-    return;
-}
+                break;
 
-/**
- * @brief Applica l'effetto di rubare una carta dall'aula studio o bonus/malus.
- * 
- * @param player Puntatore al giocatore.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta.
- * @param effect Puntatore all'effetto.
- * @param draw_deck Puntatore al mazzo di pesca.
- * @param discard_deck Puntatore al mazzo degli scarti.
- */
-void ruba_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    Player* current_player = player; // Inizializza il giocatore corrente al giocatore proprietario della carta
-    int num_cards_classroom = 0, num_cards_magic = 0, card_index = 0; // Inizializza il numero di carte presenti nell'aula studio, nel mazzo bonus/malus e l'indice della carta scelta dall'utente a 0
-    Card* stealed_card = NULL; // Inizializza la carta rubata a NULL
-    bool is_valid_choice = false; // Inizializza la validità della scelta dell'utente a false
-
-    // Valori ammessi da effect->target_card per l'effetto RUBA:
-    // STUDENTE, MATRICOLA, STUDENTE_SEMPLICE, LAUREANDO
-    // BONUS, MALUS
-    // ALL (qualsiasi carta presente nell'aula studio o bonus/malus)
-
-    // In base al giocatore target dell'effetto
-    switch (effect->target_player) {
-        case IO:
-            // In base al tipo di carta da rubare
-            switch (effect->target_card) {
-                case STUDENTE:
-                case MATRICOLA:
-                case STUDENTE_SEMPLICE:
-                case LAUREANDO:
-                    // SE il giocatore non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                    if (!deck_contains_type(player->classroom, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non hai carte di tipo %s%s%s da rubare!\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        print_deck(player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore
-
-                        do {
-                            // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da rubare al giocatore
-                            card_index = choice_card(player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            stealed_card = select_card(card_index, &player->classroom, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                            if (effect->target_card != STUDENTE && stealed_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, player->name);
-                        print_card(stealed_card); // Stampa la carta rubata
-
-                        // Registra l'azione di rubare la carta nel file di log
-                        log_ruba_effect(player, player, stealed_card);
-
-                        // Seleziona e scollega la carta
-                        stealed_card = select_card(card_index, &player->classroom, true);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(player, stealed_card, FINE, draw_deck, discard_deck);
-                        // Aggiungi la carta rubata all'aula studio del giocatore
-                        player->classroom = add_card(player->classroom, stealed_card);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                    }
-                    break;
+            case OP_CHOOSE_HAND_CARD:
+                state->chosen_card = choose_hand_card(player, state->current_player, effect, &state->zone, &state->card_index);
 
-                case BONUS:
-                case MALUS:
-                    // SE il giocatore non ha carte bonus/malus
-                    if (!deck_contains_type(player->magic_cards, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non hai carte di tipo %s%s%s da rubare!\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        print_deck(player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore
-
-                        do {
-                            // Chiede all'utente di scegliere una carta di tipo BONUS o MALUS da rubare al giocatore
-                            card_index = choice_card(player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            stealed_card = select_card(card_index, &player->magic_cards, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è del tipo richiesto
-                            if (stealed_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, player->name);
-                        print_card(stealed_card); // Stampa la carta rubata
-
-                        // Registra l'azione di rubare la carta nel file di log
-                        log_ruba_effect(player, player, stealed_card);
-
-                        // Seleziona e scollega la carta
-                        stealed_card = select_card(card_index, &player->magic_cards, true);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(player, stealed_card, FINE, draw_deck, discard_deck);
-                        // Aggiungi la carta rubata all'aula studio del giocatore
-                        player->magic_cards = add_card(player->magic_cards, stealed_card);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                    }
-                    break;
+                // SE il giocatore target non ha carte in mano => passa al prossimo giocatore
+                if (state->chosen_card == NULL) {
+                    pc = instruction->jump;
+                }
+                break;
 
-                case ALL:
-                    num_cards_classroom = count_cards(player->classroom); // Conta il numero di carte presenti nell'aula studio del giocatore
-                    num_cards_magic = count_cards(player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus del giocatore
+            case OP_ANNOUNCE:
+                announce_move(state, effect);
+                break;
 
-                    // SE il giocatore non ha carte da rubare (aula studio + bonus/malus)
-                    if ((num_cards_classroom + num_cards_magic) == 0) {
-                        printf("\n[" RED "!" RESET "] Non hai carte da rubare!\n");
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        print_deck(player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore
-                        printf("\n");
-                        print_deck(player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore
-
-                        // Chiede all'utente di scegliere una carta da rubare (aula studio + bonus/malus) al giocatore
-                        card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                        // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                        if (card_index > num_cards_classroom) {
-                            card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus del giocatore
-                            stealed_card = select_card(card_index-1, &player->magic_cards, true); // Seleziona e scollega la carta
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, player, stealed_card);
-
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->magic_cards = add_card(player->magic_cards, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        } else {
-                            // Altrimenti seleziona la carta nell'aula studio del giocatore
-                            stealed_card = select_card(card_index-1, &player->classroom, true); // Seleziona e scollega la carta
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, player, stealed_card);
-
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->classroom = add_card(player->classroom, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        }
-                    }
-                    break;
+            case OP_DISCARD:
+                // Seleziona e scarta la carta
+                select_and_discard_card(state->card_index, state->zone, state->discard_deck);
+                break;
 
-                default:
-                    printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto RUBA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    break;
-            }
-            break;
+            case OP_STEAL:
+                // Seleziona e scollega la carta
+                select_card(state->card_index, state->zone, true);
+                break;
 
-        case TU:
-            if (target_player == NULL) {
-                // Chiedere all'utente a quale giocatore applicare l'effetto
-                // Non dovrebbe mai essere NULL, ma per sicurezza lo controllo
-                target_player = choose_player(player, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
+            case OP_GIVE: {
+                // Aggiunge la carta alla stessa zona (mano, aula studio o bonus/malus) del giocatore
+                Deck* destination = &player->magic_cards;
+                if (state->zone == &state->current_player->classroom) {
+                    destination = &player->classroom;
+                } else if (state->zone == &state->current_player->hand) {
+                    destination = &player->hand;
+                }
+                add_card(destination, state->chosen_card);
+                break;
             }
 
-            // In base al tipo di carta da rubare
-            switch (effect->target_card) {
-                case STUDENTE:
-                case MATRICOLA:
-                case STUDENTE_SEMPLICE:
-                case LAUREANDO:
-                    // SE il giocatore target non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                    if (!deck_contains_type(target_player->classroom, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da rubare!\n", target_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, target_player->name);
-                        print_deck(target_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore target
-
-                        do {
-                            // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da rubare al giocatore target
-                            card_index = choice_card(target_player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            stealed_card = select_card(card_index, &target_player->classroom, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                            if (effect->target_card != STUDENTE && stealed_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, target_player->name);
-                        print_card(stealed_card); // Stampa la carta rubata
-
-                        // Registra l'azione di rubare la carta nel file di log
-                        log_ruba_effect(player, target_player, stealed_card);
-
-                        // Seleziona e scollega la carta
-                        stealed_card = select_card(card_index, &target_player->classroom, true);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(target_player, stealed_card, FINE, draw_deck, discard_deck);
-                        // Aggiungi la carta rubata all'aula studio del giocatore
-                        player->classroom = add_card(player->classroom, stealed_card);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                    }
-                    break;
-
-                case BONUS:
-                case MALUS:
-                    // SE il giocatore target non ha carte bonus/malus
-                    if (!deck_contains_type(target_player->magic_cards, effect->target_card)) {
-                        printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da rubare!\n", target_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
+            case OP_PLAY_CARD:
+                // SE il giocatore target non ha carte giocabili
+                if (count_playable_cards(state->current_player, (Type_card) instruction->arg) == 0) {
+                    if (effect->target_player == IO) {
+                        print_msg("\n[" RED "!" RESET "] %s non hai carte giocabili!\n", player->name);
                     } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, target_player->name);
-                        print_deck(target_player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore target
-
-                        do {
-                            card_index = choice_card(target_player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                            stealed_card = select_card(card_index, &target_player->magic_cards, false); // Seleziona la carta scelta
-
-                            // SE la carta selezionata non è del tipo richiesto
-                            if (stealed_card->type != effect->target_card) {
-                                printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                            } else {
-                                is_valid_choice = true; // La scelta dell'utente è valida
-                            }
-
-                        } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                        printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, target_player->name);
-                        print_card(stealed_card); // Stampa la carta rubata
-
-                        // Registra l'azione di rubare la carta nel file di log
-                        log_ruba_effect(player, target_player, stealed_card);
-
-                        // Seleziona e scollega la carta
-                        stealed_card = select_card(card_index, &target_player->magic_cards, true);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(target_player, stealed_card, FINE, draw_deck, discard_deck);
-                        // Aggiungi la carta rubata all'aula studio del giocatore
-                        player->magic_cards = add_card(player->magic_cards, stealed_card);
-                        // Controlla e attiva eventuali effetti della carta rubata
-                        check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
+                        print_msg("\n[" RED "!" RESET "] Il giocatore %s non ha carte giocabili!\n", state->current_player->name);
                     }
-                    break;
-
-                case ALL:
-                    num_cards_classroom = count_cards(target_player->classroom); // Conta il numero di carte presenti nell'aula studio del giocatore target
-                    num_cards_magic = count_cards(target_player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus del giocatore target 
-
-                    // SE il giocatore target non ha carte da rubare (aula studio + bonus/malus)
-                    if ((num_cards_classroom + num_cards_magic) == 0) {
-                        printf("\n[" RED "!" RESET "] %s non ha carte da rubare!\n", target_player->name);
-                    } else {
-                        printf("\n[" HBLU "i" RESET "] %s scegli una carta da rubare a %s:\n\n", player->name, target_player->name);
-                        print_deck(target_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore target
-                        printf("\n");
-                        print_deck(target_player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore target
-
-                        // Chiede all'utente di scegliere una carta da rubare (aula studio + bonus/malus) al giocatore target
-                        card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                        // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                        if (card_index > num_cards_classroom) {
-                            card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus del giocatore target
-                            stealed_card = select_card(card_index-1, &target_player->magic_cards, true); // Seleziona e scollega la carta
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, target_player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, target_player, stealed_card);
-
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(target_player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->magic_cards = add_card(player->magic_cards, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        } else {
-                            // Altrimenti seleziona la carta nell'aula studio del giocatore target
-                            stealed_card = select_card(card_index-1, &target_player->classroom, true); // Seleziona e scollega la carta
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, target_player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, target_player, stealed_card);
-
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(target_player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->classroom = add_card(player->classroom, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        }
-                    }
-                    break;
+                } else {
+                    // Fa giocare una carta dalla mano del giocatore target
+                    play_hand(state->current_player, (Type_card) instruction->arg, state->draw_deck, state->discard_deck, true);
+                }
+                break;
 
-                default:
-                    printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto RUBA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                    break;
+            case OP_DRAW: {
+                Player* target_player = state->current_player;
+                draw_card(&target_player, state->draw_deck, state->discard_deck, false); // Pesca una carta
+                print_msg("\n[" GRN "+" RESET "] %s hai pescato una carta!\n", target_player->name);
+                set_output_recipient(target_player); // La carta pescata è visibile solo al giocatore che l'ha pescata
+                print_card(
+                    select_card(count_cards(&target_player->hand)-1, &target_player->hand, false) // Seleziona l'ultima carta pescata
+                ); // Stampa la carta pescata
+                set_output_recipient(NULL);
+                break;
             }
-            break;
 
-        case VOI:
-            current_player = current_player->next_player; // Passa al prossimo giocatore
-            do {
-                // In base al tipo di carta da rubare
-                switch (effect->target_card) {
-                    case STUDENTE:
-                    case MATRICOLA:
-                    case STUDENTE_SEMPLICE:
-                    case LAUREANDO:
-                        // SE il giocatore corrente non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                        if (!deck_contains_type(current_player->classroom, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da rubare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-
-                            do {
-                                // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da rubare al giocatore corrente
-                                card_index = choice_card(current_player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                stealed_card = select_card(card_index, &current_player->classroom, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                                if (effect->target_card != STUDENTE && stealed_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, current_player, stealed_card);
-
-                            // Seleziona e scollega la carta
-                            stealed_card = select_card(card_index, &current_player->classroom, true);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->classroom = add_card(player->classroom, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        }
-                        break;
+            case OP_SWAP_HANDS:
+                print_msg("\n[" HBLU "i" RESET "] Carte in mano di %s scambiate con le carte in mano di %s!\n", player->name, state->current_player->name);
 
-                    case BONUS:
-                    case MALUS:
-                        // SE il giocatore corrente non ha carte bonus/malus
-                        if (!deck_contains_type(current_player->magic_cards, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da rubare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            do {
-                                card_index = choice_card(current_player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                stealed_card = select_card(card_index, &current_player->magic_cards, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è del tipo richiesto
-                                if (stealed_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, current_player, stealed_card);
-
-                            // Seleziona e scollega la carta
-                            stealed_card = select_card(card_index, &current_player->magic_cards, true);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->magic_cards = add_card(player->magic_cards, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        }
-                        break;
+                // Scambia le carte in mano tra il giocatore e il giocatore target
+                // (scambiare le carte con se stessi non ha senso, ma per completezza viene gestito)
+                if (state->current_player != player) {
+                    swap_decks(&player->hand, &state->current_player->hand);
+                }
 
-                    case ALL:
-                        num_cards_classroom = count_cards(current_player->classroom); // Conta il numero di carte presenti nell'aula studio del giocatore corrente
-                        num_cards_magic = count_cards(current_player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                        // SE il giocatore corrente non ha carte da rubare (aula studio + bonus/malus)
-                        if ((num_cards_classroom + num_cards_magic) == 0) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte da rubare!\n", current_player->name);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta da rubare a %s:\n\n", player->name, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-                            printf("\n");
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            // Chiede all'utente di scegliere una carta da rubare (aula studio + bonus/malus) al giocatore corrente
-                            card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                            // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                            if (card_index > num_cards_classroom) {
-                                card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus del giocatore corrente
-                                stealed_card = select_card(card_index-1, &current_player->magic_cards, true); // Seleziona e scollega la carta
-
-                                printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                                print_card(stealed_card); // Stampa la carta rubata
-
-                                // Registra l'azione di rubare la carta nel file di log
-                                log_ruba_effect(player, current_player, stealed_card);
-
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                                // Aggiungi la carta rubata all'aula studio del giocatore
-                                player->magic_cards = add_card(player->magic_cards, stealed_card);
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                            } else {
-                                // Altrimenti seleziona la carta nell'aula studio del giocatore corrente
-                                stealed_card = select_card(card_index-1, &current_player->classroom, true); // Seleziona e scollega la carta
-
-                                printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                                print_card(stealed_card); // Stampa la carta rubata
-
-                                // Registra l'azione di rubare la carta nel file di log
-                                log_ruba_effect(player, current_player, stealed_card);
-
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                                // Aggiungi la carta rubata all'aula studio del giocatore
-                                player->classroom = add_card(player->classroom, stealed_card);
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                            }
-                        }
-                        break;
+                // Le due mani sono visibili solo al giocatore che ha attivato lo scambio
+                set_output_recipient(player);
+                print_msg("\n");
+                print_deck(&state->current_player->hand, "Vecchia Mano", 0, false, DISCARD_DECK_COLOR); // Stampa la vecchia mano del giocatore
+                print_msg("\n");
+                print_deck(&player->hand, "Nuova Mano", 0, false, HAND_DECK_COLOR); // Stampa la nuova mano del giocatore
+                set_output_recipient(NULL);
 
-                    default:
-                        printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto RUBA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        break;
-                }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non si torna al giocatore iniziale
-            break;
+                log_scambia_effect(player, state->current_player); // Registra l'effetto di scambiare le carte in mano tra due giocatori
+                break;
 
-        case TUTTI:
-            do {
-                // In base al tipo di carta da rubare
-                switch (effect->target_card) {
-                    case STUDENTE:
-                    case MATRICOLA:
-                    case STUDENTE_SEMPLICE:
-                    case LAUREANDO:
-                        // SE il giocatore corrente non ha carte di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO
-                        if (!deck_contains_type(current_player->classroom, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da rubare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-
-                            do {
-                                // Chiede all'utente di scegliere una carta di tipo STUDENTE, MATRICOLA, STUDENTE_SEMPLICE o LAUREANDO da rubare al giocatore corrente
-                                card_index = choice_card(current_player->classroom, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                stealed_card = select_card(card_index, &current_player->classroom, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è di tipo STUDENTE o del tipo richiesto
-                                if (effect->target_card != STUDENTE && stealed_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, current_player, stealed_card);
-
-                            // Seleziona e scollega la carta
-                            stealed_card = select_card(card_index, &current_player->classroom, true);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->classroom = add_card(player->classroom, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        }
-                        break;
+            case OP_TRIGGER_TARGET:
+                // Controlla e attiva eventuali effetti della carta per il giocatore target
+                check_effect(state->current_player, state->chosen_card, (When) instruction->arg, state->draw_deck, state->discard_deck);
+                break;
 
-                    case BONUS:
-                    case MALUS:
-                        // SE il giocatore corrente non ha carte bonus/malus
-                        if (!deck_contains_type(current_player->magic_cards, effect->target_card)) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte di tipo %s%s%s da rubare!\n", current_player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta di tipo %s%s%s da rubare a %s:\n\n", player->name, get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET, current_player->name);
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", 0, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            do {
-                                card_index = choice_card(current_player->magic_cards, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                                stealed_card = select_card(card_index, &current_player->magic_cards, false); // Seleziona la carta scelta
-
-                                // SE la carta selezionata non è del tipo richiesto
-                                if (stealed_card->type != effect->target_card) {
-                                    printf("\n[" RED "!" RESET "] La carta selezionata non è di tipo %s%s%s! Riprova!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                                } else {
-                                    is_valid_choice = true; // La scelta dell'utente è valida
-                                }
-
-                            } while (!is_valid_choice); // Continua finché la scelta dell'utente non è valida
-
-                            printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                            print_card(stealed_card); // Stampa la carta rubata
-
-                            // Registra l'azione di rubare la carta nel file di log
-                            log_ruba_effect(player, current_player, stealed_card);
-
-                            // Seleziona e scollega la carta
-                            stealed_card = select_card(card_index, &current_player->magic_cards, true);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                            // Aggiungi la carta rubata all'aula studio del giocatore
-                            player->magic_cards = add_card(player->magic_cards, stealed_card);
-                            // Controlla e attiva eventuali effetti della carta rubata
-                            check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                        }
-                        break;
+            case OP_TRIGGER_PLAYER:
+                // Controlla e attiva eventuali effetti della carta per il giocatore
+                check_effect(player, state->chosen_card, (When) instruction->arg, state->draw_deck, state->discard_deck);
+                break;
 
-                    case ALL:
-                        num_cards_classroom = count_cards(current_player->classroom); // Conta il numero di carte presenti nell'aula studio del giocatore corrente
-                        num_cards_magic = count_cards(current_player->magic_cards);   // Conta il numero di carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                        // SE il giocatore corrente non ha carte da rubare (aula studio + bonus/malus)
-                        if ((num_cards_classroom + num_cards_magic) == 0) {
-                            printf("\n[" RED "!" RESET "] %s non ha carte da rubare!\n", current_player->name);
-                        } else {
-                            printf("\n[" HBLU "i" RESET "] %s scegli una carta da rubare a %s:\n\n", player->name, current_player->name);
-                            print_deck(current_player->classroom, "Aula Studio", 0, false, CLASSROOM_DECK_COLOR); // Stampa le carte presenti nell'aula studio del giocatore corrente
-                            printf("\n");
-                            print_deck(current_player->magic_cards, "Carte Bonus/Malus", num_cards_classroom, false, MAGIC_DECK_COLOR); // Stampa le carte presenti nel mazzo bonus/malus del giocatore corrente
-
-                            // Chiede all'utente di scegliere una carta da rubare (aula studio + bonus/malus) al giocatore corrente
-                            card_index = choice_int((num_cards_classroom+num_cards_magic), 1, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da rubare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-
-                            // SE l'indice della carta scelta è maggiore del numero di carte presenti nell'aula studio
-                            if (card_index > num_cards_classroom) {
-                                card_index -= num_cards_classroom; // Calcola l'indice della carta nel mazzo bonus/malus del giocatore corrente
-                                stealed_card = select_card(card_index-1, &current_player->magic_cards, true); // Seleziona e scollega la carta
-
-                                printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                                print_card(stealed_card); // Stampa la carta rubata
-
-                                // Registra l'azione di rubare la carta nel file di log
-                                log_ruba_effect(player, current_player, stealed_card);
-
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                                // Aggiungi la carta rubata all'aula studio del giocatore
-                                player->magic_cards = add_card(player->magic_cards, stealed_card);
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                            } else {
-                                // Altrimenti seleziona la carta nell'aula studio del giocatore corrente
-                                stealed_card = select_card(card_index-1, &current_player->classroom, true); // Seleziona e scollega la carta
-
-                                printf("\n[" GRN "+" RESET "] %s hai rubato una carta da %s!\n", player->name, current_player->name);
-                                print_card(stealed_card); // Stampa la carta rubata
-
-                                // Registra l'azione di rubare la carta nel file di log
-                                log_ruba_effect(player, current_player, stealed_card);
-
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(current_player, stealed_card, FINE, draw_deck, discard_deck);
-                                // Aggiungi la carta rubata all'aula studio del giocatore
-                                player->classroom = add_card(player->classroom, stealed_card);
-                                // Controlla e attiva eventuali effetti della carta rubata
-                                check_effect(player, stealed_card, SUBITO, draw_deck, discard_deck);
-                            }
-                        }
-                        break;
+            case OP_NEXT_TARGET:
+                state->current_player = state->current_player->next_player; // Passa al prossimo giocatore
 
-                    default:
-                        printf("\n[" RED "!" RESET "] Tipo di carta \"%s%s%s\" non valido per l'effetto RUBA!\n", get_color_by_type(effect->target_card), get_type_card(effect->target_card), RESET);
-                        break;
+                // SE il ciclo non è finito => ricomincia dal corpo del ciclo
+                if (state->current_player != state->end_player) {
+                    pc = instruction->jump;
                 }
-                current_player = current_player->next_player;
-            } while (current_player != player);
-            break;
+                break;
+
+            case OP_PASSIVE:
+                // Gli effetti passivi non fanno nulla quando vengono attivati
+                print_msg("\n[" RED "!" RESET "] Attivazione dell'effetto di default!\n");
+                break;
+        }
     }
+
     return;
 }
 
 /**
- * @brief Applica l'effetto di pescare una carta.
+ * @brief Controlla se una carta ISTANTANEA può bloccare l'effetto di una carta.
  * 
- * @param player Puntatore al giocatore.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta.
- * @param effect Puntatore all'effetto.
- * @param draw_deck Puntatore al mazzo di pesca.
- * @param discard_deck Puntatore al mazzo degli scarti.
+ * @param blocking_card Puntatore alla carta da utilizzare per il blocco.
+ * @param card Puntatore alla carta da bloccare.
+ * @return true Se la carta può bloccare l'effetto della carta, false altrimenti.
  */
-void pesca_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    Player* current_player = player; // Inizializza il giocatore corrente al giocatore proprietario della carta
-
-    // In base al giocatore target dell'effetto
-    switch (effect->target_player) {
-        case IO:
-            draw_card(&player, draw_deck, discard_deck, false); // Pesca una carta
-            printf("\n[" GRN "+" RESET "] %s hai pescato una carta!\n", player->name);
-            print_card(
-                select_card(count_cards(player->hand)-1, &player->hand, false) // Seleziona l'ultima carta pescata
-            ); // Stampa la carta pescata
-            break;
-        case TU:
-            if (target_player == NULL) {
-                // Chiedere all'utente a quale giocatore applicare l'effetto
-                // Non dovrebbe mai essere NULL, ma per sicurezza lo controllo
-                target_player = choose_player(player, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-            }
-
-            draw_card(&target_player, draw_deck, discard_deck, false); // Pesca una carta
-            printf("\n[" GRN "+" RESET "] %s hai pescato una carta!\n", target_player->name);
-            print_card(
-                select_card(count_cards(target_player->hand)-1, &target_player->hand, false) // Seleziona l'ultima carta pescata
-            ); // Stampa la carta pescata
-            break;
-
-        case VOI:
-            current_player = current_player->next_player; // Salta il giocatore corrente (me stesso => IO => player)
-            do {
-                draw_card(&current_player, draw_deck, discard_deck, false); // Pesca una carta
-                printf("\n[" GRN "+" RESET "] %s hai pescato una carta!\n", current_player->name);
-                print_card(
-                    select_card(count_cards(current_player->hand)-1, &current_player->hand, false) // Seleziona l'ultima carta pescata
-                ); // Stampa la carta pescata
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non si ritorna al giocatore iniziale
-
-            break;
+bool can_block_card(const Card* blocking_card, const Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-        case TUTTI:
-            do {
-                draw_card(&current_player, draw_deck, discard_deck, false); // Pesca una carta
-                printf("\n[" GRN "+" RESET "] %s hai pescato una carta!\n", current_player->name);
-                print_card(
-                    select_card(count_cards(current_player->hand)-1, &current_player->hand, false) // Seleziona l'ultima carta pescata
-                ); // Stampa la carta pescata
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non si ritorna al giocatore iniziale
-            break;
+    // SE la carta non è una carta ISTANTANEA => non può bloccare nulla
+    if (blocking_card->def->type != ISTANTANEA) {
+        return false;
     }
-    return;
+
+    // Controlla se la carta ISTANTANEA ha come effetto il blocco dell'effetto della carta
+    return has_effect(blocking_card->def->effects, blocking_card->def->num_effects, BLOCCA, IO, card->def->type) || has_effect(blocking_card->def->effects, blocking_card->def->num_effects, BLOCCA, IO, ALL);
 }
 
 /**
- * @brief Applica l'effetto di prendere una carta dalla mano di un giocatore.
+ * @brief Controlla se un giocatore può giocare carte ISTANTANEE (cioè se non ha MALUS che glielo impediscono).
  * 
- * @param player 
- * @param target_player 
- * @param card 
- * @param effect 
- * @param draw_deck 
- * @param discard_deck 
+ * @param player Puntatore al giocatore.
+ * @return true Se il giocatore può giocare carte ISTANTANEE, false altrimenti.
  */
-void prendi_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    Player* current_player = player; // Inizializza il giocatore corrente al giocatore proprietario della carta
-    int card_index = 0; // Indice della carta da prendere
-    bool show_hand = false; // Mostra la mano del giocatore target dell'effetto
-    Card* selected_card = NULL; // Puntatore alla carta selezionata
-
-    // Si assume che effect->target_card sia sempre ALL
-    // in quanto, solitamente, non dovresti poter vedere la mano degli altri giocatori
-    // (a meno che non ci siano effetti malus che lo permettano) e quindi non poter vedere
-    // e scegliere il tipo richiesto di carta da prendere
-
-    // In base al giocatore target dell'effetto
-    switch (effect->target_player) {
-        case IO:
-            // SE non ci sono carte in mano
-            if (count_cards(player->hand) == 0) {
-                printf("\n[" RED "!" RESET "] %s non hai carte in mano da prendere!\n", player->name);
-            } else {
-                printf("\n[" HBLU "i" RESET "] %s scegli una carta da prendere dalla tua mano:\n\n", player->name);
-                print_deck(player->hand, "Carte in Mano", 0, false, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore
+bool can_play_istantanea(Player* player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-                // Chiedere all'utente l'indice della carta da prendere dalla mano
-                card_index = choice_card(player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da prendere:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                selected_card = select_card(card_index, &player->hand, true); // Seleziona e scollega la carta dalla mano del giocatore
-                player->hand = add_card(player->hand, selected_card); // Aggiungi la carta presa alla mano del giocatore
+    // Scorre tutte le carte del mazzo bonus/malus del giocatore
+    for (int i = 0; i < count_cards(&player->magic_cards); i++) {
+        Card* current_card = get_card(&player->magic_cards, i);
 
-                printf("\n[" GRN "+" RESET "] %s hai preso una carta da %s!\n", player->name, player->name);
-                print_card(selected_card); // Stampa la carta presa
-
-                log_prendi_effect(player, player, selected_card); // Registra l'effetto di prendere una carta dalla mano di un giocatore
-            }
-            break;
-
-        case TU:
-            if (target_player == NULL) {
-                // Chiedere all'utente a quale giocatore applicare l'effetto
-                // Non dovrebbe mai essere NULL, ma per sicurezza lo controllo
-                target_player = choose_player(player, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-            }
-
-            // SE non ci sono carte in mano
-            if (count_cards(target_player->hand) == 0) {
-                printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte in mano da prendere!\n", target_player->name);
-            } else {
-                printf("\n[" HBLU "i" RESET "] %s scegli una carta da prendere dalla mano di %s:\n\n", player->name, target_player->name);
-
-                // Controlla se il giocatore può vedere la mano del giocatore target (effetti MOSTRA)
-                show_hand = deck_contains_effect(target_player->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(target_player->classroom, MOSTRA, IO, ALL);
-                print_deck(target_player->hand, "Carte in Mano", 0, !show_hand, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore target
-
-                // Chiedere all'utente l'indice della carta da prendere dalla mano del giocatore target
-                card_index = choice_card(target_player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da prendere:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                selected_card = select_card(card_index, &target_player->hand, true); // Seleziona e scollega la carta dalla mano del giocatore target
-                player->hand = add_card(player->hand, selected_card); // Aggiungi la carta presa alla mano del giocatore
-
-                printf("\n[" GRN "+" RESET "] %s hai preso una carta da %s!\n", player->name, target_player->name);
-                print_card(selected_card); // Stampa la carta presa
+        // SE la carta corrente ha effetti, si attiva SEMPRE e impedisce di giocare carte ISTANTANEE
+        if (current_card->def->num_effects > 0 && current_card->def->when_activate == SEMPRE && has_effect(current_card->def->effects, current_card->def->num_effects, IMPEDIRE, IO, ISTANTANEA)) {
+            return false;
+        }
+    }
 
-                log_prendi_effect(player, target_player, selected_card); // Registra l'effetto di prendere una carta dalla mano di un giocatore
-            }
-            break;
+    return true;
+}
 
-        case VOI:
-            current_player = current_player->next_player; // Salta il giocatore corrente (me stesso => IO => player)
-            do {
-                // SE non ci sono carte in mano
-                if (count_cards(current_player->hand) == 0) {
-                    printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte in mano da prendere!\n", current_player->name);
-                } else {
-                    printf("\n[" HBLU "i" RESET "] %s scegli una carta da prendere dalla mano di %s:\n\n", player->name, current_player->name);
+/**
+ * @brief Controlla se un giocatore può bloccare l'effetto di una carta.
+ * 
+ * @param player Puntatore al giocatore.
+ * @param card Puntatore alla carta da bloccare.
+ * @return true Se il giocatore può bloccare l'effetto della carta, false altrimenti.
+ */
+bool can_block_effect(Player* player, Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-                    // Controlla se il giocatore può vedere la mano del giocatore corrente (effetti MOSTRA)
-                    show_hand = deck_contains_effect(current_player->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(current_player->classroom, MOSTRA, IO, ALL);
-                    print_deck(current_player->hand, "Carte in Mano", 0, !show_hand, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore corrente
+    bool can_block = false; // Inizializza il flag di blocco a false
 
-                    // Chiedere all'utente l'indice della carta da prendere dalla mano del giocatore corrente
-                    card_index = choice_card(current_player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da prendere:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                    selected_card = select_card(card_index, &current_player->hand, true); // Seleziona e scollega la carta dalla mano del giocatore corrente
-                    player->hand = add_card(player->hand, selected_card); // Aggiungi la carta presa alla mano del giocatore
+    // Scorre tutte le carte in mano del giocatore
+    for (int i = 0; i < count_cards(&player->hand) && !can_block; i++) {
+        can_block = can_block_card(get_card(&player->hand, i), card);
+    }
 
-                    printf("\n[" GRN "+" RESET "] %s hai preso una carta da %s!\n", player->name, current_player->name);
-                    print_card(selected_card); // Stampa la carta presa
+    // SE il giocatore non ha una carta ISTANTANEA che può bloccare l'effetto della carta
+    if (!can_block) {
+        return false;
+    }
 
-                    log_prendi_effect(player, current_player, selected_card); // Registra l'effetto di prendere una carta dalla mano di un giocatore
-                }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non si ritorna al giocatore iniziale
-            break;
+    print_msg("\n[" HBLU "i" RESET "] %s possiedi una carta " BHGRN "ISTANTANEA" RESET " che può bloccare l'effetto di \"%s%s%s\"!\n", player->name, get_color_by_type(card->def->type), card->def->name, RESET);
 
-        case TUTTI:
-            do {
-                // SE non ci sono carte in mano
-                if (count_cards(current_player->hand) == 0) {
-                    printf("\n[" RED "!" RESET "] Il giocatore %s non ha carte in mano da prendere!\n", current_player->name);
-                } else {
-                    printf("\n[" HBLU "i" RESET "] %s scegli una carta da prendere dalla mano di %s:\n\n", player->name, current_player->name);
+    // Controlla se il giocatore ha delle carte MALUS che impediscono di giocare carte ISTANTANEE
+    if (!can_play_istantanea(player)) {
+        print_msg("\n[" RED "!" RESET "] Tuttavia non puoi giocare una carta " BHGRN "ISTANTANEA" RESET ", a causa di un " BHRED "MALUS" RESET ", per bloccare l'effetto di \"%s%s%s\"!\n", player->name, get_color_by_type(card->def->type), card->def->name, RESET);
+        return false;
+    }
 
-                    // Controlla se il giocatore può vedere la mano del giocatore corrente (effetti MOSTRA) o se è il giocatore corrente
-                    show_hand = (current_player == player) || deck_contains_effect(current_player->magic_cards, MOSTRA, IO, ALL) || deck_contains_effect(current_player->classroom, MOSTRA, IO, ALL);
-                    print_deck(current_player->hand, "Carte in Mano", 0, !show_hand, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore corrente
+    return true;
+}
 
-                    // Chiedere all'utente l'indice della carta da prendere dalla mano del giocatore corrente
-                    card_index = choice_card(current_player->hand, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da prendere:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-                    selected_card = select_card(card_index, &current_player->hand, true); // Seleziona e scollega la carta dalla mano del giocatore corrente
-                    player->hand = add_card(player->hand, selected_card); // Aggiungi la carta presa alla mano del giocatore
+/**
+ * @brief Chiede al giocatore se vuole bloccare l'effetto di una carta.
+ * 
+ * @param player Puntatore al giocatore.
+ * @param card Puntatore alla carta da bloccare.
+ * @return true Se il giocatore vuole bloccare l'effetto della carta, false altrimenti.
+ */
+bool ask_block_effect(Player* player, Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-                    printf("\n[" GRN "+" RESET "] %s hai preso una carta da %s!\n", player->name, current_player->name);
-                    print_card(selected_card); // Stampa la carta presa
+    // Chiede all'utente se vuole bloccare l'effetto della carta
+    print_msg("\n[" HBLU "i" RESET "] %s vuoi bloccare l'effetto di \"%s%s%s\" utilizzando una carta " BHGRN "ISTANTANEA" RESET "? (" GRN "s" RESET "/" RED "n" RESET "):\n", player->name, get_color_by_type(card->def->type), card->def->name, RESET);
+    bool choice = decide_yes_no(player, DECISION_BLOCK_EFFECT, card, "> ", "[" RED "!" RESET "] Scelta non valida! Riprova!\n");
 
-                    log_prendi_effect(player, current_player, selected_card); // Registra l'effetto di prendere una carta dalla mano di un giocatore
-                }
-                current_player = current_player->next_player; // Passa al prossimo giocatore
-            } while (current_player != player); // Continua finché non si ritorna al giocatore iniziale
-            break;
+    if (!choice) {
+        print_msg("\n[" RED "-" RESET "] Hai scelto di " RED "non bloccare" RESET " l'effetto di \"%s%s%s\"!\n", get_color_by_type(card->def->type), card->def->name, RESET);
+        return false;
     }
-    return;
+
+    print_msg("\n[" GRN "+" RESET "] Hai scelto di " GRN "bloccare" RESET " l'effetto di \"%s%s%s\"!\n", get_color_by_type(card->def->type), card->def->name, RESET);
+    return true;
 }
 
 /**
- * @brief Applica l'effetto di scambiare le carte in mano tra due giocatori.
+ * @brief Blocca l'effetto di una carta utilizzando una carta ISTANTANEA.
  * 
  * @param player Puntatore al giocatore.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta.
- * @param effect Puntatore all'effetto.
- * @param draw_deck Puntatore al mazzo di pesca.
+ * @param card Puntatore alla carta da bloccare.
  * @param discard_deck Puntatore al mazzo degli scarti.
+ * @return Card* Puntatore alla carta ISTANTANEA giocata.
  */
-void scambia_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    Player* current_player = player; // Inizializza il giocatore corrente al giocatore proprietario della carta
-
-    // In base al giocatore target dell'effetto
-    switch (effect->target_player) {
-        case IO:
-            // Scambia le carte in mano tra me stesso e me stesso
-            // Non ha senso, ma per completezza lo gestisco 
-            printf("\n[" HBLU "i" RESET "] Carte in mano di %s scambiate con le carte in mano di %s!\n", player->name, player->name);
-            printf("\n");
-            print_deck(player->hand, "Vecchia Mano", 0, false, DISCARD_DECK_COLOR); // Stampa la vecchia mano
-            printf("\n");
-            print_deck(player->hand, "Nuova Mano", 0, false, HAND_DECK_COLOR); // Stampa la nuova mano
-
-            log_scambia_effect(player, player); // Registra l'effetto di scambiare le carte in mano tra due giocatori
-            break;
+Card* block_effect(Player* player, Card* card, Deck* discard_deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-        case TU:
-            if (target_player == NULL) {
-                // Chiedere all'utente a quale giocatore applicare l'effetto
-                // Non dovrebbe mai essere NULL, ma per sicurezza lo controllo
-                target_player = choose_player(player, false, "\n[" HBLU "i" RESET "] Scegli un giocatore a cui applicare l'effetto:\n", "\n[" HBLU "i" RESET "] Inserisci l'indice del giocatore:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
-            }
+    // Chiede al giocatore di scegliere una carta ISTANTANEA da utilizzare per bloccare l'effetto della carta
+    print_msg("\n[" HBLU "i" RESET "] %s scegli una carta " BHGRN "ISTANTANEA" RESET " da utilizzare per bloccare l'effetto di \"%s%s%s\":\n\n", player->name, get_color_by_type(card->def->type), card->def->name, RESET);
+    set_output_recipient(player); // La mano è visibile solo al giocatore che sceglie
+    print_deck(&player->hand, "Carte in Mano", 0, false, HAND_DECK_COLOR); // Stampa le carte in mano del giocatore
+    set_output_recipient(NULL);
 
-            printf("\n[" HBLU "i" RESET "] Carte in mano di %s scambiate con le carte in mano di %s!\n", player->name, target_player->name);
+    // Inizializzazione delle variabili per la scelta della carta ISTANTANEA da utilizzare
+    int card_index;
+    Card* played_card;
+    bool is_valid = false;
+    do {
+        // Chiede all'utente di scegliere una carta ISTANTANEA da utilizzare
+        card_index = choice_filtered_card(player, &player->hand, CARD_FILTER_BLOCKER, ALL, card, "\n[" HBLU "i" RESET "] Inserisci l'indice della carta da utilizzare:\n> ", "[" RED "!" RESET "] Indice non valido! Riprova!\n");
+        played_card = select_card(card_index, &player->hand, false); // Seleziona la carta scelta
 
-            // Scambia le carte in mano tra il giocatore e il giocatore bersaglio
-            Card* tmp_cards = target_player->hand; // Salva le carte in mano del giocatore bersaglio in una variabile temporanea
-            target_player->hand = player->hand; // Assegna le carte in mano del giocatore al giocatore bersaglio
-            player->hand = tmp_cards; // Assegna le carte in mano salvate nella variabile temporanea al giocatore
+        // SE la carta selezionata non è una carta ISTANTANEA
+        if (played_card->def->type != ISTANTANEA) {
+            print_msg("\n[" RED "!" RESET "] La carta selezionata non è una carta " BHGRN "ISTANTANEA" RESET "! Riprova!\n");
+        } else if (!can_block_card(played_card, card)) {
+            // SE la carta ISTANTANEA non può bloccare l'effetto della carta
+            print_msg("\n[" RED "!" RESET "] La carta selezionata non può bloccare l'effetto di \"%s%s%s\"! Riprova!\n", get_color_by_type(card->def->type), card->def->name, RESET);
+        } else {
+            is_valid = true; // La carta selezionata è valida
+        }
 
-            printf("\n");
-            print_deck(target_player->hand, "Vecchia Mano", 0, false, DISCARD_DECK_COLOR); // Stampa la vecchia mano del giocatore bersaglio
-            printf("\n");
-            print_deck(player->hand, "Nuova Mano", 0, false, HAND_DECK_COLOR); // Stampa la nuova mano del giocatore
+    } while (!is_valid);
 
-            log_scambia_effect(player, target_player); // Registra l'effetto di scambiare le carte in mano tra due giocatori
-            break;
+    print_msg("\n[" GRN "+" RESET "] Hai utilizzato una carta " BHGRN "ISTANTANEA" RESET " per bloccare l'effetto di \"%s%s%s\"!\n", get_color_by_type(card->def->type), card->def->name, RESET);
+    print_card(played_card); // Stampa la carta utilizzata per bloccare l'effetto
 
-        // Configurazione non valida
-        case VOI:
-            printf("\n[" RED "!" RESET "] Target Giocatori \"VOI\" non valido per l'effetto SCAMBIA!\n");
-            break;
+    // Scollega effettivamente la carta dalla mano del giocatore
+    played_card = select_card(card_index, &player->hand, true);
 
-        // Configurazione non valida
-        case TUTTI:
-            printf("\n[" RED "!" RESET "] Target Giocatori \"TUTTI\" non valido per l'effetto SCAMBIA!\n");
-            break;
-    }
+    // Registra l'azione di blocco dell'effetto della carta nel file di log
+    log_block_effect(player, played_card, card);
 
-    return;
-}
\ No newline at end of file
+    // Applica l'effetto della carta istantanea, la carta viene scartata
+    discard_card(played_card, discard_deck);
+
+    return played_card;
+}
@@ -4,18 +4,13 @@
 #include "../model/structs.h"
 
 bool has_effect(Effect* effects, int num_effects, Action action, Type_Player target_player, Type_card target_card);
-void check_effect(Player* owner_card, Card* card, When when_activate, Card** draw_deck, Card** discard_deck);
-void activate_effect(Card* card, Effect* effect, Player* player, Player* target_player, Card** draw_deck, Card** discard_deck);
+void check_effect(Player* owner_card, Card* card, When when_activate, Deck* draw_deck, Deck* discard_deck);
+void compile_card_effects(Card_definition* definition);
+void activate_effect(Effect_state* state, int effect_index);
+bool can_block_card(const Card* blocking_card, const Card* card);
+bool can_play_istantanea(Player* player);
 bool can_block_effect(Player* player, Card* card);
 bool ask_block_effect(Player* player, Card* card);
-Card* block_effect(Player* player, Card* card, Card** discard_deck);
-
-void gioca_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck);
-void scarta_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck);
-void elimina_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck);
-void ruba_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck);
-void pesca_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck);
-void prendi_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck);
-void scambia_effect(Player* player, Player* target_player, Card* card, Effect* effect, Card** draw_deck, Card** discard_deck);
+Card* block_effect(Player* player, Card* card, Deck* discard_deck);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,433 @@
+#include "journal.h"
+#include "../card/card.h"
+#include "../player/player.h"
+#include "../utils/utils.h"
+#include <stdlib.h>
+
+/**
+ * @brief Codifica un intero senza segno in formato little-endian su un numero fisso di byte.
+ *
+ * @param bytes Buffer in cui scrivere (di almeno num_bytes byte).
+ * @param value Valore da codificare.
+ * @param num_bytes Numero di byte da scrivere (1, 2, 4 o 8).
+ */
+static void encode_uint(unsigned char* bytes, uint64_t value, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    for (int i = 0; i < num_bytes; i++) {
+        bytes[i] = (unsigned char) (value >> (8 * i));
+    }
+
+    return;
+}
+
+/**
+ * @brief Accoda un intero senza segno al buffer delle modifiche del turno corrente.
+ *
+ * @param journal Puntatore al journal.
+ * @param value Valore da accodare.
+ * @param num_bytes Numero di byte da scrivere (1, 2, 4 o 8).
+ */
+static void put_uint(Journal* journal, uint64_t value, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il buffer è pieno, ne raddoppia la capacità
+    if (journal->size + (size_t) num_bytes > journal->capacity) {
+        journal->capacity = journal->capacity == 0 ? JOURNAL_INITIAL_CAPACITY : journal->capacity * 2;
+        journal->buffer = (unsigned char*) safe_realloc(journal->buffer, journal->capacity);
+    }
+
+    encode_uint(journal->buffer + journal->size, value, num_bytes);
+    journal->size += (size_t) num_bytes;
+
+    return;
+}
+
+/**
+ * @brief Legge un intero senza segno in formato little-endian da un record del journal, avanzando il cursore.
+ *
+ * @param cursor Puntatore al cursore di lettura.
+ * @param end Fine del record.
+ * @param num_bytes Numero di byte da leggere (1, 2, 4 o 8).
+ * @return uint64_t Valore letto.
+ */
+static uint64_t get_uint(const unsigned char** cursor, const unsigned char* end, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il record non contiene abbastanza byte => il file di salvataggio è corrotto
+    if (end - *cursor < num_bytes) {
+        printf(RED "[!] File di salvataggio corrotto (record del journal incompleto)!" RESET "\n");
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t value = 0;
+    for (int i = 0; i < num_bytes; i++) {
+        value |= (uint64_t) (*cursor)[i] << (8 * i);
+    }
+    *cursor += num_bytes;
+
+    return value;
+}
+
+/**
+ * @brief Avvia il journal di una partita sul file di salvataggio (già posizionato dopo lo snapshot).
+ *
+ * @param journal Puntatore al journal.
+ * @param file Puntatore al file di salvataggio, aperto in scrittura.
+ */
+void open_journal(Journal* journal, FILE* file) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    journal->file = file;
+    journal->size = 0;
+    journal->turns = 0;
+
+    return;
+}
+
+/**
+ * @brief Chiude il file del journal e libera il buffer delle modifiche.
+ *
+ * @param journal Puntatore al journal.
+ */
+void close_journal(Journal* journal) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il journal è aperto => chiude il file di salvataggio
+    if (journal->file != NULL) {
+        fclose(journal->file);
+    }
+
+    free(journal->buffer);
+
+    journal->file = NULL;
+    journal->buffer = NULL;
+    journal->size = 0;
+    journal->capacity = 0;
+    journal->turns = 0;
+
+    return;
+}
+
+/**
+ * @brief Assegna ad ogni mazzo della partita la propria zona del journal, nell'ordine in cui i mazzi sono scritti nello snapshot.
+ *
+ * @param game Puntatore alla partita.
+ * @param first_player Puntatore al primo giocatore dello snapshot.
+ * @param journal Puntatore al journal in cui registrare le modifiche (NULL per non registrarle).
+ */
+void assign_journal_zones(Game* game, Player* first_player, Journal* journal) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Deck* common_decks[] = {&game->draw_deck, &game->discard_deck, &game->study_room};
+    int common_zones[] = {DRAW_DECK_ZONE, DISCARD_DECK_ZONE, STUDY_ROOM_ZONE};
+
+    for (int i = 0; i < 3; i++) {
+        common_decks[i]->journal = journal;
+        common_decks[i]->zone = common_zones[i];
+    }
+
+    int zone = FIRST_PLAYER_ZONE;
+    Player* player = first_player;
+    do {
+        Deck* player_decks[] = {&player->hand, &player->classroom, &player->magic_cards};
+
+        for (int i = 0; i < ZONES_PER_PLAYER; i++) {
+            player_decks[i]->journal = journal;
+            player_decks[i]->zone = zone++;
+        }
+
+        player = player->next_player;
+    } while (player != first_player);
+
+    return;
+}
+
+/**
+ * @brief Registra nel journal l'aggiunta di una carta ad un mazzo.
+ *
+ * @param deck Puntatore al mazzo.
+ * @param card Puntatore alla carta aggiunta.
+ * @param front true SE la carta è stata aggiunta in cima al mazzo, false SE in coda.
+ */
+void journal_add_card(Deck* deck, const Card* card, bool front) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il mazzo non è registrato nel journal => non fa nulla
+    if (deck->journal == NULL) {
+        return;
+    }
+
+    put_uint(deck->journal, front ? JOURNAL_ADD_FRONT : JOURNAL_ADD_BACK, 1);
+    put_uint(deck->journal, (uint64_t) deck->zone, 1);
+    put_uint(deck->journal, (uint64_t) card->def->id, 2);
+
+    return;
+}
+
+/**
+ * @brief Registra nel journal la rimozione di una carta da un mazzo (prima che venga rimossa).
+ *
+ * @param deck Puntatore al mazzo.
+ * @param card_index Indice della carta rimossa.
+ */
+void journal_remove_card(Deck* deck, int card_index) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il mazzo non è registrato nel journal => non fa nulla
+    if (deck->journal == NULL) {
+        return;
+    }
+
+    put_uint(deck->journal, JOURNAL_REMOVE, 1);
+    put_uint(deck->journal, (uint64_t) deck->zone, 1);
+    put_uint(deck->journal, (uint64_t) card_index, 2);
+
+    return;
+}
+
+/**
+ * @brief Registra nel journal lo scambio del contenuto di due mazzi.
+ *
+ * @param deck_a Puntatore al primo mazzo.
+ * @param deck_b Puntatore al secondo mazzo.
+ */
+void journal_swap_decks(const Deck* deck_a, const Deck* deck_b) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE i mazzi non sono registrati nel journal => non fa nulla
+    if (deck_a->journal == NULL || deck_b->journal == NULL) {
+        return;
+    }
+
+    put_uint(deck_a->journal, JOURNAL_SWAP, 1);
+    put_uint(deck_a->journal, (uint64_t) deck_a->zone, 1);
+    put_uint(deck_a->journal, (uint64_t) deck_b->zone, 1);
+
+    return;
+}
+
+/**
+ * @brief Registra nel journal l'intero contenuto di un mazzo (usato quando il mazzo viene mescolato).
+ *
+ * @param deck Puntatore al mazzo.
+ */
+void journal_reset_deck(const Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il mazzo non è registrato nel journal => non fa nulla
+    if (deck->journal == NULL) {
+        return;
+    }
+
+    put_uint(deck->journal, JOURNAL_RESET, 1);
+    put_uint(deck->journal, (uint64_t) deck->zone, 1);
+    put_uint(deck->journal, (uint64_t) count_cards(deck), 2);
+    for (int i = 0; i < count_cards(deck); i++) {
+        put_uint(deck->journal, (uint64_t) get_card(deck, i)->def->id, 2);
+    }
+
+    return;
+}
+
+/**
+ * @brief Scrive su disco il record di un turno: turno, giocatore di turno, stato del generatore e carte spostate dall'ultimo salvataggio.
+ *
+ * Ogni record è preceduto dalla propria lunghezza, così che un record scritto solo in parte (es. chiusura improvvisa) venga ignorato.
+ *
+ * @param journal Puntatore al journal.
+ * @param game Puntatore alla partita.
+ * @param current_player Puntatore al giocatore di turno.
+ */
+void commit_journal_turn(Journal* journal, const Game* game, const Player* current_player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Intestazione del record: lunghezza, turno, indice del giocatore di turno e stato del generatore
+    unsigned char header[4 + 4 + 1 + 8 * RNG_STATE_SIZE];
+    size_t header_size = sizeof(header) - 4; // La lunghezza non conta sé stessa
+
+    encode_uint(header, header_size + journal->size, 4);
+    encode_uint(header + 4, (uint64_t) game->round, 4);
+    encode_uint(header + 8, (uint64_t) ((current_player->hand.zone - FIRST_PLAYER_ZONE) / ZONES_PER_PLAYER), 1);
+    for (int i = 0; i < RNG_STATE_SIZE; i++) {
+        encode_uint(header + 9 + 8 * i, game->rng.state[i], 8);
+    }
+
+    safe_fwrite(header, 1, sizeof(header), journal->file);
+    if (journal->size > 0) {
+        safe_fwrite(journal->buffer, 1, journal->size, journal->file);
+    }
+    fflush(journal->file);
+
+    journal->size = 0;
+    journal->turns++;
+
+    return;
+}
+
+/**
+ * @brief Restituisce il mazzo della partita corrispondente ad una zona del journal.
+ *
+ * @param game Puntatore alla partita (con i giocatori nell'ordine dello snapshot).
+ * @param zone Zona del journal.
+ * @return Deck* Puntatore al mazzo.
+ */
+static Deck* get_zone_deck(Game* game, int zone) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    switch (zone) {
+        case DRAW_DECK_ZONE:
+            return &game->draw_deck;
+        case DISCARD_DECK_ZONE:
+            return &game->discard_deck;
+        case STUDY_ROOM_ZONE:
+            return &game->study_room;
+        default:
+            break;
+    }
+
+    // SE la zona non corrisponde a nessun giocatore => il file di salvataggio è corrotto
+    int player_index = (zone - FIRST_PLAYER_ZONE) / ZONES_PER_PLAYER;
+    if (zone < 0 || player_index >= count_players(game->players)) {
+        printf(RED "[!] File di salvataggio corrotto (zona del journal non valida)!" RESET "\n");
+        exit(EXIT_FAILURE);
+    }
+
+    Player* player = game->players;
+    for (int i = 0; i < player_index; i++) {
+        player = player->next_player;
+    }
+
+    Deck* player_decks[] = {&player->hand, &player->classroom, &player->magic_cards};
+    return player_decks[(zone - FIRST_PLAYER_ZONE) % ZONES_PER_PLAYER];
+}
+
+/**
+ * @brief Legge l'id di una carta da un record del journal e ne restituisce la definizione.
+ *
+ * @param cursor Puntatore al cursore di lettura.
+ * @param end Fine del record.
+ * @param definitions Array che associa ad ogni id del salvataggio la definizione registrata.
+ * @param num_definitions Numero di definizioni presenti nel salvataggio.
+ * @return const Card_definition* Puntatore alla definizione.
+ */
+static const Card_definition* get_definition(const unsigned char** cursor, const unsigned char* end, const Card_definition** definitions, int num_definitions) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int id = (int) get_uint(cursor, end, 2);
+
+    // SE l'id non corrisponde a nessuna definizione => il file di salvataggio è corrotto
+    if (id >= num_definitions) {
+        printf(RED "[!] File di salvataggio corrotto (carta sconosciuta)!" RESET "\n");
+        exit(EXIT_FAILURE);
+    }
+
+    return definitions[id];
+}
+
+/**
+ * @brief Applica ad una partita appena caricata da uno snapshot i record dei turni registrati nel journal.
+ *
+ * @param file Puntatore al file di salvataggio (posizionato subito dopo lo snapshot).
+ * @param game Puntatore alla partita caricata dallo snapshot.
+ * @param definitions Array che associa ad ogni id del salvataggio la definizione registrata.
+ * @param num_definitions Numero di definizioni presenti nel salvataggio.
+ */
+void replay_journal(FILE* file, Game* game, const Card_definition** definitions, int num_definitions) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char length_bytes[4];
+
+    assign_journal_zones(game, game->players, NULL); // Le modifiche applicate non vanno registrate di nuovo
+
+    // Legge un record alla volta, finché il file non termina
+    while (fread(length_bytes, 1, sizeof(length_bytes), file) == sizeof(length_bytes)) {
+        const unsigned char* cursor = length_bytes;
+        size_t length = (size_t) get_uint(&cursor, length_bytes + sizeof(length_bytes), 4);
+
+        unsigned char* record = (unsigned char*) safe_malloc(length);
+
+        // SE il record è stato scritto solo in parte => viene ignorato (la partita riprende dal turno precedente)
+        if (fread(record, 1, length, file) != length) {
+            printf("[" HBLU "i" RESET "] Ultimo turno del salvataggio incompleto: verrà ignorato.\n");
+            free(record);
+            break;
+        }
+
+        const unsigned char* end = record + length;
+        cursor = record;
+
+        game->round = (int) get_uint(&cursor, end, 4);
+        int current_seat = (int) get_uint(&cursor, end, 1); // Posto (nell'ordine dello snapshot) del giocatore di turno
+        for (int i = 0; i < RNG_STATE_SIZE; i++) {
+            game->rng.state[i] = get_uint(&cursor, end, 8);
+        }
+
+        // SE il posto non corrisponde a nessun giocatore => il file di salvataggio è corrotto
+        if (current_seat >= count_players(game->players)) {
+            printf(RED "[!] File di salvataggio corrotto (giocatore di turno non valido)!" RESET "\n");
+            exit(EXIT_FAILURE);
+        }
+
+        // La partita riprende dal giocatore di turno dell'ultimo record
+        game->current_player = game->players;
+        for (int i = 0; i < current_seat; i++) {
+            game->current_player = game->current_player->next_player;
+        }
+
+        // Applica le modifiche del turno, nell'ordine in cui sono state registrate
+        while (cursor < end) {
+            Journal_op op = (Journal_op) get_uint(&cursor, end, 1);
+            Deck* deck = get_zone_deck(game, (int) get_uint(&cursor, end, 1));
+
+            switch (op) {
+                case JOURNAL_ADD_BACK:
+                    add_card(deck, get_definition_card(get_definition(&cursor, end, definitions, num_definitions)));
+                    break;
+
+                case JOURNAL_ADD_FRONT:
+                    add_card_front(deck, get_definition_card(get_definition(&cursor, end, definitions, num_definitions)));
+                    break;
+
+                case JOURNAL_REMOVE: {
+                    int card_index = (int) get_uint(&cursor, end, 2);
+
+                    // SE l'indice non è valido => il file di salvataggio è corrotto
+                    if (card_index >= count_cards(deck)) {
+                        printf(RED "[!] File di salvataggio corrotto (carta rimossa non valida)!" RESET "\n");
+                        exit(EXIT_FAILURE);
+                    }
+
+                    select_card(card_index, deck, true);
+                    break;
+                }
+
+                case JOURNAL_SWAP:
+                    swap_decks(deck, get_zone_deck(game, (int) get_uint(&cursor, end, 1)));
+                    break;
+
+                case JOURNAL_RESET: {
+                    // Svuota il mazzo e lo riempie con le carte registrate, nel nuovo ordine
+                    while (count_cards(deck) > 0) {
+                        pop_card_back(deck);
+                    }
+
+                    int num_cards = (int) get_uint(&cursor, end, 2);
+                    reserve_deck(deck, num_cards); // Una sola allocazione per il mazzo riempito
+                    for (int i = 0; i < num_cards; i++) {
+                        add_card(deck, get_definition_card(get_definition(&cursor, end, definitions, num_definitions)));
+                    }
+                    break;
+                }
+
+                default:
+                    printf(RED "[!] File di salvataggio corrotto (operazione del journal sconosciuta)!" RESET "\n");
+                    exit(EXIT_FAILURE);
+            }
+        }
+
+        free(record);
+    }
+
+    return;
+}
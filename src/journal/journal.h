@@ -0,0 +1,19 @@
+#ifndef UNSTABLE_STUDENTS_JOURNAL_H
+#define UNSTABLE_STUDENTS_JOURNAL_H
+
+#include "../model/structs.h"
+#include <stdio.h>
+
+void open_journal(Journal* journal, FILE* file);
+void close_journal(Journal* journal);
+void assign_journal_zones(Game* game, Player* first_player, Journal* journal);
+
+void journal_add_card(Deck* deck, const Card* card, bool front);
+void journal_remove_card(Deck* deck, int card_index);
+void journal_swap_decks(const Deck* deck_a, const Deck* deck_b);
+void journal_reset_deck(const Deck* deck);
+
+void commit_journal_turn(Journal* journal, const Game* game, const Player* current_player);
+void replay_journal(FILE* file, Game* game, const Card_definition** definitions, int num_definitions);
+
+#endif
@@ -1,107 +1,1148 @@
 #include "logging.h"
+#include "../core/game.h"
 #include "../utils/utils.h"
+#include "../card/card.h"
+#include <inttypes.h>
 #include <string.h>
 
+static Log_flush_policy default_flush_policy = LOG_FLUSH_TURN;       // Politica di scrittura su disco dei nuovi logger
+static Log_rotation_policy default_rotation_policy = LOG_ROTATE_SIZE; // Politica di rotazione del file di log dei nuovi logger
+
+/**
+ * @brief Imposta la politica di scrittura su disco usata dai logger aperti da questo momento in poi.
+ * 
+ * @param policy Politica di scrittura su disco (ad ogni evento, ad ogni turno o solo alla chiusura).
+ */
+void set_log_flush_policy(Log_flush_policy policy) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    default_flush_policy = policy;
+    return;
+}
+
+/**
+ * @brief Converte il nome di una politica di scrittura su disco nel valore dell'enumerazione.
+ * 
+ * @param str Nome della politica ("always", "turn" o "exit").
+ * @param policy Puntatore alla politica in cui salvare il valore convertito.
+ * @return true se il nome è valido, false altrimenti.
+ */
+bool parse_log_flush_policy(const char* str, Log_flush_policy* policy) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    if (strcmp(str, "always") == 0) {
+        *policy = LOG_FLUSH_ALWAYS;
+    } else if (strcmp(str, "turn") == 0) {
+        *policy = LOG_FLUSH_TURN;
+    } else if (strcmp(str, "exit") == 0) {
+        *policy = LOG_FLUSH_EXIT;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Imposta la politica di rotazione del file di log usata dai logger aperti da questo momento in poi.
+ * 
+ * @param policy Politica di rotazione (per dimensione o ad ogni partita).
+ */
+void set_log_rotation_policy(Log_rotation_policy policy) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    default_rotation_policy = policy;
+    return;
+}
+
+/**
+ * @brief Converte il nome di una politica di rotazione del file di log nel valore dell'enumerazione.
+ * 
+ * @param str Nome della politica ("size" o "game").
+ * @param policy Puntatore alla politica in cui salvare il valore convertito.
+ * @return true se il nome è valido, false altrimenti.
+ */
+bool parse_log_rotation_policy(const char* str, Log_rotation_policy* policy) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    if (strcmp(str, "size") == 0) {
+        *policy = LOG_ROTATE_SIZE;
+    } else if (strcmp(str, "game") == 0) {
+        *policy = LOG_ROTATE_GAME;
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Scrive un intero senza segno in formato little-endian su un numero fisso di byte di un buffer.
+ * 
+ * @param bytes Puntatore al buffer di destinazione.
+ * @param value Valore da scrivere.
+ * @param num_bytes Numero di byte da scrivere (da 1 a 8).
+ */
+static void put_uint(unsigned char* bytes, uint64_t value, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    for (int i = 0; i < num_bytes; i++) {
+        bytes[i] = (unsigned char) (value >> (8 * i));
+    }
+
+    return;
+}
+
+/**
+ * @brief Legge un intero senza segno in formato little-endian da un numero fisso di byte di un buffer.
+ * 
+ * @param bytes Puntatore al buffer da cui leggere.
+ * @param num_bytes Numero di byte da leggere (da 1 a 8).
+ * @return uint64_t Valore letto.
+ */
+static uint64_t get_uint(const unsigned char* bytes, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t value = 0;
+    for (int i = 0; i < num_bytes; i++) {
+        value |= (uint64_t) bytes[i] << (8 * i);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Converte un record nei LOG_RECORD_SIZE byte del formato su disco (little-endian, indipendente dalla piattaforma).
+ * 
+ * @param record Puntatore al record da convertire.
+ * @param bytes Buffer di destinazione (almeno LOG_RECORD_SIZE byte).
+ */
+static void encode_record(const Log_record* record, unsigned char* bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    put_uint(bytes, record->round, 4);
+    bytes[4] = record->type;
+    bytes[5] = record->actor;
+    bytes[6] = record->target;
+    bytes[7] = record->card_type;
+    put_uint(bytes + 8, record->card, 2);
+    put_uint(bytes + 10, record->other_card, 2);
+    put_uint(bytes + 12, record->length, 4);
+    put_uint(bytes + 16, record->hash, 8);
+
+    return;
+}
+
+/**
+ * @brief Converte i LOG_RECORD_SIZE byte del formato su disco in un record.
+ * 
+ * @param bytes Buffer da cui leggere (almeno LOG_RECORD_SIZE byte).
+ * @param record Puntatore al record in cui salvare i campi letti.
+ */
+static void decode_record(const unsigned char* bytes, Log_record* record) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    record->round = (uint32_t) get_uint(bytes, 4);
+    record->type = bytes[4];
+    record->actor = bytes[5];
+    record->target = bytes[6];
+    record->card_type = bytes[7];
+    record->card = (uint16_t) get_uint(bytes + 8, 2);
+    record->other_card = (uint16_t) get_uint(bytes + 10, 2);
+    record->length = (uint32_t) get_uint(bytes + 12, 4);
+    record->hash = get_uint(bytes + 16, 8);
+
+    return;
+}
+
+/**
+ * @brief Controlla SE un record è seguito da un testo (nome di una partita, di un giocatore o di una carta).
+ * 
+ * @param type Tipo del record.
+ * @return true se il record è seguito da un testo, false altrimenti.
+ */
+static bool has_text(uint8_t type) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    return type == LOG_EVENT_INIT_GAME || type == LOG_EVENT_LOAD_GAME || type == LOG_EVENT_PLAYER_NAME || type == LOG_EVENT_CARD_NAME;
+}
+
+/**
+ * @brief Calcola la lunghezza del testo di un record completata fino a un multiplo di LOG_RECORD_SIZE.
+ * 
+ * @param length Lunghezza del testo.
+ * @return size_t Byte occupati dal testo nel file di log.
+ */
+static size_t padded_length(size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    return (length + LOG_RECORD_SIZE - 1) / LOG_RECORD_SIZE * LOG_RECORD_SIZE;
+}
+
+/**
+ * @brief Calcola l'hash FNV-1a a 64 bit del nome di una partita (usato dall'indice per cercare le partite per nome).
+ * 
+ * @param name Nome della partita.
+ * @return uint64_t Hash del nome.
+ */
+static uint64_t hash_name(const char* name) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (const unsigned char* c = (const unsigned char*) name; *c != '\0'; c++) {
+        hash = (hash ^ *c) * FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Legge il prossimo record del file di log (e il testo che lo segue, SE presente).
+ * 
+ * @param file Puntatore al file di log.
+ * @param record Puntatore al record in cui salvare i campi letti.
+ * @param text Buffer in cui salvare il testo (almeno MAX_FILENAME_LENGTH + LOG_RECORD_SIZE byte).
+ * @return long Byte letti, 0 alla fine del file (o SE l'ultimo record è troncato), -1 SE il record non è valido.
+ */
+static long read_log_record(FILE* file, Log_record* record, char* text) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[LOG_RECORD_SIZE];
+    if (fread(bytes, 1, LOG_RECORD_SIZE, file) != LOG_RECORD_SIZE) {
+        return 0;
+    }
+    decode_record(bytes, record);
+
+    // SE il record non è seguito da un testo => è già stato letto tutto
+    if (!has_text(record->type)) {
+        text[0] = '\0';
+        return LOG_RECORD_SIZE;
+    }
+
+    // SE il testo è più lungo di qualsiasi nome => il record non è valido
+    if (record->length > MAX_FILENAME_LENGTH) {
+        return -1;
+    }
+
+    size_t padded = padded_length(record->length);
+    if (fread(text, 1, padded, file) != padded) {
+        return 0; // Testo troncato (programma terminato durante la scrittura)
+    }
+    text[record->length] = '\0';
+
+    return (long) (LOG_RECORD_SIZE + padded);
+}
+
+/**
+ * @brief Converte una voce dell'indice nei LOG_INDEX_ENTRY_SIZE byte del formato su disco (little-endian).
+ * 
+ * @param entry Puntatore alla voce da convertire.
+ * @param bytes Buffer di destinazione (almeno LOG_INDEX_ENTRY_SIZE byte).
+ */
+static void encode_index_entry(const Log_index_entry* entry, unsigned char* bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    memset(bytes, 0, LOG_INDEX_ENTRY_SIZE);
+    bytes[0] = entry->type;
+    put_uint(bytes + 2, entry->card, 2);
+    put_uint(bytes + 4, entry->type == LOG_INDEX_GAME ? entry->previous : entry->round, 4); // Le voci di inizio partita non hanno un turno
+    put_uint(bytes + 8, entry->offset, 8);
+    put_uint(bytes + 16, entry->name_hash, 8);
+
+    return;
+}
+
+/**
+ * @brief Accoda una voce all'indice del file di log.
+ * 
+ * @param index Puntatore al file dell'indice.
+ * @param entry Puntatore alla voce da scrivere.
+ */
+static void write_index_entry(FILE* index, const Log_index_entry* entry) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[LOG_INDEX_ENTRY_SIZE];
+    encode_index_entry(entry, bytes);
+
+    safe_fwrite(bytes, 1, LOG_INDEX_ENTRY_SIZE, index);
+    return;
+}
+
+/**
+ * @brief Converte i LOG_INDEX_ENTRY_SIZE byte del formato su disco in una voce dell'indice.
+ * 
+ * @param bytes Byte della voce.
+ * @param entry Puntatore alla voce in cui salvare i campi letti.
+ */
+static void decode_index_entry(const unsigned char* bytes, Log_index_entry* entry) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    entry->type = bytes[0];
+    entry->card = (uint16_t) get_uint(bytes + 2, 2);
+    entry->round = entry->type == LOG_INDEX_GAME ? 0 : (uint32_t) get_uint(bytes + 4, 4);
+    entry->offset = get_uint(bytes + 8, 8);
+    entry->name_hash = get_uint(bytes + 16, 8);
+    entry->previous = entry->type == LOG_INDEX_GAME ? (uint32_t) get_uint(bytes + 4, 4) : 0;
+
+    return;
+}
+
+/**
+ * @brief Legge la prossima voce dell'indice del file di log.
+ * 
+ * @param index Puntatore al file dell'indice.
+ * @param entry Puntatore alla voce in cui salvare i campi letti.
+ * @return true se la voce è stata letta, false alla fine del file (o SE l'ultima voce è troncata).
+ */
+static bool read_index_entry(FILE* index, Log_index_entry* entry) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[LOG_INDEX_ENTRY_SIZE];
+    if (fread(bytes, 1, LOG_INDEX_ENTRY_SIZE, index) != LOG_INDEX_ENTRY_SIZE) {
+        return false;
+    }
+
+    decode_index_entry(bytes, entry);
+    return true;
+}
+
+/**
+ * @brief Legge la voce dell'indice con un certo numero (posizione nel file dell'indice).
+ * 
+ * @param index Puntatore al file dell'indice.
+ * @param number Numero della voce (partendo da 0).
+ * @param entry Puntatore alla voce in cui salvare i campi letti.
+ * @return true se la voce è stata letta, false SE non esiste.
+ */
+static bool read_index_entry_at(FILE* index, uint32_t number, Log_index_entry* entry) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    fseek(index, (long) number * LOG_INDEX_ENTRY_SIZE, SEEK_SET);
+    return read_index_entry(index, entry);
+}
+
+/**
+ * @brief Aggiunge una voce alla directory dell'indice prima che venga accodata all'indice: una voce di inizio partita
+ * diventa la testa del bucket del proprio hash e punta alla testa precedente, così le partite con lo stesso nome
+ * si trovano seguendo la catena del bucket senza leggere tutto l'indice.
+ * 
+ * @param directory Puntatore alla directory dell'indice.
+ * @param entry Puntatore alla voce (il collegamento alla voce precedente viene impostato qui).
+ */
+static void link_index_entry(Log_directory* directory, Log_index_entry* entry) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    if (entry->type == LOG_INDEX_GAME) {
+        uint32_t* head = &directory->heads[entry->name_hash % LOG_DIRECTORY_BUCKETS];
+        entry->previous = *head;
+        *head = directory->num_entries + 1;
+    }
+    directory->num_entries++;
+
+    return;
+}
+
+/**
+ * @brief Scrive su disco la directory dell'indice (le teste dei bucket solo SE richiesto, l'intestazione sempre).
+ * 
+ * @param file Puntatore al file della directory.
+ * @param directory Puntatore alla directory.
+ * @param heads true per scrivere anche le teste dei bucket.
+ */
+static void write_log_directory(FILE* file, const Log_directory* directory, bool heads) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[LOG_DIRECTORY_HEADER_SIZE + 4 * LOG_DIRECTORY_BUCKETS];
+    size_t size = LOG_DIRECTORY_HEADER_SIZE;
+
+    put_uint(bytes, directory->num_entries, LOG_DIRECTORY_HEADER_SIZE);
+    if (heads) {
+        for (int i = 0; i < LOG_DIRECTORY_BUCKETS; i++) {
+            put_uint(bytes + LOG_DIRECTORY_HEADER_SIZE + 4 * i, directory->heads[i], 4);
+        }
+        size = sizeof(bytes);
+    }
+
+    fseek(file, 0, SEEK_SET);
+    safe_fwrite(bytes, 1, size, file);
+    fflush(file);
+
+    return;
+}
+
+/**
+ * @brief Legge la directory dell'indice di un file di log e ne controlla la coerenza con l'indice.
+ * 
+ * @param path Percorso della directory.
+ * @param directory Puntatore alla directory in cui salvare i campi letti.
+ * @param num_index_entries Voci presenti nell'indice.
+ * @return true se la directory è stata letta ed è valida, false altrimenti.
+ */
+static bool read_log_directory(const char* path, Log_directory* directory, uint32_t num_index_entries) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    FILE* file = fopen(path, "rb");
+
+    // SE la directory non esiste (es. indice scritto prima che esistesse la directory, senza collegamenti tra le partite)
+    if (file == NULL) {
+        return false;
+    }
+
+    unsigned char bytes[LOG_DIRECTORY_HEADER_SIZE + 4 * LOG_DIRECTORY_BUCKETS];
+    bool valid = fread(bytes, 1, sizeof(bytes), file) == sizeof(bytes);
+    fclose(file);
+
+    directory->num_entries = (uint32_t) get_uint(bytes, LOG_DIRECTORY_HEADER_SIZE);
+    valid = valid && directory->num_entries <= num_index_entries;
+
+    // Ogni testa deve puntare a una voce coperta dalla directory
+    for (int i = 0; valid && i < LOG_DIRECTORY_BUCKETS; i++) {
+        directory->heads[i] = (uint32_t) get_uint(bytes + LOG_DIRECTORY_HEADER_SIZE + 4 * i, 4);
+        valid = directory->heads[i] <= directory->num_entries;
+    }
+
+    return valid;
+}
+
+/**
+ * @brief Ricostruisce l'indice di un file di log già esistente (es. scritto prima che esistesse l'indice), leggendolo per intero.
+ * 
+ * Le voci sono le stesse che il logger avrebbe accodato scrivendo il file.
+ * 
+ * @param path Percorso del file di log.
+ * @param index Puntatore al file dell'indice (vuoto).
+ * @param directory Puntatore alla directory dell'indice (vuota), aggiornata con le voci ricostruite.
+ */
+static void rebuild_log_index(const char* path, FILE* index, Log_directory* directory) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    FILE* file = safe_fopen(path, "rb");
+    fseek(file, LOG_RECORD_SIZE, SEEK_SET); // Salta l'intestazione
+
+    Log_record record;
+    char text[MAX_FILENAME_LENGTH + LOG_RECORD_SIZE];
+    uint64_t offset = LOG_RECORD_SIZE;
+    uint32_t indexed_round = 0;
+    long size = 0;
+
+    while ((size = read_log_record(file, &record, text)) > 0) {
+        Log_index_entry entry = {0, LOG_NO_CARD, 0, offset, 0, 0};
+
+        if (record.type == LOG_EVENT_INIT_GAME || record.type == LOG_EVENT_LOAD_GAME) {
+            entry.type = LOG_INDEX_GAME;
+            entry.name_hash = hash_name(text);
+            link_index_entry(directory, &entry);
+            write_index_entry(index, &entry);
+            indexed_round = 0;
+        } else if (record.type == LOG_EVENT_CARD_NAME) {
+            entry.type = LOG_INDEX_CARD;
+            entry.card = record.card;
+            link_index_entry(directory, &entry);
+            write_index_entry(index, &entry);
+        } else if (record.type != LOG_EVENT_PLAYER_NAME && record.round != indexed_round) {
+            entry.type = LOG_INDEX_TURN;
+            entry.round = record.round;
+            link_index_entry(directory, &entry);
+            write_index_entry(index, &entry);
+            indexed_round = record.round;
+        }
+
+        offset += (uint64_t) size;
+    }
+
+    fclose(file);
+    return;
+}
+
+/**
+ * @brief Costruisce il percorso di un segmento del file di log (o del suo indice, o della directory dell'indice).
+ * 
+ * @param segment_path Buffer di destinazione.
+ * @param size Dimensione del buffer.
+ * @param path Percorso del file di log.
+ * @param segment Numero del segmento (0 => segmento corrente, es. "log.bin"; N => "log.bin.N").
+ * @param extension Estensione accodata al percorso del segmento ("" per il segmento, LOG_INDEX_EXTENSION per l'indice, es. "log.bin.N.idx",
+ * LOG_DIRECTORY_EXTENSION per la directory dell'indice).
+ */
+static void get_segment_path(char* segment_path, size_t size, const char* path, int segment, const char* extension) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    if (segment == 0) {
+        snprintf(segment_path, size, "%s%s", path, extension);
+    } else {
+        snprintf(segment_path, size, "%s.%d%s", path, segment, extension);
+    }
+
+    return;
+}
+
+/**
+ * @brief Legge la directory dell'indice di un segmento del file di log, ricostruendo indice e directory dal file di log
+ * SE mancano o non sono validi. Le voci accodate all'indice dopo l'ultima scrittura della directory (es. dopo un crash)
+ * vengono aggiunte alla directory, che viene poi riscritta su disco.
+ * 
+ * @param path Percorso del segmento del file di log.
+ * @param directory Puntatore alla directory in cui salvare le teste dei bucket.
+ */
+static void load_log_directory(const char* path, Log_directory* directory) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char index_path[LOG_SEGMENT_PATH_LENGTH + LOG_INDEX_EXTENSION_LEN];
+    char directory_path[LOG_SEGMENT_PATH_LENGTH + LOG_INDEX_EXTENSION_LEN];
+    get_segment_path(index_path, sizeof(index_path), path, 0, LOG_INDEX_EXTENSION);
+    get_segment_path(directory_path, sizeof(directory_path), path, 0, LOG_DIRECTORY_EXTENSION);
+
+    FILE* index = fopen(index_path, "rb");
+    uint32_t num_index_entries = 0;
+    if (index != NULL) {
+        fseek(index, 0, SEEK_END);
+        num_index_entries = (uint32_t) (ftell(index) / LOG_INDEX_ENTRY_SIZE);
+    }
+
+    // SE l'indice o la directory mancano o non sono validi => li ricostruisce dal file di log
+    if (index == NULL || !read_log_directory(directory_path, directory, num_index_entries)) {
+        if (index != NULL) {
+            fclose(index);
+        }
+
+        *directory = (Log_directory) {0};
+        index = safe_fopen(index_path, "wb");
+        rebuild_log_index(path, index, directory);
+    } else {
+        // Le voci non ancora coperte dalla directory hanno già il collegamento alla voce precedente: basta aggiornare le teste
+        Log_index_entry entry;
+        fseek(index, (long) directory->num_entries * LOG_INDEX_ENTRY_SIZE, SEEK_SET);
+        while (directory->num_entries < num_index_entries && read_index_entry(index, &entry)) {
+            if (entry.type == LOG_INDEX_GAME) {
+                directory->heads[entry.name_hash % LOG_DIRECTORY_BUCKETS] = directory->num_entries + 1;
+            }
+            directory->num_entries++;
+        }
+    }
+
+    fclose(index);
+
+    FILE* file = safe_fopen(directory_path, "wb");
+    write_log_directory(file, directory, true);
+    fclose(file);
+
+    return;
+}
+
+/**
+ * @brief Apre il segmento corrente del file di log e il suo indice (dal thread della partita all'apertura, poi solo dal thread di scrittura).
+ * 
+ * @param writer Puntatore al thread di scrittura.
+ * @param mode Modalità di apertura ("ab" per accodare, "wb" per un nuovo segmento).
+ */
+static void open_log_segment(Log_writer* writer, const char* mode) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char index_path[LOG_SEGMENT_PATH_LENGTH];
+    get_segment_path(index_path, sizeof(index_path), writer->path, 0, LOG_INDEX_EXTENSION);
+
+    // Gli eventi vengono accumulati in memoria e scritti su disco secondo la politica scelta
+    writer->file = safe_fopen(writer->path, mode);
+    setvbuf(writer->file, writer->buffer, _IOFBF, LOG_BUFFER_SIZE);
+    writer->index_file = safe_fopen(index_path, mode);
+
+    return;
+}
+
+/**
+ * @brief Apre (riscrivendola) la directory dell'indice del segmento corrente, a partire da quella in memoria del thread di scrittura.
+ * 
+ * @param writer Puntatore al thread di scrittura.
+ */
+static void open_log_directory(Log_writer* writer) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char directory_path[LOG_SEGMENT_PATH_LENGTH];
+    get_segment_path(directory_path, sizeof(directory_path), writer->path, 0, LOG_DIRECTORY_EXTENSION);
+
+    writer->directory_file = safe_fopen(directory_path, "wb");
+    write_log_directory(writer->directory_file, &writer->directory, true);
+    writer->directory_changed = false;
+
+    return;
+}
+
+/**
+ * @brief Scrive su disco l'indice del segmento corrente e poi la sua directory, così la directory non copre mai voci non ancora scritte.
+ * 
+ * @param writer Puntatore al thread di scrittura.
+ */
+static void flush_log_index(Log_writer* writer) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    fflush(writer->index_file);
+    write_log_directory(writer->directory_file, &writer->directory, writer->directory_changed);
+    writer->directory_changed = false;
+
+    return;
+}
+
+/**
+ * @brief Chiude il segmento corrente del file di log e ne apre uno nuovo: i segmenti precedenti vengono rinominati
+ * ("log.bin" => "log.bin.1" => "log.bin.2" ...) e il più vecchio oltre LOG_MAX_SEGMENTS viene eliminato, insieme agli indici e alle directory.
+ * 
+ * @param writer Puntatore al thread di scrittura.
+ */
+static void rotate_log_segments(Log_writer* writer) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    flush_log_index(writer);
+    fclose(writer->file);
+    fclose(writer->index_file);
+    fclose(writer->directory_file);
+
+    static const char* extensions[] = {"", LOG_INDEX_EXTENSION, LOG_DIRECTORY_EXTENSION};
+    char from[LOG_SEGMENT_PATH_LENGTH];
+    char to[LOG_SEGMENT_PATH_LENGTH];
+
+    for (int segment = LOG_MAX_SEGMENTS - 1; segment > 0; segment--) {
+        for (int i = 0; i < 3; i++) {
+            get_segment_path(from, sizeof(from), writer->path, segment - 1, extensions[i]);
+            get_segment_path(to, sizeof(to), writer->path, segment, extensions[i]);
+
+            remove(to); // Elimina il segmento più vecchio (rename non sovrascrive i file esistenti su Windows)
+            rename(from, to);
+        }
+    }
+
+    open_log_segment(writer, "wb");
+    writer->directory = (Log_directory) {0};
+    open_log_directory(writer);
+
+    return;
+}
+
+/**
+ * @brief Sospende il thread di scrittura finché la partita non accoda una nuova richiesta.
+ * 
+ * @param writer Puntatore al thread di scrittura.
+ * @param head Posto della prossima richiesta da leggere (la coda è vuota SE coincide con il tail).
+ */
+static void wait_log_requests(Log_writer* writer, unsigned int head) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    lock_mutex(&writer->mutex);
+
+    // Il flag va pubblicato prima di ricontrollare il tail: così la partita vede il flag o il thread vede la nuova richiesta
+    __atomic_store_n(&writer->writer_waiting, true, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&writer->tail, __ATOMIC_SEQ_CST) == head) {
+        wait_condition(&writer->requested, &writer->mutex);
+    }
+    __atomic_store_n(&writer->writer_waiting, false, __ATOMIC_SEQ_CST);
+
+    unlock_mutex(&writer->mutex);
+    return;
+}
+
+/**
+ * @brief Sospende la partita finché il thread di scrittura non ha eseguito tutte le richieste precedenti a un posto della coda.
+ * 
+ * @param writer Puntatore al thread di scrittura.
+ * @param head Posto da raggiungere (il thread di scrittura ha eseguito le richieste precedenti quando il suo head lo raggiunge).
+ */
+static void wait_log_writer(Log_writer* writer, unsigned int head) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    lock_mutex(&writer->mutex);
+
+    // Il flag va pubblicato prima di ricontrollare l'head: così il thread di scrittura vede il flag o la partita vede il nuovo head
+    // (la differenza con segno resta corretta anche quando i contatori ripartono da 0)
+    __atomic_store_n(&writer->game_waiting, true, __ATOMIC_SEQ_CST);
+    while ((int) (__atomic_load_n(&writer->head, __ATOMIC_SEQ_CST) - head) < 0) {
+        wait_condition(&writer->completed, &writer->mutex);
+    }
+    __atomic_store_n(&writer->game_waiting, false, __ATOMIC_SEQ_CST);
+
+    unlock_mutex(&writer->mutex);
+    return;
+}
+
+/**
+ * @brief Funzione del thread di scrittura: esegue le richieste della coda nell'ordine in cui sono state accodate,
+ * finché non riceve la richiesta di chiusura. Quando la coda è vuota il thread resta sospeso (non si risveglia periodicamente).
+ * 
+ * @param arg Puntatore al thread di scrittura (Log_writer).
+ */
+static void run_log_writer(void* arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Log_writer* writer = (Log_writer*) arg;
+    bool running = true;
+
+    while (running) {
+        unsigned int head = __atomic_load_n(&writer->head, __ATOMIC_RELAXED);
+
+        // SE la coda è vuota => attende nuove richieste
+        // (il tail viene letto con acquire: la richiesta è completa prima che il nuovo tail sia visibile)
+        if (head == __atomic_load_n(&writer->tail, __ATOMIC_ACQUIRE)) {
+            wait_log_requests(writer, head);
+            continue;
+        }
+
+        Log_write* request = &writer->queue[head % LOG_QUEUE_SIZE];
+        switch (request->kind) {
+            case LOG_WRITE_LOG:
+                safe_fwrite(request->data, 1, request->length, writer->file);
+                break;
+            case LOG_WRITE_INDEX: {
+                // La voce viene collegata alla directory qui, dove è noto il suo numero nell'indice
+                Log_index_entry entry;
+                decode_index_entry(request->data, &entry);
+                link_index_entry(&writer->directory, &entry);
+                writer->directory_changed = writer->directory_changed || entry.type == LOG_INDEX_GAME;
+                encode_index_entry(&entry, request->data);
+                safe_fwrite(request->data, 1, request->length, writer->index_file);
+                break;
+            }
+            case LOG_WRITE_FLUSH:
+                fflush(writer->file);
+                flush_log_index(writer);
+                break;
+            case LOG_WRITE_ROTATE:
+                rotate_log_segments(writer);
+                break;
+            case LOG_WRITE_STOP:
+                running = false;
+                break;
+        }
+
+        // SE è la richiesta di chiusura => i file vanno chiusi prima di segnalarla come eseguita
+        if (!running) {
+            fclose(writer->file); // Chiude il file di log (scrivendo su disco il contenuto del buffer)
+            flush_log_index(writer);
+            fclose(writer->index_file);
+            fclose(writer->directory_file);
+        }
+
+        // Libera il posto della richiesta e, SE la partita attende, la risveglia
+        __atomic_store_n(&writer->head, head + 1, __ATOMIC_SEQ_CST);
+        if (__atomic_load_n(&writer->game_waiting, __ATOMIC_SEQ_CST)) {
+            lock_mutex(&writer->mutex);
+            signal_condition(&writer->completed);
+            unlock_mutex(&writer->mutex);
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Accoda una richiesta per il thread di scrittura (coda senza lock con un solo produttore e un solo consumatore).
+ * 
+ * La partita non scrive mai su disco: attende solo SE la coda è piena, cioè SE il disco è molto più lento della partita.
+ * 
+ * @param writer Puntatore al thread di scrittura.
+ * @param kind Tipo della richiesta.
+ * @param data Byte da scrivere (NULL SE la richiesta non ne ha).
+ * @param length Numero di byte da scrivere (al massimo LOG_RECORD_SIZE).
+ */
+static void push_log_write(Log_writer* writer, Log_write_kind kind, const void* data, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned int tail = __atomic_load_n(&writer->tail, __ATOMIC_RELAXED);
+
+    // SE la coda è piena => attende che il thread di scrittura liberi un posto
+    // (l'head viene letto con acquire: il posto viene riscritto solo dopo che il thread di scrittura lo ha letto)
+    if (tail - __atomic_load_n(&writer->head, __ATOMIC_ACQUIRE) >= LOG_QUEUE_SIZE) {
+        wait_log_writer(writer, tail - LOG_QUEUE_SIZE + 1);
+    }
+
+    Log_write* request = &writer->queue[tail % LOG_QUEUE_SIZE];
+    request->kind = (uint8_t) kind;
+    request->length = (uint8_t) length;
+    if (length > 0) {
+        memcpy(request->data, data, length);
+    }
+
+    // Pubblica la richiesta (completa prima del nuovo tail) e, SE il thread di scrittura attende, lo risveglia
+    __atomic_store_n(&writer->tail, tail + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&writer->writer_waiting, __ATOMIC_SEQ_CST)) {
+        lock_mutex(&writer->mutex);
+        signal_condition(&writer->requested);
+        unlock_mutex(&writer->mutex);
+    }
+
+    return;
+}
+
+/**
+ * @brief Accoda una voce all'indice del logger, che punta al prossimo record del file di log.
+ * 
+ * @param logger Puntatore al logger della partita.
+ * @param type Tipo della voce.
+ * @param card Id della carta (voci LOG_INDEX_CARD).
+ * @param round Turno (voci LOG_INDEX_TURN).
+ * @param name_hash Hash del nome della partita (voci LOG_INDEX_GAME).
+ */
+static void index_next_record(Logger* logger, Log_index_type type, uint16_t card, uint32_t round, uint64_t name_hash) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Log_index_entry entry = {(uint8_t) type, card, round, logger->offset, name_hash, 0}; // Il collegamento alla directory viene impostato dal thread di scrittura
+    unsigned char bytes[LOG_INDEX_ENTRY_SIZE];
+    encode_index_entry(&entry, bytes);
+    push_log_write(logger->writer, LOG_WRITE_INDEX, bytes, LOG_INDEX_ENTRY_SIZE);
+
+    return;
+}
+
+/**
+ * @brief Accoda dei byte al file di log, tenendo il conto dell'offset (senza chiederlo al file ad ogni scrittura).
+ * 
+ * @param logger Puntatore al logger della partita.
+ * @param data Puntatore ai byte da scrivere.
+ * @param size Numero di byte da scrivere.
+ */
+static void write_log_bytes(Logger* logger, const void* data, size_t size) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // I byte vengono accodati a blocchi di LOG_RECORD_SIZE (la dimensione di un posto della coda)
+    const unsigned char* bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; i += LOG_RECORD_SIZE) {
+        push_log_write(logger->writer, LOG_WRITE_LOG, bytes + i, size - i < LOG_RECORD_SIZE ? size - i : LOG_RECORD_SIZE);
+    }
+    logger->offset += size;
+
+    return;
+}
+
 /**
- * @brief Inizializza il file di log.
+ * @brief Scrive l'intestazione di un segmento vuoto del file di log (magic e versione, lunga quanto un record).
  * 
- * @return FILE* Puntatore al file di log.
+ * @param logger Puntatore al logger della partita.
  */
-FILE* init_log() {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static void write_log_header(Logger* logger) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char header[LOG_RECORD_SIZE] = {0};
+    memcpy(header, LOG_MAGIC, LOG_MAGIC_LEN);
+    put_uint(header + LOG_MAGIC_LEN, LOG_VERSION, 4);
+    write_log_bytes(logger, header, LOG_RECORD_SIZE);
 
-    FILE* log_file = NULL; // Inizializzazione del file di log
+    return;
+}
 
-    // SE il file di log non esiste
-    if (!file_exists(DEFAULT_LOG_FILE_PATH)) {
-        log_file = safe_fopen(DEFAULT_LOG_FILE_PATH, "w"); // Crea il file di log in modalità scrittura
+/**
+ * @brief Apre il file di log di una partita e avvia il suo thread di scrittura, che resta attivo finché la partita non viene chiusa.
+ * 
+ * Il file è binario e viene solo accodato: SE è vuoto viene scritta l'intestazione. Gli eventi vengono passati al thread
+ * di scrittura, quindi la partita non attende mai il disco (l'apertura e l'eventuale ricostruzione dell'indice sono sincrone).
+ * 
+ * @param logger Puntatore al logger della partita.
+ * @param path Percorso del file di log (creato SE non esiste).
+ */
+void open_logger(Logger* logger, const char* path) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    logger->flush_policy = default_flush_policy;
+    logger->rotation_policy = default_rotation_policy;
+    logger->round = 0;
+    logger->named_cards = NULL;
+    logger->num_named_cards = 0;
+    logger->indexed_round = 0;
+
+    Log_writer* writer = (Log_writer*) safe_calloc(1, sizeof(Log_writer));
+    strncpy(writer->path, path, MAX_FILENAME_LENGTH);
+    writer->queue = (Log_write*) safe_malloc(LOG_QUEUE_SIZE * sizeof(Log_write));
+    writer->buffer = (char*) safe_malloc(LOG_BUFFER_SIZE);
+    init_mutex(&writer->mutex);
+    init_condition(&writer->requested);
+    init_condition(&writer->completed);
+    logger->writer = writer;
+
+    // Apre il file di log in modalità append (creandolo SE non esiste), con l'indice accanto (es. "log.bin.idx")
+    open_log_segment(writer, "ab");
+    fseek(writer->file, 0, SEEK_END);
+    logger->offset = (uint64_t) ftell(writer->file);
+
+    char index_path[LOG_SEGMENT_PATH_LENGTH];
+    get_segment_path(index_path, sizeof(index_path), path, 0, LOG_INDEX_EXTENSION);
+    fclose(writer->index_file);
+
+    // SE il file è vuoto => riparte anche l'indice (quello di un file di log cancellato non vale più)
+    if (logger->offset == 0) {
+        writer->index_file = safe_fopen(index_path, "wb");
     } else {
-        log_file = safe_fopen(DEFAULT_LOG_FILE_PATH, "a"); // Apre il file di log in modalità append
+        // Altrimenti legge la directory dell'indice (ricostruendo indice e directory SE mancano, es. sono stati cancellati)
+        load_log_directory(path, &writer->directory);
+        writer->index_file = safe_fopen(index_path, "ab");
     }
+    open_log_directory(writer);
 
-    // SE il file di log non è stato aperto correttamente
-    if (log_file == NULL) {
-        printf(RED "[!] Errore nell'apertura del file di log \"%s\"!" RESET, DEFAULT_LOG_FILE_PATH);
-        exit(EXIT_FAILURE);
+    start_thread(&writer->thread, run_log_writer, writer);
+
+    // SE il file è vuoto => scrive l'intestazione
+    if (logger->offset == 0) {
+        write_log_header(logger);
     }
 
-    return log_file;
+    return;
 }
 
 /**
- * @brief Registra l'inizio di una nuova partita nel file di log.
+ * @brief Attende che il thread di scrittura abbia scritto tutti gli eventi e chiude il file di log di una partita.
  * 
- * @param game_name Nome della partita.
+ * @param logger Puntatore al logger della partita (se non è aperto non fa nulla).
+ */
+void close_logger(Logger* logger) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il logger non è aperto => non fa nulla
+    if (logger->writer == NULL) {
+        return;
+    }
+
+    // Il thread di scrittura chiude i file dopo aver eseguito tutte le richieste precedenti
+    push_log_write(logger->writer, LOG_WRITE_STOP, NULL, 0);
+    join_thread(&logger->writer->thread);
+
+    destroy_condition(&logger->writer->completed);
+    destroy_condition(&logger->writer->requested);
+    destroy_mutex(&logger->writer->mutex);
+    free(logger->writer->queue);
+    free(logger->writer->buffer);
+    free(logger->writer);
+    free(logger->named_cards);
+
+    logger->writer = NULL;
+    logger->named_cards = NULL;
+    logger->num_named_cards = 0;
+
+    return;
+}
+
+/**
+ * @brief Applica la politica di scrittura su disco dopo la registrazione di un evento.
+ * 
+ * @param logger Puntatore al logger della partita.
+ */
+static void log_commit(Logger* logger) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la politica richiede di scrivere ogni evento => chiede al thread di scrittura di scrivere subito su disco
+    // e attende che lo abbia fatto (un evento ancora in coda andrebbe perso in caso di exit o di crash)
+    if (logger->flush_policy == LOG_FLUSH_ALWAYS) {
+        push_log_write(logger->writer, LOG_WRITE_FLUSH, NULL, 0);
+        wait_log_writer(logger->writer, __atomic_load_n(&logger->writer->tail, __ATOMIC_RELAXED));
+    }
+
+    return;
+}
+
+/**
+ * @brief Segna l'inizio di un nuovo turno nel log, scrivendo su disco gli eventi del turno precedente SE richiesto dalla politica.
+ * 
+ * @param logger Puntatore al logger della partita.
+ */
+void log_next_round(Logger* logger) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    logger->round++; // Incrementa il contatore dei round
+
+    // SE il logger è aperto e la politica richiede di scrivere ad ogni turno => chiede al thread di scrittura di scrivere su disco
+    if (logger->writer != NULL && logger->flush_policy != LOG_FLUSH_EXIT) {
+        push_log_write(logger->writer, LOG_WRITE_FLUSH, NULL, 0);
+    }
+
+    return;
+}
+
+/**
+ * @brief Scrive un record seguito da un testo, completato con byte nulli fino a un multiplo di LOG_RECORD_SIZE
+ * (così ogni record del file inizia a un offset multiplo di LOG_RECORD_SIZE).
+ * 
+ * @param logger Puntatore al logger della partita.
+ * @param record Puntatore al record da scrivere (il campo length viene impostato dalla funzione).
+ * @param text Testo da scrivere dopo il record.
+ */
+static void write_text_record(Logger* logger, Log_record* record, const char* text) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    size_t length = strlen(text);
+    unsigned char bytes[LOG_RECORD_SIZE] = {0};
+
+    record->length = (uint32_t) length;
+    encode_record(record, bytes);
+    write_log_bytes(logger, bytes, LOG_RECORD_SIZE);
+
+    write_log_bytes(logger, text, length);
+    memset(bytes, 0, LOG_RECORD_SIZE);
+    write_log_bytes(logger, bytes, padded_length(length) - length);
+
+    return;
+}
+
+/**
+ * @brief Registra l'inizio di una partita (nuova o caricata) nel file di log, con i nomi dei giocatori seduti ai vari posti.
+ * 
+ * @param logger Puntatore al logger della partita.
+ * @param game Puntatore alla partita.
+ * @param type Tipo del record di inizio (LOG_EVENT_INIT_GAME o LOG_EVENT_LOAD_GAME).
  */
-void log_init_game(const char* game_name) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static void log_game_header(Logger* logger, const Game* game, Log_event_type type) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il logger non è aperto => non registra nulla
+    if (logger->writer == NULL) {
+        return;
+    }
 
-    log_prefix_round(false, true); // Reset del contatore dei round
+    // SE il segmento corrente contiene già delle partite e va ruotato (ad ogni partita o quando supera la dimensione massima)
+    // => la partita inizia in un nuovo segmento (una partita non viene mai divisa tra due segmenti)
+    if (logger->offset > LOG_RECORD_SIZE && (logger->rotation_policy == LOG_ROTATE_GAME || logger->offset >= LOG_MAX_SEGMENT_SIZE)) {
+        push_log_write(logger->writer, LOG_WRITE_ROTATE, NULL, 0);
+        logger->offset = 0;
+        write_log_header(logger);
+    }
+
+    // I nomi delle carte vanno registrati di nuovo per ogni partita (il renderer li dimentica ad ogni inizio)
+    if (logger->named_cards != NULL) {
+        memset(logger->named_cards, 0, (size_t) logger->num_named_cards * sizeof(bool));
+    }
+
+    index_next_record(logger, LOG_INDEX_GAME, LOG_NO_CARD, 0, hash_name(game->name));
+    logger->indexed_round = 0;
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    Log_record record = {0, (uint8_t) type, LOG_NO_PLAYER, LOG_NO_PLAYER, 0, LOG_NO_CARD, LOG_NO_CARD, 0, 0};
+    write_text_record(logger, &record, game->name);
 
-    char* game_separator = repeat_string(UNICODE_BORDER_HORIZONTAL, LOG_GAME_SEPARATOR_SIZE); // Separatore della partita
+    // I giocatori vengono registrati per posto (a partire dal primo giocatore della lista): gli eventi riportano solo il posto
+    uint8_t seat = 0;
+    const Player* player = game->players;
+    do {
+        record = (Log_record) {0, LOG_EVENT_PLAYER_NAME, seat++, LOG_NO_PLAYER, 0, LOG_NO_CARD, LOG_NO_CARD, 0, 0};
+        write_text_record(logger, &record, player->name);
+        player = player->next_player;
+    } while (player != game->players);
 
-    fprintf(log_file, "\n%s\n", game_separator); // Scrive il separatore della partita
-    fprintf(log_file, "\n[+] Inizio di una nuova partita \"%s\" salvata in \"%s%s%s\"\n\n", game_name, SAVES_FOLDER, game_name, SAVES_EXTENSION);
+    log_commit(logger); // Applica la politica di scrittura su disco
+    return;
+}
+
+/**
+ * @brief Registra l'inizio di una nuova partita nel file di log.
+ * 
+ * @param logger Puntatore al logger della partita.
+ * @param game Puntatore alla partita (con i giocatori già inizializzati).
+ */
+void log_init_game(Logger* logger, const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    free(game_separator); // Libera la memoria allocata per il separatore della partita
-    fclose(log_file); // Chiude il file di log
+    log_game_header(logger, game, LOG_EVENT_INIT_GAME);
     return;
 }
 
 /**
  * @brief Registra il caricamento di una partita salvata nel file di log.
  * 
- * @param game_name Nome del salvataggio.
+ * @param logger Puntatore al logger della partita.
+ * @param game Puntatore alla partita caricata.
+ */
+void log_load_game(Logger* logger, const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    log_game_header(logger, game, LOG_EVENT_LOAD_GAME);
+    return;
+}
+
+/**
+ * @brief Restituisce il posto di un giocatore, cioè la sua posizione nella lista dei giocatori della partita.
+ * 
+ * @param player Puntatore al giocatore.
+ * @return uint8_t Posto del giocatore.
  */
-void log_load_game(const char* game_name) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static uint8_t get_player_seat(const Player* player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint8_t seat = 0;
+    for (const Player* current = player->game->players; current != player; current = current->next_player) {
+        seat++;
+    }
 
-    log_prefix_round(false, true); // Reset del contatore dei round
+    return seat;
+}
+
+/**
+ * @brief Registra il nome di una definizione di carta la prima volta che compare in un evento della partita.
+ * 
+ * @param logger Puntatore al logger della partita.
+ * @param definition Puntatore alla definizione della carta.
+ */
+static void log_card_name(Logger* logger, const Card_definition* definition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la tabella delle carte registrate è troppo piccola => la allarga (le definizioni possono essere aggiunte dai salvataggi)
+    if (definition->id >= logger->num_named_cards) {
+        int capacity = count_card_definitions() > definition->id ? count_card_definitions() : definition->id + 1;
+        logger->named_cards = (bool*) safe_realloc(logger->named_cards, (size_t) capacity * sizeof(bool));
+        memset(logger->named_cards + logger->num_named_cards, 0, (size_t) (capacity - logger->num_named_cards) * sizeof(bool));
+        logger->num_named_cards = capacity;
+    }
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    // SE il nome è già stato registrato nella partita => non c'è nulla da fare
+    if (logger->named_cards[definition->id]) {
+        return;
+    }
 
-    char* game_separator = repeat_string(UNICODE_BORDER_HORIZONTAL, LOG_GAME_SEPARATOR_SIZE); // Separatore della partita
+    index_next_record(logger, LOG_INDEX_CARD, (uint16_t) definition->id, 0, 0);
 
-    fprintf(log_file, "\n%s\n", game_separator); // Scrive il separatore della partita
-    fprintf(log_file, "\n[+] Caricamento del salvataggio \"%s%s%s\"\n\n", SAVES_FOLDER, game_name, SAVES_EXTENSION);
+    Log_record record = {0, LOG_EVENT_CARD_NAME, LOG_NO_PLAYER, LOG_NO_PLAYER, (uint8_t) definition->type, (uint16_t) definition->id, LOG_NO_CARD, 0, 0};
+    write_text_record(logger, &record, definition->name);
+    logger->named_cards[definition->id] = true;
 
-    free(game_separator); // Libera la memoria allocata per il separatore della partita
-    fclose(log_file); // Chiude il file di log
     return;
 }
 
 /**
- * @brief Scrive il prefisso del turno nel file di log.
+ * @brief Registra un evento della partita nel file di log come record a dimensione fissa (turno, hash, posti dei giocatori e id delle carte).
  * 
- * @param next_round Flag per il prossimo turno.
- * @param reset Flag per il reset del numero dei turni.
- * @return int Numero del turno.
+ * @param type Tipo dell'evento.
+ * @param player Puntatore al giocatore che compie l'azione.
+ * @param target_player Puntatore al giocatore bersaglio (NULL SE assente).
+ * @param card Puntatore alla carta dell'evento (NULL SE assente).
+ * @param other_card Puntatore alla carta usata per bloccare (NULL SE assente).
  */
-int log_prefix_round(bool next_round, bool reset) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static void log_event(Log_event_type type, const Player* player, const Player* target_player, const Card* card, const Card* other_card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Logger* logger = &player->game->logger; // Logger della partita a cui partecipa il giocatore
 
-    static int round = 0; // Inizializzazione del contatore dei round
+    // SE il logger non è aperto (es. partite simulate) o il round è 0 (la partita non è ancora iniziata) => non registra nulla
+    if (logger->writer == NULL || logger->round == 0) {
+        return;
+    }
+
+    Log_record record = {(uint32_t) logger->round, (uint8_t) type, get_player_seat(player), LOG_NO_PLAYER, 0, LOG_NO_CARD, LOG_NO_CARD, 0, hash_game(player->game)};
+
+    if (target_player != NULL) {
+        record.target = get_player_seat(target_player);
+    }
 
-    // SE il reset è true
-    if (reset == true) {
-        round = 0; // Reset del contatore dei round
-        return round;
+    if (card != NULL) {
+        log_card_name(logger, card->def);
+        record.card = (uint16_t) card->def->id;
+        record.card_type = (uint8_t) card->def->type;
     }
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    if (other_card != NULL) {
+        log_card_name(logger, other_card->def);
+        record.other_card = (uint16_t) other_card->def->id;
+    }
 
-    // SE il next_round è true
-    if (next_round == true) {
-        round++; // Incrementa il contatore dei round
-    } else if (round > 0) {
-        // SE il round è maggiore di 0 (ovvero, la partita è iniziata)
-        fprintf(log_file, "[Turno %d]: ", round); // Scrive il prefisso del round
+    // SE è il primo evento del turno => lo registra nell'indice
+    if (logger->round != logger->indexed_round) {
+        index_next_record(logger, LOG_INDEX_TURN, LOG_NO_CARD, record.round, 0);
+        logger->indexed_round = logger->round;
     }
 
-    fclose(log_file); // Chiude il file di log
-    return round;
+    unsigned char bytes[LOG_RECORD_SIZE];
+    encode_record(&record, bytes);
+    write_log_bytes(logger, bytes, LOG_RECORD_SIZE);
+
+    log_commit(logger); // Applica la politica di scrittura su disco
+    return;
 }
 
 /**
@@ -111,18 +1152,9 @@ int log_prefix_round(bool next_round, bool reset) {
  * @param card Puntatore alla carta pescata.
  */
 void log_draw_card(const Player* player, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
-
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di pesca della carta
-
-    fprintf(log_file, "\"%s\" ha pescato la carta \"%s\".\n", player->name, card->name);
-
-    fclose(log_file); // Chiude il file di log
+    log_event(LOG_EVENT_DRAW, player, NULL, card, NULL);
     return;
 }
 
@@ -133,18 +1165,9 @@ void log_draw_card(const Player* player, const Card* card) {
  * @param card Puntatore alla carta giocata.
  */
 void log_play_card(const Player* player, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
-
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di giocata della carta
-
-    fprintf(log_file, "\"%s\" ha giocato la carta \"%s\".\n", player->name, card->name);
-
-    fclose(log_file); // Chiude il file di log
+    log_event(LOG_EVENT_PLAY, player, NULL, card, NULL);
     return;
 }
 
@@ -155,18 +1178,9 @@ void log_play_card(const Player* player, const Card* card) {
  * @param card Puntatore alla carta scartata.
  */
 void log_discard_card(const Player* player, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
-
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scarto della carta
-
-    fprintf(log_file, "\"%s\" ha scartato la carta \"%s\".\n", player->name, card->name);
-
-    fclose(log_file); // Chiude il file di log
+    log_event(LOG_EVENT_DISCARD, player, NULL, card, NULL);
     return;
 }
 
@@ -178,18 +1192,9 @@ void log_discard_card(const Player* player, const Card* card) {
  * @param card_blocked Puntatore alla carta a cui è stato bloccato l'effetto.
  */
 void log_block_effect(const Player* player, const Card* card_used, const Card* card_blocked) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
-
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scarto della carta
-
-    fprintf(log_file, "\"%s\" ha bloccato l'effetto della carta \"%s\" utilizzando la carta \"%s\".\n", player->name, card_blocked->name, card_used->name);
-
-    fclose(log_file); // Chiude il file di log
+    log_event(LOG_EVENT_BLOCK, player, NULL, card_blocked, card_used);
     return;
 }
 
@@ -201,18 +1206,9 @@ void log_block_effect(const Player* player, const Card* card_used, const Card* c
  * @param card Puntatore alla carta che è stata scartata.
  */
 void log_scarta_effect(const Player* player, const Player* target_player, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
-
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scarto della carta
-
-    fprintf(log_file, "\"%s\" ha scartato la carta \"%s\" dalla mano di \"%s\".\n", player->name, card->name, target_player->name);
-
-    fclose(log_file); // Chiude il file di log
+    log_event(LOG_EVENT_SCARTA, player, target_player, card, NULL);
     return;
 }
 
@@ -224,128 +1220,487 @@ void log_scarta_effect(const Player* player, const Player* target_player, const
  * @param card Puntatore alla carta che è stata eliminata.
  */
 void log_elimina_effect(const Player* player, const Player* target_player, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    log_event(LOG_EVENT_ELIMINA, player, target_player, card, NULL);
+    return;
+}
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
+/**
+ * @brief Registra l'azione dell'effetto ruba nel file di log.
+ * 
+ * @param player Puntatore al giocatore che ha attivato l'effetto.
+ * @param target_player Puntatore al giocatore target dell'effetto.
+ * @param card Puntatore alla carta che è stata rubata.
+ */
+void log_ruba_effect(const Player* player, const Player* target_player, const Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scarto della carta
+    log_event(LOG_EVENT_RUBA, player, target_player, card, NULL);
+    return;
+}
 
-    switch (card->type) {
-        case STUDENTE:
-        case MATRICOLA:
-        case STUDENTE_SEMPLICE:
-        case LAUREANDO:
-            fprintf(log_file, "\"%s\" ha eliminato la carta \"%s\" dall'aula studio di \"%s\".\n", player->name, card->name, target_player->name);
-            break;
-        case BONUS:
-        case MALUS:
-            fprintf(log_file, "\"%s\" ha eliminato la carta \"%s\" dall'aula bonus/malus di \"%s\".\n", player->name, card->name, target_player->name);
-            break;
-    }
+/**
+ * @brief Registra l'azione dell'effetto prendi nel file di log.
+ * 
+ * @param player Puntatore al giocatore che ha attivato l'effetto.
+ * @param target_player Puntatore al giocatore target dell'effetto.
+ * @param card Puntatore alla carta che è stata presa.
+ */
+void log_prendi_effect(const Player* player, const Player* target_player, const Card* card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    fclose(log_file); // Chiude il file di log
+    log_event(LOG_EVENT_PRENDI, player, target_player, card, NULL);
     return;
 }
 
 /**
- * @brief Registra l'azione dell'effetto ruba nel file di log.
+ * @brief Registra l'azione di scambio delle carte in mano nel file di log.
  * 
  * @param player Puntatore al giocatore che ha attivato l'effetto.
  * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta che è stata rubata.
  */
-void log_ruba_effect(const Player* player, const Player* target_player, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void log_scambia_effect(const Player* player, const Player* target_player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    log_event(LOG_EVENT_SCAMBIA, player, target_player, NULL, NULL);
+    return;
+}
+
+/**
+ * @brief Registra l'azione di vittoria di un giocatore nel file di log.
+ * 
+ * @param player Puntatore al giocatore vincitore.
+ */
+void log_winner_game(const Player* player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    log_event(LOG_EVENT_WINNER, player, NULL, NULL, NULL);
+    return;
+}
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+/**
+ * @brief Restituisce il nome registrato per un posto o per una carta, o un segnaposto SE il nome non è stato registrato.
+ * 
+ * @param names Tabella dei nomi.
+ * @param num_names Dimensione della tabella.
+ * @param id Posto del giocatore o id della carta.
+ * @return const char* Nome registrato.
+ */
+static const char* get_logged_name(char (*names)[MAX_NAME_LENGTH + 1], int num_names, int id) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    return id < num_names && names[id][0] != '\0' ? names[id] : "?";
+}
+
+/**
+ * @brief Scrive la riga di testo di un evento, nello stesso formato leggibile del vecchio file di log testuale.
+ * 
+ * @param out File su cui scrivere la riga.
+ * @param record Puntatore al record dell'evento.
+ * @param actor Nome del giocatore che compie l'azione.
+ * @param target Nome del giocatore bersaglio.
+ * @param card Nome della carta dell'evento.
+ * @param other_card Nome della carta usata per bloccare.
+ */
+static void render_event(FILE* out, const Log_record* record, const char* actor, const char* target, const char* card, const char* other_card) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
+    // Le carte studente finiscono nell'aula studio, le altre (bonus e malus) nell'aula bonus/malus
+    bool student = record->card_type == STUDENTE || record->card_type == MATRICOLA || record->card_type == STUDENTE_SEMPLICE || record->card_type == LAUREANDO;
+    const char* room = student ? "aula studio" : "aula bonus/malus";
 
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scarto della carta
+    fprintf(out, "[Turno %" PRIu32 "][%016" PRIx64 "]: ", record->round, record->hash); // Prefisso del round e hash della partita
 
-    switch (card->type) {
-        case STUDENTE:
-        case MATRICOLA:
-        case STUDENTE_SEMPLICE:
-        case LAUREANDO:
-            fprintf(log_file, "\"%s\" ha rubato la carta \"%s\" dall'aula studio di \"%s\".\n", player->name, card->name, target_player->name);
+    switch (record->type) {
+        case LOG_EVENT_DRAW:
+            fprintf(out, "\"%s\" ha pescato la carta \"%s\".\n", actor, card);
+            break;
+        case LOG_EVENT_PLAY:
+            fprintf(out, "\"%s\" ha giocato la carta \"%s\".\n", actor, card);
+            break;
+        case LOG_EVENT_DISCARD:
+            fprintf(out, "\"%s\" ha scartato la carta \"%s\".\n", actor, card);
+            break;
+        case LOG_EVENT_BLOCK:
+            fprintf(out, "\"%s\" ha bloccato l'effetto della carta \"%s\" utilizzando la carta \"%s\".\n", actor, card, other_card);
+            break;
+        case LOG_EVENT_SCARTA:
+            fprintf(out, "\"%s\" ha scartato la carta \"%s\" dalla mano di \"%s\".\n", actor, card, target);
+            break;
+        case LOG_EVENT_ELIMINA:
+            fprintf(out, "\"%s\" ha eliminato la carta \"%s\" dall'%s di \"%s\".\n", actor, card, room, target);
+            break;
+        case LOG_EVENT_RUBA:
+            fprintf(out, "\"%s\" ha rubato la carta \"%s\" dall'%s di \"%s\".\n", actor, card, room, target);
+            break;
+        case LOG_EVENT_PRENDI:
+            fprintf(out, "\"%s\" ha preso la carta \"%s\" dalla mano di \"%s\".\n", actor, card, target);
             break;
-        case BONUS:
-        case MALUS:
-            fprintf(log_file, "\"%s\" ha rubato la carta \"%s\" dall'aula bonus/malus di \"%s\".\n", player->name, card->name, target_player->name);
+        case LOG_EVENT_SCAMBIA:
+            fprintf(out, "\"%s\" ha scambiato la propria mano con quella di \"%s\".\n", actor, target);
+            break;
+        case LOG_EVENT_WINNER:
+            fprintf(out, "Il giocatore \"%s\" ha vinto la partita!\n", actor);
             break;
     }
 
-    fclose(log_file); // Chiude il file di log
     return;
 }
 
 /**
- * @brief Registra l'azione dell'effetto prendi nel file di log.
+ * @brief Apre un file di log binario in lettura e ne controlla l'intestazione.
  * 
- * @param player Puntatore al giocatore che ha attivato l'effetto.
- * @param target_player Puntatore al giocatore target dell'effetto.
- * @param card Puntatore alla carta che è stata presa.
+ * @param reader Puntatore al lettore da inizializzare.
+ * @param path Percorso del file di log.
+ * @return true se il file è stato aperto ed è un file di log valido, false altrimenti.
  */
-void log_prendi_effect(const Player* player, const Player* target_player, const Card* card) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static bool open_log_reader(Log_reader* reader, const char* path) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    *reader = (Log_reader) {0};
+    reader->file = fopen(path, "rb");
+
+    // SE il file non esiste o non può essere aperto
+    if (reader->file == NULL) {
+        printf("[" RED "!" RESET "] Impossibile aprire il file di log \"%s\"!\n", path);
+        return false;
+    }
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    // Controllo dell'intestazione
+    unsigned char header[LOG_RECORD_SIZE];
+    if (fread(header, 1, LOG_RECORD_SIZE, reader->file) != LOG_RECORD_SIZE || memcmp(header, LOG_MAGIC, LOG_MAGIC_LEN) != 0 || get_uint(header + LOG_MAGIC_LEN, 4) != LOG_VERSION) {
+        printf("[" RED "!" RESET "] Il file \"%s\" non è un file di log valido!\n", path);
+        fclose(reader->file);
+        return false;
+    }
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
+    reader->game_separator = repeat_string(UNICODE_BORDER_HORIZONTAL, LOG_GAME_SEPARATOR_SIZE);
+    return true;
+}
 
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scarto della carta
+/**
+ * @brief Chiude un file di log aperto con open_log_reader e libera la memoria del lettore.
+ * 
+ * @param reader Puntatore al lettore.
+ */
+static void close_log_reader(Log_reader* reader) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    fprintf(log_file, "\"%s\" ha preso la carta \"%s\" dalla mano di \"%s\".\n", player->name, card->name, target_player->name);
+    fclose(reader->file);
+    free(reader->card_names);
+    free(reader->game_separator);
 
-    fclose(log_file); // Chiude il file di log
+    *reader = (Log_reader) {0};
     return;
 }
 
 /**
- * @brief Registra l'azione di scambio delle carte in mano nel file di log.
+ * @brief Applica un record al lettore: i record dei nomi aggiornano le tabelle dei nomi, gli altri vengono scritti come testo.
  * 
- * @param player Puntatore al giocatore che ha attivato l'effetto.
- * @param target_player Puntatore al giocatore target dell'effetto.
+ * @param reader Puntatore al lettore.
+ * @param record Puntatore al record.
+ * @param text Testo che segue il record (vuoto SE assente).
+ * @param out File su cui scrivere il testo (NULL => vengono solo aggiornate le tabelle dei nomi).
+ * @return true se il record è valido, false altrimenti.
  */
-void log_scambia_effect(const Player* player, const Player* target_player) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+static bool render_record(Log_reader* reader, const Log_record* record, const char* text, FILE* out) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    switch (record->type) {
+        case LOG_EVENT_INIT_GAME:
+        case LOG_EVENT_LOAD_GAME:
+            // Una nuova partita: i nomi della partita precedente non valgono più
+            memset(reader->player_names, 0, sizeof(reader->player_names));
+            if (reader->card_names != NULL) {
+                memset(reader->card_names, 0, (size_t) reader->num_card_names * sizeof(*reader->card_names));
+            }
+
+            if (out == NULL) {
+                break;
+            }
+
+            fprintf(out, "\n%s\n", reader->game_separator); // Scrive il separatore della partita
+            if (record->type == LOG_EVENT_INIT_GAME) {
+                fprintf(out, "\n[+] Inizio di una nuova partita \"%s\" salvata in \"%s%s%s\"\n\n", text, SAVES_FOLDER, text, SAVES_EXTENSION);
+            } else {
+                fprintf(out, "\n[+] Caricamento del salvataggio \"%s%s%s\"\n\n", SAVES_FOLDER, text, SAVES_EXTENSION);
+            }
+            break;
+        case LOG_EVENT_PLAYER_NAME:
+            if (record->actor < MAX_PLAYERS) {
+                snprintf(reader->player_names[record->actor], MAX_NAME_LENGTH + 1, "%s", text);
+            }
+            break;
+        case LOG_EVENT_CARD_NAME:
+            // SE la tabella dei nomi delle carte è troppo piccola => la allarga
+            if (record->card >= reader->num_card_names) {
+                int capacity = record->card + 1;
+                reader->card_names = safe_realloc(reader->card_names, (size_t) capacity * sizeof(*reader->card_names));
+                memset(reader->card_names + reader->num_card_names, 0, (size_t) (capacity - reader->num_card_names) * sizeof(*reader->card_names));
+                reader->num_card_names = capacity;
+            }
+            snprintf(reader->card_names[record->card], MAX_NAME_LENGTH + 1, "%s", text);
+            break;
+        default:
+            // SE il tipo non è quello di un evento => il record non è valido
+            if (record->type >= NUM_LOG_EVENTS) {
+                return false;
+            }
+
+            if (out != NULL) {
+                render_event(out, record,
+                    get_logged_name(reader->player_names, MAX_PLAYERS, record->actor), get_logged_name(reader->player_names, MAX_PLAYERS, record->target),
+                    get_logged_name(reader->card_names, reader->num_card_names, record->card), get_logged_name(reader->card_names, reader->num_card_names, record->other_card));
+            }
+            break;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Applica al lettore i record compresi tra due offset del file di log.
+ * 
+ * @param reader Puntatore al lettore.
+ * @param start Offset del primo record.
+ * @param end Offset in cui fermarsi (UINT64_MAX => fino alla fine del file).
+ * @param out File su cui scrivere il testo degli eventi (NULL => vengono solo aggiornate le tabelle dei nomi).
+ * @return true se i record sono validi (anche SE l'ultimo record è troncato), false altrimenti.
+ */
+static bool render_log_range(Log_reader* reader, uint64_t start, uint64_t end, FILE* out) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    fseek(reader->file, (long) start, SEEK_SET);
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    Log_record record;
+    char text[MAX_FILENAME_LENGTH + LOG_RECORD_SIZE]; // Testo che segue il record corrente
+    uint64_t offset = start;
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
+    while (offset < end) {
+        long size = read_log_record(reader->file, &record, text);
 
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scambio delle carte
+        // SE il file è finito (o l'ultimo record è troncato) => non c'è altro da leggere
+        if (size == 0) {
+            break;
+        }
 
-    fprintf(log_file, "\"%s\" ha scambiato la propria mano con quella di \"%s\".\n", player->name, target_player->name);
+        if (size < 0 || !render_record(reader, &record, text, out)) {
+            return false;
+        }
 
-    fclose(log_file); // Chiude il file di log
-    return;
+        offset += (uint64_t) size;
+    }
+
+    return true;
 }
 
 /**
- * @brief Registra l'azione di vittoria di un giocatore nel file di log.
+ * @brief Converte il file di log binario nel testo leggibile (una riga per evento, come il vecchio file di log testuale).
  * 
- * @param player Puntatore al giocatore vincitore.
+ * @param path Percorso del file di log binario.
+ * @param out File su cui scrivere il testo (es. stdout).
+ * @return true se il file è stato convertito (anche SE l'ultimo record è troncato), false se non è un file di log valido.
  */
-void log_winner_game(const Player* player) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+bool render_log(const char* path, FILE* out) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Log_reader reader;
+    if (!open_log_reader(&reader, path)) {
+        return false;
+    }
+
+    bool valid = render_log_range(&reader, LOG_RECORD_SIZE, UINT64_MAX, out);
 
-    FILE* log_file = init_log(); // Inizializzazione del file di log
+    // SE è stato trovato un record non valido
+    if (!valid) {
+        printf("[" RED "!" RESET "] Il file di log \"%s\" contiene un record non valido!\n", path);
+    }
 
-    int status = log_prefix_round(false, false); // Scrive il prefisso del round
+    close_log_reader(&reader);
+    return valid;
+}
 
-    // SE il round è 0, significa che la partita non è ancora iniziata
-    if (status == 0) return; // Dunque non registra l'azione di scarto della carta
+/**
+ * @brief Cerca nella directory dell'indice le voci di inizio delle partite con un certo hash del nome,
+ * seguendo la catena del bucket dell'hash (solo le partite il cui hash cade nello stesso bucket, non tutto l'indice).
+ * 
+ * @param index Puntatore al file dell'indice.
+ * @param directory Puntatore alla directory dell'indice.
+ * @param name_hash Hash del nome della partita.
+ * @param num_games Puntatore in cui salvare il numero di voci trovate.
+ * @return uint32_t* Vettore (da liberare) dei numeri delle voci trovate, dalla partita più recente alla più vecchia.
+ */
+static uint32_t* find_indexed_games(FILE* index, const Log_directory* directory, uint64_t name_hash, int* num_games) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int capacity = LOG_QUERY_INITIAL_CAPACITY;
+    uint32_t* games = (uint32_t*) safe_malloc((size_t) capacity * sizeof(uint32_t));
+    *num_games = 0;
+
+    uint32_t link = directory->heads[name_hash % LOG_DIRECTORY_BUCKETS];
+    Log_index_entry entry;
+
+    // Ogni voce punta a una voce precedente: SE il collegamento non torna indietro (o la voce non è un inizio partita) => l'indice è corrotto
+    while (link != 0 && read_index_entry_at(index, link - 1, &entry) && entry.type == LOG_INDEX_GAME && entry.previous < link) {
+        if (entry.name_hash == name_hash) {
+            // SE il vettore è pieno => raddoppia la capacità
+            if (*num_games == capacity) {
+                capacity *= 2;
+                games = (uint32_t*) safe_realloc(games, (size_t) capacity * sizeof(uint32_t));
+            }
+            games[(*num_games)++] = link - 1;
+        }
+        link = entry.previous;
+    }
 
-    fprintf(log_file, "Il giocatore \"%s\" ha vinto la partita!\n", player->name);
+    return games;
+}
 
-    fclose(log_file); // Chiude il file di log
-    return;
-}
\ No newline at end of file
+/**
+ * @brief Scrive gli eventi di una partita (o di un solo turno della partita) registrati in un segmento del file di log.
+ * 
+ * Le partite con il nome cercato vengono trovate con la directory dell'indice; dell'indice vengono lette solo le voci
+ * di quelle partite (fino al turno richiesto), e dal file di log solo i record richiesti (più l'inizio della partita
+ * e i nomi delle carte, SE è richiesto un solo turno). Una partita caricata più volte da un salvataggio compare più volte
+ * nel file di log: vengono scritte tutte le sue parti.
+ * 
+ * @param path Percorso del segmento del file di log.
+ * @param game_name Nome della partita.
+ * @param round Turno da scrivere (0 => tutta la partita).
+ * @param out File su cui scrivere il testo (es. stdout).
+ * @param valid Puntatore in cui salvare false SE il segmento contiene un record non valido.
+ * @return int Numero di parti della partita (o di turni) trovate nel segmento.
+ */
+static int query_log_segment(const char* path, const char* game_name, int round, FILE* out, bool* valid) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Log_reader reader;
+    if (!open_log_reader(&reader, path)) {
+        *valid = false;
+        return 0;
+    }
+
+    Log_directory directory;
+    load_log_directory(path, &directory);
+
+    char index_path[LOG_SEGMENT_PATH_LENGTH + LOG_INDEX_EXTENSION_LEN];
+    get_segment_path(index_path, sizeof(index_path), path, 0, LOG_INDEX_EXTENSION);
+    FILE* index = safe_fopen(index_path, "rb");
+
+    fseek(reader.file, 0, SEEK_END);
+    uint64_t log_size = (uint64_t) ftell(reader.file);
+
+    uint64_t name_hash = hash_name(game_name);
+    int num_games = 0;
+    uint32_t* games = find_indexed_games(index, &directory, name_hash, &num_games);
+
+    Log_record record;
+    char text[MAX_FILENAME_LENGTH + LOG_RECORD_SIZE];
+    int num_found = 0;
+
+    // Le partite vengono scritte nell'ordine del file di log (la catena parte dalla più recente)
+    for (int i = num_games - 1; *valid && i >= 0; i--) {
+        Log_index_entry game;
+        read_index_entry_at(index, games[i], &game);
+
+        // SE il nome non è quello cercato (l'hash può coincidere per nomi diversi => il nome viene controllato nel file di log)
+        fseek(reader.file, (long) game.offset, SEEK_SET);
+        if (read_log_record(reader.file, &record, text) <= 0 || strcmp(text, game_name) != 0) {
+            continue;
+        }
+
+        // Le voci della partita seguono quella del suo inizio, fino all'inizio della partita successiva (o alla fine dell'indice)
+        Log_index_entry entry;
+        fseek(index, (long) (games[i] + 1) * LOG_INDEX_ENTRY_SIZE, SEEK_SET);
+        bool has_entry = read_index_entry(index, &entry);
+
+        // SE è richiesta tutta la partita => la scrive dall'inizio fino all'inizio della partita successiva (o alla fine del file)
+        if (round == 0) {
+            while (has_entry && entry.type != LOG_INDEX_GAME) {
+                has_entry = read_index_entry(index, &entry);
+            }
+
+            *valid = render_log_range(&reader, game.offset, has_entry ? entry.offset : log_size, out);
+            num_found++;
+            continue;
+        }
+
+        // Inizio della partita (nomi dei giocatori), fino alla voce successiva
+        *valid = render_log_range(&reader, game.offset, has_entry ? entry.offset : log_size, NULL);
+
+        // Nomi delle carte registrati prima del turno, quindi il turno
+        while (*valid && has_entry && entry.type != LOG_INDEX_GAME) {
+            if (entry.type == LOG_INDEX_CARD) {
+                *valid = render_log_range(&reader, entry.offset, entry.offset + 1, NULL);
+            } else if (entry.type == LOG_INDEX_TURN && entry.round == (uint32_t) round) {
+                // Il turno finisce dove inizia il turno successivo o la partita successiva (o alla fine del file)
+                uint64_t turn_start = entry.offset;
+                do {
+                    has_entry = read_index_entry(index, &entry);
+                } while (has_entry && entry.type == LOG_INDEX_CARD);
+
+                *valid = render_log_range(&reader, turn_start, has_entry ? entry.offset : log_size, out);
+                num_found++;
+                break;
+            }
+
+            has_entry = read_index_entry(index, &entry);
+        }
+    }
+
+    // SE è stato trovato un record non valido
+    if (!*valid) {
+        printf("[" RED "!" RESET "] Il file di log \"%s\" contiene un record non valido!\n", path);
+    }
+
+    free(games);
+    fclose(index);
+    close_log_reader(&reader);
+
+    return num_found;
+}
+
+/**
+ * @brief Scrive gli eventi di una partita (o di un solo turno della partita) registrati nel file di log,
+ * cercandoli in tutti i segmenti conservati dalla rotazione, dal più vecchio al corrente.
+ * 
+ * @param path Percorso del file di log binario (segmento corrente).
+ * @param game_name Nome della partita.
+ * @param round Turno da scrivere (0 => tutta la partita).
+ * @param out File su cui scrivere il testo (es. stdout).
+ * @return true se la partita (o il turno) è stata trovata, false altrimenti.
+ */
+bool query_log(const char* path, const char* game_name, int round, FILE* out) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char segment_path[LOG_SEGMENT_PATH_LENGTH];
+    int num_segments = 0;
+    int num_found = 0;
+    bool valid = true;
+
+    for (int segment = LOG_MAX_SEGMENTS - 1; valid && segment >= 0; segment--) {
+        get_segment_path(segment_path, sizeof(segment_path), path, segment, "");
+
+        // SE il segmento non esiste (es. il file di log non è mai stato ruotato) => passa al successivo
+        FILE* file = fopen(segment_path, "rb");
+        if (file == NULL) {
+            continue;
+        }
+        fclose(file);
+
+        num_found += query_log_segment(segment_path, game_name, round, out, &valid);
+        num_segments++;
+    }
+
+    // SE non esiste nessun segmento o la partita (o il turno) non è stata trovata
+    if (num_segments == 0) {
+        printf("[" RED "!" RESET "] Impossibile aprire il file di log \"%s\"!\n", path);
+    } else if (valid && num_found == 0 && round == 0) {
+        printf("[" RED "!" RESET "] La partita \"%s\" non è presente nel file di log \"%s\"!\n", game_name, path);
+    } else if (valid && num_found == 0) {
+        printf("[" RED "!" RESET "] Il turno %d della partita \"%s\" non è presente nel file di log \"%s\"!\n", round, game_name, path);
+    }
+
+    return valid && num_found > 0;
+}
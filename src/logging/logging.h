@@ -2,12 +2,38 @@
 #define UNSTABLE_STUDENTS_LOGGING_H
 
 #include "../model/structs.h"
+#include "../thread/thread.h"
 #include <stdio.h>
 
-FILE* init_log();
-void log_init_game(const char* game_name);
-void log_load_game(const char* game_name);
-int log_prefix_round(bool next_round, bool reset);
+// Il thread di scrittura dipende dal sistema operativo, quindi non può stare in structs.h
+typedef struct Log_writer {
+    Thread thread;                      // Thread di scrittura
+    Log_write* queue;                   // Coda circolare delle richieste (LOG_QUEUE_SIZE posti, un solo produttore e un solo consumatore)
+    unsigned int head;                  // Prossima richiesta letta dal thread di scrittura (modificato solo dal thread di scrittura, con le operazioni __atomic)
+    unsigned int tail;                  // Prossimo posto libero (modificato solo dal thread della partita, con le operazioni __atomic)
+    bool writer_waiting;                // Il thread di scrittura attende nuove richieste (letto e scritto con le operazioni __atomic)
+    bool game_waiting;                  // La partita attende che il thread di scrittura esegua delle richieste (letto e scritto con le operazioni __atomic)
+    Mutex mutex;                        // Mutex delle attese (usato solo quando uno dei due thread deve attendere l'altro)
+    Condition requested;                // Segnalata quando la partita accoda una richiesta mentre il thread di scrittura attende
+    Condition completed;                // Segnalata quando il thread di scrittura esegue una richiesta mentre la partita attende
+    char path[MAX_FILENAME_LENGTH + 1]; // Percorso del segmento corrente del file di log
+    FILE* file;                         // Segmento corrente del file di log (usato solo dal thread di scrittura)
+    FILE* index_file;                   // Indice del segmento corrente (usato solo dal thread di scrittura)
+    FILE* directory_file;               // Directory dell'indice del segmento corrente (usata solo dal thread di scrittura)
+    Log_directory directory;            // Directory dell'indice in memoria, scritta su disco insieme all'indice
+    bool directory_changed;             // true SE una testa della directory è cambiata dall'ultima scrittura su disco
+    char* buffer;                       // Buffer in memoria del segmento corrente
+} Log_writer;
+
+void set_log_flush_policy(Log_flush_policy policy);
+bool parse_log_flush_policy(const char* str, Log_flush_policy* policy);
+void set_log_rotation_policy(Log_rotation_policy policy);
+bool parse_log_rotation_policy(const char* str, Log_rotation_policy* policy);
+void open_logger(Logger* logger, const char* path);
+void close_logger(Logger* logger);
+void log_next_round(Logger* logger);
+void log_init_game(Logger* logger, const Game* game);
+void log_load_game(Logger* logger, const Game* game);
 void log_draw_card(const Player* player, const Card* card);
 void log_play_card(const Player* player, const Card* card);
 void log_discard_card(const Player* player, const Card* card);
@@ -18,5 +44,7 @@ void log_ruba_effect(const Player* player, const Player* target_player, const Ca
 void log_prendi_effect(const Player* player, const Player* target_player, const Card* card);
 void log_scambia_effect(const Player* player, const Player* target_player);
 void log_winner_game(const Player* player);
+bool render_log(const char* path, FILE* out);
+bool query_log(const char* path, const char* game_name, int round, FILE* out);
 
 #endif
\ No newline at end of file
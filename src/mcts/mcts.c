@@ -0,0 +1,372 @@
+// Necessario per pthread con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "mcts.h"
+
+#include "../card/card.h"
+#include "../core/game.h"
+#include "../decision/decision.h"
+#include "../player/player.h"
+#include "../rng/rng.h"
+#include "../thread/thread.h"
+#include "../utils/utils.h"
+#include "../model/constants.h"
+#include <math.h>
+#include <stdlib.h>
+
+static int mcts_time_budget_ms = MCTS_TIME_BUDGET_MS; // Tempo di ricerca per mossa (impostato all'avvio, poi solo letto)
+
+// Carta scelta dall'ultima ricerca su un'azione di gioco, giocata senza ripetere la ricerca alla scelta della carta
+static THREAD_LOCAL const Player* pending_player = NULL;
+static THREAD_LOCAL const Card* pending_card = NULL;
+
+/**
+ * @brief Imposta il tempo di ricerca per mossa del bot MCTS.
+ *
+ * @param budget_ms Tempo di ricerca in millisecondi.
+ */
+void set_mcts_time_budget(int budget_ms) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    mcts_time_budget_ms = budget_ms;
+    return;
+}
+
+/**
+ * @brief Converte una stringa nel tempo di ricerca per mossa del bot MCTS.
+ *
+ * @param str Stringa da convertire (millisecondi, intero positivo).
+ * @param budget_ms Puntatore al tempo di ricerca in cui salvare il risultato.
+ * @return true Se la stringa è un tempo valido, false altrimenti.
+ */
+bool parse_mcts_time_budget(const char* str, int* budget_ms) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char* end = NULL;
+    long value = strtol(str, &end, 10);
+
+    // SE la stringa non è un intero positivo => il tempo non è valido
+    if (end == str || *end != '\0' || value < 1 || value > 60000) {
+        return false;
+    }
+
+    *budget_ms = (int) value;
+    return true;
+}
+
+/**
+ * @brief Sostituisce le informazioni nascoste al giocatore con una delle loro possibili configurazioni.
+ *
+ * Le carte in mano agli avversari e il mazzo da cui pescare non sono visibili al giocatore: vengono
+ * rimescolate insieme e ridistribuite, mantenendo il numero di carte di ogni mano e del mazzo.
+ *
+ * @param game Puntatore alla copia della partita da modificare.
+ * @param player Puntatore al giocatore (della copia) dal cui punto di vista viene vista la partita.
+ * @param rng Puntatore al generatore di numeri casuali della ricerca.
+ */
+void determinize_game(Game* game, Player* player, Rng* rng) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Deck unseen; // Carte non visibili al giocatore
+    init_deck(&unseen);
+    int hand_sizes[MAX_PLAYERS]; // Numero di carte in mano di ogni avversario
+    int num_opponents = 0;
+
+    for (Player* p = player->next_player; p != player; p = p->next_player) {
+        hand_sizes[num_opponents++] = count_cards(&p->hand);
+        while (count_cards(&p->hand) > 0) {
+            add_card(&unseen, pop_card_front(&p->hand));
+        }
+    }
+    while (count_cards(&game->draw_deck) > 0) {
+        add_card(&unseen, pop_card_front(&game->draw_deck));
+    }
+
+    // SE non ci sono carte nascoste => non c'è nulla da ridistribuire
+    if (count_cards(&unseen) == 0) {
+        free_deck(&unseen);
+        return;
+    }
+
+    shuffle_deck(&unseen, rng);
+
+    // Ridistribuisce le carte: prima le mani degli avversari, poi il mazzo da cui pescare
+    num_opponents = 0;
+    for (Player* p = player->next_player; p != player; p = p->next_player) {
+        for (int i = 0; i < hand_sizes[num_opponents]; i++) {
+            add_card(&p->hand, pop_card_front(&unseen));
+        }
+        num_opponents++;
+    }
+    while (count_cards(&unseen) > 0) {
+        add_card(&game->draw_deck, pop_card_front(&unseen));
+    }
+
+    free_deck(&unseen);
+    return;
+}
+
+/**
+ * @brief Valuta una partita simulata dal punto di vista di un giocatore.
+ *
+ * @param game Puntatore alla partita simulata.
+ * @param player Puntatore al giocatore.
+ * @return double 1 SE il giocatore ha vinto, 0 SE ha vinto un altro giocatore, altrimenti un valore
+ * compreso tra 0 e 1 che dipende dal vantaggio in studenti sul miglior avversario.
+ */
+static double evaluate_playout(const Game* game, Player* player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    if (game->winner != NULL) {
+        return game->winner == player ? 1.0 : 0.0;
+    }
+
+    int best_opponent = 0; // Studenti del miglior avversario
+    for (Player* p = player->next_player; p != player; p = p->next_player) {
+        best_opponent = max(best_opponent, count_cards(&p->classroom));
+    }
+
+    double value = 0.5 + (double) (count_cards(&player->classroom) - best_opponent) / (2.0 * NUM_STUDENTS_TO_WIN);
+    return value < 0.0 ? 0.0 : (value > 1.0 ? 1.0 : value);
+}
+
+/**
+ * @brief Esegue una simulazione: applica una mossa alla radice su una copia determinizzata della partita
+ * e gioca il resto della partita con bot avidi, fino alla vittoria di un giocatore o al limite di round.
+ *
+ * @param worker Puntatore al thread di ricerca (con la partita reale e il posto del giocatore).
+ * @param move Mossa da applicare (MCTS_DRAW_MOVE o indice della carta in mano da giocare).
+ * @param rng Puntatore al generatore di numeri casuali del thread.
+ * @return double Ricompensa della simulazione per il giocatore (tra 0 e 1).
+ */
+double run_mcts_playout(const Mcts_worker* worker, int move, Rng* rng) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Game game;
+    clone_game(&game, worker->game);
+    init_game_rng(&game, next_random(rng));
+
+    // Nella simulazione tutti i giocatori (compreso chi decide) giocano con la strategia del bot avido:
+    // è veloce quanto quella casuale, ma le simulazioni sono molto più vicine a una partita reale
+    Player* player = game.players;
+    for (int i = 0; i < worker->seat; i++) {
+        player = player->next_player;
+    }
+    Player* p = player;
+    do {
+        p->provider = &GREEDY_PROVIDER;
+        p = p->next_player;
+    } while (p != player);
+
+    determinize_game(&game, player, &game.rng);
+
+    // Applica la mossa e conclude il turno del giocatore, come in play_game
+    if (move == MCTS_DRAW_MOVE) {
+        draw_card(&player, &game.draw_deck, &game.discard_deck, false);
+    } else {
+        play_card(player, select_card(move, &player->hand, true), &game.draw_deck, &game.discard_deck, false);
+    }
+    check_hand(player, NULL, &game.discard_deck);
+
+    if (check_win_condition(player)) {
+        game.winner = player;
+    } else {
+        // Il resto della partita parte dal turno del giocatore successivo
+        game.current_player = player->next_player;
+        game.round++;
+        game.max_rounds = game.round + MCTS_PLAYOUT_ROUNDS;
+        play_game(&game);
+    }
+
+    double reward = evaluate_playout(&game, player);
+    free_game(&game);
+
+    return reward;
+}
+
+/**
+ * @brief Cerca la mossa migliore alla radice fino allo scadere del tempo, scegliendo le mosse da simulare con UCB1.
+ *
+ * @param worker Puntatore al thread di ricerca (le statistiche vengono scritte solo da questo thread).
+ */
+void run_mcts_search(Mcts_worker* worker) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    bool was_silent = is_silent_output();
+    set_silent_output(true); // Le simulazioni non stampano nulla (la modalità silenziosa è locale al thread)
+
+    Rng rng;
+    init_rng(&rng, worker->seed);
+
+    // Ogni mossa viene simulata almeno una volta, anche SE il tempo è già scaduto
+    while (worker->num_playouts < worker->num_moves || get_wall_time() < worker->deadline) {
+        int move_index = 0;
+
+        if (worker->num_playouts < worker->num_moves) {
+            move_index = (int) worker->num_playouts;
+        } else {
+            double best_score = -1.0;
+            for (int i = 0; i < worker->num_moves; i++) {
+                double mean = worker->rewards[i] / worker->visits[i];
+                double score = mean + MCTS_EXPLORATION * sqrt(log((double) worker->num_playouts) / worker->visits[i]);
+                if (score > best_score) {
+                    best_score = score;
+                    move_index = i;
+                }
+            }
+        }
+
+        worker->rewards[move_index] += run_mcts_playout(worker, worker->moves[move_index], &rng);
+        worker->visits[move_index]++;
+        worker->num_playouts++;
+    }
+
+    set_silent_output(was_silent);
+    return;
+}
+
+/**
+ * @brief Funzione eseguita dai thread di ricerca.
+ *
+ * @param arg Puntatore al thread di ricerca (Mcts_worker).
+ */
+static void search_thread(void* arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    run_mcts_search((Mcts_worker*) arg);
+    return;
+}
+
+/**
+ * @brief Sceglie la mossa migliore tra quelle valide alla radice, con una ricerca parallela a tempo.
+ *
+ * Ogni thread cerca in modo indipendente sulla stessa radice (parallelizzazione alla radice) con il proprio
+ * generatore di numeri casuali; al termine le visite vengono sommate e viene scelta la mossa più visitata.
+ *
+ * @param player Puntatore al giocatore che decide.
+ * @param moves Mosse valide alla radice.
+ * @param num_moves Numero di mosse valide (almeno 2).
+ * @return int Mossa scelta.
+ */
+static int search_best_move(Player* player, const int* moves, int num_moves) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Game* game = player->game;
+    int num_threads = min(count_available_cores(), MCTS_MAX_THREADS);
+
+    int seat = 0; // Posto al tavolo del giocatore
+    for (Player* p = game->players; p != player; p = p->next_player) {
+        seat++;
+    }
+
+    Mcts_worker* workers = (Mcts_worker*) safe_calloc((size_t) num_threads, sizeof(Mcts_worker));
+    Thread* threads = (Thread*) safe_malloc((size_t) num_threads * sizeof(Thread));
+    double deadline = get_wall_time() + mcts_time_budget_ms / 1000.0;
+
+    for (int i = 0; i < num_threads; i++) {
+        workers[i].game = game;
+        workers[i].seat = seat;
+        workers[i].moves = moves;
+        workers[i].num_moves = num_moves;
+        workers[i].deadline = deadline;
+        workers[i].seed = next_random(&game->decision_rng); // I semi della ricerca derivano dal generatore dei bot
+    }
+
+    // Il thread corrente partecipa alla ricerca come primo thread
+    for (int i = 1; i < num_threads; i++) {
+        start_thread(&threads[i], search_thread, &workers[i]);
+    }
+    run_mcts_search(&workers[0]);
+
+    int total_visits[MAX_LEGAL_CHOICES] = {0};
+    for (int i = 0; i < num_threads; i++) {
+        if (i > 0) {
+            join_thread(&threads[i]);
+        }
+        for (int j = 0; j < num_moves; j++) {
+            total_visits[j] += workers[i].visits[j];
+        }
+    }
+
+    int best_move = 0;
+    for (int j = 1; j < num_moves; j++) {
+        if (total_visits[j] > total_visits[best_move]) {
+            best_move = j;
+        }
+    }
+
+    free(threads);
+    free(workers);
+
+    return moves[best_move];
+}
+
+/**
+ * @brief Prende una decisione con una ricerca Monte Carlo ad insiemi di informazione (ISMCTS).
+ *
+ * La ricerca riguarda la scelta principale del turno: pescare o giocare una delle carte giocabili.
+ * Le altre decisioni (bersagli, scarti, blocchi) vengono prese con la strategia del bot avido.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Valore scelto.
+ */
+int mcts_decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Player* player = decision->player;
+    int moves[MAX_LEGAL_CHOICES];
+    int num_moves = 0;
+
+    switch (decision->type) {
+        case DECISION_ACTION: {
+            // Mosse alla radice: pescare o giocare una delle carte giocabili
+            Decision play = {DECISION_CARD, player, 1, count_cards(&player->hand), NULL, NULL, &player->hand, CARD_FILTER_PLAYABLE, ALL, NULL, false};
+            int choices[MAX_LEGAL_CHOICES];
+            int num_choices = count_playable_cards(player, ALL) > 0 ? list_legal_choices(&play, choices, MAX_LEGAL_CHOICES - 1) : 0;
+
+            moves[num_moves++] = MCTS_DRAW_MOVE;
+            for (int i = 0; i < num_choices; i++) {
+                moves[num_moves++] = choices[i] - 1;
+            }
+
+            int best_move = num_moves > 1 ? search_best_move(player, moves, num_moves) : MCTS_DRAW_MOVE;
+            if (best_move == MCTS_DRAW_MOVE) {
+                return DRAW_ACTION;
+            }
+
+            pending_player = player;
+            pending_card = get_card(&player->hand, best_move);
+            return PLAY_ACTION;
+        }
+
+        case DECISION_CARD:
+            // SE non è la scelta della carta da giocare nel proprio turno => strategia del bot avido
+            if (decision->filter != CARD_FILTER_PLAYABLE || decision->force_card_type != ALL || decision->deck != &player->hand) {
+                break;
+            }
+
+            // SE la carta è già stata scelta dalla ricerca sull'azione di gioco => la gioca
+            if (pending_player == player) {
+                pending_player = NULL;
+                for (int i = 0; i < count_cards(&player->hand); i++) {
+                    if (get_card(&player->hand, i) == pending_card) {
+                        return i + 1;
+                    }
+                }
+            }
+
+            int choices[MAX_LEGAL_CHOICES];
+            int num_choices = list_legal_choices(decision, choices, MAX_LEGAL_CHOICES);
+            if (num_choices == 1) {
+                return choices[0];
+            }
+            for (int i = 0; i < num_choices; i++) {
+                moves[num_moves++] = choices[i] - 1;
+            }
+            return search_best_move(player, moves, num_moves) + 1;
+
+        default:
+            break;
+    }
+
+    return greedy_decide(decision);
+}
@@ -0,0 +1,14 @@
+#ifndef UNSTABLE_STUDENTS_MCTS_H
+#define UNSTABLE_STUDENTS_MCTS_H
+
+#include "../model/structs.h"
+#include <stdbool.h>
+
+void set_mcts_time_budget(int budget_ms);
+bool parse_mcts_time_budget(const char* str, int* budget_ms);
+void determinize_game(Game* game, Player* player, Rng* rng);
+double run_mcts_playout(const Mcts_worker* worker, int move, Rng* rng);
+void run_mcts_search(Mcts_worker* worker);
+int mcts_decide(const Decision* decision);
+
+#endif
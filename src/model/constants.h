@@ -7,7 +7,7 @@
 #define SPEED_COEFFICIENT 1000 // Coefficiente di conversione da millisecondi a microsecondi
 
 #define DEFAULT_DECK_PATH "mazzo.txt"                    // Percorso di default del mazzo di carte
-#define DEFAULT_LOG_FILE_PATH "log.txt"                  // Percorso di default del file di log
+#define DEFAULT_LOG_FILE_PATH "log.bin"                  // Percorso di default del file di log (binario, vedi --render-log)
 #define DEFAULT_SAVES_LIST_PATH "./saves/saves_list.txt" // Percorso di default del file contenente la lista dei file di salvataggi
 
 #define MAX_PLAYERS 4 // Numero massimo di giocatori
@@ -74,6 +74,34 @@
 #define SAVES_FOLDER_LEN 8 // Lunghezza della cartella di salvataggio
 #define SAVES_EXTENSION_LEN 4    // Lunghezza dell'estensione del file
 
+#define SAVE_MAGIC "USAV" // Magic iniziale dei file di salvataggio versionati
+#define SAVE_MAGIC_LEN 4  // Lunghezza del magic
+#define SAVE_VERSION 2    // Versione corrente del formato di salvataggio
+
+#define RENDER_LOG_OPTION "--render-log" // Opzione da riga di comando per convertire il file di log binario nel testo leggibile
+#define QUERY_LOG_OPTION "--query-log"   // Opzione da riga di comando per leggere dal file di log gli eventi di una partita o di un suo turno
+
+#define REPLAY_OPTION "--replay"     // Opzione da riga di comando per rigiocare un replay in modalità headless
+#define REPLAY_EXTENSION ".rpl"      // Estensione dei file di replay (salvati nella cartella dei salvataggi)
+#define REPLAY_EXTENSION_LEN 4       // Lunghezza dell'estensione dei file di replay
+#define REPLAY_MAGIC "UREP"          // Magic iniziale dei file di replay
+#define REPLAY_MAGIC_LEN 4           // Lunghezza del magic
+#define REPLAY_VERSION 1             // Versione corrente del formato dei replay
+#define REPLAY_RECORD_DECISION 'D'   // Record di una decisione (scelta a 4 byte)
+#define REPLAY_RECORD_END 'E'        // Record di fine partita (decisioni, round e hash dello stato finale)
+#define REPLAY_INITIAL_CAPACITY 1024 // Capacità iniziale del vettore delle decisioni letto da un replay
+
+#define FNV_OFFSET_BASIS 14695981039346656037ULL // Valore iniziale dell'hash FNV-1a a 64 bit
+#define FNV_PRIME 1099511628211ULL               // Moltiplicatore dell'hash FNV-1a a 64 bit
+
+#define JOURNAL_COMPACTION_INTERVAL 50 // Numero di turni registrati nel journal dopo i quali il salvataggio viene compattato in un nuovo snapshot
+#define JOURNAL_INITIAL_CAPACITY 256   // Capacità iniziale (in byte) del buffer delle modifiche di un turno
+#define DRAW_DECK_ZONE 0               // Zona del journal del mazzo di pesca
+#define DISCARD_DECK_ZONE 1            // Zona del journal del mazzo degli scarti
+#define STUDY_ROOM_ZONE 2              // Zona del journal dell'aula studio
+#define FIRST_PLAYER_ZONE 3            // Prima zona del journal dei giocatori (mano, aula, carte bonus/malus)
+#define ZONES_PER_PLAYER 3             // Numero di zone del journal di ogni giocatore
+
 #define MAX_FILENAME_LENGTH 100       // Lunghezza massima del nome di un file
 #define STR_MAX_FILENAME_LENGTH "100" // Lunghezza massima del nome di un file in formato stringa
 
@@ -82,17 +110,43 @@
 
 #define MAX_DESCRIPTION_LENGTH 255       // Lunghezza massima della descrizione di una carta
 #define STR_MAX_DESCRIPTION_LENGTH "255" // Lunghezza massima della descrizione di una carta in formato stringa
+#define MAX_DESCRIPTION_ROWS ((MAX_DESCRIPTION_LENGTH + 1) / 2) // Righe massime della descrizione suddivisa (ogni riga consuma almeno un carattere e uno spazio)
 
 #define NUM_STARTING_CARDS 5           // Numero di carte iniziali per ogni giocatore
 #define NUM_STARTING_MATRICOLA_CARDS 1 // Numero di carte matricola iniziali per ogni giocatore
 
 #define INPUT_UNIT 1        // Unità di input per la lettura di un valore
 #define INPUT_EFFECT_UNIT 3 // Unità di input per la lettura di un effetto
+#define MAX_EFFECT_PROGRAM_LENGTH 12 // Numero massimo di operazioni primitive di un effetto compilato
 
 #define MAX_HAND_SIZE 5 // Numero massimo di carte in mano
 
+#define DECK_INITIAL_CAPACITY 8 // Capacità iniziale di un mazzo (raddoppiata quando si riempie)
+
+#define NUM_ACTIONS 11     // Numero di azioni degli effetti (enumerazione Action)
+#define NUM_TYPE_PLAYERS 4 // Numero di giocatori bersaglio degli effetti (enumerazione Type_Player)
+#define NUM_TYPE_CARDS 9   // Numero di tipi di carta (enumerazione Type_card)
+
 #define ROUND_SEPARATOR_SIZE 117    // Dimensione del separatore tra i round
 #define LOG_GAME_SEPARATOR_SIZE 50 // Dimensione del separatore tra le partite nel file di log
+#define LOG_BUFFER_SIZE 65536      // Dimensione del buffer in memoria del file di log (in byte)
+#define LOG_MAGIC "ULOG"           // Magic iniziale del file di log binario
+#define LOG_MAGIC_LEN 4            // Lunghezza del magic
+#define LOG_VERSION 1              // Versione corrente del formato del file di log
+#define LOG_RECORD_SIZE 24         // Dimensione (in byte) di ogni record del file di log, intestazione compresa
+#define LOG_NO_PLAYER 0xFF         // Giocatore assente in un record del file di log
+#define LOG_NO_CARD 0xFFFF         // Carta assente in un record del file di log
+#define LOG_INDEX_EXTENSION ".idx" // Estensione dell'indice del file di log (accodata al percorso del file di log)
+#define LOG_INDEX_EXTENSION_LEN 4  // Lunghezza dell'estensione dell'indice
+#define LOG_INDEX_ENTRY_SIZE 24    // Dimensione (in byte) di ogni voce dell'indice del file di log
+#define LOG_DIRECTORY_EXTENSION ".dir" // Estensione della directory dell'indice (accodata al percorso del file di log)
+#define LOG_DIRECTORY_BUCKETS 1024     // Bucket della directory dell'indice (le partite vi sono distribuite per hash del nome)
+#define LOG_DIRECTORY_HEADER_SIZE 4    // Dimensione (in byte) dell'intestazione della directory (voci dell'indice coperte)
+#define LOG_QUERY_INITIAL_CAPACITY 16  // Capacità iniziale del vettore delle partite trovate nella directory dell'indice
+#define LOG_QUEUE_SIZE 4096        // Posti della coda tra la partita e il thread di scrittura del file di log
+#define LOG_MAX_SEGMENT_SIZE (4 * 1024 * 1024) // Dimensione (in byte) oltre la quale il file di log viene ruotato all'inizio della partita successiva
+#define LOG_MAX_SEGMENTS 4         // Segmenti del file di log conservati: il corrente (es. "log.bin") e i precedenti ("log.bin.1", ...)
+#define LOG_SEGMENT_PATH_LENGTH (MAX_FILENAME_LENGTH + 16) // Lunghezza massima del percorso di un segmento del file di log o del suo indice
 
 #define BASE_PLAYER_HEIGHT 7 // Altezza base di un giocatore (per la visualizzazione grafica su terminale)
 #define PLAYER_PADDING 3     // Padding per la formattazione del giocatore (per la visualizzazione grafica su terminale)
@@ -118,6 +172,8 @@
 #define CARD_WIDTH 31           // Larghezza di una carta (per la visualizzazione grafica su terminale)
 #define REAL_CARD_WIDTH 29      // Larghezza reale di una carta (per la visualizzazione grafica su terminale)
 #define MAX_CARD_INDEX_LENGTH 7 // Lunghezza massima dell'indice di una carta (per la visualizzazione grafica su terminale)
+#define FRAME_ESCAPE_BYTES 96   // Byte riservati alle sequenze di escape dei colori di ogni carta (o bordo) in una riga del frame
+#define RENDERED_CARDS_INITIAL_CAPACITY 64 // Capacità iniziale della cache delle carte formattate (potenza di 2, raddoppiata oltre i 3/4)
 
 // Card Unicode Borders
 #define UNICODE_BORDER_UP_LEFT "┌"    // U+250C
@@ -129,6 +185,54 @@
 
 #define COLOR_PADDING 15 // Padding per la formattazione del colore (per la visualizzazione grafica su terminale)
 
-#define SHUFFLE_ROUNDS 1000 // Numero di round per mescolare il mazzo
+#define RNG_STATE_SIZE 4 // Numero di parole a 64 bit dello stato del generatore di numeri casuali (xoshiro256**)
+
+#define HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL         // Moltiplicatore (dispari) dell'hash dei mazzi: la carta in posizione i pesa HASH_MULTIPLIER^i
+#define HASH_MULTIPLIER_INVERSE 0xF1DE83E19937733DULL // Inverso di HASH_MULTIPLIER modulo 2^64 (per togliere una carta in tempo costante)
+#define HASH_KEYS_SEED 0x5A0B1157C0DE5EEDULL          // Seme delle chiavi casuali delle definizioni delle carte
+
+#define SIMULATE_OPTION "--simulate" // Opzione da riga di comando per simulare partite in modalità headless
+#define DEFAULT_SIMULATION_PLAYERS 4 // Numero di giocatori di default per le partite simulate
+#define MAX_SIMULATION_ROUNDS 1000   // Numero massimo di round di una partita simulata (evita partite infinite)
+#define TOURNAMENT_OPTION "--tournament" // Opzione da riga di comando per giocare un torneo di partite simulate in parallelo
+#define MAX_TOURNAMENT_THREADS 256         // Numero massimo di thread di un torneo
+#define DEFAULT_BENCH_GAMES 1000     // Numero di partite di default del benchmark (make bench)
+#define DEFAULT_BENCH_SEED 1         // Seme di default del benchmark, fisso per rendere confrontabili le misurazioni
+
+#define BOTS_OPTION "--bots"      // Opzione da riga di comando per assegnare i bot ai posti delle partite simulate
+#define MAX_BOTS_LIST_LENGTH 64    // Lunghezza massima della lista dei bot (es. "avido,bloccatore")
+#define NUM_DECISION_PROVIDERS 5   // Numero di fornitori di decisioni assegnabili ai giocatori (umano + bot)
+#define MAX_LEGAL_CHOICES 128      // Numero massimo di scelte valide elencate per una decisione
+
+#define MCTS_BUDGET_OPTION "--mcts-budget" // Opzione da riga di comando per impostare il tempo di ricerca per mossa del bot MCTS
+#define MCTS_TIME_BUDGET_MS 50      // Tempo di ricerca di default per mossa del bot MCTS, in millisecondi
+#define MCTS_MAX_THREADS 16         // Numero massimo di thread usati dalla ricerca di una mossa
+#define MCTS_PLAYOUT_ROUNDS 40      // Round massimi di una simulazione, oltre i quali la posizione viene valutata
+#define MCTS_EXPLORATION 1.4        // Costante di esplorazione di UCB1
+#define MCTS_DRAW_MOVE -1           // Mossa "pesca una carta" alla radice (le altre mosse sono indici di carte in mano)
+
+#define SERVER_OPTION "--server"     // Opzione da riga di comando per ospitare partite in rete (server TCP)
+#define REPLAY_DIR_OPTION "--replay-dir" // Opzione da riga di comando per registrare i replay delle partite del server in una cartella
+#define SERVER_BACKLOG 128           // Connessioni in attesa di essere accettate dal server
+#define SERVER_MAX_EVENTS 64         // Eventi letti da ogni chiamata a epoll_wait
+#define SERVER_LINE_LENGTH 128       // Lunghezza massima di una riga del protocollo (le righe più lunghe vengono troncate)
+#define SERVER_RECV_BUFFER_SIZE 1024 // Byte letti da ogni chiamata a recv
+#define SERVER_MAX_PENDING_OUTPUT (1024 * 1024) // Byte di output in coda oltre i quali un giocatore che non legge viene considerato disconnesso
+
+#define SESSION_STACK_SIZE (256 * 1024) // Dimensione dello stack di ogni sessione di gioco (coroutine)
+
+#define SCREEN_CLEAR "\e[H\e[2J"       // Sequenza di escape: cursore in alto a sinistra e pulizia dello schermo
+#define SCREEN_CLEAR_LINE "\e[K"       // Sequenza di escape: pulizia della riga dal cursore in poi
+#define SCREEN_CLEAR_BELOW "\e[J"      // Sequenza di escape: pulizia dello schermo dal cursore in poi
+#define SCREEN_MOVE_CURSOR "\e[%d;1H"  // Sequenza di escape: cursore all'inizio di una riga (numerata da 1)
+#define SCREEN_ESCAPE_BYTES 16         // Byte riservati alle sequenze di escape di ogni riga aggiornata dello schermo
+#define PRINT_MSG_BUFFER_SIZE 1024     // Dimensione del buffer di print_msg (i messaggi più lunghi vengono allocati)
+
+#define TRACE_TABLE_SIZE 1024          // Voci della tabella del tracciamento di ogni thread (potenza di 2, maggiore del numero di funzioni)
+#define TRACE_REPORT_PATH "trace.txt"  // Percorso del report del tracciamento delle funzioni
+
+#define SEED_OPTION "--seed" // Opzione da riga di comando per impostare il seme del generatore di numeri casuali
+#define LOG_FLUSH_OPTION "--log-flush" // Opzione da riga di comando per impostare la politica di scrittura su disco del file di log
+#define LOG_ROTATE_OPTION "--log-rotate" // Opzione da riga di comando per impostare la politica di rotazione del file di log
 
 #endif
\ No newline at end of file
@@ -42,4 +42,96 @@ typedef enum {
     TUTTI
 } Type_Player;
 
+typedef enum {
+    DECISION_ACTION,
+    DECISION_CARD,
+    DECISION_PLAYER,
+    DECISION_OPTIONAL_EFFECT,
+    DECISION_BLOCK_EFFECT
+} Decision_type;
+
+typedef enum {
+    CARD_FILTER_ANY,      // Qualsiasi carta del mazzo
+    CARD_FILTER_PLAYABLE, // Carte giocabili del tipo richiesto (vedi play_hand)
+    CARD_FILTER_BLOCKER,  // Carte ISTANTANEE che possono bloccare la carta della decisione (vedi block_effect)
+    CARD_FILTER_TYPE      // Carte del tipo richiesto dall'effetto (vedi gli effetti ELIMINA e RUBA)
+} Card_filter;
+
+typedef enum {
+    SESSION_RUNNING,  // La partita è in esecuzione (o non è ancora iniziata)
+    SESSION_WAITING,  // La partita è sospesa in attesa della risposta a una decisione
+    SESSION_FINISHED  // La partita è terminata
+} Session_state;
+
+typedef enum {
+    LOG_FLUSH_ALWAYS,
+    LOG_FLUSH_TURN,
+    LOG_FLUSH_EXIT
+} Log_flush_policy;
+
+typedef enum {
+    LOG_ROTATE_SIZE, // Nuovo segmento all'inizio di una partita, SE il segmento corrente supera LOG_MAX_SEGMENT_SIZE
+    LOG_ROTATE_GAME  // Nuovo segmento all'inizio di ogni partita
+} Log_rotation_policy;
+
+typedef enum {
+    LOG_WRITE_LOG,    // Byte da accodare al segmento corrente del file di log
+    LOG_WRITE_INDEX,  // Voce da accodare all'indice del segmento corrente
+    LOG_WRITE_FLUSH,  // Scrittura su disco del file di log e dell'indice
+    LOG_WRITE_ROTATE, // Chiusura del segmento corrente e apertura di un nuovo segmento
+    LOG_WRITE_STOP    // Chiusura dei file e termine del thread di scrittura
+} Log_write_kind;
+
+// Tipi dei record del file di log (l'ordine fa parte del formato del file: i nuovi tipi vanno aggiunti in fondo)
+typedef enum {
+    LOG_EVENT_INIT_GAME,   // Inizio di una nuova partita (seguito dal nome della partita)
+    LOG_EVENT_LOAD_GAME,   // Caricamento di un salvataggio (seguito dal nome della partita)
+    LOG_EVENT_PLAYER_NAME, // Nome del giocatore seduto al posto actor (seguito dal nome)
+    LOG_EVENT_CARD_NAME,   // Nome della definizione di carta card (seguito dal nome)
+    LOG_EVENT_DRAW,        // actor ha pescato card
+    LOG_EVENT_PLAY,        // actor ha giocato card
+    LOG_EVENT_DISCARD,     // actor ha scartato card
+    LOG_EVENT_BLOCK,       // actor ha bloccato card usando other_card
+    LOG_EVENT_SCARTA,      // actor ha scartato card dalla mano di target
+    LOG_EVENT_ELIMINA,     // actor ha eliminato card dall'aula di target
+    LOG_EVENT_RUBA,        // actor ha rubato card dall'aula di target
+    LOG_EVENT_PRENDI,      // actor ha preso card dalla mano di target
+    LOG_EVENT_SCAMBIA,     // actor ha scambiato la propria mano con quella di target
+    LOG_EVENT_WINNER,      // actor ha vinto la partita
+    NUM_LOG_EVENTS
+} Log_event_type;
+
+typedef enum {
+    LOG_INDEX_GAME, // Inizio di una partita (record LOG_EVENT_INIT_GAME o LOG_EVENT_LOAD_GAME)
+    LOG_INDEX_TURN, // Primo evento di un turno
+    LOG_INDEX_CARD  // Nome di una carta (record LOG_EVENT_CARD_NAME)
+} Log_index_type;
+
+typedef enum {
+    JOURNAL_ADD_BACK,
+    JOURNAL_ADD_FRONT,
+    JOURNAL_REMOVE,
+    JOURNAL_SWAP,
+    JOURNAL_RESET
+} Journal_op;
+
+typedef enum {
+    OP_SELECT_TARGET,     // Sceglie il giocatore target degli effetti TU SE non è ancora stato scelto (argomento: Type_Player, gli altri lo azzerano)
+    OP_OFFER_BLOCK,       // Offre ai giocatori target di bloccare l'effetto con una carta ISTANTANEA (argomento: Type_Player, SE viene bloccato termina)
+    OP_FOR_TARGETS,       // Apre il ciclo sui giocatori target (argomento: Type_Player)
+    OP_CHOOSE_CARD,       // Sceglie una carta del tipo richiesto dal giocatore target (argomento: Type_card, SE non ce ne sono salta alla fine del ciclo)
+    OP_CHOOSE_HAND_CARD,  // Sceglie una carta dalla mano del giocatore target (SE è vuota salta alla fine del ciclo)
+    OP_ANNOUNCE,          // Stampa e registra nel file di log lo spostamento della carta scelta (in base all'azione dell'effetto)
+    OP_DISCARD,           // Scollega la carta scelta e la aggiunge al mazzo degli scarti
+    OP_STEAL,             // Scollega la carta scelta dal mazzo del giocatore target
+    OP_GIVE,              // Aggiunge la carta scelta al mazzo del giocatore (stessa zona da cui è stata presa)
+    OP_PLAY_CARD,         // Fa giocare al giocatore target una carta dalla mano (argomento: Type_card)
+    OP_DRAW,              // Fa pescare una carta al giocatore target
+    OP_SWAP_HANDS,        // Scambia le carte in mano tra il giocatore e il giocatore target
+    OP_TRIGGER_TARGET,    // Controlla gli effetti della carta scelta per il giocatore target (argomento: When)
+    OP_TRIGGER_PLAYER,    // Controlla gli effetti della carta scelta per il giocatore (argomento: When)
+    OP_NEXT_TARGET,       // Passa al prossimo giocatore target (SE il ciclo non è finito salta all'inizio del ciclo)
+    OP_PASSIVE            // Effetto passivo (BLOCCA, MOSTRA, IMPEDIRE, INGEGNERE), controllato altrove: attivarlo non fa nulla
+} Effect_op;
+
 #endif
\ No newline at end of file
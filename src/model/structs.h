@@ -5,6 +5,8 @@
 #include "constants.h"
 #include "enums.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 
 typedef struct {
     Action action_effect;
@@ -13,22 +15,278 @@ typedef struct {
 } Effect;
 
 typedef struct {
+    uint8_t op;   // Operazione primitiva (Effect_op)
+    uint8_t arg;  // Argomento dell'operazione
+    uint8_t jump; // Indice dell'istruzione a cui saltare (OP_CHOOSE_CARD, OP_CHOOSE_HAND_CARD e OP_NEXT_TARGET)
+} Effect_instruction;
+
+typedef struct {
+    Effect_instruction code[MAX_EFFECT_PROGRAM_LENGTH];
+    int length;
+} Effect_program;
+
+typedef struct {
+    uint8_t start;  // Inizio della riga nel testo
+    uint8_t length; // Lunghezza della riga (senza gli spazi di riempimento)
+} Text_line;
+
+typedef struct {
+    int id;
     char name[MAX_NAME_LENGTH + 1];
     char description[MAX_DESCRIPTION_LENGTH + 1];
+    int description_rows;                              // Righe della descrizione suddivisa su REAL_CARD_WIDTH caratteri
+    Text_line description_lines[MAX_DESCRIPTION_ROWS]; // Righe della descrizione (calcolate alla registrazione della definizione)
     Type_card type;
     int num_effects;
     Effect* effects;
+    Effect_program* programs; // Effetti compilati alla registrazione della definizione (uno per effetto)
     When when_activate;
     bool optional;
-    struct Card* next_card;
+    int quantity;
+    uint64_t hash_key; // Chiave casuale (ricavata dall'id) usata per l'hash dei mazzi
+} Card_definition;
+
+typedef struct {
+    const Card_definition* def;
 } Card;
 
 typedef struct {
+    int counts[NUM_ACTIONS][NUM_TYPE_PLAYERS][NUM_TYPE_CARDS];
+} Effect_index;
+
+typedef struct Journal {
+    FILE* file;
+    unsigned char* buffer;
+    size_t size;
+    size_t capacity;
+    int turns;
+} Journal;
+
+typedef struct {
+    Card** cards;
+    int capacity;
+    int head;
+    int size;
+    Effect_index* effect_index;
+    Journal* journal;
+    int zone;
+    uint64_t hash;       // Hash dell'ordine delle carte del mazzo, aggiornato ad ogni spostamento (vedi hash_game)
+    uint64_t hash_power; // HASH_MULTIPLIER elevato al numero di carte del mazzo
+} Deck;
+
+typedef struct {
+    char* data;
+    size_t length;
+    size_t capacity;
+} Frame;
+
+typedef struct {
+    Frame previous;  // Ultimo frame presentato (una riga dello schermo per ogni '\n')
+    int rows;        // Righe dell'ultimo frame presentato
+    int rows_below;  // Righe stampate sotto il frame dopo la presentazione (messaggi, menu e input)
+    int term_rows;   // Righe del terminale al momento della presentazione
+    int term_cols;   // Colonne del terminale al momento della presentazione (una larghezza diversa riposiziona le righe già stampate)
+    bool valid;      // true SE il frame presentato è ancora in cima allo schermo (nessuno scorrimento da allora)
+} Screen;
+
+typedef struct {
+    const Deck* deck;
+    const char* name;
+    const char* color;
+    bool hidden;
+    int offset_card_index;
+    int num_cards;
+    int max_rows_description;
+    int card_rows;
+    int rows;
+    int width;
+    size_t max_row_bytes;
+} Deck_layout;
+
+typedef struct {
+    const Card_definition* def; // Definizione della carta (NULL SE la voce è libera)
+    int max_rows_description;   // Righe riservate alla descrizione
+    int num_rows;               // Righe della carta (senza indice)
+    char* rows;                 // Righe della carta una dopo l'altra, senza '\n'
+    size_t* row_offsets;        // Inizio di ogni riga in rows (num_rows + 1 valori)
+} Rendered_card;
+
+typedef struct {
+    Rendered_card* entries; // Tabella a indirizzamento aperto, chiave (definizione, righe riservate alla descrizione)
+    int capacity;           // Capacità della tabella (potenza di 2)
+    int size;               // Voci occupate
+} Rendered_card_cache;
+
+typedef struct {
+    uint64_t seed;
+    uint64_t state[RNG_STATE_SIZE];
+} Rng;
+
+typedef struct {
+    uint8_t kind;                        // Tipo della richiesta (Log_write_kind)
+    uint8_t length;                      // Byte di data da scrivere
+    unsigned char data[LOG_RECORD_SIZE]; // Byte da scrivere (richieste LOG_WRITE_LOG e LOG_WRITE_INDEX)
+} Log_write;
+
+typedef struct {
+    struct Log_writer* writer;             // Thread di scrittura del file di log (NULL SE il logger non è aperto, vedi logging.h)
+    Log_flush_policy flush_policy;
+    Log_rotation_policy rotation_policy;
+    int round;
+    bool* named_cards;   // Definizioni delle carte il cui nome è già stato registrato nella partita (indicizzate per id)
+    int num_named_cards; // Dimensione di named_cards
+    uint64_t offset;     // Offset nel segmento corrente del file di log del prossimo record
+    int indexed_round;   // Ultimo turno della partita registrato nell'indice (0 SE nessuno)
+} Logger;
+
+typedef struct {
+    uint32_t round;      // Turno dell'evento
+    uint8_t type;        // Tipo del record (Log_event_type)
+    uint8_t actor;       // Posto del giocatore che compie l'azione (LOG_NO_PLAYER SE assente)
+    uint8_t target;      // Posto del giocatore bersaglio (LOG_NO_PLAYER SE assente)
+    uint8_t card_type;   // Tipo della carta (Type_card)
+    uint16_t card;       // Id della definizione della carta (LOG_NO_CARD SE assente)
+    uint16_t other_card; // Id della carta usata per bloccare (LOG_NO_CARD SE assente)
+    uint32_t length;     // Lunghezza del testo che segue il record (nomi di partite, giocatori e carte)
+    uint64_t hash;       // Hash dello stato della partita (vedi hash_game)
+} Log_record;
+
+typedef struct {
+    uint8_t type;       // Tipo della voce (Log_index_type)
+    uint16_t card;      // Id della definizione della carta (voci LOG_INDEX_CARD)
+    uint32_t round;     // Turno (voci LOG_INDEX_TURN)
+    uint64_t offset;    // Offset nel file di log del record indicizzato
+    uint64_t name_hash; // Hash FNV-1a del nome della partita (voci LOG_INDEX_GAME)
+    uint32_t previous;  // Numero + 1 della voce di inizio partita precedente nello stesso bucket della directory (voci LOG_INDEX_GAME, 0 SE nessuna)
+} Log_index_entry;
+
+typedef struct {
+    uint32_t num_entries;                  // Voci dell'indice coperte dalla directory
+    uint32_t heads[LOG_DIRECTORY_BUCKETS]; // Per ogni bucket, numero + 1 dell'ultima voce di inizio partita il cui hash del nome cade nel bucket (0 SE nessuna)
+} Log_directory;
+
+typedef struct {
+    FILE* file;                                          // File di log binario
+    char player_names[MAX_PLAYERS][MAX_NAME_LENGTH + 1]; // Nomi dei giocatori della partita corrente, per posto
+    char (*card_names)[MAX_NAME_LENGTH + 1];             // Nomi delle carte della partita corrente, per id
+    int num_card_names;                                  // Dimensione di card_names
+    char* game_separator;                                // Separatore delle partite
+} Log_reader;
+
+typedef struct {
+    FILE* file;           // File su cui vengono registrate le decisioni (NULL SE la partita non viene registrata)
+    int num_decisions;    // Decisioni registrate o da rigiocare
+    const int* decisions; // Decisioni da rigiocare (NULL SE la partita non è un replay)
+    int next_decision;    // Indice della prossima decisione da rigiocare
+    bool exhausted;       // true SE la partita ha chiesto più decisioni di quelle registrate
+} Replay;
+
+typedef struct Player {
     char name[MAX_NAME_LENGTH + 1];
-    Card* hand;
-    Card* classroom;
-    Card* magic_cards;
+    Deck hand;
+    Deck classroom;
+    Deck magic_cards;
     struct Player* next_player;
+    const struct Decision_provider* provider;
+    struct Game* game;
 } Player;
 
-#endif
\ No newline at end of file
+typedef struct {
+    void (*write)(void* context, const Player* recipient, const char* data, size_t length); // Scrive l'output di gioco (es. sui socket dei giocatori di un tavolo), riservato a recipient SE non è NULL
+    void* context;                                                                          // Contesto passato a write
+} Output_sink;
+
+typedef struct {
+    Card* card;             // Carta di cui vengono attivati gli effetti
+    Player* player;         // Giocatore proprietario della carta
+    Player* target_player;  // Giocatore target degli effetti TU (scelto una sola volta per tutti gli effetti della carta)
+    Player* current_player; // Giocatore target corrente del ciclo
+    Player* end_player;     // Giocatore a cui il ciclo si ferma
+    Card* chosen_card;      // Carta scelta dal giocatore target corrente
+    Deck* zone;             // Mazzo del giocatore target da cui è stata scelta la carta
+    int card_index;         // Indice della carta scelta nel mazzo
+    bool blocked;           // SE un giocatore ha bloccato l'effetto (gli effetti successivi della carta non vengono attivati)
+    Deck* draw_deck;        // Mazzo di pesca
+    Deck* discard_deck;     // Mazzo degli scarti
+} Effect_state;
+
+typedef struct {
+    Decision_type type;
+    Player* player;
+    int min_range;
+    int max_range;
+    const char* msg;
+    const char* error_msg;
+    const Deck* deck;          // Mazzo a cui si riferisce la scelta di una carta (NULL SE la scelta non riguarda un solo mazzo)
+    Card_filter filter;        // Carte del mazzo ammesse dalla scelta
+    Type_card force_card_type; // Tipo di carta richiesto (CARD_FILTER_PLAYABLE e CARD_FILTER_TYPE)
+    const Card* card;          // Carta a cui si riferisce la decisione (da bloccare, da assegnare o con effetto opzionale)
+    bool with_me;              // SE la scelta di un giocatore include il giocatore stesso (DECISION_PLAYER)
+} Decision;
+
+typedef struct Decision_provider {
+    const char* name;
+    int (*decide)(const Decision* decision);
+} Decision_provider;
+
+typedef struct Game {
+    char name[MAX_FILENAME_LENGTH + 1];
+    Player* players;
+    Player* current_player; // Giocatore di turno (da cui riprende una partita caricata, poi aggiornato da play_game all'inizio di ogni turno)
+    Deck draw_deck;
+    Deck discard_deck;
+    Deck study_room;
+    int round;
+    int max_rounds;
+    bool headless;
+    Player* winner;
+    Rng rng;
+    Rng decision_rng;       // Generatore dei bot, separato da quello della partita (che così dipende solo dalle decisioni registrate nei replay)
+    Logger logger;
+    Journal journal;
+    Replay replay;
+    void (*turn_observer)(const struct Game* game); // Callback opzionale invocata all'inizio di ogni turno (benchmark)
+} Game;
+
+typedef struct {
+    int num_games;                      // Partite giocate
+    int num_completed_games;            // Partite terminate con un vincitore
+    long total_rounds;                  // Round totali giocati
+    int wins[MAX_PLAYERS];              // Vittorie per posto al tavolo
+    unsigned long long num_allocations; // Allocazioni dinamiche eseguite
+} Tournament_results;
+
+typedef struct {
+    int worker_index;           // Indice del thread (gioca le partite worker_index, worker_index + num_workers, ...)
+    int num_workers;            // Numero totale di thread
+    int num_games;              // Numero totale di partite del torneo
+    int num_players;            // Numero di giocatori per partita
+    uint64_t seed;              // Seme del torneo
+    const Decision_provider* const* seat_providers; // Bot assegnati ai posti al tavolo (NULL => bot casuali)
+    Tournament_results results; // Risultati parziali del thread (scritti solo dal thread stesso)
+} Tournament_worker;
+
+typedef struct {
+    const Game* game;                  // Partita reale (solo lettura durante la ricerca)
+    int seat;                          // Posto al tavolo del giocatore che decide (0 = primo giocatore della lista)
+    const int* moves;                  // Mosse valide alla radice (MCTS_DRAW_MOVE o indice della carta da giocare)
+    int num_moves;                     // Numero di mosse valide
+    double deadline;                   // Istante (get_wall_time) in cui la ricerca deve terminare
+    uint64_t seed;                     // Seme del generatore di numeri casuali del thread
+    int visits[MAX_LEGAL_CHOICES];     // Visite di ogni mossa alla radice
+    double rewards[MAX_LEGAL_CHOICES]; // Ricompense totali di ogni mossa alla radice
+    long num_playouts;                 // Simulazioni completate dal thread
+} Mcts_worker;
+
+typedef struct {
+    const char* function;     // Nome della funzione (__func__, usato anche come chiave della tabella)
+    unsigned long long calls; // Numero di chiamate
+    double total_time;        // Tempo cumulativo in secondi (comprende le funzioni chiamate)
+} Trace_entry;
+
+typedef struct {
+    Trace_entry* entry; // Voce della funzione nella tabella del thread
+    double start_time;  // Istante di ingresso nella funzione
+} Trace_scope;
+
+#endif
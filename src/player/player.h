@@ -8,13 +8,15 @@
 Player* add_player(Player* head, const char* name);
 int count_players(Player* head);
 void free_players(Player* head);
-char** format_player(int* buffer_rows, Player* player, bool is_self, char* color);
+void render_player(Frame* frame, Player* player, bool is_self, char* color);
 void print_player(Player* player, bool is_self, char* color);
-Player* choose_player(Player* players, bool with_me, const char* msg_player, const char* msg_index, const char* error_msg);
-void init_hand(Player* player, Card** draw_deck, Card** study_room, Card** discard_deck);
-void check_hand(Player* player, char* color, Card** discard_deck);
+Player* choose_player(Player* players, bool with_me, const Card* card, const char* msg_player, const char* msg_index, const char* error_msg);
+void init_hand(Player* player, Deck* draw_deck, Deck* study_room, Deck* discard_deck);
+void check_hand(Player* player, char* color, Deck* discard_deck);
 bool can_play_card(Player* player, Card* card);
+bool matches_card_type(const Card* card, Type_card force_card_type);
 int count_playable_cards(Player* player, Type_card force_card_type);
-void play_hand(Player* player, Type_card force_card_type, Card** draw_deck, Card** discard_deck, bool show_card);
+void play_hand(Player* player, Type_card force_card_type, Deck* draw_deck, Deck* discard_deck, bool show_card);
+void play_card(Player* player, Card* played_card, Deck* draw_deck, Deck* discard_deck, bool show_card);
 
 #endif
\ No newline at end of file
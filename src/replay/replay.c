@@ -0,0 +1,348 @@
+#include "replay.h"
+
+#include "../card/card.h"
+#include "../core/game.h"
+#include "../player/player.h"
+#include "../save_load/save_load.h"
+#include "../utils/utils.h"
+#include "../model/colors.h"
+#include <inttypes.h>
+#include <string.h>
+
+// Fornitore di decisioni che rigioca le decisioni registrate in un replay
+const Decision_provider REPLAY_PROVIDER = {"replay", replay_decide};
+
+/**
+ * @brief Scrive un intero senza segno in formato little-endian su un numero fisso di byte.
+ *
+ * @param file Puntatore al file in cui scrivere.
+ * @param value Valore da scrivere.
+ * @param num_bytes Numero di byte da scrivere (1, 2, 4 o 8).
+ */
+static void write_uint(FILE* file, uint64_t value, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[sizeof(uint64_t)];
+    for (int i = 0; i < num_bytes; i++) {
+        bytes[i] = (unsigned char) (value >> (8 * i));
+    }
+
+    safe_fwrite(bytes, 1, (size_t) num_bytes, file);
+    return;
+}
+
+/**
+ * @brief Legge un intero senza segno in formato little-endian da un numero fisso di byte.
+ *
+ * @param file Puntatore al file da cui leggere.
+ * @param value Puntatore in cui salvare il valore letto.
+ * @param num_bytes Numero di byte da leggere (1, 2, 4 o 8).
+ * @return true se il valore è stato letto, false se il file è terminato prima.
+ */
+static bool read_uint(FILE* file, uint64_t* value, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[sizeof(uint64_t)];
+    if (fread(bytes, 1, (size_t) num_bytes, file) != (size_t) num_bytes) {
+        return false;
+    }
+
+    *value = 0;
+    for (int i = 0; i < num_bytes; i++) {
+        *value |= (uint64_t) bytes[i] << (8 * i);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Avvia la registrazione delle decisioni di una partita appena inizializzata.
+ *
+ * L'intestazione contiene tutto ciò che serve a ricostruire la partita: hash del mazzo, seme, limite di round
+ * e nomi dei giocatori. Seguono i record delle decisioni e, a fine partita, il record con l'hash dello stato finale.
+ *
+ * @param replay Puntatore al replay della partita.
+ * @param path Percorso del file di replay (sovrascritto SE esiste già).
+ * @param game Puntatore alla partita (con i generatori di numeri casuali già inizializzati).
+ */
+void open_replay(Replay* replay, const char* path, const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    replay->file = safe_fopen(path, "wb");
+    replay->num_decisions = 0;
+
+    safe_fwrite(REPLAY_MAGIC, 1, REPLAY_MAGIC_LEN, replay->file);
+    write_uint(replay->file, REPLAY_VERSION, 1);
+    write_uint(replay->file, hash_card_definitions(), 8);
+    write_uint(replay->file, game->rng.seed, 8);
+    write_uint(replay->file, (uint64_t) game->max_rounds, 4);
+    write_uint(replay->file, (uint64_t) count_players(game->players), 1);
+
+    Player* player = game->players;
+    do {
+        size_t len = strlen(player->name);
+        write_uint(replay->file, len, 1);
+        safe_fwrite(player->name, 1, len, replay->file);
+        player = player->next_player;
+    } while (player != game->players);
+
+    return;
+}
+
+/**
+ * @brief Registra una decisione presa durante la partita (scelta già controllata da decide).
+ *
+ * @param replay Puntatore al replay della partita (se non è aperto non fa nulla).
+ * @param choice Scelta da registrare.
+ */
+void record_decision(Replay* replay, int choice) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la partita non viene registrata => non fa nulla
+    if (replay->file == NULL) {
+        return;
+    }
+
+    write_uint(replay->file, REPLAY_RECORD_DECISION, 1);
+    write_uint(replay->file, (uint32_t) choice, 4);
+    replay->num_decisions++;
+
+    return;
+}
+
+/**
+ * @brief Scrive su disco le decisioni ancora in memoria (all'inizio di ogni turno): se il programma termina
+ * in modo anomalo, il replay contiene la partita fino al turno in corso.
+ *
+ * @param replay Puntatore al replay della partita (se non è aperto non fa nulla).
+ */
+void flush_replay(Replay* replay) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    if (replay->file != NULL) {
+        fflush(replay->file);
+    }
+
+    return;
+}
+
+/**
+ * @brief Registra la fine della partita (numero di decisioni, round e hash dello stato finale) e chiude il replay.
+ *
+ * @param replay Puntatore al replay della partita (se non è aperto non fa nulla).
+ * @param game Puntatore alla partita terminata.
+ */
+void end_replay(Replay* replay, const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la partita non viene registrata => non fa nulla
+    if (replay->file == NULL) {
+        return;
+    }
+
+    write_uint(replay->file, REPLAY_RECORD_END, 1);
+    write_uint(replay->file, (uint64_t) replay->num_decisions, 4);
+    write_uint(replay->file, (uint64_t) game->round, 4);
+    write_uint(replay->file, hash_game(game), 8);
+    close_replay(replay);
+
+    return;
+}
+
+/**
+ * @brief Chiude il file del replay, senza registrare la fine della partita.
+ *
+ * @param replay Puntatore al replay della partita (se non è aperto non fa nulla).
+ */
+void close_replay(Replay* replay) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il replay non è aperto => non fa nulla
+    if (replay->file == NULL) {
+        return;
+    }
+
+    fclose(replay->file);
+    replay->file = NULL;
+
+    return;
+}
+
+/**
+ * @brief Restituisce la prossima decisione registrata nel replay della partita.
+ *
+ * SE le decisioni registrate sono finite (replay incompleto o partita divergente) la partita viene fatta terminare:
+ * le azioni diventano "esci dalla partita" e le altre decisioni prendono la prima scelta dell'intervallo.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Scelta registrata.
+ */
+int replay_decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Replay* replay = &decision->player->game->replay;
+
+    // SE le decisioni registrate sono finite
+    if (replay->next_decision >= replay->num_decisions) {
+        replay->exhausted = true;
+        return decision->type == DECISION_ACTION ? EXIT_ACTION : decision->min_range;
+    }
+
+    return replay->decisions[replay->next_decision++];
+}
+
+/**
+ * @brief Rigioca in modalità headless (senza output, log né salvataggi) una partita registrata, una o più volte,
+ * e controlla che lo stato finale coincida con quello registrato.
+ *
+ * @param path Percorso del file di replay.
+ * @param num_runs Numero di volte in cui rigiocare la partita (per misurare le prestazioni del motore).
+ * @return true se la partita è stata rigiocata e lo stato finale coincide (o il replay è incompleto), false altrimenti.
+ */
+bool run_replay(const char* path, int num_runs) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    FILE* file = fopen(path, "rb");
+
+    // SE il file non esiste o non può essere aperto
+    if (file == NULL) {
+        printf("[" RED "!" RESET "] Impossibile aprire il replay \"%s\"!\n", path);
+        return false;
+    }
+
+    load_card_definitions(DEFAULT_DECK_PATH);
+
+    // Lettura dell'intestazione
+    char magic[REPLAY_MAGIC_LEN];
+    uint64_t version = 0, deck_hash = 0, seed = 0, max_rounds = 0, num_players = 0;
+    bool valid = fread(magic, 1, REPLAY_MAGIC_LEN, file) == REPLAY_MAGIC_LEN && memcmp(magic, REPLAY_MAGIC, REPLAY_MAGIC_LEN) == 0
+        && read_uint(file, &version, 1) && version == REPLAY_VERSION
+        && read_uint(file, &deck_hash, 8) && read_uint(file, &seed, 8) && read_uint(file, &max_rounds, 4)
+        && read_uint(file, &num_players, 1) && num_players >= MIN_PLAYERS && num_players <= MAX_PLAYERS;
+
+    char names[MAX_PLAYERS][MAX_NAME_LENGTH + 1];
+    for (int i = 0; valid && i < (int) num_players; i++) {
+        uint64_t len = 0;
+        valid = read_uint(file, &len, 1) && len <= MAX_NAME_LENGTH && fread(names[i], 1, (size_t) len, file) == len;
+        names[i][valid ? len : 0] = '\0';
+    }
+
+    // SE l'intestazione non è valida
+    if (!valid) {
+        printf("[" RED "!" RESET "] Il file \"%s\" non è un replay valido!\n", path);
+        fclose(file);
+        return false;
+    }
+
+    // SE il replay è stato registrato con un mazzo diverso => le carte (e quindi la partita) non coinciderebbero
+    if (deck_hash != hash_card_definitions()) {
+        printf("[" RED "!" RESET "] Il replay \"%s\" è stato registrato con un mazzo diverso da \"%s\"!\n", path, DEFAULT_DECK_PATH);
+        fclose(file);
+        return false;
+    }
+
+    // Lettura delle decisioni e del record di fine partita (assente SE il programma è terminato durante la partita)
+    int capacity = REPLAY_INITIAL_CAPACITY;
+    int num_decisions = 0;
+    int* decisions = (int*) safe_malloc((size_t) capacity * sizeof(int));
+    bool has_end = false;
+    uint64_t end_decisions = 0, end_round = 0, end_hash = 0;
+
+    uint64_t tag = 0;
+    while (!has_end && read_uint(file, &tag, 1)) {
+        uint64_t value = 0;
+
+        if (tag == REPLAY_RECORD_DECISION && read_uint(file, &value, 4)) {
+            // SE il vettore è pieno => raddoppia la capacità
+            if (num_decisions == capacity) {
+                capacity *= 2;
+                decisions = (int*) safe_realloc(decisions, (size_t) capacity * sizeof(int));
+            }
+            decisions[num_decisions++] = (int) (int32_t) (uint32_t) value;
+        } else if (tag == REPLAY_RECORD_END && read_uint(file, &end_decisions, 4) && read_uint(file, &end_round, 4) && read_uint(file, &end_hash, 8)) {
+            has_end = true;
+        } else {
+            break; // Record troncato (programma terminato durante la scrittura): si rigioca fino all'ultima decisione completa
+        }
+    }
+
+    fclose(file);
+
+    // L'output di gioco viene soppresso: la partita viene rigiocata alla massima velocità del motore
+    set_silent_output(true);
+
+    Game game;
+    bool matches = true;
+    double start_time = get_wall_time();
+
+    for (int run = 0; run < num_runs; run++) {
+        // L'ultima partita viene liberata dopo il resoconto (serve il suo stato finale)
+        if (run > 0) {
+            free_game(&game);
+        }
+
+        // Ricostruzione della partita: stessi giocatori e stesso seme, tutte le decisioni prese dal replay
+        game = (Game) {0};
+        sprintf(game.name, "replay");
+        game.headless = true;
+        game.max_rounds = (int) max_rounds;
+
+        for (int i = 0; i < (int) num_players; i++) {
+            game.players = add_player(game.players, names[i]);
+        }
+
+        Player* player = game.players;
+        do {
+            player->provider = &REPLAY_PROVIDER;
+            player = player->next_player;
+        } while (player != game.players);
+
+        init_game_rng(&game, seed);
+        link_players_to_game(&game);
+        init_game_cards(&game);
+
+        game.replay.decisions = decisions;
+        game.replay.num_decisions = num_decisions;
+
+        play_game(&game);
+
+        // Controllo dello stato finale: tutte le decisioni rigiocate e, SE il replay è completo, nessuna decisione in più, stesso round e stesso hash
+        matches = game.replay.next_decision == num_decisions;
+        if (has_end) {
+            matches = matches && !game.replay.exhausted && end_decisions == (uint64_t) num_decisions && end_round == (uint64_t) game.round && end_hash == hash_game(&game);
+        }
+
+        // SE la partita diverge => è inutile rigiocarla ancora
+        if (!matches) {
+            break;
+        }
+    }
+
+    double elapsed_time = get_wall_time() - start_time;
+
+    set_silent_output(false);
+
+    printf("[" HBLU "i" RESET "] Replay \"%s\": %d giocatori, seme %" PRIu64 ", %d decisioni, %d round.\n", path, (int) num_players, seed, num_decisions, game.round + 1);
+    printf("[" HBLU "i" RESET "] Rigiocata %d %s in %.3f secondi", num_runs, num_runs == 1 ? "volta" : "volte", elapsed_time);
+    if (elapsed_time > 0) {
+        printf(" (%.1f partite/s, %.0f decisioni/s)", num_runs / elapsed_time, (double) num_runs * num_decisions / elapsed_time);
+    }
+    printf(".\n");
+
+    if (!matches) {
+        printf("[" RED "!" RESET "] Il replay diverge: rigiocate %d/%d decisioni, round %d", game.replay.next_decision, num_decisions, game.round + 1);
+        if (has_end) {
+            printf(" (registrato %" PRIu64 "), hash dello stato finale %016" PRIx64 " (registrato %016" PRIx64 ")", end_round + 1, hash_game(&game), end_hash);
+        }
+        printf(".\n");
+    } else if (has_end) {
+        printf("[" HGRN "+" RESET "] Stato finale verificato (hash %016" PRIx64 ").\n", end_hash);
+    } else {
+        printf("[" HBLU "i" RESET "] Replay incompleto (partita interrotta): stato finale non verificabile.\n");
+    }
+
+    free_game(&game);
+    free(decisions);
+
+    return matches;
+}
@@ -0,0 +1,17 @@
+#ifndef UNSTABLE_STUDENTS_REPLAY_H
+#define UNSTABLE_STUDENTS_REPLAY_H
+
+#include "../model/structs.h"
+#include <stdbool.h>
+
+extern const Decision_provider REPLAY_PROVIDER;
+
+void open_replay(Replay* replay, const char* path, const Game* game);
+void record_decision(Replay* replay, int choice);
+void flush_replay(Replay* replay);
+void end_replay(Replay* replay, const Game* game);
+void close_replay(Replay* replay);
+int replay_decide(const Decision* decision);
+bool run_replay(const char* path, int num_runs);
+
+#endif
@@ -0,0 +1,151 @@
+#include "rng.h"
+#include "../utils/utils.h"
+#include <time.h>
+#include <assert.h>
+#include <errno.h>
+
+/**
+ * @brief Ruota a sinistra di k bit un valore a 64 bit.
+ * 
+ * @param x Valore da ruotare.
+ * @param k Numero di bit di cui ruotare.
+ * @return uint64_t Valore ruotato.
+ */
+static uint64_t rotl(const uint64_t x, int k) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * @brief Genera il prossimo valore della sequenza SplitMix64 (usata solo per espandere il seme nello stato del generatore).
+ * 
+ * @param x Puntatore allo stato della sequenza.
+ * @return uint64_t Valore generato.
+ */
+static uint64_t splitmix64(uint64_t* x) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Mescola i bit di un valore a 64 bit (un passo di SplitMix64), così che valori vicini diano risultati indipendenti.
+ * Usata per ricavare chiavi casuali riproducibili (es. le chiavi delle carte per l'hash della partita).
+ * 
+ * @param value Valore da mescolare.
+ * @return uint64_t Valore mescolato.
+ */
+uint64_t mix_hash(uint64_t value) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return splitmix64(&value);
+}
+
+/**
+ * @brief Genera un seme a partire dall'orologio di sistema (usato quando il seme non viene passato da riga di comando).
+ * 
+ * @return uint64_t Seme generato.
+ */
+uint64_t generate_seed() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    static uint64_t counter = 0; // Contatore per generare semi diversi anche nello stesso secondo
+
+    uint64_t seed = (uint64_t) time(NULL) ^ ((uint64_t) clock() << 32) ^ (++counter * 0x9E3779B97F4A7C15ULL);
+    return splitmix64(&seed);
+}
+
+/**
+ * @brief Inizializza il generatore di numeri casuali (xoshiro256**) a partire da un seme.
+ * 
+ * @param rng Puntatore al generatore da inizializzare.
+ * @param seed Seme del generatore.
+ */
+void init_rng(Rng* rng, uint64_t seed) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    rng->seed = seed;
+
+    // Lo stato viene ricavato dal seme tramite SplitMix64 (così non è mai composto da soli zeri)
+    uint64_t x = seed;
+    for (int i = 0; i < RNG_STATE_SIZE; i++) {
+        rng->state[i] = splitmix64(&x);
+    }
+
+    return;
+}
+
+/**
+ * @brief Genera il prossimo numero casuale a 64 bit (xoshiro256**).
+ * 
+ * @param rng Puntatore al generatore.
+ * @return uint64_t Numero casuale generato.
+ */
+uint64_t next_random(Rng* rng) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t* s = rng->state;
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
+}
+
+/**
+ * @brief Genera un numero intero casuale uniforme compreso nell'intervallo [min_range, max_range].
+ * 
+ * @param rng Puntatore al generatore.
+ * @param min_range Valore minimo (incluso).
+ * @param max_range Valore massimo (incluso).
+ * @return int Numero casuale generato.
+ */
+int random_int(Rng* rng, int min_range, int max_range) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    assert (min_range <= max_range && "Intervallo non valido!");
+
+    uint64_t bound = (uint64_t) max_range - (uint64_t) min_range + 1;
+
+    // Scarta i valori che renderebbero la distribuzione non uniforme (bias del modulo)
+    uint64_t limit = UINT64_MAX - UINT64_MAX % bound;
+    uint64_t value;
+    do {
+        value = next_random(rng);
+    } while (value >= limit);
+
+    return min_range + (int) (value % bound);
+}
+
+/**
+ * @brief Converte una stringa in un seme per il generatore di numeri casuali.
+ * 
+ * @param str Stringa da convertire (numero decimale senza segno).
+ * @param seed Puntatore al seme in cui salvare il valore convertito.
+ * @return true se la stringa è un seme valido, false altrimenti.
+ */
+bool parse_seed(const char* str, uint64_t* seed) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char* end = NULL;
+    errno = 0;
+    unsigned long long value = strtoull(str, &end, 10);
+
+    // SE la stringa è vuota, contiene caratteri non numerici, è negativa o fuori intervallo => seme non valido
+    if (end == str || *end != '\0' || str[0] == '-' || errno == ERANGE) {
+        return false;
+    }
+
+    *seed = (uint64_t) value;
+    return true;
+}
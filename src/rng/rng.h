@@ -0,0 +1,14 @@
+#ifndef UNSTABLE_STUDENTS_RNG_H
+#define UNSTABLE_STUDENTS_RNG_H
+
+#include "../model/structs.h"
+#include <stdint.h>
+
+uint64_t mix_hash(uint64_t value);
+uint64_t generate_seed();
+void init_rng(Rng* rng, uint64_t seed);
+uint64_t next_random(Rng* rng);
+int random_int(Rng* rng, int min_range, int max_range);
+bool parse_seed(const char* str, uint64_t* seed);
+
+#endif
@@ -3,68 +3,114 @@
 #include "../utils/utils.h"
 #include "../core/game.h"
 #include "../logging/logging.h"
+#include "../decision/decision.h"
+#include "../rng/rng.h"
+#include "../player/player.h"
+#include "../journal/journal.h"
+#include <string.h>
+#include <inttypes.h>
+
+// Record di un giocatore nel formato di salvataggio precedente (v1).
+// Riproduce il layout originale della struttura Player, così che i campi aggiunti
+// in memoria (es. il fornitore di decisioni) non cambino il formato dei salvataggi.
+typedef struct {
+    char name[MAX_NAME_LENGTH + 1];
+    void* hand;
+    void* classroom;
+    void* magic_cards;
+    void* next_player;
+} Saved_player;
+
+// Record di una carta nel formato di salvataggio precedente (v1).
+// Riproduce il layout originale della struttura Card (prima delle definizioni condivise),
+// così che i salvataggi esistenti restino compatibili.
+typedef struct {
+    char name[MAX_NAME_LENGTH + 1];
+    char description[MAX_DESCRIPTION_LENGTH + 1];
+    Type_card type;
+    int num_effects;
+    void* effects;
+    When when_activate;
+    bool optional;
+    void* next_card;
+} Saved_card;
 
 /**
- * @brief Carica un mazzo di carte da un file binario di salvataggio.
+ * @brief Carica un mazzo di carte da un file di salvataggio nel formato precedente (v1).
  * 
  * @param file Puntatore al file da cui caricare le carte.
  * @param num_cards Numero di carte da caricare.
- * @return Card* Puntatore alla testa della lista di carte.
+ * @return Deck Mazzo di carte caricato.
  */
-Card* load_saved_deck(FILE* file, int num_cards) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+Deck load_legacy_deck(FILE* file, int num_cards) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    Card* deck = NULL; // Inizializzazione del mazzo
+    Deck deck; // Inizializzazione del mazzo
+    init_deck(&deck);
+    reserve_deck(&deck, num_cards); // Una sola allocazione per l'intero mazzo
 
     for (int i = 0; i < num_cards; i++) {
-        // Alloca la memoria per la carta
-        Card* card = (Card*) safe_calloc(1, sizeof(Card));
-        // Legge la carta dal file
-        safe_fread(card, sizeof(Card), 1, file);
+        // Legge il record della carta dal file
+        Saved_card saved_card;
+        safe_fread(&saved_card, sizeof(Saved_card), 1, file);
+
+        // Alloca la memoria per la definizione della carta
+        Card_definition* definition = (Card_definition*) safe_calloc(1, sizeof(Card_definition));
+        memcpy(definition->name, saved_card.name, sizeof(definition->name));
+        memcpy(definition->description, saved_card.description, sizeof(definition->description));
+        definition->type = saved_card.type;
+        definition->num_effects = saved_card.num_effects;
+        definition->when_activate = saved_card.when_activate;
+        definition->optional = saved_card.optional;
 
         // Sanitizza e rimuove gli spazi dal nome
-        sanitize_string(card->name);
-        strip_string(card->name);
+        sanitize_string(definition->name);
+        strip_string(definition->name);
 
         // Sanitizza e rimuove gli spazi dalla descrizione
-        sanitize_string(card->description);
-        strip_string(card->description);
+        sanitize_string(definition->description);
+        strip_string(definition->description);
 
         // SE la carta ha effetti
-        if (card->num_effects > 0) {
+        if (definition->num_effects > 0) {
             // Alloca la memoria per gli effetti della carta
-            card->effects = (Effect*) safe_calloc(card->num_effects, sizeof(Effect));
+            definition->effects = (Effect*) safe_calloc((size_t) definition->num_effects, sizeof(Effect));
             // Legge gli effetti della carta
-            safe_fread(card->effects, sizeof(Effect), card->num_effects, file);
+            safe_fread(definition->effects, sizeof(Effect), (size_t) definition->num_effects, file);
         } else {
-            card->effects = NULL; // Per evitare problemi imposto a NULL se non ci sono effetti
+            definition->effects = NULL; // Per evitare problemi imposto a NULL se non ci sono effetti
         }
 
-        card->next_card = NULL; // Imposta il puntatore alla prossima carta a NULL
+        // Collega la carta alla definizione condivisa con lo stesso nome (registrandola SE non esiste)
+        Card* card = get_definition_card(register_card_definition(definition));
 
-        deck = add_card(deck, card); // Aggiunge la carta al mazzo
+        add_card(&deck, card); // Aggiunge la carta al mazzo
     }
 
     return deck;
 }
 
 /**
- * @brief Carica i giocatori da un file binario di salvataggio.
+ * @brief Carica i giocatori da un file di salvataggio nel formato precedente (v1).
  * 
  * @param file Puntatore al file da cui caricare i giocatori.
  * @param num_players Numero di giocatori da caricare.
  * @return Player* Puntatore alla testa della lista circolare dei giocatori.
  */
-Player* load_saved_players(FILE* file, int num_players) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+Player* load_legacy_players(FILE* file, int num_players) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     Player* head = NULL; // Inizializzazione della testa della lista circolare
 
     for (int i = 0; i < num_players; i++) {
-        // Alloca la memoria per il giocatore
+        // Legge il record del giocatore dal file
+        Saved_player saved_player;
+        safe_fread(&saved_player, sizeof(Saved_player), 1, file);
+
+        // Alloca la memoria per il giocatore e copia il nome
         Player* player = (Player*) safe_calloc(1, sizeof(Player));
-        // Legge il giocatore dal file
-        safe_fread(player, sizeof(Player), 1, file);
+        memcpy(player->name, saved_player.name, sizeof(player->name));
+        player->provider = &HUMAN_PROVIDER; // Le partite caricate vengono giocate da terminale
 
         // Sanitizza e rimuove gli spazi dal nome
         sanitize_string(player->name);
@@ -73,17 +119,19 @@ Player* load_saved_players(FILE* file, int num_players) {
         // Carica il mazzo delle carte in mano
         int num_hand_cards = 0;
         safe_fread(&num_hand_cards, sizeof(int), 1, file);
-        player->hand = load_saved_deck(file, num_hand_cards);
+        player->hand = load_legacy_deck(file, num_hand_cards);
 
         // Carica il mazzo delle carte dell'aula studio
         int num_classroom_cards = 0;
         safe_fread(&num_classroom_cards, sizeof(int), 1, file);
-        player->classroom = load_saved_deck(file, num_classroom_cards);
+        player->classroom = load_legacy_deck(file, num_classroom_cards);
+        enable_effect_index(&player->classroom);
 
         // Carica il mazzo delle carte bonus/malus
         int num_magic_cards = 0;
         safe_fread(&num_magic_cards, sizeof(int), 1, file);
-        player->magic_cards = load_saved_deck(file, num_magic_cards);
+        player->magic_cards = load_legacy_deck(file, num_magic_cards);
+        enable_effect_index(&player->magic_cards);
 
         // SE la testa è NULL => Inizializza la lista circolare
         if (head == NULL) {
@@ -105,146 +153,504 @@ Player* load_saved_players(FILE* file, int num_players) {
 }
 
 /**
- * @brief Carica una partita da un file binario di salvataggio.
+ * @brief Carica una partita da un file di salvataggio nel formato precedente (v1), composto dalle strutture scritte così come sono in memoria.
  * 
- * @param path_file Percorso del file di salvataggio.
- * @param game_name Nome della partita.
+ * @param file Puntatore al file di salvataggio (posizionato all'inizio).
+ * @param game Puntatore alla partita in cui caricare i dati.
  */
-void load_saved_game(const char* path_file, const char* game_name) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    FILE *file = safe_fopen(path_file, "rb"); // Apertura del file in lettura binaria
-    printf("[" YEL "S" RESET "] Caricamento del salvataggio \"" GRN "%s" RESET "\" in corso...\n", path_file);
+void load_legacy_game(FILE* file, Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Carica i giocatori della partita
     int num_players = 0;
     safe_fread(&num_players, sizeof(int), 1, file);
-    Player* players = load_saved_players(file, num_players);
+    game->players = load_legacy_players(file, num_players);
 
     // Carica il mazzo di pesca
     int num_draw_deck_cards = 0;
     safe_fread(&num_draw_deck_cards, sizeof(int), 1, file);
-    Card* draw_deck = load_saved_deck(file, num_draw_deck_cards);
+    game->draw_deck = load_legacy_deck(file, num_draw_deck_cards);
 
     // Carica il mazzo degli scarti
     int num_discard_deck_cards = 0;
     safe_fread(&num_discard_deck_cards, sizeof(int), 1, file);
-    Card* discard_deck = load_saved_deck(file, num_discard_deck_cards);
+    game->discard_deck = load_legacy_deck(file, num_discard_deck_cards);
 
     // Carica il mazzo dell'aula studio
     int num_study_room_cards = 0;
     safe_fread(&num_study_room_cards, sizeof(int), 1, file);
-    Card* study_room = load_saved_deck(file, num_study_room_cards);
+    game->study_room = load_legacy_deck(file, num_study_room_cards);
 
-    fclose(file); // Chiusura del file
+    // Carica lo stato del generatore di numeri casuali (presente in coda solo nei salvataggi più recenti del formato v1).
+    // SE non è presente viene generato un nuovo seme.
+    if (fread(&game->rng, sizeof(Rng), 1, file) != 1) {
+        init_rng(&game->rng, generate_seed());
+    }
 
-    log_load_game(game_name); // Registra l'azione di caricamento della partita nel file di log
+    return;
+}
 
-    // Avvia la partita con i dati caricati
-    play_game(game_name, players, draw_deck, discard_deck, study_room);
+/**
+ * @brief Scrive un intero senza segno in formato little-endian su un numero fisso di byte.
+ * 
+ * @param file Puntatore al file in cui scrivere.
+ * @param value Valore da scrivere.
+ * @param num_bytes Numero di byte da scrivere (1, 2, 4 o 8).
+ */
+static void write_uint(FILE* file, uint64_t value, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[sizeof(uint64_t)];
+    for (int i = 0; i < num_bytes; i++) {
+        bytes[i] = (unsigned char) (value >> (8 * i));
+    }
+
+    safe_fwrite(bytes, 1, (size_t) num_bytes, file);
     return;
 }
 
 /**
- * @brief Salva un mazzo di carte in un file binario di salvataggio.
+ * @brief Legge un intero senza segno in formato little-endian da un numero fisso di byte.
+ * 
+ * @param file Puntatore al file da cui leggere.
+ * @param num_bytes Numero di byte da leggere (1, 2, 4 o 8).
+ * @return uint64_t Valore letto.
+ */
+static uint64_t read_uint(FILE* file, int num_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char bytes[sizeof(uint64_t)];
+    safe_fread(bytes, 1, (size_t) num_bytes, file);
+
+    uint64_t value = 0;
+    for (int i = 0; i < num_bytes; i++) {
+        value |= (uint64_t) bytes[i] << (8 * i);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Scrive una stringa preceduta dalla sua lunghezza.
+ * 
+ * @param file Puntatore al file in cui scrivere.
+ * @param str Stringa da scrivere.
+ * @param len_bytes Numero di byte usati per la lunghezza.
+ */
+static void write_string(FILE* file, const char* str, int len_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    size_t len = strlen(str);
+    write_uint(file, len, len_bytes);
+    safe_fwrite((void*) str, 1, len, file);
+
+    return;
+}
+
+/**
+ * @brief Legge una stringa preceduta dalla sua lunghezza.
+ * 
+ * @param file Puntatore al file da cui leggere.
+ * @param str Buffer in cui salvare la stringa (di almeno max_len + 1 caratteri).
+ * @param max_len Lunghezza massima ammessa.
+ * @param len_bytes Numero di byte usati per la lunghezza.
+ */
+static void read_string(FILE* file, char* str, size_t max_len, int len_bytes) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    size_t len = (size_t) read_uint(file, len_bytes);
+
+    // SE la lunghezza non è valida => il file di salvataggio è corrotto
+    if (len > max_len) {
+        print_msg(RED "[!] File di salvataggio corrotto (stringa troppo lunga)!" RESET "\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // SE la stringa non è vuota => la legge dal file
+    if (len > 0) {
+        safe_fread(str, 1, len, file);
+    }
+    str[len] = '\0';
+
+    return;
+}
+
+/**
+ * @brief Aggiorna un hash FNV-1a con una sequenza di byte.
+ * 
+ * @param hash Hash corrente.
+ * @param data Puntatore ai byte da aggiungere.
+ * @param size Numero di byte.
+ * @return uint64_t Hash aggiornato.
+ */
+static uint64_t fnv1a(uint64_t hash, const void* data, size_t size) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    const unsigned char* bytes = (const unsigned char*) data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Aggiorna l'hash del mazzo con il contenuto di una definizione (indipendente dalla rappresentazione in memoria).
+ * 
+ * @param hash Hash corrente.
+ * @param definition Puntatore alla definizione.
+ * @return uint64_t Hash aggiornato.
+ */
+static uint64_t hash_card_definition(uint64_t hash, const Card_definition* definition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    unsigned char fields[4] = {(unsigned char) definition->type, (unsigned char) definition->when_activate, (unsigned char) definition->optional, (unsigned char) definition->num_effects};
+
+    hash = fnv1a(hash, definition->name, strlen(definition->name) + 1);
+    hash = fnv1a(hash, definition->description, strlen(definition->description) + 1);
+    hash = fnv1a(hash, fields, sizeof(fields));
+
+    for (int i = 0; i < definition->num_effects; i++) {
+        unsigned char effect[3] = {(unsigned char) definition->effects[i].action_effect, (unsigned char) definition->effects[i].target_player, (unsigned char) definition->effects[i].target_card};
+        hash = fnv1a(hash, effect, sizeof(effect));
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Calcola l'hash della tabella delle definizioni delle carte (usato per riconoscere il mazzo di un salvataggio).
+ * 
+ * @return uint64_t Hash della tabella delle definizioni.
+ */
+uint64_t hash_card_definitions() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    for (int i = 0; i < count_card_definitions(); i++) {
+        hash = hash_card_definition(hash, get_card_definition(i));
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Scrive un mazzo di carte come numero di carte seguito dagli id delle loro definizioni.
  * 
- * @param file Puntatore al file in cui salvare le carte.
+ * @param file Puntatore al file in cui scrivere.
  * @param deck Puntatore al mazzo di carte da salvare.
  */
-void save_deck(FILE* file, Card* deck) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void write_deck(FILE* file, const Deck* deck) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    Card* current_card = deck; // Inizializzazione della carta corrente
+    write_uint(file, (uint64_t) count_cards(deck), 4);
+    for (int i = 0; i < count_cards(deck); i++) {
+        write_uint(file, (uint64_t) get_card(deck, i)->def->id, 2);
+    }
 
-    // Scorre tutte le carte del mazzo
-    while (current_card != NULL) {
-        // Scrive la carta nel file
-        safe_fwrite(current_card, sizeof(Card), 1, file);
+    return;
+}
 
-        // SE la carta ha effetti
-        if (current_card->num_effects > 0) {
-            // Scrive gli effetti della carta nel file
-            safe_fwrite(current_card->effects, sizeof(Effect), current_card->num_effects, file);
+/**
+ * @brief Legge un mazzo di carte scritto da write_deck.
+ * 
+ * @param file Puntatore al file da cui leggere.
+ * @param deck Puntatore al mazzo in cui aggiungere le carte (già inizializzato).
+ * @param definitions Array che associa ad ogni id del salvataggio la definizione registrata.
+ * @param num_definitions Numero di definizioni presenti nel salvataggio.
+ */
+void read_deck(FILE* file, Deck* deck, const Card_definition** definitions, int num_definitions) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int num_cards = (int) read_uint(file, 4);
+    reserve_deck(deck, count_cards(deck) + num_cards); // Una sola allocazione per l'intero mazzo
+    for (int i = 0; i < num_cards; i++) {
+        int id = (int) read_uint(file, 2);
+
+        // SE l'id non corrisponde a nessuna definizione => il file di salvataggio è corrotto
+        if (id >= num_definitions) {
+            print_msg(RED "[!] File di salvataggio corrotto (carta sconosciuta)!" RESET "\n");
+            exit(EXIT_FAILURE);
         }
 
-        current_card = current_card->next_card; // Passa alla prossima carta
+        add_card(deck, get_definition_card(definitions[id]));
     }
 
     return;
 }
 
 /**
- * @brief Salva i giocatori in un file binario di salvataggio.
+ * @brief Scrive lo stato completo di una partita nel formato di salvataggio v2.
+ * 
+ * Il formato è indipendente dall'ABI (interi little-endian di dimensione fissa, nessun puntatore):
+ *   - intestazione: magic, versione, hash del mazzo, seme e stato del generatore, numero del turno;
+ *   - tabella delle definizioni delle carte (ognuna scritta una sola volta);
+ *   - giocatori (nell'ordine dei posti al tavolo), posto del giocatore di turno e mazzi, con le carte salvate come id delle definizioni.
  * 
- * @param file Puntatore al file in cui salvare i giocatori.
- * @param players Puntatore alla testa della lista circolare dei giocatori.
+ * @param file Puntatore al file in cui scrivere.
+ * @param game Puntatore alla partita.
+ * @param current_player Puntatore al giocatore di turno.
  */
-void save_players(FILE* file, Player* players) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+void write_snapshot(FILE* file, const Game* game, Player* current_player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Intestazione
+    safe_fwrite(SAVE_MAGIC, 1, SAVE_MAGIC_LEN, file);
+    write_uint(file, SAVE_VERSION, 4);
+    write_uint(file, hash_card_definitions(), 8);
+    write_uint(file, game->rng.seed, 8);
+    for (int i = 0; i < RNG_STATE_SIZE; i++) {
+        write_uint(file, game->rng.state[i], 8);
+    }
+    write_uint(file, (uint64_t) game->round, 4);
+
+    // Tabella delle definizioni delle carte
+    write_uint(file, (uint64_t) count_card_definitions(), 2);
+    for (int i = 0; i < count_card_definitions(); i++) {
+        const Card_definition* definition = get_card_definition(i);
+
+        write_string(file, definition->name, 1);
+        write_string(file, definition->description, 2);
+        write_uint(file, (uint64_t) definition->type, 1);
+        write_uint(file, (uint64_t) definition->when_activate, 1);
+        write_uint(file, (uint64_t) definition->optional, 1);
+        write_uint(file, (uint64_t) definition->num_effects, 1);
+
+        for (int j = 0; j < definition->num_effects; j++) {
+            write_uint(file, (uint64_t) definition->effects[j].action_effect, 1);
+            write_uint(file, (uint64_t) definition->effects[j].target_player, 1);
+            write_uint(file, (uint64_t) definition->effects[j].target_card, 1);
+        }
+    }
 
-    Player* current = players; // Inizializzazione del giocatore corrente
+    // Giocatori, nell'ordine dei posti al tavolo (il primo è game->players), seguiti dal posto del giocatore di turno
+    write_uint(file, (uint64_t) count_players(game->players), 1);
+    int current_seat = 0;
+    int seat = 0;
+    Player* player = game->players;
     do {
-        // Scrive il giocatore nel file
-        safe_fwrite(current, sizeof(Player), 1, file);
+        write_string(file, player->name, 1);
+        write_deck(file, &player->hand);
+        write_deck(file, &player->classroom);
+        write_deck(file, &player->magic_cards);
+
+        // SE è il giocatore di turno => ne memorizza il posto
+        if (player == current_player) {
+            current_seat = seat;
+        }
+
+        seat++;
+        player = player->next_player;
+    } while (player != game->players);
+    write_uint(file, (uint64_t) current_seat, 1);
+
+    // Mazzi comuni
+    write_deck(file, &game->draw_deck);
+    write_deck(file, &game->discard_deck);
+    write_deck(file, &game->study_room);
+
+    return;
+}
+
+/**
+ * @brief Legge lo stato completo di una partita scritto da write_snapshot (dopo il magic), in un'unica passata.
+ * 
+ * @param file Puntatore al file da cui leggere (posizionato subito dopo il magic).
+ * @param game Puntatore alla partita in cui caricare i dati.
+ * @param num_definitions Puntatore in cui salvare il numero di definizioni presenti nel salvataggio.
+ * @return const Card_definition** Array (da liberare) che associa ad ogni id del salvataggio la definizione registrata.
+ */
+const Card_definition** read_snapshot(FILE* file, Game* game, int* num_definitions) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Intestazione
+    uint64_t version = read_uint(file, 4);
+    if (version != SAVE_VERSION) {
+        print_msg(RED "[!] Versione del file di salvataggio non supportata (%" PRIu64 ")!" RESET "\n", version);
+        exit(EXIT_FAILURE);
+    }
+
+    uint64_t deck_hash = read_uint(file, 8);
+    game->rng.seed = read_uint(file, 8);
+    for (int i = 0; i < RNG_STATE_SIZE; i++) {
+        game->rng.state[i] = read_uint(file, 8);
+    }
+    game->round = (int) read_uint(file, 4);
+
+    // Tabella delle definizioni delle carte: ogni definizione viene registrata (o riconosciuta, SE già presente) una sola volta
+    *num_definitions = (int) read_uint(file, 2);
+    const Card_definition** definitions = (const Card_definition**) safe_malloc((size_t) *num_definitions * sizeof(Card_definition*));
+    uint64_t hash = FNV_OFFSET_BASIS;
+
+    for (int i = 0; i < *num_definitions; i++) {
+        Card_definition* definition = (Card_definition*) safe_calloc(1, sizeof(Card_definition));
+
+        read_string(file, definition->name, MAX_NAME_LENGTH, 1);
+        read_string(file, definition->description, MAX_DESCRIPTION_LENGTH, 2);
+        definition->type = (Type_card) read_uint(file, 1);
+        definition->when_activate = (When) read_uint(file, 1);
+        definition->optional = read_uint(file, 1) != 0;
+        definition->num_effects = (int) read_uint(file, 1);
+
+        // SE la carta ha effetti
+        if (definition->num_effects > 0) {
+            definition->effects = (Effect*) safe_calloc((size_t) definition->num_effects, sizeof(Effect));
+            for (int j = 0; j < definition->num_effects; j++) {
+                definition->effects[j].action_effect = (Action) read_uint(file, 1);
+                definition->effects[j].target_player = (Type_Player) read_uint(file, 1);
+                definition->effects[j].target_card = (Type_card) read_uint(file, 1);
+            }
+        }
+
+        hash = hash_card_definition(hash, definition);
+        definitions[i] = register_card_definition(definition);
+    }
 
-        // Scrive il mazzo delle carte in mano del giocatore nel file
-        int num_hand_cards = count_cards(current->hand);
-        safe_fwrite(&num_hand_cards, sizeof(int), 1, file);
-        save_deck(file, current->hand);
+    // SE l'hash delle definizioni non corrisponde a quello dell'intestazione => il file di salvataggio è corrotto
+    if (hash != deck_hash) {
+        print_msg(RED "[!] File di salvataggio corrotto (hash del mazzo non valido)!" RESET "\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Giocatori
+    int num_players = (int) read_uint(file, 1);
+    Player* last = NULL;
+    for (int i = 0; i < num_players; i++) {
+        char name[MAX_NAME_LENGTH + 1];
+        read_string(file, name, MAX_NAME_LENGTH, 1);
+
+        Player* player = (Player*) safe_calloc(1, sizeof(Player));
+        strncpy(player->name, name, MAX_NAME_LENGTH);
+        player->provider = &HUMAN_PROVIDER; // Le partite caricate vengono giocate da terminale
+
+        init_deck(&player->hand);
+        init_deck(&player->classroom);
+        init_deck(&player->magic_cards);
+        read_deck(file, &player->hand, definitions, *num_definitions);
+        read_deck(file, &player->classroom, definitions, *num_definitions);
+        read_deck(file, &player->magic_cards, definitions, *num_definitions);
+        enable_effect_index(&player->classroom);
+        enable_effect_index(&player->magic_cards);
+
+        // Collega il giocatore in coda alla lista circolare
+        if (last == NULL) {
+            game->players = player;
+        } else {
+            last->next_player = player;
+        }
+        player->next_player = game->players;
+        last = player;
+    }
+
+    // Giocatore di turno
+    int current_seat = (int) read_uint(file, 1);
+
+    // SE il posto non corrisponde a nessun giocatore => il file di salvataggio è corrotto
+    if (current_seat >= num_players) {
+        print_msg(RED "[!] File di salvataggio corrotto (giocatore di turno non valido)!" RESET "\n");
+        exit(EXIT_FAILURE);
+    }
+
+    game->current_player = game->players;
+    for (int i = 0; i < current_seat; i++) {
+        game->current_player = game->current_player->next_player;
+    }
+
+    // Mazzi comuni
+    init_deck(&game->draw_deck);
+    init_deck(&game->discard_deck);
+    init_deck(&game->study_room);
+    read_deck(file, &game->draw_deck, definitions, *num_definitions);
+    read_deck(file, &game->discard_deck, definitions, *num_definitions);
+    read_deck(file, &game->study_room, definitions, *num_definitions);
+
+    return definitions;
+}
+
+/**
+ * @brief Carica una partita da un file binario di salvataggio.
+ * 
+ * I salvataggi nel formato v2 vengono riconosciuti dal magic iniziale; gli altri vengono letti con il formato
+ * precedente (v1) e vengono migrati al formato v2 al primo salvataggio successivo.
+ * 
+ * @param path_file Percorso del file di salvataggio.
+ * @param game_name Nome della partita.
+ */
+void load_saved_game(const char* path_file, const char* game_name) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    FILE *file = safe_fopen(path_file, "rb"); // Apertura del file in lettura binaria
+    print_msg("[" YEL "S" RESET "] Caricamento del salvataggio \"" GRN "%s" RESET "\" in corso...\n", path_file);
+
+    Game game = {0};
+    strncpy(game.name, game_name, MAX_FILENAME_LENGTH);
+
+    // Riconosce il formato del salvataggio dal magic iniziale
+    char magic[SAVE_MAGIC_LEN];
+    if (fread(magic, 1, SAVE_MAGIC_LEN, file) == SAVE_MAGIC_LEN && memcmp(magic, SAVE_MAGIC, SAVE_MAGIC_LEN) == 0) {
+        // Carica lo snapshot e vi applica i turni registrati nel journal
+        int num_definitions = 0;
+        const Card_definition** definitions = read_snapshot(file, &game, &num_definitions);
+        replay_journal(file, &game, definitions, num_definitions);
+        free(definitions);
+    } else {
+        rewind(file); // Il formato v1 non ha intestazione: si riparte dall'inizio del file
+        load_legacy_game(file, &game);
+        print_msg("[" HBLU "i" RESET "] Salvataggio nel formato precedente: verrà convertito al nuovo formato al prossimo salvataggio.\n");
+    }
+
+    fclose(file); // Chiusura del file
 
-        // Scrive il mazzo delle carte dell'aula studio del giocatore nel file
-        int num_classroom_cards = count_cards(current->classroom);
-        safe_fwrite(&num_classroom_cards, sizeof(int), 1, file);
-        save_deck(file, current->classroom);
+    link_players_to_game(&game);
+    init_rng(&game.decision_rng, mix_hash(game.rng.seed)); // Il generatore dei bot non viene salvato: riparte dal seme della partita
 
-        // Scrive il mazzo delle carte bonus/malus del giocatore nel file
-        int num_magic_cards = count_cards(current->magic_cards);
-        safe_fwrite(&num_magic_cards, sizeof(int), 1, file);
-        save_deck(file, current->magic_cards);
+    // Apre il file di log della partita e registra l'azione di caricamento della partita
+    open_logger(&game.logger, DEFAULT_LOG_FILE_PATH);
+    log_load_game(&game.logger, &game);
+    game.logger.round = game.round; // Il prefisso dei turni del log riprende dal turno salvato
 
-        current = current->next_player; // Passa al prossimo giocatore
-    } while (current != players); // Continua finché non torna alla testa
+    print_msg("[" HBLU "i" RESET "] Seme della partita: " HYEL "%" PRIu64 RESET "\n", game.rng.seed);
+
+    // Avvia la partita con i dati caricati
+    play_game(&game);
 
+    // Libera la memoria allocata per la partita
+    free_game(&game);
     return;
 }
 
 /**
- * @brief Salva una partita in un file binario di salvataggio.
+ * @brief Salva una partita in un file binario di salvataggio (formato v2).
+ * 
+ * Il primo salvataggio (e uno ogni JOURNAL_COMPACTION_INTERVAL turni) riscrive lo snapshot completo della partita;
+ * negli altri turni vengono solo accodate al file le carte spostate dall'ultimo salvataggio (journal).
  * 
  * @param filename Percorso del file di salvataggio.
- * @param players Puntatore alla testa della lista circolare dei giocatori.
- * @param draw_deck Puntatore al mazzo di carte da cui pescare.
- * @param discard_deck Puntatore al mazzo degli scarti.
- * @param study_room Puntatore al mazzo dell'aula studio.
+ * @param game Puntatore alla partita da salvare.
+ * @param current_player Puntatore al giocatore di turno.
  */
-void save_game(char* filename, Player* players, Card* draw_deck, Card* discard_deck, Card* study_room) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
-
-    printf("\n[" YEL "S" RESET "] Salvataggio della partita in \"" GRN "%s" RESET "\" in corso...\n", filename);
+void save_game(const char* filename, Game* game, Player* current_player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
-    FILE* file = safe_fopen(filename, "wb"); // Apertura del file in scrittura binaria
+    print_msg("\n[" YEL "S" RESET "] Salvataggio della partita in \"" GRN "%s" RESET "\" in corso...\n", filename);
 
-    // Scrive i giocatori nel file
-    int num_players = count_players(players);
-    safe_fwrite(&num_players, sizeof(int), 1, file);
-    save_players(file, players);
+    // SE il journal è attivo e non ha raggiunto il limite di turni => registra solo le modifiche del turno
+    if (game->journal.file != NULL && game->journal.turns < JOURNAL_COMPACTION_INTERVAL) {
+        commit_journal_turn(&game->journal, game, current_player);
+        return;
+    }
 
-    // Scrive il mazzo di pesca nel file
-    int num_draw_deck_cards = count_cards(draw_deck);
-    safe_fwrite(&num_draw_deck_cards, sizeof(int), 1, file);
-    save_deck(file, draw_deck);
+    // Compattazione: riscrive lo snapshot completo e riparte con un journal vuoto
+    close_journal(&game->journal);
 
-    // Scrive il mazzo degli scarti nel file
-    int num_discard_deck_cards = count_cards(discard_deck);
-    safe_fwrite(&num_discard_deck_cards, sizeof(int), 1, file);
-    save_deck(file, discard_deck);
+    FILE* file = safe_fopen(filename, "wb"); // Apertura del file in scrittura binaria (resta aperto per il journal)
+    write_snapshot(file, game, current_player);
+    fflush(file);
 
-    // Scrive il mazzo dell'aula studio nel file
-    int num_study_room_cards = count_cards(study_room);
-    safe_fwrite(&num_study_room_cards, sizeof(int), 1, file);
-    save_deck(file, study_room);
+    open_journal(&game->journal, file);
+    assign_journal_zones(game, game->players, &game->journal);
 
-    fclose(file); // Chiusura del file
     return;
 }
 
@@ -257,7 +663,7 @@ void save_game(char* filename, Player* players, Card* draw_deck, Card* discard_d
  * @return true Se il salvataggio è già stato registrato, false altrimenti.
  */
 bool is_already_registered(const char* save_name, const char** registered_saves, int num_registered_saves) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     bool is_registered = false; // Inizializzazione del flag di controllo
 
@@ -282,7 +688,7 @@ bool is_already_registered(const char* save_name, const char** registered_saves,
  * @return char** Array di stringhe dei salvataggi registrati aggiornato.
  */
 char** register_new_save(const char* filename, char* save_name, char** registered_saves, int* num_registered_saves) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Verifica SE il salvataggio non è già stato registrato
     if (!is_already_registered(save_name, registered_saves, *num_registered_saves)) {
@@ -311,7 +717,7 @@ char** register_new_save(const char* filename, char* save_name, char** registere
  * @return char** Array di stringhe dei salvataggi registrati.
  */
 char** load_registered_saves(const char* filename, int* num_registered_saves) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     *num_registered_saves = 0; // Inizializza il numero di righe
     char** registered_saves = NULL; // Inizializza l'array di puntatori
@@ -357,7 +763,7 @@ char** load_registered_saves(const char* filename, int* num_registered_saves) {
  * @param num_registered_saves Numero di salvataggi registrati.
  */
 void free_registered_saves(char** registered_saves, int num_registered_saves) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // SE l'array di puntatori non è vuoto
     if (registered_saves != NULL) {        
@@ -4,13 +4,18 @@
 #include "../model/structs.h"
 #include <stdio.h>
 
-Card* load_saved_deck(FILE* file, int num_cards);
-Player* load_saved_players(FILE* file, int num_players);
-void load_saved_game(const char* path_file, const char* game_name);
+Deck load_legacy_deck(FILE* file, int num_cards);
+Player* load_legacy_players(FILE* file, int num_players);
+void load_legacy_game(FILE* file, Game* game);
+
+uint64_t hash_card_definitions();
+void write_deck(FILE* file, const Deck* deck);
+void read_deck(FILE* file, Deck* deck, const Card_definition** definitions, int num_definitions);
+void write_snapshot(FILE* file, const Game* game, Player* current_player);
+const Card_definition** read_snapshot(FILE* file, Game* game, int* num_definitions);
 
-void save_deck(FILE* file, Card* deck);
-void save_players(FILE* file, Player* players);
-void save_game(char* filename, Player* players, Card* draw_deck, Card* discard_deck, Card* study_room);
+void load_saved_game(const char* path_file, const char* game_name);
+void save_game(const char* filename, Game* game, Player* current_player);
 
 bool is_already_registered(const char* save_name, const char** registered_saves, int num_registered_saves);
 char** register_new_save(const char* filename, char* save_name, char** registered_saves, int* num_registered_saves);
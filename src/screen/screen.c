@@ -0,0 +1,264 @@
+// Necessario per fileno con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "screen.h"
+
+#include "../utils/utils.h"
+#include <string.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    #include <io.h>
+#else
+    #include <sys/ioctl.h>
+    #include <unistd.h>
+#endif
+
+static THREAD_LOCAL Screen screen = {{NULL, 0, 0}, 0, 0, 0, false}; // Stato dello schermo del thread corrente (solo il thread della partita reale stampa)
+
+/**
+ * @brief Scrive dei byte su stdout con un'unica chiamata di sistema (ripetuta solo in caso di scrittura parziale).
+ * 
+ * @param data Byte da scrivere.
+ * @param length Numero di byte da scrivere.
+ */
+static void write_screen(const char* data, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    fflush(stdout); // Scrive prima l'output ancora nel buffer di stdio, per non invertire l'ordine
+
+    while (length > 0) {
+        #ifdef _WIN32
+            int written = _write(_fileno(stdout), data, (unsigned int) length);
+        #else
+            ssize_t written = write(STDOUT_FILENO, data, length);
+        #endif
+
+        // SE la scrittura non è andata a buon fine => rinuncia (l'output di gioco non è essenziale)
+        if (written <= 0) {
+            return;
+        }
+
+        data += written;
+        length -= (size_t) written;
+    }
+
+    return;
+}
+
+/**
+ * @brief Legge le dimensioni del terminale.
+ * 
+ * @param rows Puntatore al numero di righe del terminale.
+ * @param cols Puntatore al numero di colonne del terminale.
+ * @return true SE stdout è un terminale di cui si conoscono le dimensioni, false altrimenti.
+ */
+static bool get_terminal_size(int* rows, int* cols) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        CONSOLE_SCREEN_BUFFER_INFO info;
+        if (!_isatty(_fileno(stdout)) || !GetConsoleScreenBufferInfo(GetStdHandle(STD_OUTPUT_HANDLE), &info)) {
+            return false;
+        }
+        *rows = info.srWindow.Bottom - info.srWindow.Top + 1;
+        *cols = info.srWindow.Right - info.srWindow.Left + 1;
+    #else
+        struct winsize size;
+        if (!isatty(STDOUT_FILENO) || ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0) {
+            return false;
+        }
+        *rows = size.ws_row;
+        *cols = size.ws_col;
+    #endif
+
+    return *rows > 0 && *cols > 0;
+}
+
+/**
+ * @brief Restituisce la lunghezza di una riga del frame fino al '\n' escluso (o alla fine del frame).
+ * 
+ * @param line Inizio della riga.
+ * @param end Fine del frame.
+ * @return size_t Lunghezza della riga in byte.
+ */
+static size_t line_length(const char* line, const char* end) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    const char* newline = memchr(line, '\n', (size_t) (end - line));
+    return newline != NULL ? (size_t) (newline - line) : (size_t) (end - line);
+}
+
+/**
+ * @brief Calcola la larghezza visibile di una riga (senza sequenze di escape e contando una colonna per carattere UTF-8).
+ * 
+ * @param line Inizio della riga.
+ * @param length Lunghezza della riga in byte.
+ * @return int Numero di colonne occupate dalla riga.
+ */
+static int visible_width(const char* line, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int width = 0;
+    for (size_t i = 0; i < length; i++) {
+        // SE inizia una sequenza di escape => la salta fino alla lettera finale
+        if (line[i] == '\e') {
+            while (i + 1 < length && !((line[i+1] >= 'A' && line[i+1] <= 'Z') || (line[i+1] >= 'a' && line[i+1] <= 'z'))) {
+                i++;
+            }
+            i++;
+        } else if (((unsigned char) line[i] & 0xC0) != 0x80) {
+            width++; // I byte di continuazione UTF-8 non occupano colonne
+        }
+    }
+
+    return width;
+}
+
+/**
+ * @brief Pulisce lo schermo della console (con una sequenza di escape, senza avviare una shell).
+ */
+void clear_screen() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE l'output di gioco non va sul terminale => non c'è uno schermo da pulire
+    if (get_output_sink() != NULL) {
+        return;
+    }
+
+    write_screen(SCREEN_CLEAR, strlen(SCREEN_CLEAR));
+    screen.valid = false;
+
+    return;
+}
+
+/**
+ * @brief Presenta un frame completo sullo schermo.
+ * 
+ * SE il frame presentato in precedenza è ancora in cima allo schermo, vengono riscritte solo le righe cambiate
+ * (posizionando il cursore su ognuna) e viene pulito l'output stampato sotto il frame; altrimenti lo schermo viene
+ * pulito e il frame scritto per intero. In entrambi i casi l'aggiornamento avviene con un'unica scrittura.
+ * SE stdout non è un terminale o il frame non entra nel terminale, il frame viene semplicemente stampato.
+ * 
+ * @param frame Puntatore al frame da presentare (righe terminate da '\n').
+ */
+void present_screen(const Frame* frame) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la modalità silenziosa è attiva => non presenta nulla
+    if (is_silent_output()) {
+        return;
+    }
+
+    // SE l'output di gioco non va sul terminale (es. giocatori in rete) => il frame viene stampato come un normale output
+    if (get_output_sink() != NULL) {
+        print_frame(frame);
+        return;
+    }
+
+    const char* end = frame->data + frame->length;
+    int rows = 0, term_rows = 0, term_cols = 0;
+    bool fits = get_terminal_size(&term_rows, &term_cols);
+
+    // Conta le righe del frame e controlla che ognuna entri nel terminale senza andare a capo
+    for (const char* line = frame->data; line < end; rows++) {
+        size_t length = line_length(line, end);
+        fits = fits && visible_width(line, length) <= term_cols;
+        line += length + 1;
+    }
+    fits = fits && rows < term_rows; // Il frame e la riga del cursore devono entrare senza scorrimento
+
+    // SE il frame non può essere indirizzato per righe => lo stampa come un normale output
+    if (!fits) {
+        screen.valid = false;
+        write_screen(frame->data, frame->length);
+        return;
+    }
+
+    Frame output;
+    init_frame(&output, frame->length + (size_t) (rows + screen.rows + 1) * SCREEN_ESCAPE_BYTES);
+
+    // SE il frame precedente non è più sullo schermo (o le dimensioni del terminale sono cambiate) => ridisegna tutto
+    if (!screen.valid || screen.term_rows != term_rows || screen.term_cols != term_cols) {
+        frame_append(&output, SCREEN_CLEAR);
+        frame_append(&output, frame->data);
+    } else {
+        char escape[SCREEN_ESCAPE_BYTES];
+        const char* line = frame->data;
+        const char* previous_line = screen.previous.data;
+        const char* previous_end = screen.previous.data + screen.previous.length;
+
+        // Confronta il frame con il precedente riga per riga e riscrive solo le righe cambiate
+        for (int row = 0; row < max(rows, screen.rows); row++) {
+            size_t length = row < rows ? line_length(line, end) : 0;
+            size_t previous_length = row < screen.rows ? line_length(previous_line, previous_end) : 0;
+
+            // SE la riga è cambiata (o esiste solo in uno dei due frame)
+            if (row >= rows || row >= screen.rows || length != previous_length || memcmp(line, previous_line, length) != 0) {
+                snprintf(escape, sizeof(escape), SCREEN_MOVE_CURSOR, row + 1);
+                frame_append(&output, escape);
+                if (row < rows) {
+                    reserve_frame(&output, length);
+                    memcpy(output.data + output.length, line, length);
+                    output.length += length;
+                    output.data[output.length] = '\0';
+                }
+                frame_append(&output, SCREEN_CLEAR_LINE);
+            }
+
+            line += row < rows ? length + 1 : 0;
+            previous_line += row < screen.rows ? previous_length + 1 : 0;
+        }
+
+        // Riporta il cursore sotto il frame e pulisce l'output stampato dopo la presentazione precedente
+        snprintf(escape, sizeof(escape), SCREEN_MOVE_CURSOR, rows + 1);
+        frame_append(&output, escape);
+        frame_append(&output, SCREEN_CLEAR_BELOW);
+    }
+
+    write_screen(output.data, output.length);
+    free_frame(&output);
+
+    // Il frame presentato diventa il frame precedente
+    free_frame(&screen.previous);
+    init_frame(&screen.previous, frame->length);
+    frame_append(&screen.previous, frame->data);
+    screen.rows = rows;
+    screen.rows_below = 0;
+    screen.term_rows = term_rows;
+    screen.term_cols = term_cols;
+    screen.valid = true;
+
+    return;
+}
+
+/**
+ * @brief Registra dell'output stampato sotto il frame presentato.
+ * 
+ * SE l'output fa scorrere lo schermo, il frame presentato non è più in cima allo schermo
+ * e la prossima presentazione ridisegnerà tutto.
+ * 
+ * @param data Output stampato.
+ * @param length Lunghezza dell'output in byte.
+ */
+void note_screen_output(const char* data, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE non c'è un frame sullo schermo => non c'è nulla da invalidare
+    if (!screen.valid) {
+        return;
+    }
+
+    for (const char* newline = memchr(data, '\n', length); newline != NULL; newline = memchr(newline + 1, '\n', length - (size_t) (newline + 1 - data))) {
+        screen.rows_below++;
+    }
+
+    // SE l'output ha raggiunto il fondo del terminale => lo schermo è scorso
+    if (screen.rows + screen.rows_below >= screen.term_rows) {
+        screen.valid = false;
+    }
+
+    return;
+}
@@ -0,0 +1,11 @@
+#ifndef UNSTABLE_STUDENTS_SCREEN_H
+#define UNSTABLE_STUDENTS_SCREEN_H
+
+#include "../model/structs.h"
+#include <stddef.h>
+
+void clear_screen();
+void present_screen(const Frame* frame);
+void note_screen_output(const char* data, size_t length);
+
+#endif
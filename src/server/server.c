@@ -0,0 +1,720 @@
+// Necessario per socket e MSG_NOSIGNAL con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "server.h"
+
+#include "../card/card.h"
+#include "../core/game.h"
+#include "../decision/decision.h"
+#include "../player/player.h"
+#include "../replay/replay.h"
+#include "../rng/rng.h"
+#include "../utils/utils.h"
+#include "../model/colors.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+/**
+ * @brief Aggiorna gli eventi osservati su un socket: lettura e, SE c'è dell'output in coda, scrittura.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione.
+ */
+static void update_events(Server* server, Server_connection* connection) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    struct epoll_event event;
+    event.events = EPOLLIN | (connection->writing ? EPOLLOUT : 0);
+    event.data.ptr = connection;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_MOD, connection->fd, &event);
+
+    return;
+}
+
+/**
+ * @brief Rimuove un giocatore dalla sala d'attesa, SE presente.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione del giocatore.
+ */
+static void leave_lobby(Server* server, Server_connection* connection) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    for (int i = 0; i < server->num_waiting; i++) {
+        if (server->lobby[i] == connection) {
+            server->lobby[i] = server->lobby[--server->num_waiting];
+            return;
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Segna una connessione come chiusa: il giocatore lascia la sala d'attesa o il suo posto al tavolo.
+ *
+ * La connessione viene liberata solo al termine degli eventi letti, che potrebbero riferirsi ad essa.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione da chiudere.
+ */
+static void close_connection(Server* server, Server_connection* connection) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la connessione è già stata chiusa => non c'è nulla da fare
+    if (connection->closed) {
+        return;
+    }
+
+    connection->closed = true;
+    epoll_ctl(server->epoll_fd, EPOLL_CTL_DEL, connection->fd, NULL);
+
+    // SE il giocatore è seduto a un tavolo => al suo posto gioca il bot casuale, altrimenti lascia la sala d'attesa
+    if (connection->table != NULL) {
+        connection->table->seats[connection->seat].connection = NULL;
+    } else {
+        leave_lobby(server, connection);
+    }
+
+    return;
+}
+
+/**
+ * @brief Invia l'output in coda di una connessione, finché il socket lo accetta senza bloccare.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione.
+ */
+static void flush_connection(Server* server, Server_connection* connection) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Frame* output = &connection->output;
+    size_t sent_length = 0;
+
+    while (sent_length < output->length) {
+        ssize_t sent = send(connection->fd, output->data + sent_length, output->length - sent_length, MSG_NOSIGNAL); // MSG_NOSIGNAL: niente SIGPIPE se il client ha chiuso
+
+        // SE l'invio è stato interrotto da un segnale => riprova
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        // SE il socket è pieno => il resto viene inviato quando epoll lo segnala scrivibile
+        if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        if (sent <= 0) {
+            close_connection(server, connection);
+            return;
+        }
+
+        sent_length += (size_t) sent;
+    }
+
+    memmove(output->data, output->data + sent_length, output->length - sent_length);
+    output->length -= sent_length;
+
+    // SE la connessione va chiusa e tutto l'output è stato inviato
+    if (output->length == 0 && connection->hangup) {
+        close_connection(server, connection);
+        return;
+    }
+
+    // SE è cambiato il bisogno di osservare il socket in scrittura
+    bool writing = output->length > 0;
+    if (writing != connection->writing) {
+        connection->writing = writing;
+        update_events(server, connection);
+    }
+
+    return;
+}
+
+/**
+ * @brief Accoda dei byte all'output di una connessione e prova a inviarli subito.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione.
+ * @param data Byte da inviare.
+ * @param length Numero di byte da inviare.
+ */
+static void send_connection(Server* server, Server_connection* connection, const char* data, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la connessione è chiusa => l'output viene scartato
+    if (connection->closed) {
+        return;
+    }
+
+    // SE il client non legge da troppo tempo => viene considerato disconnesso (non può rallentare gli altri tavoli)
+    if (connection->output.length + length > SERVER_MAX_PENDING_OUTPUT) {
+        close_connection(server, connection);
+        return;
+    }
+
+    frame_append_length(&connection->output, data, length);
+    flush_connection(server, connection);
+
+    return;
+}
+
+/**
+ * @brief Invia una stringa su una connessione.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione.
+ * @param str Stringa da inviare.
+ */
+static void send_string(Server* server, Server_connection* connection, const char* str) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    send_connection(server, connection, str, strlen(str));
+    return;
+}
+
+/**
+ * @brief Restituisce il posto al tavolo di un giocatore della partita.
+ *
+ * @param player Puntatore al giocatore (i giocatori della partita sono nello stesso ordine dei posti al tavolo).
+ * @return int Posto del giocatore.
+ */
+static int find_seat(const Player* player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int seat = 0;
+    for (const Player* p = player->game->players; p != player; p = p->next_player) {
+        seat++;
+    }
+
+    return seat;
+}
+
+/**
+ * @brief Invia l'output di gioco ai giocatori connessi di un tavolo (destinazione dell'output delle sessioni dei tavoli).
+ *
+ * L'output riservato a un giocatore (es. le carte della sua mano) viene inviato solo al suo posto, il resto a tutto il tavolo.
+ *
+ * @param context Puntatore al tavolo (Server_table).
+ * @param recipient Puntatore al giocatore a cui è riservato l'output (NULL => tutti i giocatori del tavolo).
+ * @param data Byte da inviare.
+ * @param length Numero di byte da inviare.
+ */
+static void write_table_output(void* context, const Player* recipient, const char* data, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Server_table* table = (Server_table*) context;
+    int recipient_seat = recipient != NULL ? find_seat(recipient) : -1;
+
+    for (int i = 0; i < table->num_seats; i++) {
+        if (table->seats[i].connection != NULL && (recipient_seat < 0 || recipient_seat == i)) {
+            send_connection(table->server, table->seats[i].connection, data, length);
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Controlla se al tavolo è ancora connesso almeno un giocatore.
+ *
+ * @param table Puntatore al tavolo.
+ * @return true se almeno un giocatore è connesso, false altrimenti.
+ */
+static bool has_connected_seats(const Server_table* table) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    for (int i = 0; i < table->num_seats; i++) {
+        if (table->seats[i].connection != NULL) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Riprende la partita del tavolo con la risposta alla decisione in attesa.
+ *
+ * @param table Puntatore al tavolo.
+ * @param answer Risposta alla decisione.
+ */
+static void answer_table(Server_table* table, int answer) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    table->prompted = false;
+    resume_session(&table->session, answer);
+
+    return;
+}
+
+/**
+ * @brief Fa avanzare la partita di un tavolo finché non attende la scelta di un giocatore connesso o termina.
+ *
+ * La richiesta della scelta viene inviata solo al giocatore che deve scegliere; al posto dei giocatori disconnessi
+ * sceglie il bot casuale (la partita termina quando non resta nessun giocatore).
+ *
+ * @param table Puntatore al tavolo.
+ */
+static void advance_table(Server_table* table) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    while (table->session.state == SESSION_WAITING) {
+        const Decision* decision = table->session.decision;
+        Server_seat* seat = &table->seats[find_seat(decision->player)];
+
+        // SE il giocatore è connesso => la partita resta sospesa fino alla sua scelta
+        if (seat->connection != NULL) {
+            if (!table->prompted) {
+                table->prompted = true;
+                send_string(table->server, seat->connection, decision->msg);
+            }
+
+            // SE l'invio della richiesta non ha disconnesso il giocatore
+            if (seat->connection != NULL) {
+                return;
+            }
+        }
+
+        answer_table(table, decision->type == DECISION_ACTION && !has_connected_seats(table) ? EXIT_ACTION : random_decide(decision));
+    }
+
+    return;
+}
+
+/**
+ * @brief Crea un tavolo con i giocatori in attesa e avvia la sua partita in una nuova sessione.
+ *
+ * @param server Puntatore al server.
+ */
+static void start_table(Server* server) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Server_table* table = (Server_table*) safe_calloc(1, sizeof(Server_table));
+    table->id = ++server->num_tables;
+    table->server = server;
+    table->num_seats = server->num_waiting;
+    table->sink = (Output_sink) {write_table_output, table};
+
+    for (int i = 0; i < table->num_seats; i++) {
+        Server_connection* connection = server->lobby[i];
+        connection->table = table;
+        connection->seat = i;
+
+        table->seats[i].connection = connection;
+        strcpy(table->seats[i].name, connection->name);
+    }
+    server->num_waiting = 0;
+
+    table->next = server->tables;
+    server->tables = table;
+
+    // Inizializzazione della partita: nessun file di log né salvataggio (partita headless), un giocatore per posto
+    Game* game = &table->game;
+    sprintf(game->name, "tavolo_%d", table->id);
+    game->headless = true;
+
+    for (int i = 0; i < table->num_seats; i++) {
+        game->players = add_player(game->players, table->seats[i].name);
+    }
+
+    Player* p = game->players;
+    for (int i = 0; i < table->num_seats; i++) {
+        p->provider = &SESSION_PROVIDER;
+        p = p->next_player;
+    }
+
+    // Anche l'output della preparazione della partita viene inviato ai giocatori del tavolo
+    set_output_sink(&table->sink);
+
+    uint64_t seed = generate_seed();
+    init_game_rng(game, seed);
+    link_players_to_game(game);
+    init_game_cards(game);
+
+    // SE è stata indicata una cartella dei replay => registra le decisioni della partita (il seme distingue il replay da quelli degli altri tavoli)
+    if (server->replay_folder != NULL) {
+        size_t path_size = strlen(server->replay_folder) + sizeof("/tavolo_18446744073709551615" REPLAY_EXTENSION);
+        char* replay_path = (char*) safe_malloc(path_size);
+        snprintf(replay_path, path_size, "%s/tavolo_%" PRIu64 "%s", server->replay_folder, seed, REPLAY_EXTENSION);
+        open_replay(&game->replay, replay_path, game);
+        free(replay_path);
+    }
+
+    print_msg("\n[" HGRN "+" RESET "] Tavolo %d: la partita inizia! (seme " HYEL "%" PRIu64 RESET ")\n", table->id, seed);
+    set_output_sink(NULL);
+
+    printf("[" HBLU "i" RESET "] Tavolo %d avviato con %d giocatori.\n", table->id, table->num_seats);
+
+    start_session(&table->session, game, &table->sink);
+    advance_table(table);
+
+    return;
+}
+
+/**
+ * @brief Fa avanzare le partite dei tavoli i cui giocatori si sono disconnessi ed elimina i tavoli la cui partita è terminata.
+ *
+ * Le connessioni dei giocatori di un tavolo eliminato vengono chiuse dopo l'invio dell'output in coda.
+ *
+ * @param server Puntatore al server.
+ */
+static void update_tables(Server* server) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Server_table** t = &server->tables;
+    while (*t != NULL) {
+        Server_table* table = *t;
+
+        advance_table(table);
+
+        // SE la partita è ancora in corso => passa al tavolo successivo
+        if (table->session.state != SESSION_FINISHED) {
+            t = &table->next;
+            continue;
+        }
+
+        set_output_sink(&table->sink);
+        print_msg("\n[" RED "-" RESET "] Tavolo %d: partita terminata, arrivederci!\n", table->id);
+        set_output_sink(NULL);
+
+        free_game(&table->game);
+        free_session(&table->session);
+
+        for (int i = 0; i < table->num_seats; i++) {
+            Server_connection* connection = table->seats[i].connection;
+            if (connection != NULL) {
+                connection->table = NULL;
+                connection->hangup = true;
+                flush_connection(server, connection);
+            }
+        }
+
+        printf("[" HBLU "i" RESET "] Tavolo %d terminato.\n", table->id);
+
+        *t = table->next;
+        free(table);
+    }
+
+    return;
+}
+
+/**
+ * @brief Libera le connessioni chiuse (al termine degli eventi letti, quando nessun evento può più riferirsi ad esse).
+ *
+ * @param server Puntatore al server.
+ */
+static void free_closed_connections(Server* server) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Server_connection** c = &server->connections;
+    while (*c != NULL) {
+        Server_connection* connection = *c;
+
+        // SE la connessione è ancora aperta => passa alla connessione successiva
+        if (!connection->closed) {
+            c = &connection->next;
+            continue;
+        }
+
+        *c = connection->next;
+        close(connection->fd);
+        free_frame(&connection->output);
+        free(connection);
+    }
+
+    return;
+}
+
+/**
+ * @brief Gestisce la scelta inviata da un giocatore seduto a un tavolo.
+ *
+ * La scelta viene consegnata alla partita solo se la partita attende una scelta del giocatore (le altre righe vengono ignorate).
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione del giocatore.
+ * @param line Riga ricevuta (senza '\n').
+ */
+static void handle_choice(Server* server, Server_connection* connection, const char* line) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Server_table* table = connection->table;
+    const Decision* decision = table->session.decision;
+
+    // SE la partita non attende una scelta del giocatore => la riga viene ignorata
+    if (table->session.state != SESSION_WAITING || find_seat(decision->player) != connection->seat) {
+        return;
+    }
+
+    int choice;
+    if (decision->type == DECISION_OPTIONAL_EFFECT || decision->type == DECISION_BLOCK_EFFECT) {
+        // Le decisioni sì/no vengono lette come carattere
+        if (!char_find("sSnN", line[0])) {
+            send_string(server, connection, decision->error_msg);
+            send_string(server, connection, decision->msg);
+            return;
+        }
+        choice = line[0] == 's' || line[0] == 'S';
+    } else {
+        // SE la riga non è un intero => ripete la richiesta (l'intervallo viene controllato da decide)
+        char* end;
+        long value = strtol(line, &end, 10);
+        if (end == line || *end != '\0') {
+            send_string(server, connection, decision->msg);
+            return;
+        }
+        choice = (int) value;
+    }
+
+    answer_table(table, choice);
+    advance_table(table);
+
+    return;
+}
+
+/**
+ * @brief Gestisce una riga ricevuta da un client.
+ *
+ * La prima riga è il nome del giocatore, che entra nella sala d'attesa; le righe successive sono le scelte del giocatore.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione del client.
+ * @param line Riga ricevuta (senza '\n').
+ */
+static void handle_line(Server* server, Server_connection* connection, char* line) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il giocatore è seduto a un tavolo => la riga è una scelta
+    if (connection->table != NULL) {
+        handle_choice(server, connection, line);
+        return;
+    }
+
+    // SE il giocatore ha già un nome => è in attesa di un tavolo (o la sua partita è terminata)
+    if (connection->name[0] != '\0') {
+        return;
+    }
+
+    // Sanitizza e rimuove gli spazi dal nome
+    line[MAX_NAME_LENGTH] = '\0';
+    sanitize_string(line);
+    strip_string(line);
+
+    // SE il nome del giocatore non è valido
+    if (strlen(line) == 0) {
+        send_string(server, connection, "[" RED "!" RESET "] Nome non valido. Riprova!\n> ");
+        return;
+    }
+
+    strcpy(connection->name, line);
+    server->lobby[server->num_waiting++] = connection;
+
+    char msg[SERVER_LINE_LENGTH];
+    snprintf(msg, sizeof(msg), "[" HBLU "i" RESET "] In attesa di altri giocatori (%d/%d)...\n", server->num_waiting, server->num_players);
+    send_string(server, connection, msg);
+
+    // SE la sala d'attesa è piena => avvia un nuovo tavolo
+    if (server->num_waiting == server->num_players) {
+        start_table(server);
+    }
+
+    return;
+}
+
+/**
+ * @brief Legge i dati disponibili su una connessione e gestisce le righe complete.
+ *
+ * @param server Puntatore al server.
+ * @param connection Puntatore alla connessione del client.
+ */
+static void read_connection(Server* server, Server_connection* connection) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char data[SERVER_RECV_BUFFER_SIZE];
+    ssize_t received = recv(connection->fd, data, sizeof(data), 0);
+
+    // SE non ci sono dati o l'attesa è stata interrotta da un segnale => il socket verrà segnalato di nuovo da epoll
+    if (received < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+    }
+
+    // SE il client si è disconnesso
+    if (received <= 0) {
+        close_connection(server, connection);
+        return;
+    }
+
+    // Divide i dati ricevuti in righe (le righe troppo lunghe vengono troncate, i '\r' dei client telnet ignorati)
+    for (ssize_t i = 0; i < received && !connection->closed; i++) {
+        if (data[i] == '\n') {
+            connection->buffer[connection->length] = '\0';
+            connection->length = 0;
+            handle_line(server, connection, connection->buffer);
+        } else if (data[i] != '\r' && connection->length < SERVER_LINE_LENGTH) {
+            connection->buffer[connection->length++] = data[i];
+        }
+    }
+
+    return;
+}
+
+/**
+ * @brief Accetta una nuova connessione e chiede il nome al giocatore.
+ *
+ * @param server Puntatore al server.
+ */
+static void accept_connection(Server* server) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int fd = accept(server->listen_fd, NULL, NULL);
+
+    // SE non è stato possibile accettare la connessione (es. il client ha già chiuso) => la ignora
+    if (fd < 0) {
+        return;
+    }
+
+    Server_connection* connection = (Server_connection*) safe_calloc(1, sizeof(Server_connection));
+    connection->fd = fd;
+    connection->seat = -1;
+
+    // Il socket non è bloccante: un client che non legge l'output non deve bloccare il ciclo degli eventi (e quindi tutti i tavoli)
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = connection;
+
+    // Le richieste di scelta sono brevi e attendono la risposta del giocatore: vanno inviate subito, senza l'algoritmo di Nagle
+    int no_delay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+
+    // SE il socket non può essere osservato => chiude la connessione
+    if (fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0 || epoll_ctl(server->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        close(fd);
+        free(connection);
+        return;
+    }
+
+    connection->next = server->connections;
+    server->connections = connection;
+
+    send_string(server, connection, "[" HBLU "i" RESET "] Benvenuto in " BOLD "Unstable Students" RESET "! Inserisci il tuo nome:\n> ");
+
+    return;
+}
+
+/**
+ * @brief Avvia il server di gioco TCP: accetta i giocatori, li raggruppa in tavoli e ospita le partite di tutti i tavoli.
+ *
+ * Un unico thread gestisce tutto: il ciclo degli eventi (epoll) accetta le connessioni, legge le righe di tutti i client
+ * e invia l'output in coda; la partita di ogni tavolo è una sessione che si sospende quando attende la scelta
+ * di un giocatore e viene ripresa quando la scelta arriva, senza bloccare gli altri tavoli.
+ *
+ * @param port Porta TCP su cui ascoltare (0 => porta libera scelta dal sistema, stampata all'avvio).
+ * @param num_players Numero di giocatori per tavolo.
+ * @param replay_folder Cartella in cui registrare i replay dei tavoli (NULL => le partite non vengono registrate).
+ * @return false se non è stato possibile avviare il server, altrimenti non termina.
+ */
+bool run_server(int port, int num_players, const char* replay_folder) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la cartella dei replay non è scrivibile => i tavoli non potrebbero aprire i propri replay
+    if (replay_folder != NULL && access(replay_folder, W_OK) != 0) {
+        printf("[" RED "!" RESET "] Impossibile registrare i replay nella cartella \"%s\": %s\n", replay_folder, strerror(errno));
+        return false;
+    }
+
+    load_card_definitions(DEFAULT_DECK_PATH);
+
+    Server server = {0};
+    server.num_players = num_players;
+    server.replay_folder = replay_folder;
+
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons((uint16_t) port);
+
+    int reuse = 1;
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.ptr = NULL;
+
+    server.listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    server.epoll_fd = epoll_create1(0);
+
+    // Controllo SE il server può essere avviato
+    if (server.listen_fd < 0 || server.epoll_fd < 0
+        || setsockopt(server.listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) != 0
+        || bind(server.listen_fd, (struct sockaddr*) &address, sizeof(address)) != 0
+        || listen(server.listen_fd, SERVER_BACKLOG) != 0
+        || epoll_ctl(server.epoll_fd, EPOLL_CTL_ADD, server.listen_fd, &event) != 0) {
+        printf("[" RED "!" RESET "] Impossibile avviare il server sulla porta %d: %s\n", port, strerror(errno));
+        return false;
+    }
+
+    // Porta effettiva del server (con la porta 0 viene scelta dal sistema)
+    socklen_t address_length = sizeof(address);
+    getsockname(server.listen_fd, (struct sockaddr*) &address, &address_length);
+    port = ntohs(address.sin_port);
+
+    printf("[" HBLU "i" RESET "] Server in ascolto sulla porta %d (%d giocatori per tavolo).\n", port, num_players);
+    fflush(stdout);
+
+    struct epoll_event events[SERVER_MAX_EVENTS];
+    while (true) {
+        int num_events = epoll_wait(server.epoll_fd, events, SERVER_MAX_EVENTS, -1);
+
+        for (int i = 0; i < num_events; i++) {
+            Server_connection* connection = (Server_connection*) events[i].data.ptr;
+
+            // SE l'evento è sul socket in ascolto => nuova connessione
+            if (connection == NULL) {
+                accept_connection(&server);
+                continue;
+            }
+
+            if ((events[i].events & EPOLLOUT) && !connection->closed) {
+                flush_connection(&server, connection);
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP)) && !connection->closed) {
+                read_connection(&server, connection);
+            }
+        }
+
+        // Le connessioni vengono liberate dopo gli eventi letti, che potrebbero riferirsi ad esse
+        update_tables(&server);
+        free_closed_connections(&server);
+
+        fflush(stdout);
+    }
+}
+
+#else
+
+/**
+ * @brief Avvia il server di gioco TCP (disponibile solo su Linux, dove è presente epoll).
+ *
+ * @param port Porta TCP su cui ascoltare (non utilizzata).
+ * @param num_players Numero di giocatori per tavolo (non utilizzato).
+ * @param replay_folder Cartella dei replay dei tavoli (non utilizzata).
+ * @return false.
+ */
+bool run_server(int port, int num_players, const char* replay_folder) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    (void) port;
+    (void) num_players;
+    (void) replay_folder;
+
+    printf("[" RED "!" RESET "] Il server di gioco è disponibile solo su Linux.\n");
+    return false;
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef UNSTABLE_STUDENTS_SERVER_H
+#define UNSTABLE_STUDENTS_SERVER_H
+
+#include "../model/structs.h"
+#include "../session/session.h"
+#include <stdbool.h>
+
+#ifdef __linux__
+    // Le strutture del server contengono la sessione di gioco, il cui contesto dipende dal sistema operativo, quindi non possono stare in structs.h
+
+    typedef struct Server_connection {
+        int fd;                              // Socket del client (non bloccante)
+        char buffer[SERVER_LINE_LENGTH + 1]; // Riga in ricezione (non ancora terminata da '\n')
+        size_t length;                       // Byte della riga in ricezione
+        Frame output;                        // Output in coda, non ancora accettato dal socket
+        bool writing;                        // true SE il socket è osservato anche in scrittura (output in coda)
+        bool hangup;                         // true SE la connessione va chiusa appena l'output in coda è stato inviato
+        char name[MAX_NAME_LENGTH + 1];      // Nome del giocatore (vuoto finché non è stato inviato)
+        bool closed;                         // true dopo la disconnessione (la connessione viene liberata al termine degli eventi letti)
+        struct Server_table* table;          // Tavolo del giocatore (NULL finché il giocatore è in attesa)
+        int seat;                            // Posto al tavolo
+        struct Server_connection* next;      // Connessione successiva nella lista del server
+    } Server_connection;
+
+    typedef struct {
+        Server_connection* connection;  // Connessione del giocatore (NULL dopo la disconnessione: al suo posto gioca il bot casuale)
+        char name[MAX_NAME_LENGTH + 1]; // Nome del giocatore
+    } Server_seat;
+
+    typedef struct Server_table {
+        int id;                         // Numero del tavolo (a partire da 1)
+        struct Server* server;          // Server che ospita il tavolo
+        Game game;                      // Partita del tavolo
+        Game_session session;           // Sessione che gioca la partita, sospesa mentre attende la scelta di un giocatore
+        Output_sink sink;               // Destinazione dell'output di gioco (i giocatori connessi, o solo quello a cui l'output è riservato)
+        bool prompted;                  // true SE la richiesta della decisione in attesa è già stata inviata al giocatore
+        Server_seat seats[MAX_PLAYERS]; // Posti al tavolo, nell'ordine di gioco
+        int num_seats;                  // Numero di giocatori al tavolo
+        struct Server_table* next;      // Tavolo successivo nella lista del server
+    } Server_table;
+
+    typedef struct Server {
+        int listen_fd;                         // Socket in ascolto
+        int epoll_fd;                          // Istanza epoll del ciclo degli eventi
+        int num_players;                       // Giocatori per tavolo
+        int num_tables;                        // Tavoli creati dall'avvio del server
+        Server_connection* lobby[MAX_PLAYERS]; // Giocatori con un nome in attesa di un tavolo
+        int num_waiting;                       // Giocatori in attesa
+        Server_connection* connections;        // Connessioni aperte
+        Server_table* tables;                  // Tavoli non ancora eliminati
+        const char* replay_folder;             // Cartella dei replay dei tavoli (NULL => le partite non vengono registrate)
+    } Server;
+#endif
+
+bool run_server(int port, int num_players, const char* replay_folder);
+
+#endif
@@ -0,0 +1,265 @@
+#include "session.h"
+
+#include "../core/game.h"
+#include "../utils/utils.h"
+#include "../model/colors.h"
+
+#ifdef SESSION_ASAN
+    #include <dlfcn.h>
+    #include <sanitizer/common_interface_defs.h>
+#endif
+
+// Fornitore di decisioni che sospende la partita finché chi gestisce la sessione non fornisce la risposta
+const Decision_provider SESSION_PROVIDER = {"sessione", session_decide};
+
+static THREAD_LOCAL Game_session* current_session = NULL; // Sessione in esecuzione sul thread corrente (NULL fuori dalle sessioni)
+
+#ifdef _WIN32
+    static THREAD_LOCAL bool thread_is_fiber = false; // Flag per convertire una sola volta il thread in fiber
+#endif
+
+#ifdef SESSION_ASAN
+    // swapcontext della libc: i cambi di stack vengono annunciati ad ASan, quindi il suo intercettore non serve
+    // (stamperebbe soltanto l'avviso "ASan doesn't fully support makecontext/swapcontext" al primo cambio di contesto)
+    static THREAD_LOCAL int (*libc_swapcontext)(ucontext_t*, const ucontext_t*) = NULL;
+#endif
+
+/**
+ * @brief Passa dal contesto di chi ha avviato o ripreso la sessione al contesto della partita, e viceversa.
+ *
+ * Con AddressSanitizer ogni cambio di stack viene annunciato (inizio e limiti del nuovo stack) e completato al ritorno,
+ * altrimenti ASan scambierebbe lo stack della sessione per memoria non valida.
+ *
+ * @param session Puntatore alla sessione.
+ * @param to_game true per passare alla partita, false per tornare a chi ha avviato o ripreso la sessione.
+ */
+static void switch_context(Game_session* session, bool to_game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        SwitchToFiber(to_game ? session->context : session->caller); // Il fiber corrente viene salvato da SwitchToFiber
+    #else
+        #ifdef SESSION_ASAN
+            void* fake_stack = NULL; // Stack fittizio del contesto sospeso, ripristinato quando viene ripreso
+            if (to_game) {
+                __sanitizer_start_switch_fiber(&fake_stack, session->stack, SESSION_STACK_SIZE);
+            } else {
+                __sanitizer_start_switch_fiber(&fake_stack, session->caller_stack, session->caller_stack_size);
+            }
+        #endif
+
+        #ifdef SESSION_ASAN
+            // SE la swapcontext della libc non è ancora stata cercata => la cerca (altrimenti resta quella intercettata da ASan)
+            if (libc_swapcontext == NULL) {
+                void* libc = dlopen("libc.so.6", RTLD_LAZY | RTLD_NOLOAD);
+                void* symbol = libc != NULL ? dlsym(libc, "swapcontext") : NULL;
+                libc_swapcontext = symbol != NULL ? (int (*)(ucontext_t*, const ucontext_t*)) symbol : swapcontext;
+            }
+            int (*swap)(ucontext_t*, const ucontext_t*) = libc_swapcontext;
+        #else
+            int (*swap)(ucontext_t*, const ucontext_t*) = swapcontext;
+        #endif
+
+        // SE il cambio di contesto non è riuscito
+        if (swap(to_game ? &session->caller : &session->context, to_game ? &session->context : &session->caller) != 0) {
+            printf(RED "[!] Errore nel cambio di contesto di una sessione di gioco!" RESET);
+            exit(EXIT_FAILURE);
+        }
+
+        #ifdef SESSION_ASAN
+            // SE è stata ripresa la partita => chi l'ha ripresa potrebbe avere uno stack diverso da chi l'ha sospesa
+            if (to_game) {
+                __sanitizer_finish_switch_fiber(fake_stack, NULL, NULL);
+            } else {
+                __sanitizer_finish_switch_fiber(fake_stack, &session->caller_stack, &session->caller_stack_size);
+            }
+        #endif
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Funzione di ingresso delle sessioni: gioca la partita e restituisce il controllo a chi ha ripreso la sessione.
+ *
+ * La sessione viene letta da current_session (makecontext accetta solo argomenti int, non puntatori).
+ */
+#ifdef _WIN32
+static VOID CALLBACK session_entry(LPVOID arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    (void) arg;
+
+    Game_session* session = current_session;
+    play_game(session->game);
+    session->state = SESSION_FINISHED;
+
+    // Un fiber non deve mai terminare: torna a chi ha ripreso la sessione, che non lo riprenderà più
+    SwitchToFiber(session->caller);
+}
+#else
+static void session_entry(void) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Game_session* session = current_session;
+
+    #ifdef SESSION_ASAN
+        // Completa il primo cambio di stack, salvando i limiti dello stack di chi ha avviato la sessione
+        __sanitizer_finish_switch_fiber(NULL, &session->caller_stack, &session->caller_stack_size);
+    #endif
+
+    play_game(session->game);
+    session->state = SESSION_FINISHED;
+
+    #ifdef SESSION_ASAN
+        // Lo stack della sessione non verrà più ripreso: nessuno stack fittizio da conservare
+        __sanitizer_start_switch_fiber(NULL, session->caller_stack, session->caller_stack_size);
+    #endif
+
+    // Al ritorno viene ripreso uc_link, cioè il contesto di chi ha ripreso la sessione
+    return;
+}
+#endif
+
+/**
+ * @brief Esegue la partita della sessione finché non richiede una decisione o termina.
+ *
+ * L'output di gioco e la sessione corrente sono locali al thread: vengono impostati per la partita della sessione
+ * e ripristinati quando la partita si sospende, così un solo thread può alternare le partite di molte sessioni.
+ *
+ * @param session Puntatore alla sessione da eseguire.
+ */
+static void run_session(Game_session* session) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Game_session* caller_session = current_session;
+    const Output_sink* caller_sink = get_output_sink();
+
+    current_session = session;
+    set_output_sink(session->sink);
+    session->state = SESSION_RUNNING;
+
+    #ifdef _WIN32
+        session->caller = GetCurrentFiber();
+    #endif
+    switch_context(session, true);
+
+    set_output_sink(caller_sink);
+    current_session = caller_session;
+
+    return;
+}
+
+/**
+ * @brief Sospende la partita della sessione corrente finché non viene fornita la risposta alla decisione.
+ *
+ * @param decision Puntatore alla decisione da prendere.
+ * @return int Risposta fornita con resume_session (non necessariamente valida: l'intervallo viene controllato da decide).
+ */
+int session_decide(const Decision* decision) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Game_session* session = current_session;
+
+    // SE la partita non è giocata da una sessione => nessuno può fornire la risposta
+    if (session == NULL) {
+        printf(RED "[!] Decisione di una sessione di gioco richiesta fuori da una sessione!" RESET);
+        exit(EXIT_FAILURE);
+    }
+
+    session->decision = decision;
+    session->state = SESSION_WAITING;
+    switch_context(session, false);
+
+    return session->answer;
+}
+
+/**
+ * @brief Avvia una sessione di gioco: la partita viene giocata finché non richiede una decisione a un giocatore
+ * con il fornitore SESSION_PROVIDER (stato SESSION_WAITING) o termina (stato SESSION_FINISHED).
+ *
+ * Le decisioni degli altri giocatori (bot) vengono prese senza sospendere la partita.
+ *
+ * @param session Puntatore alla sessione da avviare (deve restare valido fino a free_session).
+ * @param game Puntatore alla partita già inizializzata (deve restare valido fino al termine della partita).
+ * @param sink Destinazione dell'output di gioco della partita (NULL => stdout).
+ */
+void start_session(Game_session* session, Game* game, const Output_sink* sink) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    *session = (Game_session) {0};
+    session->game = game;
+    session->sink = sink;
+
+    #ifdef _WIN32
+        // Solo un fiber può passare a un altro fiber
+        if (!thread_is_fiber) {
+            thread_is_fiber = ConvertThreadToFiber(NULL) != NULL;
+        }
+        session->context = CreateFiber(SESSION_STACK_SIZE, session_entry, NULL);
+        bool created = thread_is_fiber && session->context != NULL;
+    #else
+        session->stack = safe_malloc(SESSION_STACK_SIZE);
+        bool created = getcontext(&session->context) == 0;
+        session->context.uc_stack.ss_sp = session->stack;
+        session->context.uc_stack.ss_size = SESSION_STACK_SIZE;
+        session->context.uc_link = &session->caller;
+        if (created) {
+            makecontext(&session->context, session_entry, 0);
+        }
+    #endif
+
+    // Controlla SE il contesto della partita è stato creato correttamente
+    if (!created) {
+        printf(RED "[!] Errore nella creazione di una sessione di gioco!" RESET);
+        exit(EXIT_FAILURE);
+    }
+
+    run_session(session);
+
+    return;
+}
+
+/**
+ * @brief Riprende una sessione sospesa fornendo la risposta alla decisione in attesa.
+ *
+ * La partita prosegue finché non richiede un'altra decisione o termina.
+ *
+ * @param session Puntatore alla sessione (nello stato SESSION_WAITING).
+ * @param answer Risposta alla decisione in attesa.
+ */
+void resume_session(Game_session* session, int answer) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la sessione non attende una decisione => non c'è nulla da riprendere
+    if (session->state != SESSION_WAITING) {
+        return;
+    }
+
+    session->answer = answer;
+    session->decision = NULL;
+    run_session(session);
+
+    return;
+}
+
+/**
+ * @brief Libera lo stack di una sessione terminata (la partita va liberata a parte, con free_game).
+ *
+ * @param session Puntatore alla sessione (nello stato SESSION_FINISHED: lo stack di una partita sospesa
+ * può contenere memoria allocata che non verrebbe liberata).
+ */
+void free_session(Game_session* session) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        if (session->context != NULL) {
+            DeleteFiber(session->context);
+            session->context = NULL;
+        }
+    #else
+        free(session->stack);
+        session->stack = NULL;
+    #endif
+
+    return;
+}
@@ -0,0 +1,49 @@
+#ifndef UNSTABLE_STUDENTS_SESSION_H
+#define UNSTABLE_STUDENTS_SESSION_H
+
+#include "../model/structs.h"
+#include <stdbool.h>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    typedef LPVOID Session_context; // Fiber
+#else
+    #include <ucontext.h>
+    typedef ucontext_t Session_context;
+#endif
+
+// AddressSanitizer va avvisato ad ogni cambio di stack tra le sessioni (gcc definisce __SANITIZE_ADDRESS__, clang __has_feature)
+#if defined(__SANITIZE_ADDRESS__)
+    #define SESSION_ASAN
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define SESSION_ASAN
+    #endif
+#endif
+
+// Il contesto della coroutine dipende dal sistema operativo, quindi la sessione non può stare in structs.h
+typedef struct {
+    Game* game;                // Partita giocata dalla sessione
+    Session_state state;       // Stato della sessione
+    const Decision* decision;  // Decisione in attesa di risposta (valida solo nello stato SESSION_WAITING)
+    int answer;                // Risposta alla decisione in attesa
+    const Output_sink* sink;   // Destinazione dell'output di gioco della sessione (NULL => stdout)
+    Session_context context;   // Contesto della partita (stack e registri salvati alla sospensione)
+    Session_context caller;    // Contesto di chi ha avviato o ripreso la sessione
+    void* stack;               // Stack della partita (NULL con i fiber, che allocano il proprio)
+    #ifdef SESSION_ASAN
+        const void* caller_stack;  // Inizio dello stack di chi ha ripreso la sessione (per AddressSanitizer)
+        size_t caller_stack_size;  // Dimensione dello stack di chi ha ripreso la sessione
+    #endif
+} Game_session;
+
+extern const Decision_provider SESSION_PROVIDER;
+
+int session_decide(const Decision* decision);
+void start_session(Game_session* session, Game* game, const Output_sink* sink);
+void resume_session(Game_session* session, int answer);
+void free_session(Game_session* session);
+
+#endif
@@ -0,0 +1,249 @@
+// Necessario per pthread e sysconf con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "thread.h"
+
+#include "../utils/utils.h"
+#include "../model/colors.h"
+
+#ifndef _WIN32
+    #include <unistd.h>
+#endif
+
+/**
+ * @brief Restituisce il numero di core disponibili sulla macchina.
+ *
+ * @return Numero di core disponibili (almeno 1).
+ */
+int count_available_cores() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return max((int) info.dwNumberOfProcessors, 1);
+    #else
+        return max((int) sysconf(_SC_NPROCESSORS_ONLN), 1);
+    #endif
+}
+
+/**
+ * @brief Funzione di ingresso dei thread: esegue la funzione del thread con il suo argomento.
+ *
+ * @param arg Puntatore al thread (Thread).
+ */
+#ifdef _WIN32
+static DWORD WINAPI thread_entry(LPVOID arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    Thread* thread = (Thread*) arg;
+    thread->function(thread->arg);
+    #ifdef TRACE
+        flush_thread_trace(); // Unisce le statistiche del tracciamento del thread a quelle complessive
+    #endif
+    return 0;
+}
+#else
+static void* thread_entry(void* arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    Thread* thread = (Thread*) arg;
+    thread->function(thread->arg);
+    #ifdef TRACE
+        flush_thread_trace(); // Unisce le statistiche del tracciamento del thread a quelle complessive
+    #endif
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Avvia un thread che esegue una funzione.
+ *
+ * @param thread Puntatore al thread da avviare (deve restare valido fino a join_thread).
+ * @param function Funzione da eseguire.
+ * @param arg Argomento della funzione.
+ */
+void start_thread(Thread* thread, void (*function)(void* arg), void* arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    thread->function = function;
+    thread->arg = arg;
+
+    #ifdef _WIN32
+        thread->handle = CreateThread(NULL, 0, thread_entry, thread, 0, NULL);
+        bool started = thread->handle != NULL;
+    #else
+        bool started = pthread_create(&thread->handle, NULL, thread_entry, thread) == 0;
+    #endif
+
+    // Controlla SE il thread è stato avviato correttamente
+    if (!started) {
+        printf(RED "[!] Errore nella creazione di un thread!" RESET);
+        exit(EXIT_FAILURE);
+    }
+
+    return;
+}
+
+/**
+ * @brief Attende il termine di un thread.
+ *
+ * @param thread Puntatore al thread da attendere.
+ */
+void join_thread(Thread* thread) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        WaitForSingleObject(thread->handle, INFINITE);
+        CloseHandle(thread->handle);
+    #else
+        pthread_join(thread->handle, NULL);
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Inizializza un mutex.
+ *
+ * @param mutex Puntatore al mutex da inizializzare.
+ */
+void init_mutex(Mutex* mutex) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        InitializeCriticalSection(mutex);
+    #else
+        // Controlla SE il mutex è stato creato correttamente
+        if (pthread_mutex_init(mutex, NULL) != 0) {
+            printf(RED "[!] Errore nella creazione di un mutex!" RESET);
+            exit(EXIT_FAILURE);
+        }
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Libera le risorse di un mutex (che non deve essere bloccato da nessun thread).
+ *
+ * @param mutex Puntatore al mutex.
+ */
+void destroy_mutex(Mutex* mutex) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        DeleteCriticalSection(mutex);
+    #else
+        pthread_mutex_destroy(mutex);
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Blocca un mutex, attendendo SE è già bloccato da un altro thread.
+ *
+ * @param mutex Puntatore al mutex.
+ */
+void lock_mutex(Mutex* mutex) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        EnterCriticalSection(mutex);
+    #else
+        pthread_mutex_lock(mutex);
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Sblocca un mutex bloccato dal thread corrente.
+ *
+ * @param mutex Puntatore al mutex.
+ */
+void unlock_mutex(Mutex* mutex) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        LeaveCriticalSection(mutex);
+    #else
+        pthread_mutex_unlock(mutex);
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Inizializza una variabile di condizione.
+ *
+ * @param condition Puntatore alla variabile di condizione da inizializzare.
+ */
+void init_condition(Condition* condition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        InitializeConditionVariable(condition);
+    #else
+        // Controlla SE la variabile di condizione è stata creata correttamente
+        if (pthread_cond_init(condition, NULL) != 0) {
+            printf(RED "[!] Errore nella creazione di una variabile di condizione!" RESET);
+            exit(EXIT_FAILURE);
+        }
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Libera le risorse di una variabile di condizione (su cui non deve attendere nessun thread).
+ *
+ * @param condition Puntatore alla variabile di condizione.
+ */
+void destroy_condition(Condition* condition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        (void) condition; // Le variabili di condizione di Windows non hanno risorse da liberare
+    #else
+        pthread_cond_destroy(condition);
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Sblocca il mutex e sospende il thread corrente finché la condizione non viene segnalata, quindi blocca di nuovo il mutex.
+ *
+ * Il risveglio può avvenire anche senza segnalazione: la condizione attesa va ricontrollata al risveglio.
+ *
+ * @param condition Puntatore alla variabile di condizione.
+ * @param mutex Puntatore al mutex (bloccato dal thread corrente).
+ */
+void wait_condition(Condition* condition, Mutex* mutex) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        SleepConditionVariableCS(condition, mutex, INFINITE);
+    #else
+        pthread_cond_wait(condition, mutex);
+    #endif
+
+    return;
+}
+
+/**
+ * @brief Risveglia un thread in attesa su una variabile di condizione (SE ce n'è uno).
+ *
+ * @param condition Puntatore alla variabile di condizione.
+ */
+void signal_condition(Condition* condition) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    #ifdef _WIN32
+        WakeConditionVariable(condition);
+    #else
+        pthread_cond_signal(condition);
+    #endif
+
+    return;
+}
@@ -0,0 +1,39 @@
+#ifndef UNSTABLE_STUDENTS_THREAD_H
+#define UNSTABLE_STUDENTS_THREAD_H
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+    typedef HANDLE Thread_handle;
+    typedef CRITICAL_SECTION Mutex;
+    typedef CONDITION_VARIABLE Condition;
+#else
+    #include <pthread.h>
+    typedef pthread_t Thread_handle;
+    typedef pthread_mutex_t Mutex;
+    typedef pthread_cond_t Condition;
+#endif
+
+// Il tipo del thread dipende dal sistema operativo, quindi non può stare in structs.h
+typedef struct {
+    Thread_handle handle;        // Thread del sistema operativo
+    void (*function)(void* arg); // Funzione eseguita dal thread
+    void* arg;                   // Argomento della funzione
+} Thread;
+
+int count_available_cores();
+void start_thread(Thread* thread, void (*function)(void* arg), void* arg);
+void join_thread(Thread* thread);
+
+void init_mutex(Mutex* mutex);
+void destroy_mutex(Mutex* mutex);
+void lock_mutex(Mutex* mutex);
+void unlock_mutex(Mutex* mutex);
+
+void init_condition(Condition* condition);
+void destroy_condition(Condition* condition);
+void wait_condition(Condition* condition, Mutex* mutex);
+void signal_condition(Condition* condition);
+
+#endif
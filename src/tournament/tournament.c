@@ -0,0 +1,149 @@
+// Necessario per pthread con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "tournament.h"
+
+#include "../card/card.h"
+#include "../core/game.h"
+#include "../decision/decision.h"
+#include "../utils/utils.h"
+#include "../thread/thread.h"
+#include <inttypes.h>
+
+/**
+ * @brief Gioca le partite del torneo assegnate a un thread.
+ *
+ * Ogni partita ha il proprio stato (generatore di numeri casuali, logger, mazzi), quindi i thread non condividono
+ * nulla di modificabile. Il seme di ogni partita dipende solo dal suo indice: i risultati non dipendono dal numero di thread.
+ *
+ * @param worker Puntatore al thread (con i parametri del torneo e i risultati parziali).
+ */
+void play_tournament_games(Tournament_worker* worker) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // L'output di gioco è soppresso per ogni thread (la modalità silenziosa è locale al thread)
+    set_silent_output(true);
+
+    // I risultati vengono accumulati in locale e scritti una sola volta al termine (evita il false sharing tra thread)
+    Tournament_results results = {0};
+    unsigned long long start_allocations = count_allocations();
+
+    for (int i = worker->worker_index; i < worker->num_games; i += worker->num_workers) {
+        Game game;
+        init_simulated_game(&game, i, worker->num_players, worker->seed, worker->seat_providers);
+        Player* first_player = game.players; // Primo giocatore al tavolo (per ricavare il posto del vincitore)
+
+        play_game(&game);
+
+        // Aggiornamento dei risultati parziali
+        results.num_games++;
+        results.total_rounds += game.round + 1;
+        if (game.winner != NULL) {
+            results.num_completed_games++;
+
+            int seat = 0;
+            for (Player* p = first_player; p != game.winner; p = p->next_player) {
+                seat++;
+            }
+            results.wins[seat]++;
+        }
+
+        free_game(&game);
+    }
+
+    results.num_allocations = count_allocations() - start_allocations;
+    worker->results = results;
+
+    return;
+}
+
+/**
+ * @brief Somma i risultati parziali di un thread ai risultati complessivi del torneo.
+ *
+ * @param total Puntatore ai risultati complessivi.
+ * @param partial Puntatore ai risultati parziali.
+ */
+void merge_tournament_results(Tournament_results* total, const Tournament_results* partial) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    total->num_games += partial->num_games;
+    total->num_completed_games += partial->num_completed_games;
+    total->total_rounds += partial->total_rounds;
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        total->wins[i] += partial->wins[i];
+    }
+    total->num_allocations += partial->num_allocations;
+
+    return;
+}
+
+/**
+ * @brief Funzione eseguita dai thread del torneo.
+ *
+ * @param arg Puntatore al thread del torneo (Tournament_worker).
+ */
+static void tournament_thread(void* arg) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    play_tournament_games((Tournament_worker*) arg);
+    return;
+}
+
+/**
+ * @brief Gioca in modalità headless un torneo di partite simulate, distribuite su più thread.
+ *
+ * @param num_games Numero di partite del torneo.
+ * @param num_players Numero di giocatori per partita.
+ * @param num_threads Numero di thread da utilizzare.
+ * @param seed Seme del torneo (la partita i usa il seme seed + i, come in simulate_games).
+ * @param seat_providers Bot assegnati ai posti al tavolo (NULL o posti NULL => bot casuali).
+ */
+void run_tournament(int num_games, int num_players, int num_threads, uint64_t seed, const Decision_provider* const* seat_providers) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    num_threads = min(num_threads, num_games); // Non servono più thread che partite
+
+    // Le definizioni delle carte vengono caricate prima di avviare i thread, che poi le leggono soltanto
+    load_card_definitions(DEFAULT_DECK_PATH);
+
+    Thread* threads = (Thread*) safe_malloc((size_t) num_threads * sizeof(Thread));
+    Tournament_worker* workers = (Tournament_worker*) safe_calloc((size_t) num_threads, sizeof(Tournament_worker));
+
+    double start_time = get_wall_time(); // Tempo di inizio del torneo
+
+    for (int i = 0; i < num_threads; i++) {
+        workers[i].worker_index = i;
+        workers[i].num_workers = num_threads;
+        workers[i].num_games = num_games;
+        workers[i].num_players = num_players;
+        workers[i].seed = seed;
+        workers[i].seat_providers = seat_providers;
+        start_thread(&threads[i], tournament_thread, &workers[i]);
+    }
+
+    // Attende i thread e unisce i risultati parziali (ogni thread ha scritto solo i propri, non servono lock)
+    Tournament_results total = {0};
+    for (int i = 0; i < num_threads; i++) {
+        join_thread(&threads[i]);
+        merge_tournament_results(&total, &workers[i].results);
+    }
+
+    double elapsed_time = get_wall_time() - start_time; // Tempo reale impiegato in secondi
+
+    free(threads);
+    free(workers);
+
+    printf("[" HBLU "i" RESET "] Torneo di %d partite con %d giocatori su %d thread in %.3f secondi", num_games, num_players, num_threads, elapsed_time);
+    if (elapsed_time > 0) {
+        printf(" (%.1f partite/s)", num_games / elapsed_time);
+    }
+    printf(".\n");
+    printf("[" HBLU "i" RESET "] Seme del torneo: %" PRIu64 "\n", seed);
+    printf("[" HBLU "i" RESET "] Partite con un vincitore: %d/%d, round medi per partita: %.1f\n", total.num_completed_games, num_games, (double) total.total_rounds / num_games);
+    printf("[" HBLU "i" RESET "] Vittorie per posto:");
+    for (int i = 0; i < num_players; i++) {
+        const Decision_provider* provider = seat_providers != NULL && seat_providers[i] != NULL ? seat_providers[i] : &RANDOM_PROVIDER;
+        printf(" Bot %d (%s) = %d%s", i + 1, provider->name, total.wins[i], i + 1 < num_players ? "," : "\n");
+    }
+
+    return;
+}
@@ -0,0 +1,11 @@
+#ifndef UNSTABLE_STUDENTS_TOURNAMENT_H
+#define UNSTABLE_STUDENTS_TOURNAMENT_H
+
+#include "../model/structs.h"
+#include <stdint.h>
+
+void play_tournament_games(Tournament_worker* worker);
+void merge_tournament_results(Tournament_results* total, const Tournament_results* partial);
+void run_tournament(int num_games, int num_players, int num_threads, uint64_t seed, const Decision_provider* const* seat_providers);
+
+#endif
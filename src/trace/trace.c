@@ -0,0 +1,134 @@
+#include "trace.h"
+
+// Senza TRACE il modulo non contiene codice: TRACE_FUNCTION() non genera chiamate
+#ifdef TRACE
+
+#include "../utils/utils.h"
+#include "../model/colors.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Le funzioni di questo file non usano TRACE_FUNCTION() (e chiamano solo get_wall_time, che non è tracciata),
+// altrimenti il tracciamento traccerebbe se stesso all'infinito.
+
+static THREAD_LOCAL Trace_entry thread_trace[TRACE_TABLE_SIZE]; // Tabella del tracciamento del thread corrente (senza lock)
+static Trace_entry total_trace[TRACE_TABLE_SIZE];               // Tabella complessiva, in cui confluiscono le tabelle dei thread
+static volatile int total_trace_lock = 0;                       // Spinlock della tabella complessiva
+static volatile int report_registered = 0;                      // Flag per registrare una sola volta il report all'uscita
+
+/**
+ * @brief Cerca (o crea) la voce di una funzione in una tabella del tracciamento.
+ * 
+ * La chiave è il puntatore a __func__, unico per ogni funzione, quindi non servono confronti tra stringhe.
+ * 
+ * @param table Tabella del tracciamento.
+ * @param function Nome della funzione.
+ * @return Trace_entry* Puntatore alla voce della funzione.
+ */
+static Trace_entry* find_trace_entry(Trace_entry* table, const char* function) {
+    size_t index = (size_t) (((uintptr_t) function >> 3) & (TRACE_TABLE_SIZE - 1));
+
+    // Scansione lineare a partire dalla posizione ricavata dal puntatore
+    while (table[index].function != NULL && table[index].function != function) {
+        index = (index + 1) & (TRACE_TABLE_SIZE - 1);
+    }
+
+    table[index].function = function;
+    return &table[index];
+}
+
+/**
+ * @brief Confronta due voci del tracciamento per tempo cumulativo decrescente (per qsort).
+ * 
+ * @param a Puntatore alla prima voce.
+ * @param b Puntatore alla seconda voce.
+ * @return Valore negativo, nullo o positivo a seconda dell'ordine delle voci.
+ */
+static int compare_trace_entries(const void* a, const void* b) {
+    double x = ((const Trace_entry*) a)->total_time, y = ((const Trace_entry*) b)->total_time;
+    return (x < y) - (x > y);
+}
+
+/**
+ * @brief Scrive il report del tracciamento (chiamate e tempo cumulativo di ogni funzione), all'uscita del programma.
+ */
+static void write_trace_report() {
+    flush_thread_trace(); // Il thread che termina il programma non è passato da join_thread
+
+    qsort(total_trace, TRACE_TABLE_SIZE, sizeof(Trace_entry), compare_trace_entries);
+
+    FILE* file = fopen(TRACE_REPORT_PATH, "w");
+    if (file == NULL) {
+        printf("\n[" RED "!" RESET "] Impossibile scrivere il report del tracciamento \"%s\"!\n", TRACE_REPORT_PATH);
+        return;
+    }
+
+    fprintf(file, "%-32s %14s %18s %16s\n", "Funzione", "Chiamate", "Tempo totale (ms)", "Tempo medio (us)");
+    for (int i = 0; i < TRACE_TABLE_SIZE && total_trace[i].function != NULL; i++) {
+        const Trace_entry* entry = &total_trace[i];
+        fprintf(file, "%-32s %14llu %18.3f %16.3f\n", entry->function, entry->calls, entry->total_time * 1e3, entry->total_time * 1e6 / (double) entry->calls);
+    }
+
+    fclose(file);
+    printf("\n[" HBLU "i" RESET "] Report del tracciamento delle funzioni scritto in \"%s\".\n", TRACE_REPORT_PATH);
+
+    return;
+}
+
+/**
+ * @brief Registra l'ingresso in una funzione (vedi TRACE_FUNCTION).
+ * 
+ * @param function Nome della funzione.
+ * @return Trace_scope Scope della chiamata, chiuso da end_trace all'uscita dalla funzione.
+ */
+Trace_scope begin_trace(const char* function) {
+    // Alla prima chiamata (di qualsiasi thread) registra il report all'uscita del programma
+    if (report_registered == 0 && __sync_bool_compare_and_swap(&report_registered, 0, 1)) {
+        atexit(write_trace_report);
+    }
+
+    Trace_scope scope;
+    scope.entry = find_trace_entry(thread_trace, function);
+    scope.entry->calls++;
+    scope.start_time = get_wall_time();
+
+    return scope;
+}
+
+/**
+ * @brief Registra l'uscita da una funzione, aggiungendo il tempo trascorso al suo tempo cumulativo.
+ * 
+ * @param scope Puntatore allo scope della chiamata.
+ */
+void end_trace(Trace_scope* scope) {
+    scope->entry->total_time += get_wall_time() - scope->start_time;
+    return;
+}
+
+/**
+ * @brief Unisce la tabella del tracciamento del thread corrente alla tabella complessiva e la azzera.
+ * 
+ * Va chiamata da ogni thread prima di terminare (vedi thread_entry).
+ */
+void flush_thread_trace() {
+    // Acquisisce lo spinlock della tabella complessiva
+    while (__sync_lock_test_and_set(&total_trace_lock, 1)) {
+        // Attesa attiva: le unioni sono rare (una per thread)
+    }
+
+    for (int i = 0; i < TRACE_TABLE_SIZE; i++) {
+        if (thread_trace[i].function != NULL) {
+            Trace_entry* entry = find_trace_entry(total_trace, thread_trace[i].function);
+            entry->calls += thread_trace[i].calls;
+            entry->total_time += thread_trace[i].total_time;
+        }
+    }
+
+    __sync_lock_release(&total_trace_lock);
+    memset(thread_trace, 0, sizeof(thread_trace));
+
+    return;
+}
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef UNSTABLE_STUDENTS_TRACE_H
+#define UNSTABLE_STUDENTS_TRACE_H
+
+// #define TRACE 1 // Decommentare (o compilare con "make TRACE=1") per abilitare il tracciamento delle funzioni
+
+#include "../model/structs.h"
+#include <stdio.h>
+
+// TRACE_FUNCTION() va usata come prima istruzione di ogni funzione:
+// - con TRACE conta le chiamate e misura il tempo cumulativo della funzione (report scritto all'uscita del programma);
+// - con DEBUG stampa il nome della funzione;
+// - altrimenti non genera alcun codice.
+#if defined(TRACE)
+    // Il tempo della funzione viene chiuso all'uscita dallo scope tramite l'attributo cleanup (GCC, Clang, MinGW)
+    #if !defined(__GNUC__)
+        #error "Il tracciamento delle funzioni (TRACE) richiede GCC o Clang"
+    #endif
+
+    Trace_scope begin_trace(const char* function);
+    void end_trace(Trace_scope* scope);
+    void flush_thread_trace();
+
+    #define TRACE_FUNCTION() Trace_scope trace_scope __attribute__((cleanup(end_trace), unused)) = begin_trace(__func__)
+#elif defined(DEBUG)
+    #define TRACE_FUNCTION() printf("[DEBUG] Entrato nella funzione \"%s\".\n", __func__)
+#else
+    #define TRACE_FUNCTION() ((void) 0)
+#endif
+
+#endif
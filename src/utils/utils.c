@@ -1,48 +1,56 @@
+// Necessario per clock_gettime con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
 #include "utils.h"
 
 #include "../model/constants.h"
 #include "../model/colors.h"
+#include "../screen/screen.h"
 #include <assert.h>
+#include <stdarg.h>
 #include <string.h>
 
-/**
- * @brief Stampa un messaggio di debug con il nome della funzione.
- * 
- * @param func Nome della funzione.
- */
-void dbg_func(const char* func) {
-    #ifdef DEBUG
-        printf("[DEBUG] Entrato nella funzione \"%s\".\n", func);
-    #endif
-    return;
-}
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <time.h>
+#endif
+
+static THREAD_LOCAL bool silent_output = false; // Flag per sopprimere l'output di gioco del thread corrente (partite simulate e ricerca dei bot)
+static THREAD_LOCAL const Output_sink* output_sink = NULL; // Destinazione dell'output di gioco del thread corrente (NULL => stdout)
+static THREAD_LOCAL const Player* output_recipient = NULL; // Giocatore a cui è riservato l'output di gioco del thread corrente (NULL => tutti i giocatori)
+static THREAD_LOCAL unsigned long long num_allocations = 0; // Numero di allocazioni dinamiche eseguite dal thread corrente (benchmark e tornei)
 
 /**
  * @brief Pulisce il buffer di input.
  */
 void clear_buffer() {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
     while (getchar() != '\n'); // Pulisce il buffer di input
+    note_screen_output("\n", 1); // L'invio dell'utente porta il cursore a capo
     return;
 }
 
 /**
- * @brief Pulisce lo schermo della console.
+ * @brief Restituisce l'istante corrente di un orologio monotono (tempo reale, non tempo di CPU).
+ * 
+ * @return Istante corrente in secondi.
  */
-void clear_screen() {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+double get_wall_time() {
+    // Non tracciata: viene usata dal tracciamento stesso per misurare il tempo delle funzioni
 
     #ifdef _WIN32
-        system("cls"); 
-    #elif _WIN64
-        system("cls");
-    #elif __linux__
-        system("clear");
-    #elif __APPLE__
-        system("clear");
+        LARGE_INTEGER frequency, counter;
+        QueryPerformanceFrequency(&frequency);
+        QueryPerformanceCounter(&counter);
+        return (double) counter.QuadPart / (double) frequency.QuadPart;
+    #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (double) ts.tv_sec + (double) ts.tv_nsec / 1e9;
     #endif
-
-    return;
 }
 
 /**
@@ -52,7 +60,7 @@ void clear_screen() {
  * @param speed Velocità di stampa in millisecondi.
  */
 void slow_print(const char* str, unsigned int speed) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     for (int i = 0; str[i] != '\0'; i++) {
         printf("%c", str[i]); // Stampa un carattere
@@ -64,13 +72,135 @@ void slow_print(const char* str, unsigned int speed) {
     return;
 }
 
+/**
+ * @brief Abilita o disabilita la modalità silenziosa dell'output di gioco.
+ * 
+ * @param silent Flag per sopprimere l'output di gioco.
+ */
+void set_silent_output(bool silent) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    silent_output = silent;
+    return;
+}
+
+/**
+ * @brief Controlla se la modalità silenziosa dell'output di gioco è attiva.
+ * 
+ * @return true se l'output di gioco è soppresso, false altrimenti.
+ */
+bool is_silent_output() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return silent_output;
+}
+
+/**
+ * @brief Imposta la destinazione dell'output di gioco del thread corrente.
+ * 
+ * @param sink Puntatore alla destinazione (NULL per tornare a stdout).
+ */
+void set_output_sink(const Output_sink* sink) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    output_sink = sink;
+    return;
+}
+
+/**
+ * @brief Restituisce la destinazione dell'output di gioco del thread corrente.
+ * 
+ * @return const Output_sink* Puntatore alla destinazione, NULL SE l'output va su stdout.
+ */
+const Output_sink* get_output_sink() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return output_sink;
+}
+
+/**
+ * @brief Riserva l'output di gioco del thread corrente a un giocatore (es. le carte della sua mano).
+ * 
+ * Le destinazioni che servono più giocatori (i tavoli del server) inviano l'output riservato solo a quel giocatore;
+ * su stdout (partite da terminale) l'output viene stampato comunque.
+ * 
+ * @param player Puntatore al giocatore (NULL per tornare all'output visibile a tutti i giocatori).
+ */
+void set_output_recipient(const Player* player) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    output_recipient = player;
+    return;
+}
+
+/**
+ * @brief Scrive dell'output di gioco sulla destinazione del thread corrente (stdout, registrandolo sullo schermo).
+ * 
+ * @param data Byte da scrivere.
+ * @param length Numero di byte da scrivere.
+ */
+static void write_output(const char* data, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE è impostata una destinazione => l'output non passa dal terminale
+    if (output_sink != NULL) {
+        output_sink->write(output_sink->context, output_recipient, data, length);
+        return;
+    }
+
+    fwrite(data, 1, length, stdout);
+    note_screen_output(data, length);
+
+    return;
+}
+
+/**
+ * @brief Stampa un messaggio di gioco, a meno che la modalità silenziosa non sia attiva.
+ * 
+ * @param format Stringa di formato (come per printf).
+ * @param ... Argomenti della stringa di formato.
+ */
+void print_msg(const char* format, ...) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la modalità silenziosa è attiva => non stampa nulla
+    if (silent_output) {
+        return;
+    }
+
+    // Formatta il messaggio in un buffer, così da stamparlo con un'unica scrittura e registrarlo sullo schermo
+    char buffer[PRINT_MSG_BUFFER_SIZE];
+    char* msg = buffer;
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(buffer, sizeof(buffer), format, args);
+    va_end(args);
+
+    // SE il messaggio non è valido => non stampa nulla
+    if (length < 0) {
+        return;
+    }
+
+    // SE il messaggio non entra nel buffer => lo formatta in un buffer allocato della dimensione giusta
+    if ((size_t) length >= sizeof(buffer)) {
+        msg = (char*) safe_malloc((size_t) length + 1);
+        va_start(args, format);
+        vsnprintf(msg, (size_t) length + 1, format, args);
+        va_end(args);
+    }
+
+    write_output(msg, (size_t) length);
+
+    if (msg != buffer) {
+        free(msg);
+    }
+
+    return;
+}
+
 /**
  * @brief Legge un numero intero da input.
  * 
  * @param num Puntatore alla variabile in cui salvare il numero letto.
  */
 void read_int(int* num) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Continua a leggere finché l'input non è un intero
     while (scanf(" %d", num) != 1) { // Legge un intero
@@ -91,16 +221,16 @@ void read_int(int* num) {
  * @return Il numero scelto dall'utente.
  */
 int choice_int(int max_range, int min_range, char* msg, char* error_msg) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     int choice_int; // Variabile per la scelta dell'utente
     do {
-        printf(msg); // Stampa il messaggio per la scelta
+        print_msg(msg); // Stampa il messaggio per la scelta
         read_int(&choice_int); // Legge un intero
 
         // Controlla SE la scelta è valida
         if (choice_int < min_range || choice_int > max_range) {
-            printf(error_msg); // Stampa il messaggio di errore
+            print_msg(error_msg); // Stampa il messaggio di errore
         }
     } while (choice_int < min_range || choice_int > max_range);
 
@@ -114,7 +244,7 @@ int choice_int(int max_range, int min_range, char* msg, char* error_msg) {
  * @return true se il carattere è alfanumerico, false altrimenti.
  */
 bool char_isalnum(const char c) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
     // Controlla se il carattere è una lettera o un numero
     return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
 }
@@ -127,7 +257,7 @@ bool char_isalnum(const char c) {
  * @return true se il carattere è presente, false altrimenti.
  */
 bool char_find(const char* str, const char c) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Scorre tutti i caratteri della stringa
     for (int i = 0; i < strlen(str); i++) {
@@ -147,7 +277,7 @@ bool char_find(const char* str, const char c) {
  * @return Numero di occorrenze del carattere.
  */
 int count_char(const char* str, const char c) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     int count = 0; // Contatore delle occorrenze
 
@@ -169,13 +299,13 @@ int count_char(const char* str, const char c) {
  * @return Il carattere letto.
  */
 char read_char(const char* choices, const char* msg, const char* error_msg) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     char c; // Initializza la variabile per la scelta dell'utente
     bool valid = false; // Flag per la validità della scelta
 
     do {
-        printf(msg); // Stampa il messaggio per la scelta
+        print_msg(msg); // Stampa il messaggio per la scelta
         scanf(" %c", &c); // Legge un carattere
         clear_buffer(); // Pulisce il buffer di input
 
@@ -183,7 +313,7 @@ char read_char(const char* choices, const char* msg, const char* error_msg) {
         if (char_find(choices, c)) {
             valid = true;
         } else {
-            printf("%s", error_msg); // Stampa il messaggio di errore
+            print_msg("%s", error_msg); // Stampa il messaggio di errore
         }
 
     } while (!valid);
@@ -199,7 +329,7 @@ char read_char(const char* choices, const char* msg, const char* error_msg) {
  * @return Il valore minimo.
  */
 int min(const int a, const int b) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
     return a < b ? a : b; // Restituisce il valore minimo
 }
 
@@ -211,7 +341,7 @@ int min(const int a, const int b) {
  * @return Il valore massimo.
  */
 int max(const int a, const int b) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
     return a > b ? a : b; // Restituisce il valore massimo
 }
 
@@ -222,7 +352,7 @@ int max(const int a, const int b) {
  * @return true se il nome del file è valido, false altrimenti.
  */
 bool is_valid_filename(const char* filename) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Controlla la lunghezza del nome del file
     if (strlen(filename) == 0 || strlen(filename) > MAX_FILENAME_LENGTH) {
@@ -246,7 +376,7 @@ bool is_valid_filename(const char* filename) {
  * @return true se il file esiste, false altrimenti.
  */
 bool file_exists(const char* path) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     FILE *file = fopen(path, "r"); // Apre il file in modalità lettura
     if (file) {
@@ -265,7 +395,7 @@ bool file_exists(const char* path) {
  * @return Puntatore al file aperto.
  */
 FILE* safe_fopen(const char* filename, const char* mode) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     FILE* file = fopen(filename, mode); // Apre il file
 
@@ -287,7 +417,7 @@ FILE* safe_fopen(const char* filename, const char* mode) {
  * @param stream Puntatore al file da cui leggere.
  */
 void safe_fread(void* ptr, size_t element_size, size_t count, FILE* stream) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     size_t read = fread(ptr, element_size, count, stream); // Legge dal file
 
@@ -309,7 +439,7 @@ void safe_fread(void* ptr, size_t element_size, size_t count, FILE* stream) {
  * @param stream Puntatore al file su cui scrivere.
  */
 void safe_fwrite(void* ptr, size_t element_size, size_t count, FILE* stream) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     size_t written = fwrite(ptr, element_size, count, stream); // Scrive sul file
 
@@ -322,6 +452,16 @@ void safe_fwrite(void* ptr, size_t element_size, size_t count, FILE* stream) {
     return;
 }
 
+/**
+ * @brief Restituisce il numero di allocazioni dinamiche eseguite dal thread corrente tramite safe_malloc, safe_calloc e safe_realloc.
+ * 
+ * @return Numero di allocazioni eseguite dal thread corrente dal suo avvio.
+ */
+unsigned long long count_allocations() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+    return num_allocations;
+}
+
 /**
  * @brief Alloca memoria in modo sicuro.
  * 
@@ -329,9 +469,10 @@ void safe_fwrite(void* ptr, size_t element_size, size_t count, FILE* stream) {
  * @return Puntatore alla memoria allocata.
  */
 void* safe_malloc(size_t size) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     void* ptr = malloc(size); // Alloca memoria dinamicamente
+    num_allocations++; // Aggiorna il contatore delle allocazioni
 
     // Controlla SE la memoria è stata allocata correttamente
     if (ptr == NULL) {
@@ -350,9 +491,10 @@ void* safe_malloc(size_t size) {
  * @return Puntatore alla memoria allocata.
  */
 void* safe_calloc(size_t num, size_t size) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     void* ptr = calloc(num, size); // Alloca e azzera memoria dinamicamente
+    num_allocations++; // Aggiorna il contatore delle allocazioni
 
     // Controlla SE la memoria è stata allocata correttamente
     if (ptr == NULL) {
@@ -371,9 +513,10 @@ void* safe_calloc(size_t num, size_t size) {
  * @return Puntatore alla nuova memoria allocata.
  */
 void* safe_realloc(void* ptr, size_t size) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     void* new_ptr = realloc(ptr, size); // Rialloca memoria dinamicamente
+    num_allocations++; // Aggiorna il contatore delle allocazioni
 
     // Controlla SE la memoria è stata riallocata correttamente
     if (new_ptr == NULL) {
@@ -390,7 +533,7 @@ void* safe_realloc(void* ptr, size_t size) {
  * @param str Stringa da sanificare.
  */
 void sanitize_string(char* str) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     int i, j = 0; // Offset iniziali
     int len = strlen(str); // Lunghezza della stringa
@@ -411,7 +554,7 @@ void sanitize_string(char* str) {
  * @param str Stringa da elaborare.
  */
 void strip_string(char* str) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     // Offset iniziali
     int left_index = 0;
@@ -446,7 +589,7 @@ void strip_string(char* str) {
  * @return true Se le stringhe sono uguali, false altrimenti.
  */
 bool strcmp_insensitive(const char* s1, const char* s2) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     if (strlen(s1) != strlen(s2)) {
         return false;
@@ -476,20 +619,22 @@ bool strcmp_insensitive(const char* s1, const char* s2) {
 }
 
 /**
- * @brief Divide una stringa in più righe di lunghezza massima specificata.
+ * @brief Calcola come dividere una stringa in più righe di lunghezza massima specificata, senza copiarla.
+ * 
+ * Le righe vengono spezzate all'ultimo spazio entro la lunghezza massima (o a metà parola SE non ci sono spazi)
+ * e gli spazi all'inizio di ogni riga vengono saltati.
  * 
  * @param text Testo da spezzare.
  * @param max_width Lunghezza massima di ogni riga.
- * @param num_lines Puntatore per restituire il numero di righe generate.
- * @return Array di stringhe contenenti il testo wrappato.
+ * @param lines Vettore in cui scrivere inizio e lunghezza di ogni riga (NULL per contare solo le righe).
+ * @param max_lines Dimensione del vettore delle righe.
+ * @return int Numero di righe del testo.
  */
-char** wrap_text(const char* text, const int max_width, int* num_lines) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+int wrap_text_lines(const char* text, const int max_width, Text_line* lines, const int max_lines) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     int len = strlen(text); // Lunghezza del testo
-    int lines = 0; // Numero di righe generate
-
-    char** wrapped_text = NULL;
+    int num_lines = 0; // Numero di righe calcolate
 
     int start = 0;
     while (start < len) {
@@ -508,24 +653,12 @@ char** wrap_text(const char* text, const int max_width, int* num_lines) {
             }
         }
 
-        // Calcola la lunghezza della riga e alloca la memoria
-        int line_length = end - start;
-        char* line = (char*) safe_malloc((max_width + 1) * sizeof(char));
-
-        // Copia la riga nel buffer
-        strncpy(line, text + start, line_length);
-
-        // Aggiunge spazi alla fine della riga
-        for (int i = line_length; i < max_width; i++) {
-            line[i] = ' ';
+        // SE c'è spazio nel vettore => salva inizio e lunghezza della riga
+        if (lines != NULL && num_lines < max_lines) {
+            lines[num_lines].start = (uint8_t) start;
+            lines[num_lines].length = (uint8_t) (end - start);
         }
-
-        // Termina correttamente la stringa
-        line[max_width] = '\0';
-
-        // Aggiunge la nuova riga al puntatore di righe
-        wrapped_text = (char**) safe_realloc(wrapped_text, (lines + 1) * sizeof(char*));
-        wrapped_text[lines++] = line;
+        num_lines++;
 
         // Aggiorna l'inizio del prossimo segmento
         start = end;
@@ -536,8 +669,7 @@ char** wrap_text(const char* text, const int max_width, int* num_lines) {
         };
     }
 
-    *num_lines = lines;
-    return wrapped_text;
+    return num_lines;
 }
 
 /**
@@ -548,7 +680,7 @@ char** wrap_text(const char* text, const int max_width, int* num_lines) {
  * @return Stringa contenente il carattere ripetuto.
  */
 char* repeat_char(const char c, const int times) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     char* repeated_str = (char*) safe_malloc((times + 1) * sizeof(char)); // Alloca la memoria dinamicamente per la nuova stringa
     repeated_str[times] = '\0'; // Termina correttamente la stringa
@@ -569,7 +701,7 @@ char* repeat_char(const char c, const int times) {
  * @return Nuova stringa contenente la ripetizione della stringa originale.
  */
 char* repeat_string(const char* str, const int times) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     int len = strlen(str); // Lunghezza della stringa
     char* repeated_str = (char*) safe_malloc((len * times + 1) * sizeof(char)); // Alloca la memoria dinamicamente per la nuova stringa
@@ -591,7 +723,7 @@ char* repeat_string(const char* str, const int times) {
  * @return Numero di spazi di padding necessari.
  */
 int calculate_padding(const int max_width, const int len) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
     return (max_width - len) / 2;
 }
 
@@ -603,7 +735,7 @@ int calculate_padding(const int max_width, const int len) {
  * @return Nuova stringa con padding aggiunto.
  */
 char* padding_string(const char* str, const int width) {
-    dbg_func(__func__); // Stampa il nome della funzione in modalità debug
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
 
     int len = strlen(str); // Lunghezza della stringa
     assert (len <= width && "Stringa più lunga della larghezza specificata!");
@@ -630,4 +762,174 @@ char* padding_string(const char* str, const int width) {
     free(right_padding);
 
     return padded_str;
+}
+
+/**
+ * @brief Inizializza un frame, allocando in anticipo la memoria necessaria.
+ * 
+ * @param frame Puntatore al frame da inizializzare.
+ * @param capacity Numero di byte da allocare (calcolato dal layout del contenuto).
+ */
+void init_frame(Frame* frame, size_t capacity) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    frame->data = (char*) safe_malloc(capacity + 1);
+    frame->data[0] = '\0';
+    frame->length = 0;
+    frame->capacity = capacity;
+
+    return;
+}
+
+/**
+ * @brief Svuota un frame mantenendo la memoria già allocata (il frame viene inizializzato SE non lo è ancora).
+ * 
+ * @param frame Puntatore al frame.
+ */
+void reset_frame(Frame* frame) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE il frame non è ancora stato allocato => lo inizializza
+    if (frame->data == NULL) {
+        init_frame(frame, 0);
+        return;
+    }
+
+    frame->data[0] = '\0';
+    frame->length = 0;
+
+    return;
+}
+
+/**
+ * @brief Si assicura che nel frame ci sia spazio per altri byte (di norma non serve, la capacità è calcolata in anticipo).
+ * 
+ * @param frame Puntatore al frame.
+ * @param size Numero di byte da aggiungere.
+ */
+void reserve_frame(Frame* frame, size_t size) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE la stima del layout non è sufficiente => raddoppia la capacità
+    if (frame->length + size > frame->capacity) {
+        frame->capacity = frame->capacity * 2 > frame->length + size ? frame->capacity * 2 : frame->length + size;
+        frame->data = (char*) safe_realloc(frame->data, frame->capacity + 1);
+    }
+
+    return;
+}
+
+/**
+ * @brief Accoda una stringa al frame.
+ * 
+ * @param frame Puntatore al frame.
+ * @param str Stringa da accodare.
+ */
+void frame_append(Frame* frame, const char* str) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    size_t len = strlen(str);
+    reserve_frame(frame, len);
+
+    memcpy(frame->data + frame->length, str, len);
+    frame->length += len;
+    frame->data[frame->length] = '\0';
+
+    return;
+}
+
+/**
+ * @brief Accoda al frame i primi caratteri di una stringa.
+ * 
+ * @param frame Puntatore al frame.
+ * @param str Stringa da cui copiare i caratteri.
+ * @param length Numero di caratteri da accodare.
+ */
+void frame_append_length(Frame* frame, const char* str, size_t length) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    reserve_frame(frame, length);
+
+    memcpy(frame->data + frame->length, str, length);
+    frame->length += length;
+    frame->data[frame->length] = '\0';
+
+    return;
+}
+
+/**
+ * @brief Accoda al frame una stringa ripetuta un numero specificato di volte.
+ * 
+ * @param frame Puntatore al frame.
+ * @param str Stringa da ripetere.
+ * @param times Numero di ripetizioni.
+ */
+void frame_append_repeat(Frame* frame, const char* str, int times) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // SE non ci sono ripetizioni => non fa nulla
+    if (times <= 0) {
+        return;
+    }
+
+    size_t len = strlen(str);
+    reserve_frame(frame, len * (size_t) times);
+
+    for (int i = 0; i < times; i++) {
+        memcpy(frame->data + frame->length, str, len);
+        frame->length += len;
+    }
+    frame->data[frame->length] = '\0';
+
+    return;
+}
+
+/**
+ * @brief Accoda al frame una stringa centrata entro una lunghezza specificata (come padding_string, senza allocazioni).
+ * 
+ * @param frame Puntatore al frame.
+ * @param str Stringa da accodare.
+ * @param width Lunghezza desiderata della stringa.
+ */
+void frame_append_centered(Frame* frame, const char* str, int width) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int len = (int) strlen(str); // Lunghezza della stringa
+    assert (len <= width && "Stringa più lunga della larghezza specificata!");
+
+    int left_padding_len = calculate_padding(width, len);
+
+    frame_append_repeat(frame, " ", left_padding_len);
+    frame_append(frame, str);
+    frame_append_repeat(frame, " ", width - len - left_padding_len);
+
+    return;
+}
+
+/**
+ * @brief Stampa il contenuto di un frame con un'unica scrittura.
+ * 
+ * @param frame Puntatore al frame da stampare.
+ */
+void print_frame(const Frame* frame) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    write_output(frame->data, frame->length);
+    return;
+}
+
+/**
+ * @brief Libera la memoria allocata per un frame.
+ * 
+ * @param frame Puntatore al frame da liberare.
+ */
+void free_frame(Frame* frame) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    free(frame->data);
+    frame->data = NULL;
+    frame->length = 0;
+    frame->capacity = 0;
+
+    return;
 }
\ No newline at end of file
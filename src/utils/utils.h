@@ -3,14 +3,28 @@
 
 // #define DEBUG 1 // Decommentare per abilitare la modalità debug
 
+#include "../model/structs.h"
+#include "../trace/trace.h"
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdio.h>
 
-void dbg_func(const char* func);
+// Specificatore per le variabili locali a ciascun thread (il C99 non prevede _Thread_local)
+#ifdef _MSC_VER
+    #define THREAD_LOCAL __declspec(thread)
+#else
+    #define THREAD_LOCAL __thread
+#endif
+
 void clear_buffer();
-void clear_screen();
+double get_wall_time();
 void slow_print(const char* str, unsigned int speed);
+void set_silent_output(bool silent);
+bool is_silent_output();
+void set_output_sink(const Output_sink* sink);
+const Output_sink* get_output_sink();
+void set_output_recipient(const Player* player);
+void print_msg(const char* format, ...);
 void read_int(int* num);
 int choice_int(int max_range, int min_range, char* msg, char* error_msg);
 bool char_isalnum(const char c);
@@ -24,16 +38,27 @@ bool file_exists(const char* path);
 FILE* safe_fopen(const char* filename, const char* mode);
 void safe_fread(void* ptr, size_t element_size, size_t count, FILE* stream);
 void safe_fwrite(void* ptr, size_t element_size, size_t count, FILE* stream);
+unsigned long long count_allocations();
 void* safe_malloc(size_t size);
 void* safe_calloc(size_t num, size_t size);
 void* safe_realloc(void* ptr, size_t size);
 void sanitize_string(char* str);
 void strip_string(char* str);
 bool strcmp_insensitive(const char* s1, const char* s2);
-char** wrap_text(const char* text, const int max_width, int* num_lines);
+int wrap_text_lines(const char* text, const int max_width, Text_line* lines, const int max_lines);
 char* repeat_char(const char c, const int times);
 char* repeat_string(const char* str, const int times);
 int calculate_padding(const int max_width, const int len);
 char* padding_string(const char* str, const int width);
 
+void init_frame(Frame* frame, size_t capacity);
+void reset_frame(Frame* frame);
+void reserve_frame(Frame* frame, size_t size);
+void frame_append(Frame* frame, const char* str);
+void frame_append_length(Frame* frame, const char* str, size_t length);
+void frame_append_repeat(Frame* frame, const char* str, int times);
+void frame_append_centered(Frame* frame, const char* str, int width);
+void print_frame(const Frame* frame);
+void free_frame(Frame* frame);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "../src/core/game.h"
+#include "../src/decision/decision.h"
+#include "../src/utils/utils.h"
+#include "../src/model/constants.h"
+#include "../src/model/colors.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define NUM_GOLDEN_GAMES 24 // Partite simulate di riferimento
+
+/**
+ * @brief Partita simulata di riferimento: bot, numero di giocatori e seme, con il turno e l'hash finali attesi.
+ */
+typedef struct {
+    bool mixed_bots;    // true => bot greedy/blocker/casuali ai posti, false => solo bot casuali
+    int num_players;
+    uint64_t seed;
+    int round;          // Turno finale atteso
+    uint64_t hash;      // hash_game finale atteso
+} Golden_game;
+
+// Hash finali ottenuti con i gestori delle azioni precedenti alla compilazione degli effetti (vedi activate_effect):
+// qualsiasi differenza nell'ordine delle decisioni o degli spostamenti delle carte cambia l'hash della partita
+static const Golden_game GOLDEN_GAMES[NUM_GOLDEN_GAMES] = {
+    {false, 2, 7919u, 138, 0x6c766add7a935166ULL},
+    {false, 2, 15838u, 66, 0xe722bdd1e5124502ULL},
+    {false, 2, 23757u, 166, 0xa2bd22a15c183eaeULL},
+    {false, 2, 31676u, 70, 0x996aaf7a1eda735aULL},
+    {false, 3, 7919u, 82, 0x65b8af27cb1139c4ULL},
+    {false, 3, 15838u, 41, 0x0b103d313c9ab127ULL},
+    {false, 3, 23757u, 109, 0xa36f058fb6785e20ULL},
+    {false, 3, 31676u, 171, 0x3209cef9a66a53d2ULL},
+    {false, 4, 7919u, 179, 0xa79277386eb1bf21ULL},
+    {false, 4, 15838u, 111, 0xec43a44f28659451ULL},
+    {false, 4, 23757u, 131, 0x92e3229fc62ddb25ULL},
+    {false, 4, 31676u, 155, 0x94452aa9d9da4714ULL},
+    {true, 2, 7919u, 9, 0x1ceee6ce981dd55eULL},
+    {true, 2, 15838u, 10, 0x9e28f84ea3170b52ULL},
+    {true, 2, 23757u, 8, 0x5cb5ea0dbd6f479aULL},
+    {true, 2, 31676u, 10, 0x0bc8ce45c7d28554ULL},
+    {true, 3, 7919u, 24, 0xfdbbb2e660b2031aULL},
+    {true, 3, 15838u, 18, 0x6e55d734e41094a6ULL},
+    {true, 3, 23757u, 10, 0x3abe333ec8fe767bULL},
+    {true, 3, 31676u, 101, 0x8d8e2cff3e945e87ULL},
+    {true, 4, 7919u, 24, 0x1d066796ecce70e0ULL},
+    {true, 4, 15838u, 27, 0x9cb268f4cef57222ULL},
+    {true, 4, 23757u, 16, 0xdba1dc2a45763b37ULL},
+    {true, 4, 31676u, 68, 0x87bf0f753a84cde9ULL},
+};
+
+int main() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Bot dei posti al tavolo delle partite con bot misti (i bot MCTS non sono deterministici: dipendono dal tempo)
+    const Decision_provider* mixed_providers[MAX_PLAYERS] = {&GREEDY_PROVIDER, &BLOCKER_PROVIDER, &RANDOM_PROVIDER, &BLOCKER_PROVIDER};
+    int num_failures = 0; // Partite che non terminano con il turno e l'hash attesi
+
+    for (int i = 0; i < NUM_GOLDEN_GAMES; i++) {
+        const Golden_game* golden = &GOLDEN_GAMES[i];
+
+        // Durante la partita l'output di gioco viene soppresso
+        set_silent_output(true);
+
+        Game game;
+        init_simulated_game(&game, 0, golden->num_players, golden->seed, golden->mixed_bots ? mixed_providers : NULL);
+        play_game(&game);
+        uint64_t hash = hash_game(&game);
+        int round = game.round;
+        free_game(&game);
+
+        set_silent_output(false);
+
+        // SE la partita non termina come quella di riferimento => il test fallisce
+        if (round != golden->round || hash != golden->hash) {
+            printf("[" RED "!" RESET "] Partita %d (%d giocatori, seme %" PRIu64 "): turno %d, hash %016" PRIx64 ", attesi turno %d, hash %016" PRIx64 "\n", i + 1, golden->num_players, golden->seed, round, hash, golden->round, golden->hash);
+            num_failures++;
+        }
+    }
+
+    // SE almeno una partita non coincide => il test fallisce
+    if (num_failures > 0) {
+        printf("[" RED "!" RESET "] Effetti delle carte: %d partite su %d non coincidono con quelle di riferimento\n", num_failures, NUM_GOLDEN_GAMES);
+        return EXIT_FAILURE;
+    }
+
+    printf("[" HGRN "+" RESET "] Effetti delle carte: %d partite su %d coincidono con quelle di riferimento\n", NUM_GOLDEN_GAMES, NUM_GOLDEN_GAMES);
+    return EXIT_SUCCESS;
+}
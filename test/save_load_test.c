@@ -0,0 +1,126 @@
+#include "../src/core/game.h"
+#include "../src/card/card.h"
+#include "../src/journal/journal.h"
+#include "../src/player/player.h"
+#include "../src/save_load/save_load.h"
+#include "../src/utils/utils.h"
+#include "../src/model/constants.h"
+#include "../src/model/colors.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TEST_GAMES 20   // Partite simulate salvate e ricaricate ad ogni turno
+#define TEST_PLAYERS 4  // Giocatori per partita (con più di due giocatori il giocatore di turno non è quasi mai il primo)
+#define TEST_SEED 1     // Seme delle partite simulate
+
+static FILE* save_file = NULL; // File di salvataggio della partita in corso (snapshot al primo turno, poi journal)
+static int num_checks = 0;     // Turni salvati e ricaricati
+static int num_failures = 0;   // Turni in cui la partita caricata non coincide con quella non interrotta
+
+/**
+ * @brief Controlla che l'hash mantenuto da ogni mazzo coincida con quello ricalcolato da zero.
+ *
+ * @param game Puntatore alla partita.
+ * @return true Se tutti gli hash sono aggiornati, false altrimenti.
+ */
+static bool check_deck_hashes(const Game* game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    bool valid = game->draw_deck.hash == compute_deck_hash(&game->draw_deck)
+        && game->discard_deck.hash == compute_deck_hash(&game->discard_deck)
+        && game->study_room.hash == compute_deck_hash(&game->study_room);
+
+    Player* player = game->players;
+    do {
+        valid = valid && player->hand.hash == compute_deck_hash(&player->hand)
+            && player->classroom.hash == compute_deck_hash(&player->classroom)
+            && player->magic_cards.hash == compute_deck_hash(&player->magic_cards);
+        player = player->next_player;
+    } while (player != game->players);
+
+    return valid;
+}
+
+/**
+ * @brief Osservatore dei turni: salva la partita come farebbe play_game (snapshot al primo turno, poi un record
+ * del journal per turno), la ricarica dal file e confronta la partita caricata con quella non interrotta.
+ *
+ * @param observed_game Puntatore alla partita in corso.
+ */
+static void on_turn_start(const Game* observed_game) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Game* game = (Game*) observed_game; // Il journal registra le modifiche dei mazzi della partita
+
+    // Salvataggio del turno
+    if (save_file == NULL) {
+        save_file = tmpfile();
+        if (save_file == NULL) {
+            printf(RED "[!] Errore nella creazione del file di salvataggio temporaneo!" RESET "\n");
+            exit(EXIT_FAILURE);
+        }
+
+        write_snapshot(save_file, game, game->current_player);
+        open_journal(&game->journal, save_file);
+        assign_journal_zones(game, game->players, &game->journal);
+    } else {
+        commit_journal_turn(&game->journal, game, game->current_player);
+    }
+
+    // Caricamento del salvataggio, come in load_saved_game
+    Game loaded = {0};
+    char magic[SAVE_MAGIC_LEN];
+    rewind(save_file);
+    safe_fread(magic, 1, SAVE_MAGIC_LEN, save_file);
+
+    int num_definitions = 0;
+    const Card_definition** definitions = read_snapshot(save_file, &loaded, &num_definitions);
+    replay_journal(save_file, &loaded, definitions, num_definitions);
+    free(definitions);
+    link_players_to_game(&loaded);
+    fseek(save_file, 0, SEEK_END); // Il journal riprende ad accodare i record dalla fine del file
+
+    uint64_t expected_hash = hash_game(game);
+    uint64_t loaded_hash = hash_game(&loaded);
+    num_checks++;
+
+    // SE la partita caricata non coincide con quella non interrotta => il test fallisce
+    if (loaded.round != game->round || loaded_hash != expected_hash || !check_deck_hashes(&loaded)) {
+        printf("[" RED "!" RESET "] %s, round %d: hash della partita caricata %016" PRIx64 ", atteso %016" PRIx64 "\n", game->name, game->round, loaded_hash, expected_hash);
+        num_failures++;
+    }
+
+    free_game(&loaded);
+    return;
+}
+
+int main() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Durante il test l'output di gioco viene soppresso
+    set_silent_output(true);
+
+    for (int i = 0; i < TEST_GAMES; i++) {
+        Game game;
+        init_simulated_game(&game, i, TEST_PLAYERS, TEST_SEED, NULL);
+        game.turn_observer = on_turn_start;
+
+        play_game(&game);
+
+        free_game(&game); // Chiude anche il file di salvataggio temporaneo (aperto dal journal)
+        save_file = NULL;
+    }
+
+    set_silent_output(false);
+
+    // SE almeno un turno non coincide => il test fallisce
+    if (num_failures > 0) {
+        printf("[" RED "!" RESET "] Salvataggio e caricamento: %d turni su %d non coincidono con la partita non interrotta\n", num_failures, num_checks);
+        return EXIT_FAILURE;
+    }
+
+    printf("[" HGRN "+" RESET "] Salvataggio e caricamento: %d turni su %d coincidono con la partita non interrotta\n", num_checks, num_checks);
+    return EXIT_SUCCESS;
+}
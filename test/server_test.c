@@ -0,0 +1,308 @@
+// Necessario per socket, fork e mkdtemp con -std=c99
+#define _POSIX_C_SOURCE 200809L
+
+#include "../src/card/card.h"
+#include "../src/replay/replay.h"
+#include "../src/server/server.h"
+#include "../src/utils/utils.h"
+#include "../src/model/constants.h"
+#include "../src/model/colors.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+
+#include <dirent.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define TEST_PLAYERS 3           // Giocatori del tavolo
+#define TEST_SEED 1              // Seme delle risposte dei client
+#define TEST_MAX_ANSWERS 200000  // Risposte oltre le quali la partita viene considerata bloccata
+#define TEST_TIMEOUT_MS 30000    // Attesa massima di output dal server
+
+#define YES_NO_CHOICES "(" GRN "s" RESET "/" RED "n" RESET ")" // Richiesta di una decisione sì/no
+
+/**
+ * @brief Client di prova seduto al tavolo: riceve l'output di gioco e risponde alle richieste di scelta.
+ */
+typedef struct {
+    int fd;          // Socket del client
+    Frame received;  // Output ricevuto dall'ultima risposta
+    bool finished;   // true SE il server ha ricevuto il saluto di fine partita
+    bool closed;     // true SE il server ha chiuso la connessione
+} Test_client;
+
+/**
+ * @brief Genera un numero pseudo-casuale per le risposte dei client (xorshift, riproducibile).
+ *
+ * @param state Puntatore allo stato del generatore.
+ * @param range Numero di valori possibili.
+ * @return int Valore compreso tra 0 e range - 1.
+ */
+static int next_answer(uint64_t* state, int range) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+
+    return (int) (*state % (uint64_t) range);
+}
+
+/**
+ * @brief Controlla se l'output ricevuto termina con una stringa.
+ *
+ * @param received Puntatore all'output ricevuto.
+ * @param suffix Stringa da cercare.
+ * @return true Se l'output termina con la stringa, false altrimenti.
+ */
+static bool ends_with(const Frame* received, const char* suffix) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    size_t length = strlen(suffix);
+    return received->length >= length && memcmp(received->data + received->length - length, suffix, length) == 0;
+}
+
+/**
+ * @brief Risponde a una richiesta di scelta come un giocatore casuale: le risposte non valide vengono richieste di nuovo dal server.
+ *
+ * @param client Puntatore al client.
+ * @param state Puntatore allo stato del generatore delle risposte.
+ */
+static void answer_prompt(Test_client* client, uint64_t* state) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char answer[8];
+
+    if (ends_with(&client->received, ACTION_MENU)) {
+        // Azioni: quasi sempre gioca una carta, a volte pesca o mostra le schermate di stato (mai "esci")
+        static const char* actions[] = {"1", "1", "1", "1", "2", "3", "4"};
+        strcpy(answer, actions[next_answer(state, 7)]);
+    } else if (strstr(client->received.data, YES_NO_CHOICES) != NULL) {
+        strcpy(answer, next_answer(state, 2) == 0 ? "s" : "n");
+    } else {
+        sprintf(answer, "%d", next_answer(state, 10)); // Indici delle carte e dei giocatori
+    }
+
+    strcat(answer, "\n");
+    send(client->fd, answer, strlen(answer), MSG_NOSIGNAL);
+    reset_frame(&client->received);
+
+    return;
+}
+
+/**
+ * @brief Avvia il server in un processo figlio sulla porta scelta dal sistema e ne legge la porta.
+ *
+ * @param replay_folder Cartella dei replay dei tavoli.
+ * @param server_pid Puntatore al processo del server.
+ * @return int Porta del server, 0 SE il server non è stato avviato.
+ */
+static int start_test_server(const char* replay_folder, pid_t* server_pid) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    int pipe_fds[2];
+    if (pipe(pipe_fds) != 0) {
+        return 0;
+    }
+
+    fflush(stdout);
+    *server_pid = fork();
+
+    // Processo figlio: l'output del server (che stampa la porta all'avvio) viene letto dal test
+    if (*server_pid == 0) {
+        close(pipe_fds[0]);
+        dup2(pipe_fds[1], STDOUT_FILENO);
+        signal(SIGPIPE, SIG_IGN); // Dopo la porta il test smette di leggere: le stampe successive del server vengono scartate
+        run_server(0, TEST_PLAYERS, replay_folder);
+        _exit(EXIT_FAILURE);
+    }
+
+    close(pipe_fds[1]);
+
+    char line[SERVER_LINE_LENGTH + 1] = {0};
+    size_t length = 0;
+    char* port = NULL;
+    ssize_t received;
+    while (port == NULL && length < SERVER_LINE_LENGTH && (received = read(pipe_fds[0], line + length, SERVER_LINE_LENGTH - length)) > 0) {
+        length += (size_t) received;
+        port = strstr(line, "porta ");
+    }
+
+    close(pipe_fds[0]);
+    return port != NULL ? atoi(port + strlen("porta ")) : 0;
+}
+
+/**
+ * @brief Collega un client al server e invia il nome del giocatore.
+ *
+ * @param client Puntatore al client.
+ * @param port Porta del server.
+ * @param index Indice del giocatore.
+ * @return true se il client è collegato, false altrimenti.
+ */
+static bool connect_client(Test_client* client, int port, int index) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    struct sockaddr_in address = {0};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons((uint16_t) port);
+
+    *client = (Test_client) {0};
+    init_frame(&client->received, 0);
+    client->fd = socket(AF_INET, SOCK_STREAM, 0);
+
+    if (client->fd < 0 || connect(client->fd, (struct sockaddr*) &address, sizeof(address)) != 0) {
+        return false;
+    }
+
+    char name[MAX_NAME_LENGTH + 2];
+    sprintf(name, "Client%d\n", index + 1);
+    return send(client->fd, name, strlen(name), MSG_NOSIGNAL) == (ssize_t) strlen(name);
+}
+
+/**
+ * @brief Gioca la partita del tavolo finché il server non chiude tutte le connessioni.
+ *
+ * @param clients Client seduti al tavolo.
+ * @return true se la partita è terminata e tutti i client hanno ricevuto il saluto di fine partita, false altrimenti.
+ */
+static bool play_table(Test_client* clients) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    uint64_t state = TEST_SEED * 0x9E3779B97F4A7C15ULL;
+    int num_answers = 0;
+    int num_open = TEST_PLAYERS;
+
+    while (num_open > 0 && num_answers < TEST_MAX_ANSWERS) {
+        struct pollfd fds[TEST_PLAYERS];
+        for (int i = 0; i < TEST_PLAYERS; i++) {
+            fds[i].fd = clients[i].closed ? -1 : clients[i].fd;
+            fds[i].events = POLLIN;
+            fds[i].revents = 0;
+        }
+
+        // SE il server non invia nulla per troppo tempo => la partita è bloccata
+        if (poll(fds, TEST_PLAYERS, TEST_TIMEOUT_MS) <= 0) {
+            printf("[" RED "!" RESET "] Il server non risponde da %d ms\n", TEST_TIMEOUT_MS);
+            return false;
+        }
+
+        for (int i = 0; i < TEST_PLAYERS; i++) {
+            Test_client* client = &clients[i];
+            if (fds[i].revents == 0) {
+                continue;
+            }
+
+            char data[SERVER_RECV_BUFFER_SIZE];
+            ssize_t received = recv(client->fd, data, sizeof(data), 0);
+
+            // SE il server ha chiuso la connessione => il tavolo è stato eliminato
+            if (received <= 0) {
+                client->closed = true;
+                num_open--;
+                continue;
+            }
+
+            frame_append_length(&client->received, data, (size_t) received);
+            client->finished = client->finished || strstr(client->received.data, "partita terminata, arrivederci!") != NULL;
+
+            // SE l'output termina con una richiesta di scelta (non quella del nome) => risponde
+            if (ends_with(&client->received, "> ") && !ends_with(&client->received, "nome:\n> ")) {
+                answer_prompt(client, &state);
+                num_answers++;
+            }
+        }
+    }
+
+    bool finished = num_open == 0;
+    for (int i = 0; i < TEST_PLAYERS; i++) {
+        finished = finished && clients[i].finished;
+    }
+
+    return finished;
+}
+
+int main() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    char replay_folder[] = "/tmp/unstable_students_test_XXXXXX";
+    if (mkdtemp(replay_folder) == NULL) {
+        printf("[" RED "!" RESET "] Server: impossibile creare la cartella dei replay\n");
+        return EXIT_FAILURE;
+    }
+
+    pid_t server_pid = -1;
+    int port = start_test_server(replay_folder, &server_pid);
+    if (port == 0) {
+        printf("[" RED "!" RESET "] Server: impossibile avviare il server\n");
+        return EXIT_FAILURE;
+    }
+
+    // Tutti i client si siedono allo stesso tavolo e giocano la partita fino alla fine
+    Test_client clients[TEST_PLAYERS];
+    bool connected = true;
+    for (int i = 0; i < TEST_PLAYERS; i++) {
+        connected = connect_client(&clients[i], port, i) && connected;
+    }
+
+    bool finished = connected && play_table(clients);
+
+    for (int i = 0; i < TEST_PLAYERS; i++) {
+        close(clients[i].fd);
+        free_frame(&clients[i].received);
+    }
+
+    kill(server_pid, SIGTERM);
+    waitpid(server_pid, NULL, 0);
+
+    // Il replay registrato dal tavolo deve essere rigiocato fino allo stesso stato finale
+    bool verified = false;
+    int num_replays = 0;
+    DIR* dir = opendir(replay_folder);
+    struct dirent* entry;
+    while (dir != NULL && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] == '.') {
+            continue;
+        }
+
+        char path[sizeof(replay_folder) + MAX_FILENAME_LENGTH + 2];
+        snprintf(path, sizeof(path), "%s/%s", replay_folder, entry->d_name);
+        verified = run_replay(path, 1);
+        num_replays++;
+        remove(path);
+    }
+    if (dir != NULL) {
+        closedir(dir);
+    }
+    rmdir(replay_folder);
+    free_card_definitions();
+
+    // SE la partita non è terminata o il suo replay non coincide => il test fallisce
+    if (!finished || num_replays != 1 || !verified) {
+        printf("[" RED "!" RESET "] Server: partita %s, %d replay %s\n", finished ? "terminata" : "non terminata", num_replays, verified ? "verificato" : "non verificato");
+        return EXIT_FAILURE;
+    }
+
+    printf("[" HGRN "+" RESET "] Server: tavolo di %d giocatori giocato fino alla fine, replay verificato\n", TEST_PLAYERS);
+    return EXIT_SUCCESS;
+}
+
+#else
+
+int main() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Il server è disponibile solo su Linux, dove è presente epoll
+    printf("[" HBLU "i" RESET "] Server: test saltato (server disponibile solo su Linux)\n");
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "../src/core/game.h"
+#include "../src/card/card.h"
+#include "../src/decision/decision.h"
+#include "../src/session/session.h"
+#include "../src/utils/utils.h"
+#include "../src/model/constants.h"
+#include "../src/model/colors.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_PAIRS 8    // Coppie di partite giocate in due sessioni alternate sullo stesso thread
+#define TEST_PLAYERS 3  // Giocatori per partita
+#define TEST_SEED 101   // Seme delle partite simulate
+
+/**
+ * @brief Gioca una partita simulata senza sessioni (bot casuali) e restituisce l'hash dello stato finale.
+ *
+ * @param index Indice della partita (seme TEST_SEED + index).
+ * @param round Puntatore al round finale.
+ * @return uint64_t Hash della partita terminata.
+ */
+static uint64_t play_straight(int index, int* round) {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    Game game;
+    init_simulated_game(&game, index, TEST_PLAYERS, TEST_SEED, NULL);
+    play_game(&game);
+
+    uint64_t hash = hash_game(&game);
+    *round = game.round;
+    free_game(&game);
+
+    return hash;
+}
+
+int main() {
+    TRACE_FUNCTION(); // Traccia la funzione (solo in modalità debug o trace)
+
+    // Tutti i posti sospendono la partita: le risposte vengono date da qui, con le stesse scelte del bot casuale
+    const Decision_provider* session_providers[MAX_PLAYERS] = {&SESSION_PROVIDER, &SESSION_PROVIDER, &SESSION_PROVIDER, &SESSION_PROVIDER};
+    int num_failures = 0;
+    int num_switches = 0;
+
+    // Durante le partite l'output di gioco viene soppresso
+    set_silent_output(true);
+
+    for (int pair = 0; pair < TEST_PAIRS; pair++) {
+        Game games[2];
+        Game_session sessions[2];
+
+        for (int i = 0; i < 2; i++) {
+            init_simulated_game(&games[i], 2 * pair + i, TEST_PLAYERS, TEST_SEED, session_providers);
+            start_session(&sessions[i], &games[i], NULL);
+        }
+
+        // Le due partite vengono riprese a turno, una decisione alla volta, finché non terminano entrambe
+        while (sessions[0].state == SESSION_WAITING || sessions[1].state == SESSION_WAITING) {
+            for (int i = 0; i < 2; i++) {
+                if (sessions[i].state == SESSION_WAITING) {
+                    resume_session(&sessions[i], random_decide(sessions[i].decision));
+                    num_switches++;
+                }
+            }
+        }
+
+        for (int i = 0; i < 2; i++) {
+            int round;
+            uint64_t hash = play_straight(2 * pair + i, &round);
+
+            // SE la partita giocata nella sessione non coincide con quella giocata direttamente => il test fallisce
+            if (hash_game(&games[i]) != hash || games[i].round != round) {
+                set_silent_output(false);
+                printf("[" RED "!" RESET "] Partita %d: turno %d, hash %016" PRIx64 " nella sessione, turno %d, hash %016" PRIx64 " senza sessione\n", 2 * pair + i + 1, games[i].round, hash_game(&games[i]), round, hash);
+                set_silent_output(true);
+                num_failures++;
+            }
+
+            free_session(&sessions[i]);
+            free_game(&games[i]);
+        }
+    }
+
+    set_silent_output(false);
+    free_card_definitions();
+
+    // SE almeno una partita non coincide => il test fallisce
+    if (num_failures > 0) {
+        printf("[" RED "!" RESET "] Sessioni: %d partite su %d non coincidono con quelle giocate senza sessione\n", num_failures, 2 * TEST_PAIRS);
+        return EXIT_FAILURE;
+    }
+
+    printf("[" HGRN "+" RESET "] Sessioni: %d partite su %d (%d riprese alternate) coincidono con quelle giocate senza sessione\n", 2 * TEST_PAIRS, 2 * TEST_PAIRS, num_switches);
+    return EXIT_SUCCESS;
+}